@@ -1,4 +1,8 @@
 #define PERL_NO_GET_CONTEXT
+#ifdef USE_EMBEDDED_SOURCE
+/* C++ headers go before Perl's, whose macros clash with the standard library */
+#include <mygramdb/mygramclient_c_internal.h>
+#endif
 #include "EXTERN.h"
 #include "perl.h"
 #include "XSUB.h"
@@ -7,7 +11,453 @@
 
 #include <mygramdb/mygramclient_c.h>
 
-typedef MygramClient_C* MygramDB__Client;
+/* A client plus the result handles its calls are decoded from. The handles
+ * are refilled by every call, so steady-state searches and gets do not
+ * allocate on the C side. */
+typedef struct {
+    MygramClient_C* api;
+    MygramSearchResult_C* search_result;
+    MygramDocument_C* document;
+    MygramPipeline_C* pipeline;  /* search_batch/count_batch */
+    MygramAsyncResult_C* async_result;  /* poll_result */
+#ifdef USE_EMBEDDED_SOURCE
+    struct DirectCall* direct;  /* Searches and gets on the C++ client */
+#endif
+} MygramClient_XS;
+
+typedef MygramClient_XS* MygramDB__Client;
+typedef MygramPreparedSearch_C* MygramDB__Client__XS__PreparedSearch;
+
+/* Borrow string pointers from an array ref (NULL/empty when not an array ref).
+ * The returned array must be released with Safefree. */
+static const char**
+av_to_c_strings(pTHX_ SV* array_ref, size_t* count)
+{
+    const char** strings = NULL;
+    AV* av;
+    size_t i;
+
+    *count = 0;
+    if (!SvOK(array_ref) || !SvROK(array_ref) || SvTYPE(SvRV(array_ref)) != SVt_PVAV) {
+        return NULL;
+    }
+
+    av = (AV*)SvRV(array_ref);
+    *count = av_len(av) + 1;
+    if (*count > 0) {
+        Newx(strings, *count, const char*);
+        for (i = 0; i < *count; i++) {
+            SV** sv = av_fetch(av, i, 0);
+            strings[i] = sv ? SvPV_nolen(*sv) : "";
+        }
+    }
+    return strings;
+}
+
+/* Borrow key/value pointers from a hash ref (NULL/empty when not a hash ref).
+ * Both returned arrays must be released with Safefree. */
+static void
+hv_to_c_filters(pTHX_ SV* hash_ref, const char*** keys, const char*** values, size_t* count)
+{
+    HV* hv;
+    HE* entry;
+    size_t i = 0;
+
+    *keys = NULL;
+    *values = NULL;
+    *count = 0;
+    if (!SvOK(hash_ref) || !SvROK(hash_ref) || SvTYPE(SvRV(hash_ref)) != SVt_PVHV) {
+        return;
+    }
+
+    hv = (HV*)SvRV(hash_ref);
+    *count = hv_iterinit(hv);
+    if (*count > 0) {
+        Newx(*keys, *count, const char*);
+        Newx(*values, *count, const char*);
+        while ((entry = hv_iternext(hv)) != NULL) {
+            (*keys)[i] = HePV(entry, PL_na);
+            (*values)[i] = SvPV_nolen(HeVAL(entry));
+            i++;
+        }
+    }
+}
+
+/* Array ref of array refs for search_batch/count_batch (croaks otherwise) */
+static AV*
+batch_requests(pTHX_ SV* requests_ref, const char* method)
+{
+    AV* requests;
+    SSize_t i;
+
+    if (!SvROK(requests_ref) || SvTYPE(SvRV(requests_ref)) != SVt_PVAV) {
+        croak("%s: requests must be an array ref", method);
+    }
+    requests = (AV*)SvRV(requests_ref);
+    for (i = 0; i <= av_len(requests); i++) {
+        SV** request = av_fetch(requests, i, 0);
+        if (!request || !SvROK(*request) || SvTYPE(SvRV(*request)) != SVt_PVAV) {
+            croak("%s: request %d is not an array ref", method, (int)i);
+        }
+    }
+    return requests;
+}
+
+/* Element index of a batch request as a string ("" when missing) */
+static const char*
+request_string(pTHX_ SV* request, I32 index)
+{
+    SV** sv = av_fetch((AV*)SvRV(request), index, 0);
+    return sv && SvOK(*sv) ? SvPV_nolen(*sv) : "";
+}
+
+/* Element index of a batch request as an unsigned number (fallback when missing) */
+static UV
+request_uv(pTHX_ SV* request, I32 index, UV fallback)
+{
+    SV** sv = av_fetch((AV*)SvRV(request), index, 0);
+    return sv && SvOK(*sv) ? SvUV(*sv) : fallback;
+}
+
+/* { error => message } for a failed batch item */
+static SV*
+batch_error_to_sv(pTHX_ const MygramPipeline_C* pipeline, size_t index)
+{
+    HV* rh = newHV();
+    const char* message = mygramclient_pipeline_error(pipeline, index);
+    hv_store(rh, "error", 5, newSVpv(message ? message : "", 0), 0);
+    return newRV_noinc((SV*)rh);
+}
+
+/* Build { total_count => N, results => [ { primary_key => ... }, ... ] } */
+static SV*
+search_result_to_sv(pTHX_ const MygramSearchResult_C* result)
+{
+    HV* rh = newHV();
+    AV* results_av = newAV();
+    size_t i;
+
+    hv_store(rh, "total_count", 11, newSVuv(result->total_count), 0);
+
+    for (i = 0; i < result->count; i++) {
+        HV* doc_hv = newHV();
+        hv_store(doc_hv, "primary_key", 11,
+                 newSVpvn(result->primary_keys[i], result->key_lengths[i]), 0);
+        av_push(results_av, newRV_noinc((SV*)doc_hv));
+    }
+    hv_store(rh, "results", 7, newRV_noinc((SV*)results_av), 0);
+
+    return newRV_noinc((SV*)rh);
+}
+
+/* Build [ primary_key, ... ]: one SV per result instead of a hash, its key
+ * SV and a reference */
+static SV*
+search_keys_to_sv(pTHX_ const MygramSearchResult_C* result)
+{
+    AV* keys_av = newAV();
+    size_t i;
+
+    if (result->count > 0) {
+        av_extend(keys_av, result->count - 1);
+    }
+    for (i = 0; i < result->count; i++) {
+        av_push(keys_av, newSVpvn(result->primary_keys[i], result->key_lengths[i]));
+    }
+    return newRV_noinc((SV*)keys_av);
+}
+
+/* Pack the primary keys as native uint64 IDs, for unpack("Q*"): a single SV
+ * whatever the result count. Returns NULL with *error set (a mortal) on a
+ * key that is not a decimal uint64. */
+static SV*
+search_ids_to_sv(pTHX_ const MygramSearchResult_C* result, SV** error)
+{
+    SV* packed = newSV(result->count * sizeof(uint64_t) + 1);  /* newSV(0) would have no buffer */
+    char* out = SvPVX(packed);
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < result->count; i++) {
+        const char* key = result->primary_keys[i];
+        size_t length = result->key_lengths[i];
+        uint64_t id = 0;
+
+        for (j = 0; j < length; j++) {
+            unsigned digit = (unsigned char)key[j] - '0';
+            if (digit > 9 || id > (UINT64_MAX - digit) / 10) {
+                break;
+            }
+            id = id * 10 + digit;
+        }
+        if (length == 0 || j != length) {
+            *error = sv_2mortal(newSVpvf("Primary key is not an unsigned 64-bit integer: %.*s", (int)length, key));
+            SvREFCNT_dec(packed);
+            return NULL;
+        }
+        Copy(&id, out + i * sizeof(uint64_t), sizeof(uint64_t), char);
+    }
+    SvCUR_set(packed, result->count * sizeof(uint64_t));
+    *SvEND(packed) = '\0';
+    SvPOK_only(packed);
+    return packed;
+}
+
+/* Perl forms of a search result: search, *_keys and *_ids */
+enum { RESULT_HASH, RESULT_KEYS, RESULT_IDS };
+
+/* Build a search result in the given form; NULL with *error set if it cannot be */
+static SV*
+search_result_form_to_sv(pTHX_ const MygramSearchResult_C* result, int form, SV** error)
+{
+    if (form == RESULT_KEYS) {
+        return search_keys_to_sv(aTHX_ result);
+    }
+    if (form == RESULT_IDS) {
+        return search_ids_to_sv(aTHX_ result, error);
+    }
+    return search_result_to_sv(aTHX_ result);
+}
+
+/* Build { primary_key => ..., fields => { key => value } } */
+static SV*
+document_to_sv(pTHX_ const MygramDocument_C* doc)
+{
+    HV* rh = newHV();
+    HV* fields_hv = newHV();
+    size_t i;
+
+    hv_store(rh, "primary_key", 11, newSVpvn(doc->primary_key, doc->primary_key_length), 0);
+    for (i = 0; i < doc->field_count; i++) {
+        hv_store(fields_hv, doc->field_keys[i], doc->field_key_lengths[i],
+                 newSVpvn(doc->field_values[i], doc->field_value_lengths[i]), 0);
+    }
+    hv_store(rh, "fields", 6, newRV_noinc((SV*)fields_hv), 0);
+
+    return newRV_noinc((SV*)rh);
+}
+
+#ifdef USE_EMBEDDED_SOURCE
+/* Embedded builds run searches and gets on the C++ client behind the handle
+ * and decode the reply where it lies: search keys are views into the
+ * client's receive buffer and document fields into the document's copy of
+ * the reply, so each is copied once, into its SV, instead of into the C
+ * result handles first. Arguments are converted into reused strings. */
+struct DirectCall {
+    mygramdb::client::SearchResponseView search;
+    mygramdb::client::Document document;
+    std::vector<char*> keys;  /* search seen as a MygramSearchResult_C, for the decoders */
+    std::vector<size_t> key_lengths;
+    std::string table;
+    std::string query;
+    std::string primary_key;
+    std::string sort_column;
+    std::vector<std::string> and_terms;
+    std::vector<std::string> not_terms;
+    std::vector<std::pair<std::string, std::string>> filters;
+};
+
+/* Overwrite strings from an array ref (empty when not an array ref) */
+static void
+av_to_strings(pTHX_ SV* array_ref, std::vector<std::string>& strings)
+{
+    AV* av = NULL;
+    size_t count = 0;
+    size_t i;
+
+    if (SvOK(array_ref) && SvROK(array_ref) && SvTYPE(SvRV(array_ref)) == SVt_PVAV) {
+        av = (AV*)SvRV(array_ref);
+        count = av_len(av) + 1;
+    }
+    strings.resize(count);
+    for (i = 0; i < count; i++) {
+        SV** sv = av_fetch(av, i, 0);
+        STRLEN length = 0;
+        const char* str = sv ? SvPV(*sv, length) : "";
+        strings[i].assign(str, length);
+    }
+}
+
+/* Overwrite filters from a hash ref (empty when not a hash ref) */
+static void
+hv_to_filters(pTHX_ SV* hash_ref, std::vector<std::pair<std::string, std::string>>& filters)
+{
+    size_t used = 0;
+
+    if (SvOK(hash_ref) && SvROK(hash_ref) && SvTYPE(SvRV(hash_ref)) == SVt_PVHV) {
+        HV* hv = (HV*)SvRV(hash_ref);
+        HE* entry;
+        filters.resize(hv_iterinit(hv));
+        while ((entry = hv_iternext(hv)) != NULL && used < filters.size()) {
+            STRLEN key_length;
+            STRLEN value_length;
+            const char* key = HePV(entry, key_length);
+            const char* value = SvPV(HeVAL(entry), value_length);
+            filters[used].first.assign(key, key_length);
+            filters[used].second.assign(value, value_length);
+            used++;
+        }
+    }
+    filters.resize(used);
+}
+
+/* Run a search on the client behind the handle, with the arguments in
+ * client->direct (prepared if not NULL, else with the AND/NOT/FILTER/SORT
+ * clauses if clauses is set), and build the result in the given form while
+ * the client is held; total_count may be NULL. Returns NULL with *error set
+ * when the result cannot be built, or left NULL when the search failed (see
+ * get_last_error). Nothing in here croaks, so a pooled client always goes
+ * back. */
+static SV*
+direct_search(pTHX_ MygramClient_XS* client, const MygramPreparedSearch_C* prepared, int clauses, unsigned int limit,
+              unsigned int offset, int sort_desc, int form, UV* total_count, SV** error)
+{
+    DirectCall& call = *client->direct;
+    MygramSearchResult_C result;
+    size_t i;
+
+    mygramdb::client::ClientLease lease(client->api);
+    if (!lease) {
+        return NULL;
+    }
+    mygram::utils::Expected<void, mygram::utils::Error> status;
+    if (prepared != NULL) {
+        status = lease->Search(prepared->prepared, call.query, limit, offset, call.search);
+    } else if (clauses) {
+        status = lease->Search(call.table, call.query, limit, offset, call.and_terms, call.not_terms, call.filters,
+                               call.sort_column, sort_desc != 0, call.search);
+    } else {
+        status = lease->Search(call.table, call.query, limit, offset, call.search);
+    }
+    if (!status) {
+        mygramdb::client::SetHandleError(client->api, status.error().to_string());
+        return NULL;
+    }
+
+    result.count = call.search.primary_keys.size();
+    result.total_count = call.search.total_count;
+    call.keys.resize(result.count);
+    call.key_lengths.resize(result.count);
+    for (i = 0; i < result.count; i++) {
+        call.keys[i] = const_cast<char*>(call.search.primary_keys[i].data());
+        call.key_lengths[i] = call.search.primary_keys[i].size();
+    }
+    result.primary_keys = call.keys.data();
+    result.key_lengths = call.key_lengths.data();
+    if (total_count != NULL) {
+        *total_count = result.total_count;
+    }
+    return search_result_form_to_sv(aTHX_ &result, form, error);
+}
+
+/* Get a document on the client behind the handle, with the arguments in
+ * client->direct, as document_to_sv builds it. NULL on failure (see
+ * get_last_error). */
+static SV*
+direct_get(pTHX_ MygramClient_XS* client)
+{
+    DirectCall& call = *client->direct;
+    HV* rh;
+    HV* fields_hv;
+
+    {
+        mygramdb::client::ClientLease lease(client->api);
+        if (!lease) {
+            return NULL;
+        }
+        auto status = lease->Get(call.table, call.primary_key, call.document);
+        if (!status) {
+            mygramdb::client::SetHandleError(client->api, status.error().to_string());
+            return NULL;
+        }
+    }
+
+    rh = newHV();
+    fields_hv = newHV();
+    hv_store(rh, "primary_key", 11, newSVpvn(call.document.primary_key.data(), call.document.primary_key.size()), 0);
+    for (const auto& [key, value] : call.document.fields) {
+        hv_store(fields_hv, key.data(), key.size(), newSVpvn(value.data(), value.size()), 0);
+    }
+    hv_store(rh, "fields", 6, newRV_noinc((SV*)fields_hv), 0);
+
+    return newRV_noinc((SV*)rh);
+}
+#endif
+
+/* Croak with the client's last error unless a submit call succeeded */
+static UV
+submitted_id(pTHX_ MygramClient_XS* client, int status, const uint64_t* id)
+{
+    if (status != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Submit failed: %s", err);
+    }
+    return (UV)*id;
+}
+
+/* Build { fingerprint => ..., samples => N, <DebugInfo means>,
+ * optimizations => { name => count } } (no fingerprint key when NULL) */
+static SV*
+debug_profile_to_sv(pTHX_ const MygramDebugProfile_C* profile)
+{
+    HV* rh = newHV();
+    HV* opt_hv = newHV();
+    size_t i;
+
+    if (profile->fingerprint) {
+        hv_store(rh, "fingerprint", 11, newSVpv(profile->fingerprint, 0), 0);
+    }
+    hv_store(rh, "samples", 7, newSVuv(profile->samples), 0);
+    hv_store(rh, "query_time_ms", 13, newSVnv(profile->query_time_ms), 0);
+    hv_store(rh, "index_time_ms", 13, newSVnv(profile->index_time_ms), 0);
+    hv_store(rh, "filter_time_ms", 14, newSVnv(profile->filter_time_ms), 0);
+    hv_store(rh, "terms", 5, newSVnv(profile->terms), 0);
+    hv_store(rh, "ngrams", 6, newSVnv(profile->ngrams), 0);
+    hv_store(rh, "candidates", 10, newSVnv(profile->candidates), 0);
+    hv_store(rh, "after_intersection", 18, newSVnv(profile->after_intersection), 0);
+    hv_store(rh, "after_not", 9, newSVnv(profile->after_not), 0);
+    hv_store(rh, "after_filters", 13, newSVnv(profile->after_filters), 0);
+    hv_store(rh, "final", 5, newSVnv(profile->final), 0);
+
+    for (i = 0; i < profile->optimization_count; i++) {
+        hv_store(opt_hv, profile->optimizations[i].name, strlen(profile->optimizations[i].name),
+                 newSVuv(profile->optimizations[i].count), 0);
+    }
+    hv_store(rh, "optimizations", 13, newRV_noinc((SV*)opt_hv), 0);
+
+    return newRV_noinc((SV*)rh);
+}
+
+/* Wrap a new C client with its result handles; croaks (freeing api) on failure */
+static MygramClient_XS*
+client_xs_new(pTHX_ MygramClient_C* api)
+{
+    MygramClient_XS* client;
+
+    Newxz(client, 1, MygramClient_XS);
+    client->api = api;
+    client->search_result = mygramclient_search_result_create();
+    client->document = mygramclient_document_create();
+    client->pipeline = mygramclient_pipeline_create();
+    client->async_result = mygramclient_async_result_create();
+#ifdef USE_EMBEDDED_SOURCE
+    client->direct = new DirectCall();
+#endif
+    if (client->api == NULL || client->search_result == NULL || client->document == NULL ||
+        client->pipeline == NULL || client->async_result == NULL) {
+        mygramclient_destroy(client->api);
+        mygramclient_search_result_destroy(client->search_result);
+        mygramclient_document_destroy(client->document);
+        mygramclient_pipeline_destroy(client->pipeline);
+        mygramclient_async_result_destroy(client->async_result);
+#ifdef USE_EMBEDDED_SOURCE
+        delete client->direct;
+#endif
+        Safefree(client);
+        croak("Failed to create MygramDB client");
+    }
+    return client;
+}
 
 MODULE = MygramDB::Client    PACKAGE = MygramDB::Client::XS
 
@@ -28,10 +478,27 @@ new(CLASS, host, port, timeout_ms=5000, recv_buffer_size=65536)
         .recv_buffer_size = recv_buffer_size
     };
 
-    RETVAL = mygramclient_create(&config);
-    if (RETVAL == NULL) {
-        croak("Failed to create MygramDB client");
-    }
+    RETVAL = client_xs_new(aTHX_ mygramclient_create(&config));
+  OUTPUT:
+    RETVAL
+
+MygramDB__Client
+new_pooled(CLASS, host, port, max_connections, timeout_ms=5000, recv_buffer_size=65536)
+    const char* CLASS
+    const char* host
+    unsigned short port
+    unsigned int max_connections
+    unsigned int timeout_ms
+    unsigned int recv_buffer_size
+  CODE:
+    MygramClientConfig_C config = {
+        .host = host,
+        .port = port,
+        .timeout_ms = timeout_ms,
+        .recv_buffer_size = recv_buffer_size
+    };
+
+    RETVAL = client_xs_new(aTHX_ mygramclient_create_pooled(&config, max_connections));
   OUTPUT:
     RETVAL
 
@@ -40,16 +507,24 @@ DESTROY(client)
     MygramDB__Client client
   CODE:
     if (client) {
-        mygramclient_destroy(client);
+        mygramclient_destroy(client->api);
+        mygramclient_search_result_destroy(client->search_result);
+        mygramclient_document_destroy(client->document);
+        mygramclient_pipeline_destroy(client->pipeline);
+        mygramclient_async_result_destroy(client->async_result);
+#ifdef USE_EMBEDDED_SOURCE
+        delete client->direct;
+#endif
+        Safefree(client);
     }
 
 int
 connect(client)
     MygramDB__Client client
   CODE:
-    RETVAL = mygramclient_connect(client);
+    RETVAL = mygramclient_connect(client->api);
     if (RETVAL != 0) {
-        const char* err = mygramclient_get_last_error(client);
+        const char* err = mygramclient_get_last_error(client->api);
         croak("Connection failed: %s", err);
     }
   OUTPUT:
@@ -59,13 +534,13 @@ void
 disconnect(client)
     MygramDB__Client client
   CODE:
-    mygramclient_disconnect(client);
+    mygramclient_disconnect(client->api);
 
 int
 is_connected(client)
     MygramDB__Client client
   CODE:
-    RETVAL = mygramclient_is_connected(client);
+    RETVAL = mygramclient_is_connected(client->api);
   OUTPUT:
     RETVAL
 
@@ -73,7 +548,7 @@ const char*
 get_last_error(client)
     MygramDB__Client client
   CODE:
-    RETVAL = mygramclient_get_last_error(client);
+    RETVAL = mygramclient_get_last_error(client->api);
   OUTPUT:
     RETVAL
 
@@ -84,37 +559,21 @@ search(client, table, query, limit=1000, offset=0)
     const char* query
     unsigned int limit
     unsigned int offset
-  PREINIT:
-    MygramSearchResult_C* result = NULL;
-    HV* rh;
-    AV* results_av;
-    size_t i;
   CODE:
-    if (mygramclient_search(client, table, query, limit, offset, &result) != 0) {
-        const char* err = mygramclient_get_last_error(client);
-        croak("Search failed: %s", err);
+#ifdef USE_EMBEDDED_SOURCE
+    client->direct->table.assign(table);
+    client->direct->query.assign(query);
+    RETVAL = direct_search(aTHX_ client, NULL, 0, limit, offset, 1, RESULT_HASH, NULL, NULL);
+#else
+    RETVAL = NULL;
+    if (mygramclient_search_into(client->api, table, query, limit, offset, client->search_result) == 0) {
+        RETVAL = search_result_to_sv(aTHX_ client->search_result);
     }
-
-    /* Create hash for return value */
-    rh = newHV();
-
-    /* Add total_count */
-    hv_store(rh, "total_count", 11, newSVuv(result->total_count), 0);
-
-    /* Add results array */
-    results_av = newAV();
-    for (i = 0; i < result->count; i++) {
-        HV* doc_hv = newHV();
-        hv_store(doc_hv, "primary_key", 11,
-                 newSVpv(result->primary_keys[i], 0), 0);
-        av_push(results_av, newRV_noinc((SV*)doc_hv));
+#endif
+    if (RETVAL == NULL) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Search failed: %s", err);
     }
-    hv_store(rh, "results", 7, newRV_noinc((SV*)results_av), 0);
-
-    RETVAL = newRV_noinc((SV*)rh);
-
-    /* Free C result */
-    mygramclient_free_search_result(result);
   OUTPUT:
     RETVAL
 
@@ -131,7 +590,7 @@ search_advanced(client, table, query, limit, offset, and_terms_av, not_terms_av,
     const char* sort_column
     int sort_desc
   PREINIT:
-    MygramSearchResult_C* result = NULL;
+#ifndef USE_EMBEDDED_SOURCE
     const char** and_terms = NULL;
     size_t and_count = 0;
     const char** not_terms = NULL;
@@ -139,102 +598,185 @@ search_advanced(client, table, query, limit, offset, and_terms_av, not_terms_av,
     const char** filter_keys = NULL;
     const char** filter_values = NULL;
     size_t filter_count = 0;
-    AV* and_av = NULL;
-    AV* not_av = NULL;
-    HV* filter_hv = NULL;
-    HV* rh;
-    AV* results_av;
-    size_t i;
+    int status;
+#endif
   CODE:
-    /* Process AND terms */
-    if (SvOK(and_terms_av) && SvROK(and_terms_av) && SvTYPE(SvRV(and_terms_av)) == SVt_PVAV) {
-        and_av = (AV*)SvRV(and_terms_av);
-        and_count = av_len(and_av) + 1;
-        if (and_count > 0) {
-            Newx(and_terms, and_count, const char*);
-            for (i = 0; i < and_count; i++) {
-                SV** sv = av_fetch(and_av, i, 0);
-                and_terms[i] = sv ? SvPV_nolen(*sv) : "";
-            }
-        }
-    }
+#ifdef USE_EMBEDDED_SOURCE
+    client->direct->table.assign(table);
+    client->direct->query.assign(query);
+    client->direct->sort_column.assign(sort_column);
+    av_to_strings(aTHX_ and_terms_av, client->direct->and_terms);
+    av_to_strings(aTHX_ not_terms_av, client->direct->not_terms);
+    hv_to_filters(aTHX_ filters_hv, client->direct->filters);
+    RETVAL = direct_search(aTHX_ client, NULL, 1, limit, offset, sort_desc, RESULT_HASH, NULL, NULL);
+#else
+    and_terms = av_to_c_strings(aTHX_ and_terms_av, &and_count);
+    not_terms = av_to_c_strings(aTHX_ not_terms_av, &not_count);
+    hv_to_c_filters(aTHX_ filters_hv, &filter_keys, &filter_values, &filter_count);
 
-    /* Process NOT terms */
-    if (SvOK(not_terms_av) && SvROK(not_terms_av) && SvTYPE(SvRV(not_terms_av)) == SVt_PVAV) {
-        not_av = (AV*)SvRV(not_terms_av);
-        not_count = av_len(not_av) + 1;
-        if (not_count > 0) {
-            Newx(not_terms, not_count, const char*);
-            for (i = 0; i < not_count; i++) {
-                SV** sv = av_fetch(not_av, i, 0);
-                not_terms[i] = sv ? SvPV_nolen(*sv) : "";
-            }
-        }
-    }
+    status = mygramclient_search_advanced_into(
+        client->api, table, query, limit, offset,
+        and_terms, and_count,
+        not_terms, not_count,
+        filter_keys, filter_values, filter_count,
+        sort_column, sort_desc,
+        client->search_result);
 
-    /* Process filters */
-    if (SvOK(filters_hv) && SvROK(filters_hv) && SvTYPE(SvRV(filters_hv)) == SVt_PVHV) {
-        filter_hv = (HV*)SvRV(filters_hv);
-        filter_count = hv_iterinit(filter_hv);
-        if (filter_count > 0) {
-            Newx(filter_keys, filter_count, const char*);
-            Newx(filter_values, filter_count, const char*);
-
-            HE* entry;
-            i = 0;
-            while ((entry = hv_iternext(filter_hv)) != NULL) {
-                filter_keys[i] = HePV(entry, PL_na);
-                SV* val = HeVAL(entry);
-                filter_values[i] = SvPV_nolen(val);
-                i++;
-            }
-        }
-    }
-
-    /* Call C API */
-    if (mygramclient_search_advanced(
-            client, table, query, limit, offset,
-            and_terms, and_count,
-            not_terms, not_count,
-            filter_keys, filter_values, filter_count,
-            sort_column, sort_desc,
-            &result) != 0) {
-        const char* err = mygramclient_get_last_error(client);
-
-        /* Clean up allocated memory */
-        if (and_terms) Safefree(and_terms);
-        if (not_terms) Safefree(not_terms);
-        if (filter_keys) Safefree(filter_keys);
-        if (filter_values) Safefree(filter_values);
+    /* Free borrowed argument arrays */
+    if (and_terms) Safefree(and_terms);
+    if (not_terms) Safefree(not_terms);
+    if (filter_keys) Safefree(filter_keys);
+    if (filter_values) Safefree(filter_values);
 
+    RETVAL = status == 0 ? search_result_to_sv(aTHX_ client->search_result) : NULL;
+#endif
+    if (RETVAL == NULL) {
+        const char* err = mygramclient_get_last_error(client->api);
         croak("Search failed: %s", err);
     }
+  OUTPUT:
+    RETVAL
 
-    /* Create hash for return value */
-    rh = newHV();
-    hv_store(rh, "total_count", 11, newSVuv(result->total_count), 0);
-
-    /* Add results array */
-    results_av = newAV();
-    for (i = 0; i < result->count; i++) {
-        HV* doc_hv = newHV();
-        hv_store(doc_hv, "primary_key", 11,
-                 newSVpv(result->primary_keys[i], 0), 0);
-        av_push(results_av, newRV_noinc((SV*)doc_hv));
-    }
-    hv_store(rh, "results", 7, newRV_noinc((SV*)results_av), 0);
+MygramDB__Client__XS__PreparedSearch
+prepare_search(client, table, and_terms_av=&PL_sv_undef, not_terms_av=&PL_sv_undef, filters_hv=&PL_sv_undef, sort_column="", sort_desc=1)
+    MygramDB__Client client
+    const char* table
+    SV* and_terms_av
+    SV* not_terms_av
+    SV* filters_hv
+    const char* sort_column
+    int sort_desc
+  PREINIT:
+    const char** and_terms = NULL;
+    size_t and_count = 0;
+    const char** not_terms = NULL;
+    size_t not_count = 0;
+    const char** filter_keys = NULL;
+    const char** filter_values = NULL;
+    size_t filter_count = 0;
+    int status;
+  CODE:
+    and_terms = av_to_c_strings(aTHX_ and_terms_av, &and_count);
+    not_terms = av_to_c_strings(aTHX_ not_terms_av, &not_count);
+    hv_to_c_filters(aTHX_ filters_hv, &filter_keys, &filter_values, &filter_count);
 
-    RETVAL = newRV_noinc((SV*)rh);
+    status = mygramclient_prepare_search(
+        client->api, table,
+        and_terms, and_count,
+        not_terms, not_count,
+        filter_keys, filter_values, filter_count,
+        sort_column, sort_desc,
+        &RETVAL);
 
-    /* Free C result and allocated memory */
-    mygramclient_free_search_result(result);
     if (and_terms) Safefree(and_terms);
     if (not_terms) Safefree(not_terms);
     if (filter_keys) Safefree(filter_keys);
     if (filter_values) Safefree(filter_values);
+
+    if (status != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Prepare search failed: %s", err);
+    }
+  OUTPUT:
+    RETVAL
+
+SV*
+search_prepared(client, prepared, query, limit=1000, offset=0)
+    MygramDB__Client client
+    MygramDB__Client__XS__PreparedSearch prepared
+    const char* query
+    unsigned int limit
+    unsigned int offset
+  CODE:
+#ifdef USE_EMBEDDED_SOURCE
+    client->direct->query.assign(query);
+    RETVAL = direct_search(aTHX_ client, prepared, 0, limit, offset, 1, RESULT_HASH, NULL, NULL);
+#else
+    RETVAL = NULL;
+    if (mygramclient_search_prepared_into(client->api, prepared, query, limit, offset, client->search_result) == 0) {
+        RETVAL = search_result_to_sv(aTHX_ client->search_result);
+    }
+#endif
+    if (RETVAL == NULL) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Search failed: %s", err);
+    }
   OUTPUT:
     RETVAL
 
+void
+search_keys(client, table, query, limit=1000, offset=0)
+    MygramDB__Client client
+    const char* table
+    const char* query
+    unsigned int limit
+    unsigned int offset
+  ALIAS:
+    search_ids = 1
+  PREINIT:
+    SV* rv = NULL;
+    SV* error = NULL;
+    UV total_count = 0;
+  PPCODE:
+    /* ix 0: keys, 1: packed IDs; total_count follows in list context */
+#ifdef USE_EMBEDDED_SOURCE
+    client->direct->table.assign(table);
+    client->direct->query.assign(query);
+    rv = direct_search(aTHX_ client, NULL, 0, limit, offset, 1, RESULT_KEYS + ix, &total_count, &error);
+#else
+    if (mygramclient_search_into(client->api, table, query, limit, offset, client->search_result) == 0) {
+        total_count = client->search_result->total_count;
+        rv = search_result_form_to_sv(aTHX_ client->search_result, RESULT_KEYS + ix, &error);
+    }
+#endif
+    if (rv == NULL && error != NULL) {
+        croak("%" SVf, SVfARG(error));
+    } else if (rv == NULL) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Search failed: %s", err);
+    }
+
+    XPUSHs(sv_2mortal(rv));
+    if (GIMME_V == G_ARRAY) {
+        XPUSHs(sv_2mortal(newSVuv(total_count)));
+    }
+
+void
+search_prepared_keys(client, prepared, query, limit=1000, offset=0)
+    MygramDB__Client client
+    MygramDB__Client__XS__PreparedSearch prepared
+    const char* query
+    unsigned int limit
+    unsigned int offset
+  ALIAS:
+    search_prepared_ids = 1
+  PREINIT:
+    SV* rv = NULL;
+    SV* error = NULL;
+    UV total_count = 0;
+  PPCODE:
+    /* ix 0: keys, 1: packed IDs; total_count follows in list context */
+#ifdef USE_EMBEDDED_SOURCE
+    client->direct->query.assign(query);
+    rv = direct_search(aTHX_ client, prepared, 0, limit, offset, 1, RESULT_KEYS + ix, &total_count, &error);
+#else
+    if (mygramclient_search_prepared_into(client->api, prepared, query, limit, offset, client->search_result) == 0) {
+        total_count = client->search_result->total_count;
+        rv = search_result_form_to_sv(aTHX_ client->search_result, RESULT_KEYS + ix, &error);
+    }
+#endif
+    if (rv == NULL && error != NULL) {
+        croak("%" SVf, SVfARG(error));
+    } else if (rv == NULL) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Search failed: %s", err);
+    }
+
+    XPUSHs(sv_2mortal(rv));
+    if (GIMME_V == G_ARRAY) {
+        XPUSHs(sv_2mortal(newSVuv(total_count)));
+    }
+
 UV
 count(client, table, query)
     MygramDB__Client client
@@ -243,46 +785,222 @@ count(client, table, query)
   PREINIT:
     uint64_t count = 0;
   CODE:
-    if (mygramclient_count(client, table, query, &count) != 0) {
-        const char* err = mygramclient_get_last_error(client);
+    if (mygramclient_count(client->api, table, query, &count) != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
         croak("Count failed: %s", err);
     }
     RETVAL = count;
   OUTPUT:
     RETVAL
 
+SV*
+search_batch(client, requests_ref)
+    MygramDB__Client client
+    SV* requests_ref
+  PREINIT:
+    AV* requests;
+    AV* results_av;
+    SSize_t i;
+  CODE:
+    requests = batch_requests(aTHX_ requests_ref, "search_batch");
+    mygramclient_pipeline_clear(client->pipeline);
+    for (i = 0; i <= av_len(requests); i++) {
+        SV* request = *av_fetch(requests, i, 0);
+        mygramclient_pipeline_add_search(client->pipeline, request_string(aTHX_ request, 0),
+                                         request_string(aTHX_ request, 1), request_uv(aTHX_ request, 2, 1000),
+                                         request_uv(aTHX_ request, 3, 0));
+    }
+    if (mygramclient_pipeline_execute(client->api, client->pipeline) != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Search batch failed: %s", err);
+    }
+
+    results_av = newAV();
+    for (i = 0; i <= av_len(requests); i++) {
+        const MygramSearchResult_C* result = mygramclient_pipeline_search_result(client->pipeline, i);
+        av_push(results_av, result ? search_result_to_sv(aTHX_ result) : batch_error_to_sv(aTHX_ client->pipeline, i));
+    }
+    RETVAL = newRV_noinc((SV*)results_av);
+  OUTPUT:
+    RETVAL
+
+SV*
+count_batch(client, requests_ref)
+    MygramDB__Client client
+    SV* requests_ref
+  PREINIT:
+    AV* requests;
+    AV* results_av;
+    SSize_t i;
+    uint64_t count;
+  CODE:
+    requests = batch_requests(aTHX_ requests_ref, "count_batch");
+    mygramclient_pipeline_clear(client->pipeline);
+    for (i = 0; i <= av_len(requests); i++) {
+        SV* request = *av_fetch(requests, i, 0);
+        mygramclient_pipeline_add_count(client->pipeline, request_string(aTHX_ request, 0),
+                                        request_string(aTHX_ request, 1));
+    }
+    if (mygramclient_pipeline_execute(client->api, client->pipeline) != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Count batch failed: %s", err);
+    }
+
+    results_av = newAV();
+    for (i = 0; i <= av_len(requests); i++) {
+        if (mygramclient_pipeline_count_result(client->pipeline, i, &count) == 0) {
+            HV* rh = newHV();
+            hv_store(rh, "count", 5, newSVuv(count), 0);
+            av_push(results_av, newRV_noinc((SV*)rh));
+        } else {
+            av_push(results_av, batch_error_to_sv(aTHX_ client->pipeline, i));
+        }
+    }
+    RETVAL = newRV_noinc((SV*)results_av);
+  OUTPUT:
+    RETVAL
+
 SV*
 get(client, table, primary_key)
     MygramDB__Client client
     const char* table
     const char* primary_key
-  PREINIT:
-    MygramDocument_C* doc = NULL;
-    HV* rh;
-    HV* fields_hv;
-    size_t i;
   CODE:
-    if (mygramclient_get(client, table, primary_key, &doc) != 0) {
-        const char* err = mygramclient_get_last_error(client);
+#ifdef USE_EMBEDDED_SOURCE
+    client->direct->table.assign(table);
+    client->direct->primary_key.assign(primary_key);
+    RETVAL = direct_get(aTHX_ client);
+#else
+    RETVAL = NULL;
+    if (mygramclient_get_into(client->api, table, primary_key, client->document) == 0) {
+        RETVAL = document_to_sv(aTHX_ client->document);
+    }
+#endif
+    if (RETVAL == NULL) {
+        const char* err = mygramclient_get_last_error(client->api);
         croak("Get failed: %s", err);
     }
+  OUTPUT:
+    RETVAL
 
-    /* Create hash for return value */
-    rh = newHV();
-    hv_store(rh, "primary_key", 11, newSVpv(doc->primary_key, 0), 0);
+int
+fileno(client)
+    MygramDB__Client client
+  CODE:
+    RETVAL = mygramclient_get_fd(client->api);
+  OUTPUT:
+    RETVAL
 
-    /* Add fields */
-    fields_hv = newHV();
-    for (i = 0; i < doc->field_count; i++) {
-        hv_store(fields_hv, doc->field_keys[i], strlen(doc->field_keys[i]),
-                 newSVpv(doc->field_values[i], 0), 0);
+UV
+submit_search(client, table, query, limit=1000, offset=0)
+    MygramDB__Client client
+    const char* table
+    const char* query
+    unsigned int limit
+    unsigned int offset
+  PREINIT:
+    uint64_t id = 0;
+  CODE:
+    RETVAL = submitted_id(aTHX_ client, mygramclient_submit_search(client->api, table, query, limit, offset, &id), &id);
+  OUTPUT:
+    RETVAL
+
+UV
+submit_search_prepared(client, prepared, query, limit=1000, offset=0)
+    MygramDB__Client client
+    MygramDB__Client__XS__PreparedSearch prepared
+    const char* query
+    unsigned int limit
+    unsigned int offset
+  PREINIT:
+    uint64_t id = 0;
+  CODE:
+    RETVAL = submitted_id(aTHX_ client,
+                          mygramclient_submit_search_prepared(client->api, prepared, query, limit, offset, &id), &id);
+  OUTPUT:
+    RETVAL
+
+UV
+submit_count(client, table, query)
+    MygramDB__Client client
+    const char* table
+    const char* query
+  PREINIT:
+    uint64_t id = 0;
+  CODE:
+    RETVAL = submitted_id(aTHX_ client, mygramclient_submit_count(client->api, table, query, &id), &id);
+  OUTPUT:
+    RETVAL
+
+UV
+submit_get(client, table, primary_key)
+    MygramDB__Client client
+    const char* table
+    const char* primary_key
+  PREINIT:
+    uint64_t id = 0;
+  CODE:
+    RETVAL = submitted_id(aTHX_ client, mygramclient_submit_get(client->api, table, primary_key, &id), &id);
+  OUTPUT:
+    RETVAL
+
+int
+wants_write(client)
+    MygramDB__Client client
+  CODE:
+    RETVAL = mygramclient_wants_write(client->api);
+  OUTPUT:
+    RETVAL
+
+UV
+pending(client)
+    MygramDB__Client client
+  CODE:
+    RETVAL = mygramclient_pending(client->api);
+  OUTPUT:
+    RETVAL
+
+int
+process_io(client)
+    MygramDB__Client client
+  CODE:
+    RETVAL = mygramclient_process_io(client->api);
+    if (RETVAL < 0) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("I/O failed: %s", err);
     }
-    hv_store(rh, "fields", 6, newRV_noinc((SV*)fields_hv), 0);
+  OUTPUT:
+    RETVAL
 
-    RETVAL = newRV_noinc((SV*)rh);
+SV*
+poll_result(client)
+    MygramDB__Client client
+  PREINIT:
+    const MygramAsyncResult_C* result;
+    SV* rv;
+    HV* rh;
+  CODE:
+    if (mygramclient_poll_result(client->api, client->async_result) != 1) {
+        XSRETURN_UNDEF;
+    }
+    result = client->async_result;
 
-    /* Free C result */
-    mygramclient_free_document(doc);
+    /* The reply as the blocking call returns it, plus the request id */
+    if (result->search) {
+        rv = search_result_to_sv(aTHX_ result->search);
+    } else if (result->document) {
+        rv = document_to_sv(aTHX_ result->document);
+    } else {
+        rv = newRV_noinc((SV*)newHV());
+        if (result->error) {
+            hv_store((HV*)SvRV(rv), "error", 5, newSVpv(result->error, 0), 0);
+        } else {
+            hv_store((HV*)SvRV(rv), "count", 5, newSVuv(result->count), 0);
+        }
+    }
+    rh = (HV*)SvRV(rv);
+    hv_store(rh, "id", 2, newSVuv(result->id), 0);
+    RETVAL = rv;
   OUTPUT:
     RETVAL
 
@@ -295,8 +1013,8 @@ info(client)
     AV* tables_av;
     size_t i;
   CODE:
-    if (mygramclient_info(client, &info) != 0) {
-        const char* err = mygramclient_get_last_error(client);
+    if (mygramclient_info(client->api, &info) != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
         croak("Info failed: %s", err);
     }
 
@@ -327,9 +1045,9 @@ int
 enable_debug(client)
     MygramDB__Client client
   CODE:
-    RETVAL = mygramclient_debug_on(client);
+    RETVAL = mygramclient_debug_on(client->api);
     if (RETVAL != 0) {
-        const char* err = mygramclient_get_last_error(client);
+        const char* err = mygramclient_get_last_error(client->api);
         croak("Enable debug failed: %s", err);
     }
   OUTPUT:
@@ -339,9 +1057,9 @@ int
 disable_debug(client)
     MygramDB__Client client
   CODE:
-    RETVAL = mygramclient_debug_off(client);
+    RETVAL = mygramclient_debug_off(client->api);
     if (RETVAL != 0) {
-        const char* err = mygramclient_get_last_error(client);
+        const char* err = mygramclient_get_last_error(client->api);
         croak("Disable debug failed: %s", err);
     }
   OUTPUT:
@@ -351,9 +1069,9 @@ int
 replication_stop(client)
     MygramDB__Client client
   CODE:
-    RETVAL = mygramclient_replication_stop(client);
+    RETVAL = mygramclient_replication_stop(client->api);
     if (RETVAL != 0) {
-        const char* err = mygramclient_get_last_error(client);
+        const char* err = mygramclient_get_last_error(client->api);
         croak("Replication stop failed: %s", err);
     }
   OUTPUT:
@@ -363,14 +1081,291 @@ int
 replication_start(client)
     MygramDB__Client client
   CODE:
-    RETVAL = mygramclient_replication_start(client);
+    RETVAL = mygramclient_replication_start(client->api);
     if (RETVAL != 0) {
-        const char* err = mygramclient_get_last_error(client);
+        const char* err = mygramclient_get_last_error(client->api);
         croak("Replication start failed: %s", err);
     }
   OUTPUT:
     RETVAL
 
+SV*
+metrics(client)
+    MygramDB__Client client
+  PREINIT:
+    MygramClientMetrics_C* metrics = NULL;
+    HV* rh;
+    HV* commands_hv;
+    AV* errors_av;
+    size_t i;
+    size_t b;
+  CODE:
+    if (mygramclient_get_metrics(client->api, &metrics) != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Metrics failed: %s", err);
+    }
+
+    /* One hash per command type, keyed by command name */
+    commands_hv = newHV();
+    for (i = 0; i < metrics->command_count; i++) {
+        const MygramCommandMetrics_C* cm = &metrics->commands[i];
+        HV* command_hv = newHV();
+        HV* latency_hv = newHV();
+        AV* buckets_av = newAV();
+
+        hv_store(command_hv, "requests", 8, newSVuv(cm->requests), 0);
+        hv_store(command_hv, "errors", 6, newSVuv(cm->errors), 0);
+        hv_store(command_hv, "bytes_sent", 10, newSVuv(cm->bytes_sent), 0);
+        hv_store(command_hv, "bytes_received", 14, newSVuv(cm->bytes_received), 0);
+        hv_store(command_hv, "recv_calls", 10, newSVuv(cm->recv_calls), 0);
+
+        hv_store(latency_hv, "count", 5, newSVuv(cm->latency_count), 0);
+        hv_store(latency_hv, "sum_ns", 6, newSVuv(cm->latency_sum_ns), 0);
+        hv_store(latency_hv, "min_ns", 6, newSVuv(cm->latency_min_ns), 0);
+        hv_store(latency_hv, "max_ns", 6, newSVuv(cm->latency_max_ns), 0);
+        hv_store(latency_hv, "p50_ns", 6, newSVuv(cm->latency_p50_ns), 0);
+        hv_store(latency_hv, "p90_ns", 6, newSVuv(cm->latency_p90_ns), 0);
+        hv_store(latency_hv, "p99_ns", 6, newSVuv(cm->latency_p99_ns), 0);
+        hv_store(latency_hv, "p999_ns", 7, newSVuv(cm->latency_p999_ns), 0);
+
+        /* Non-empty buckets as [upper_ns, count] pairs */
+        for (b = 0; b < cm->bucket_count; b++) {
+            AV* bucket_av = newAV();
+            av_push(bucket_av, newSVuv(cm->buckets[b].upper_ns));
+            av_push(bucket_av, newSVuv(cm->buckets[b].count));
+            av_push(buckets_av, newRV_noinc((SV*)bucket_av));
+        }
+        hv_store(latency_hv, "buckets", 7, newRV_noinc((SV*)buckets_av), 0);
+        hv_store(command_hv, "latency", 7, newRV_noinc((SV*)latency_hv), 0);
+
+        hv_store(commands_hv, cm->command, strlen(cm->command), newRV_noinc((SV*)command_hv), 0);
+    }
+
+    errors_av = newAV();
+    for (i = 0; i < metrics->error_count; i++) {
+        HV* error_hv = newHV();
+        hv_store(error_hv, "code", 4, newSViv(metrics->errors[i].code), 0);
+        hv_store(error_hv, "name", 4, newSVpv(metrics->errors[i].name, 0), 0);
+        hv_store(error_hv, "count", 5, newSVuv(metrics->errors[i].count), 0);
+        av_push(errors_av, newRV_noinc((SV*)error_hv));
+    }
+
+    rh = newHV();
+    hv_store(rh, "commands", 8, newRV_noinc((SV*)commands_hv), 0);
+    hv_store(rh, "errors", 6, newRV_noinc((SV*)errors_av), 0);
+    RETVAL = newRV_noinc((SV*)rh);
+
+    mygramclient_free_metrics(metrics);
+  OUTPUT:
+    RETVAL
+
+void
+reset_metrics(client)
+    MygramDB__Client client
+  CODE:
+    mygramclient_reset_metrics(client->api);
+
+int
+set_span_ring(client, path_sv, capacity=65536)
+    MygramDB__Client client
+    SV* path_sv
+    UV capacity
+  PREINIT:
+    const char* path = NULL;
+  CODE:
+    if (SvOK(path_sv)) {
+        path = SvPV_nolen(path_sv);
+    }
+    RETVAL = mygramclient_set_span_ring(client->api, path, (size_t)capacity);
+    if (RETVAL != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Set span ring failed: %s", err);
+    }
+  OUTPUT:
+    RETVAL
+
+void
+set_debug_sampling(client, one_in)
+    MygramDB__Client client
+    UV one_in
+  CODE:
+    mygramclient_set_debug_sampling(client->api, (uint32_t)one_in);
+
+SV*
+debug_profiles(client)
+    MygramDB__Client client
+  PREINIT:
+    MygramDebugProfile_C* profiles = NULL;
+    size_t count = 0;
+    AV* profiles_av;
+    size_t i;
+  CODE:
+    if (mygramclient_get_debug_profiles(client->api, &profiles, &count) != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Debug profiles failed: %s", err);
+    }
+
+    /* Array of profile hashes, most sampled first */
+    profiles_av = newAV();
+    for (i = 0; i < count; i++) {
+        av_push(profiles_av, debug_profile_to_sv(aTHX_ &profiles[i]));
+    }
+    RETVAL = newRV_noinc((SV*)profiles_av);
+
+    mygramclient_free_debug_profiles(profiles, count);
+  OUTPUT:
+    RETVAL
+
+void
+reset_debug_profiles(client)
+    MygramDB__Client client
+  CODE:
+    mygramclient_reset_debug_profiles(client->api);
+
+int
+enable_query_stats(client, max_fingerprints=256)
+    MygramDB__Client client
+    UV max_fingerprints
+  CODE:
+    RETVAL = mygramclient_enable_query_stats(client->api, (size_t)max_fingerprints);
+  OUTPUT:
+    RETVAL
+
+int
+disable_query_stats(client)
+    MygramDB__Client client
+  CODE:
+    RETVAL = mygramclient_enable_query_stats(client->api, 0);
+  OUTPUT:
+    RETVAL
+
+SV*
+query_stats(client)
+    MygramDB__Client client
+  PREINIT:
+    MygramQueryStats_C* stats = NULL;
+    size_t count = 0;
+    AV* stats_av;
+    size_t i;
+  CODE:
+    if (mygramclient_get_query_stats(client->api, &stats, &count) != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Query stats failed: %s", err);
+    }
+
+    /* Array of per-shape hashes, most called first */
+    stats_av = newAV();
+    for (i = 0; i < count; i++) {
+        const MygramQueryStats_C* qs = &stats[i];
+        HV* shape_hv = newHV();
+        HV* latency_hv = newHV();
+        HV* matched_hv = newHV();
+
+        hv_store(shape_hv, "fingerprint", 11, newSVpv(qs->fingerprint, 0), 0);
+        hv_store(shape_hv, "calls", 5, newSVuv(qs->calls), 0);
+        hv_store(shape_hv, "errors", 6, newSVuv(qs->errors), 0);
+
+        hv_store(latency_hv, "sum_ns", 6, newSVuv(qs->latency_sum_ns), 0);
+        hv_store(latency_hv, "min_ns", 6, newSVuv(qs->latency_min_ns), 0);
+        hv_store(latency_hv, "max_ns", 6, newSVuv(qs->latency_max_ns), 0);
+        hv_store(latency_hv, "p50_ns", 6, newSVuv(qs->latency_p50_ns), 0);
+        hv_store(latency_hv, "p90_ns", 6, newSVuv(qs->latency_p90_ns), 0);
+        hv_store(latency_hv, "p99_ns", 6, newSVuv(qs->latency_p99_ns), 0);
+        hv_store(shape_hv, "latency", 7, newRV_noinc((SV*)latency_hv), 0);
+
+        hv_store(matched_hv, "sum", 3, newSVuv(qs->matched_sum), 0);
+        hv_store(matched_hv, "max", 3, newSVuv(qs->matched_max), 0);
+        hv_store(matched_hv, "p50", 3, newSVuv(qs->matched_p50), 0);
+        hv_store(matched_hv, "p90", 3, newSVuv(qs->matched_p90), 0);
+        hv_store(matched_hv, "p99", 3, newSVuv(qs->matched_p99), 0);
+        hv_store(shape_hv, "matched", 7, newRV_noinc((SV*)matched_hv), 0);
+
+        /* DebugInfo means only when some reply carried DEBUG output */
+        hv_store(shape_hv, "debug", 5,
+                 qs->debug.samples > 0 ? debug_profile_to_sv(aTHX_ &qs->debug) : newSV(0), 0);
+
+        av_push(stats_av, newRV_noinc((SV*)shape_hv));
+    }
+    RETVAL = newRV_noinc((SV*)stats_av);
+
+    mygramclient_free_query_stats(stats, count);
+  OUTPUT:
+    RETVAL
+
+void
+reset_query_stats(client)
+    MygramDB__Client client
+  CODE:
+    mygramclient_reset_query_stats(client->api);
+
+int
+enable_heavy_hitters(client, top_k=32)
+    MygramDB__Client client
+    UV top_k
+  CODE:
+    RETVAL = mygramclient_enable_heavy_hitters(client->api, (size_t)top_k);
+  OUTPUT:
+    RETVAL
+
+SV*
+heavy_hitters(client)
+    MygramDB__Client client
+  PREINIT:
+    MygramHeavyHitters_C* hitters = NULL;
+    HV* rh;
+    AV* top_av;
+    size_t i;
+  CODE:
+    if (mygramclient_get_heavy_hitters(client->api, &hitters) != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Heavy hitters failed: %s", err);
+    }
+
+    top_av = newAV();
+    for (i = 0; i < hitters->count; i++) {
+        const MygramHeavyHitter_C* hh = &hitters->top[i];
+        HV* hitter_hv = newHV();
+        hv_store(hitter_hv, "command", 7, newSVpv(hh->command, 0), 0);
+        hv_store(hitter_hv, "count", 5, newSVuv(hh->count), 0);
+        hv_store(hitter_hv, "latency_ns", 10, newSVuv(hh->latency_ns), 0);
+        hv_store(hitter_hv, "latency_share", 13, newSVnv(hh->latency_share), 0);
+        av_push(top_av, newRV_noinc((SV*)hitter_hv));
+    }
+
+    rh = newHV();
+    hv_store(rh, "total_requests", 14, newSVuv(hitters->total_requests), 0);
+    hv_store(rh, "total_latency_ns", 16, newSVuv(hitters->total_latency_ns), 0);
+    hv_store(rh, "top", 3, newRV_noinc((SV*)top_av), 0);
+    RETVAL = newRV_noinc((SV*)rh);
+
+    mygramclient_free_heavy_hitters(hitters);
+  OUTPUT:
+    RETVAL
+
+void
+reset_heavy_hitters(client)
+    MygramDB__Client client
+  CODE:
+    mygramclient_reset_heavy_hitters(client->api);
+
+int
+set_capture(client, path_sv)
+    MygramDB__Client client
+    SV* path_sv
+  PREINIT:
+    const char* path = NULL;
+  CODE:
+    if (SvOK(path_sv)) {
+        path = SvPV_nolen(path_sv);
+    }
+    RETVAL = mygramclient_set_capture(client->api, path);
+    if (RETVAL != 0) {
+        const char* err = mygramclient_get_last_error(client->api);
+        croak("Set capture failed: %s", err);
+    }
+  OUTPUT:
+    RETVAL
+
 SV*
 parse_search_expression(expression)
     const char* expression
@@ -421,3 +1416,19 @@ parse_search_expression(expression)
     mygramclient_free_parsed_expression(parsed);
   OUTPUT:
     RETVAL
+
+UV
+live_sv_count()
+  CODE:
+    /* SVs allocated in this interpreter; documented as a diagnostics function */
+    RETVAL = PL_sv_count;
+  OUTPUT:
+    RETVAL
+
+MODULE = MygramDB::Client    PACKAGE = MygramDB::Client::XS::PreparedSearch
+
+void
+DESTROY(prepared)
+    MygramDB__Client__XS__PreparedSearch prepared
+  CODE:
+    mygramclient_free_prepared_search(prepared);
@@ -0,0 +1,134 @@
+/**
+ * @file alloc_count.c
+ * @brief LD_PRELOAD shim counting malloc calls per process, for bench/client_bench.pl
+ *
+ * Counters live in a shared file named by MYGRAM_ALLOC_COUNT_FILE so a Perl
+ * process can read its own counts without calling into C. The file holds an
+ * AllocCountFile: every process (including each forked child, via
+ * pthread_atfork) claims the next slot and stamps it with its pid.
+ * malloc/calloc/realloc/posix_memalign/aligned_alloc are counted with the
+ * requested bytes; the real allocator is glibc's __libc_* entry points, so
+ * this shim only builds on glibc.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define ALLOC_COUNT_SLOTS 255
+
+struct AllocCountSlot {
+  uint64_t pid;
+  uint64_t calls; /* Allocating calls */
+  uint64_t bytes; /* Bytes requested by them */
+  uint64_t frees;
+};
+
+/* File layout (native byte order); Perl reads it with unpack("Q*") */
+struct AllocCountFile {
+  char magic[8]; /* ALLOC_COUNT_MAGIC */
+  uint64_t next_slot;
+  uint64_t reserved[2];
+  struct AllocCountSlot slots[ALLOC_COUNT_SLOTS];
+};
+
+#define ALLOC_COUNT_MAGIC "MYGALLC1"
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void* __libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void* ptr);
+
+static struct AllocCountFile* counters;
+static struct AllocCountSlot* slot;
+
+static void ClaimSlot(void) {
+  slot = NULL;
+  if (counters == NULL) {
+    return;
+  }
+  uint64_t index = __atomic_fetch_add(&counters->next_slot, 1, __ATOMIC_RELAXED);
+  if (index < ALLOC_COUNT_SLOTS) {
+    counters->slots[index].pid = (uint64_t)getpid();
+    slot = &counters->slots[index];
+  }
+}
+
+static void Count(size_t bytes) {
+  if (slot != NULL) {
+    __atomic_fetch_add(&slot->calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&slot->bytes, bytes, __ATOMIC_RELAXED);
+  }
+}
+
+__attribute__((constructor)) static void Init(void) {
+  const char* path = getenv("MYGRAM_ALLOC_COUNT_FILE");
+  if (path == NULL) {
+    return;
+  }
+  int fd = open(path, O_RDWR | O_CLOEXEC);
+  if (fd < 0) {
+    return;
+  }
+  void* mapping = mmap(NULL, sizeof(struct AllocCountFile), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return;
+  }
+  counters = (struct AllocCountFile*)mapping;
+  if (memcmp(counters->magic, ALLOC_COUNT_MAGIC, sizeof(counters->magic)) != 0) {
+    counters = NULL; /* Not sized and stamped by the harness */
+    munmap(mapping, sizeof(struct AllocCountFile));
+    return;
+  }
+  ClaimSlot();
+  pthread_atfork(NULL, NULL, ClaimSlot);
+}
+
+void* malloc(size_t size) {
+  Count(size);
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+  Count(count * size);
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+  Count(size);
+  return __libc_realloc(ptr, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+  Count(size);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+  if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  Count(size);
+  void* ptr = __libc_memalign(alignment, size);
+  if (ptr == NULL) {
+    return ENOMEM;
+  }
+  *out = ptr;
+  return 0;
+}
+
+void free(void* ptr) {
+  if (ptr != NULL && slot != NULL) {
+    __atomic_fetch_add(&slot->frees, 1, __ATOMIC_RELAXED);
+  }
+  __libc_free(ptr);
+}
@@ -0,0 +1,262 @@
+/**
+ * @file bench_util.h
+ * @brief Shared helpers for the C++ benchmarks in bench/
+ *
+ * Provides heap allocation counting (by replacing the global operator
+ * new/delete and, on glibc, malloc/calloc/realloc so C API allocations are
+ * counted too), a steady-clock timer, and a canned-reply loopback server so
+ * client code paths can be measured without a MygramDB instance.
+ *
+ * Include this header from exactly one translation unit per benchmark binary:
+ * it defines the replacement allocation functions.
+ */
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mygramdb::bench {
+
+/**
+ * @brief Process-wide heap allocation counters
+ */
+struct AllocationCounters {
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> bytes{0};
+};
+
+inline AllocationCounters& GlobalAllocations() {
+  static AllocationCounters counters;
+  return counters;
+}
+
+inline void CountAllocation(std::size_t size) {
+  auto& counters = GlobalAllocations();
+  counters.count.fetch_add(1, std::memory_order_relaxed);
+  counters.bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Snapshot of allocation counters, for before/after deltas
+ */
+struct AllocationSnapshot {
+  uint64_t count;
+  uint64_t bytes;
+
+  static AllocationSnapshot Take() {
+    auto& counters = GlobalAllocations();
+    return {counters.count.load(std::memory_order_relaxed), counters.bytes.load(std::memory_order_relaxed)};
+  }
+};
+
+/**
+ * @brief Result of one benchmark case
+ */
+struct BenchResult {
+  double ns_per_op = 0.0;
+  double allocs_per_op = 0.0;
+  double bytes_per_op = 0.0;
+};
+
+/**
+ * @brief Run fn iterations times and report per-operation time and heap usage
+ */
+template <typename Fn>
+BenchResult Measure(uint64_t iterations, Fn&& fn) {
+  auto before = AllocationSnapshot::Take();
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < iterations; ++i) {
+    fn();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto after = AllocationSnapshot::Take();
+
+  BenchResult result;
+  auto divisor = static_cast<double>(iterations);
+  auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  result.ns_per_op = static_cast<double>(elapsed_ns) / divisor;
+  result.allocs_per_op = static_cast<double>(after.count - before.count) / divisor;
+  result.bytes_per_op = static_cast<double>(after.bytes - before.bytes) / divisor;
+  return result;
+}
+
+inline void PrintResult(const char* name, const BenchResult& result) {
+  std::printf("%-40s %12.1f ns/op %10.2f allocs/op %12.1f B/op\n", name, result.ns_per_op, result.allocs_per_op,
+              result.bytes_per_op);
+}
+
+/**
+ * @brief Loopback server answering every request line with a fixed reply
+ *
+ * Listens on 127.0.0.1 with an ephemeral port and serves each client
+ * connection on its own background thread, so pooled clients can open
+ * several.
+ */
+class CannedServer {
+ public:
+  explicit CannedServer(std::string reply) : reply_(std::move(reply)) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    int enable = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) - Required for socket API
+    if (bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listen_fd_, 16) < 0) {
+      std::perror("CannedServer");
+      std::exit(1);
+    }
+    socklen_t len = sizeof(addr);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) - Required for socket API
+    getsockname(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    thread_ = std::thread([this] { Serve(); });
+  }
+
+  ~CannedServer() {
+    shutdown(listen_fd_, SHUT_RDWR);
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    close(listen_fd_);
+    // No new connections now; end the open ones
+    for (int conn : connections_) {
+      shutdown(conn, SHUT_RDWR);
+    }
+    for (auto& thread : connection_threads_) {
+      thread.join();
+    }
+    for (int conn : connections_) {
+      close(conn);
+    }
+  }
+
+  CannedServer(const CannedServer&) = delete;
+  CannedServer& operator=(const CannedServer&) = delete;
+  CannedServer(CannedServer&&) = delete;
+  CannedServer& operator=(CannedServer&&) = delete;
+
+  [[nodiscard]] uint16_t port() const { return port_; }
+
+  /**
+   * @brief Most recent request line received (without terminator)
+   */
+  [[nodiscard]] std::string last_request() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_request_;
+  }
+
+ private:
+  void Serve() {
+    while (true) {
+      int conn = accept(listen_fd_, nullptr, nullptr);
+      if (conn < 0) {
+        return;
+      }
+      connections_.push_back(conn);
+      connection_threads_.emplace_back([this, conn] { ServeConnection(conn); });
+    }
+  }
+
+  // Closing conn is left to the destructor, so its descriptor is not reused meanwhile
+  void ServeConnection(int conn) {
+    std::string pending;
+    std::string replies;
+    char buffer[4096];  // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+    while (true) {
+      ssize_t received = recv(conn, buffer, sizeof(buffer), 0);
+      if (received <= 0) {
+        break;
+      }
+      pending.append(buffer, static_cast<size_t>(received));
+      size_t pos = 0;
+      while ((pos = pending.find("\r\n")) != std::string::npos) {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          last_request_.assign(pending, 0, pos);
+        }
+        pending.erase(0, pos + 2);
+        replies += reply_;
+      }
+      // One write per pipelined batch; separate small writes would stall on Nagle
+      if (!replies.empty() && send(conn, replies.data(), replies.size(), MSG_NOSIGNAL) < 0) {
+        return;
+      }
+      replies.clear();
+    }
+  }
+
+  std::string reply_;
+  mutable std::mutex mutex_;
+  std::string last_request_;
+  int listen_fd_ = -1;
+  uint16_t port_ = 0;
+  std::thread thread_;
+  std::vector<int> connections_;  // Only touched by thread_ until it is joined
+  std::vector<std::thread> connection_threads_;
+};
+
+}  // namespace mygramdb::bench
+
+// Replacement global allocation functions counting every heap allocation
+// NOLINTBEGIN(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
+#if defined(__GLIBC__)
+// glibc exports its allocator under __libc_* names, so malloc can be counted
+// here and operator new can skip the counted entry point
+extern "C" void* __libc_malloc(std::size_t size);
+extern "C" void* __libc_calloc(std::size_t count, std::size_t size);
+extern "C" void* __libc_realloc(void* ptr, std::size_t size);
+
+extern "C" void* malloc(std::size_t size) noexcept {
+  mygramdb::bench::CountAllocation(size);
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(std::size_t count, std::size_t size) noexcept {
+  mygramdb::bench::CountAllocation(count * size);
+  return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, std::size_t size) noexcept {
+  mygramdb::bench::CountAllocation(size);
+  return __libc_realloc(ptr, size);
+}
+
+#define MYGRAM_BENCH_RAW_MALLOC __libc_malloc
+#else
+#define MYGRAM_BENCH_RAW_MALLOC std::malloc
+#endif
+
+void* operator new(std::size_t size) {
+  mygramdb::bench::CountAllocation(size);
+  if (void* ptr = MYGRAM_BENCH_RAW_MALLOC(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+// NOLINTEND(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
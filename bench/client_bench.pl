@@ -0,0 +1,437 @@
+#!/usr/bin/env perl
+
+# Benchmark harness for the Perl clients.
+#
+# Sweeps client implementations, query mixes, result sizes and concurrency
+# against a MygramDB server (by default a tools/mygram_mock_server started
+# for the run) and reports, per combination: throughput, latency
+# percentiles, time per 1,000 results, RSS growth, malloc calls/bytes per
+# operation and the SVs one call's result holds.
+#
+# Each worker is a forked process with its own connection. Workers warm up,
+# wait for each other, then time every call individually; latency
+# percentiles are over all calls of all workers, and ops/s is the total
+# calls divided by the slowest worker's wall time. Allocations are counted
+# by bench/alloc_count.so (built by "make bench", glibc only), which the
+# harness preloads into a re-run of itself; without it they are reported as
+# n/a. RSS growth is the worker's VmRSS after the timed loop minus before it.
+# SVs per call are counted (with the XS module's live_sv_count) around one
+# extra call whose result is kept, so they are what a caller holding the
+# result pays for it.
+#
+# Usage: perl -Mblib bench/client_bench.pl [options]
+#   --clients LIST      pp,xs,xs_prepared,xs_keys,xs_ids (default: all available)
+#   --mixes LIST        search,count,get,mixed (default: all)
+#   --limits LIST       SEARCH LIMITs for search/mixed (default: 1,10,100,1000)
+#   --concurrency LIST  Worker processes (default: 1,4)
+#   --iterations N      Timed calls per worker (default: 2000)
+#   --warmup N          Untimed calls per worker first (default: 200)
+#   --host ADDR --port N  Use a running server instead of the mock server
+#   --docs N            Documents in the mock server's table (default: 100000)
+#   --json              One JSON object per combination (JSON Lines) instead of a table
+#   --no-allocs         Do not count allocations
+
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/../lib";
+use File::Temp qw(tempfile);
+use Getopt::Long qw(GetOptions);
+use JSON::PP ();
+use POSIX qw(ceil);
+use Time::HiRes qw(time);
+use MygramDB::Client;
+
+my $has_xs = eval { require MygramDB::Client::XS; 1 };
+
+my $TABLE = 'articles';
+my @QUERIES = qw(hello world news golang perl data search index);
+my $ALLOC_SHIM = "$FindBin::Bin/alloc_count.so";
+my $ALLOC_MAGIC = 'MYGALLC1';
+my $ALLOC_FILE_SIZE = 32 + 255 * 32;    # struct AllocCountFile in alloc_count.c
+
+my %opt = (
+    clients     => join(',', 'pp', ($has_xs ? ('xs', 'xs_prepared', 'xs_keys', 'xs_ids') : ())),
+    mixes       => 'search,count,get,mixed',
+    limits      => '1,10,100,1000',
+    concurrency => '1,4',
+    iterations  => 2000,
+    warmup      => 200,
+    docs        => 100000,
+);
+my @argv = @ARGV;    # For the re-run below
+GetOptions(\%opt, 'clients=s', 'mixes=s', 'limits=s', 'concurrency=s', 'iterations=i', 'warmup=i', 'host=s',
+           'port=i', 'docs=i', 'json', 'no-allocs')
+    or die "Usage: $0 [--clients LIST] [--mixes LIST] [--limits LIST] [--concurrency LIST] [--iterations N]\n"
+         . "          [--warmup N] [--host ADDR --port N] [--docs N] [--json] [--no-allocs]\n";
+
+# Re-run under the allocation counting shim when it is available
+if (!$opt{'no-allocs'} && !defined $ENV{MYGRAM_ALLOC_COUNT_FILE} && $^O eq 'linux' && -e $ALLOC_SHIM) {
+    my ($fh, $counts) = tempfile(UNLINK => 1);
+    print $fh $ALLOC_MAGIC, "\0" x ($ALLOC_FILE_SIZE - length $ALLOC_MAGIC);
+    close $fh;
+    local $ENV{MYGRAM_ALLOC_COUNT_FILE} = $counts;
+    local $ENV{LD_PRELOAD} = join(' ', $ALLOC_SHIM, grep { defined } $ENV{LD_PRELOAD});
+    system($^X, (map { "-I$_" } grep { !ref } @INC), $0, @argv);
+    exit($? == -1 ? 1 : $? >> 8);
+}
+
+# Client implementations: connect, then build a closure per mix that issues
+# one call (numbered $i), leaves its result in $last_result and returns the
+# number of results it received
+my $last_result;
+my %CLIENTS = (
+    pp => {
+        connect => sub {
+            my ($host, $port) = @_;
+            my $client = MygramDB::Client->new(host => $host, port => $port, timeout => 5);
+            $client->connect or die "pp: " . $client->errstr . "\n";
+            return $client;
+        },
+        search => sub {
+            my ($client, $limit) = @_;
+            return sub {
+                $last_result = $client->search(table => $TABLE, query => $QUERIES[$_[0] % @QUERIES], limit => $limit)
+                    or die "pp search: " . $client->errstr . "\n";
+                return scalar @{$last_result->{results}};
+            };
+        },
+        count => sub {
+            my ($client) = @_;
+            return sub {
+                defined($last_result = $client->count(table => $TABLE, query => $QUERIES[$_[0] % @QUERIES]))
+                    or die "pp count: " . $client->errstr . "\n";
+                return 0;
+            };
+        },
+        get => sub {
+            my ($client) = @_;
+            return sub {
+                $last_result = $client->get(table => $TABLE, primary_key => $_[0] % 1000 + 1)
+                    or die "pp get: " . $client->errstr . "\n";
+                return 1;
+            };
+        },
+    },
+    xs => {
+        connect => \&xs_connect,
+        search  => sub {
+            my ($client, $limit) = @_;
+            return sub {
+                $last_result = $client->search($TABLE, $QUERIES[$_[0] % @QUERIES], $limit, 0);
+                return scalar @{$last_result->{results}};
+            };
+        },
+        count => \&xs_count,
+        get   => \&xs_get,
+    },
+    xs_prepared => {
+        connect => \&xs_connect,
+        search  => sub {
+            my ($client, $limit) = @_;
+            my $prepared = $client->prepare_search($TABLE);
+            return sub {
+                $last_result = $client->search_prepared($prepared, $QUERIES[$_[0] % @QUERIES], $limit, 0);
+                return scalar @{$last_result->{results}};
+            };
+        },
+        # count/get have no prepared form; only the mixed workload uses these
+        count => \&xs_count,
+        get   => \&xs_get,
+        search_only => 1,
+    },
+    # Prepared searches returning [key, ...] and packed uint64 IDs instead of hashrefs
+    xs_keys => {
+        connect => \&xs_connect,
+        search  => sub {
+            my ($client, $limit) = @_;
+            my $prepared = $client->prepare_search($TABLE);
+            return sub {
+                $last_result = $client->search_prepared_keys($prepared, $QUERIES[$_[0] % @QUERIES], $limit, 0);
+                return scalar @$last_result;
+            };
+        },
+        count => \&xs_count,
+        get   => \&xs_get,
+        search_only => 1,
+    },
+    xs_ids => {
+        connect => \&xs_connect,
+        search  => sub {
+            my ($client, $limit) = @_;
+            my $prepared = $client->prepare_search($TABLE);
+            return sub {
+                $last_result = $client->search_prepared_ids($prepared, $QUERIES[$_[0] % @QUERIES], $limit, 0);
+                return length($last_result) / 8;
+            };
+        },
+        count => \&xs_count,
+        get   => \&xs_get,
+        search_only => 1,
+    },
+);
+
+sub xs_connect {
+    my ($host, $port) = @_;
+    my $client = MygramDB::Client::XS->new($host, $port, 5000, 65536);
+    $client->connect;
+    return $client;
+}
+
+sub xs_count {
+    my ($client) = @_;
+    return sub { $last_result = $client->count($TABLE, $QUERIES[$_[0] % @QUERIES]); return 0 };
+}
+
+sub xs_get {
+    my ($client) = @_;
+    return sub { $last_result = $client->get($TABLE, $_[0] % 1000 + 1); return 1 };
+}
+
+# Workload of one worker: a closure issuing call $i
+sub make_workload {
+    my ($impl, $client, $mix, $limit) = @_;
+    return $impl->{$mix}->($client, $limit) unless $mix eq 'mixed';
+
+    # 7 searches, 2 counts and 1 get in every 10 calls
+    my $search = $impl->{search}->($client, $limit);
+    my $count = $impl->{count}->($client);
+    my $get = $impl->{get}->($client);
+    my @calls = (($search) x 7, ($count) x 2, $get);
+    return sub { $calls[$_[0] % 10]->($_[0]) };
+}
+
+sub rss_kb {
+    open(my $fh, '<', "/proc/$$/status") or return undef;
+    while (my $line = <$fh>) {
+        return $1 if $line =~ /^VmRSS:\s+(\d+)/;
+    }
+    return undef;
+}
+
+# Offset of this process's slot in the allocation counts file (undef: not counted)
+sub alloc_slot {
+    my $path = $ENV{MYGRAM_ALLOC_COUNT_FILE} or return undef;
+    open(my $fh, '<:raw', $path) or return undef;
+    read($fh, my $data, $ALLOC_FILE_SIZE) == $ALLOC_FILE_SIZE or return undef;
+    for (my $offset = 32; $offset < $ALLOC_FILE_SIZE; $offset += 32) {
+        return $offset if unpack('Q', substr($data, $offset, 8)) == $$;
+    }
+    return undef;
+}
+
+# (calls, bytes) allocated so far by this process; the read buffer is reused
+my $alloc_buffer = "\0" x 16;
+sub alloc_counts {
+    my ($fh, $slot) = @_;
+    sysseek($fh, $slot + 8, 0);
+    sysread($fh, $alloc_buffer, 16);
+    return unpack('QQ', $alloc_buffer);
+}
+
+sub reset_alloc_slots {
+    my $path = $ENV{MYGRAM_ALLOC_COUNT_FILE} or return;
+    open(my $fh, '+<:raw', $path) or return;
+    sysseek($fh, 8, 0);
+    syswrite($fh, pack('Q', 1));    # Slot 0 stays with this process
+}
+
+sub run_worker {
+    my ($cell, $host, $port, $out, $go) = @_;
+    my $impl = $CLIENTS{$cell->{client}};
+    my $client = $impl->{connect}->($host, $port);
+    my $call = make_workload($impl, $client, $cell->{mix}, $cell->{limit});
+
+    my $slot = alloc_slot();
+    open(my $counts_fh, '<:raw', $ENV{MYGRAM_ALLOC_COUNT_FILE} // '/dev/null') or die "alloc counts: $!";
+
+    $call->($_) for 1 .. $opt{warmup};
+    my $iterations = $opt{iterations};
+    my @latency = (0.5) x $iterations;    # NVs, so storing a latency does not allocate
+    my $results = 0;
+
+    # Wait for every worker to warm up
+    syswrite($out, "ready\n");
+    sysread($go, my $ignored, 1);
+
+    my $rss_before = rss_kb();
+    my ($calls_before, $bytes_before) = defined $slot ? alloc_counts($counts_fh, $slot) : (0, 0);
+    my $start = time;
+    for my $i (0 .. $iterations - 1) {
+        my $t = time;
+        $results += $call->($i);
+        $latency[$i] = time - $t;
+    }
+    my $elapsed = time - $start;
+    my ($calls_after, $bytes_after) = defined $slot ? alloc_counts($counts_fh, $slot) : (0, 0);
+    my $rss_after = rss_kb();
+
+    my $rss_growth = defined $rss_before && defined $rss_after ? $rss_after - $rss_before : -1;
+    my @allocs = defined $slot ? ($calls_after - $calls_before, $bytes_after - $bytes_before) : (-1, -1);
+
+    # SVs held by the result of one more call
+    my $svs = -1;
+    if ($has_xs) {
+        undef $last_result;
+        my $before = MygramDB::Client::XS::live_sv_count();
+        $call->($iterations);
+        $svs = MygramDB::Client::XS::live_sv_count() - $before;
+    }
+    syswrite($out, join(' ', $elapsed, $results, $rss_growth, @allocs, $svs) . "\n" . pack('d*', @latency));
+}
+
+# Run one combination; returns its result record
+sub run_cell {
+    my ($cell, $host, $port) = @_;
+    my @workers;
+    for (1 .. $cell->{concurrency}) {
+        pipe(my $result_read, my $result_write) or die "pipe: $!";
+        pipe(my $go_read, my $go_write) or die "pipe: $!";
+        my $pid = fork // die "fork: $!";
+        if ($pid == 0) {
+            close $result_read;
+            close $go_write;
+            my $ok = eval { run_worker($cell, $host, $port, $result_write, $go_read); 1 };
+            syswrite($result_write, "error $@") unless $ok;
+            POSIX::_exit(0);
+        }
+        close $result_write;
+        close $go_read;
+        push @workers, {pid => $pid, result => $result_read, go => $go_write};
+    }
+
+    my $error;
+    for my $worker (@workers) {
+        my $line = readline($worker->{result}) // "error worker exited\n";
+        $error //= $1 if $line =~ /^error (.*)/s;
+    }
+    close $_->{go} for @workers;    # Start the timed loops
+
+    my (@latency, $elapsed, $results, $rss_growth, $calls, $bytes, $svs);
+    for my $worker (@workers) {
+        my $line = readline($worker->{result}) // "error worker exited\n";
+        if ($line =~ /^error (.*)/s) {
+            $error //= $1;
+            next;
+        }
+        my ($worker_elapsed, $worker_results, $worker_rss, $worker_calls, $worker_bytes, $worker_svs) =
+            split ' ', $line;
+        local $/ = \(8 * $opt{iterations});
+        push @latency, unpack('d*', readline($worker->{result}));
+        $elapsed = $worker_elapsed if !defined $elapsed || $worker_elapsed > $elapsed;
+        $results += $worker_results;
+        $rss_growth = $worker_rss if $worker_rss > ($rss_growth // -1);
+        if ($worker_calls >= 0) {
+            $calls += $worker_calls;
+            $bytes += $worker_bytes;
+        }
+        $svs = $worker_svs if $worker_svs >= 0;    # The same in every worker
+    }
+    for my $worker (@workers) {
+        close $worker->{result};
+        waitpid($worker->{pid}, 0);
+    }
+    reset_alloc_slots();
+
+    my %record = (%$cell, iterations => $opt{iterations});
+    if (defined $error) {
+        chomp $error;
+        return {%record, error => $error};
+    }
+    @latency = sort { $a <=> $b } @latency;
+    my $ops = scalar @latency;
+    my $us = sub { sprintf('%.1f', $_[0] * 1e6) + 0 };
+    my $percentile = sub { $latency[ceil($_[0] / 100 * $ops) - 1] };
+    my $busy = 0;
+    $busy += $_ for @latency;
+    return {
+        %record,
+        ops             => $ops,
+        ops_per_sec     => sprintf('%.0f', $ops / $elapsed) + 0,
+        p50_us          => $us->($percentile->(50)),
+        p90_us          => $us->($percentile->(90)),
+        p99_us          => $us->($percentile->(99)),
+        p999_us         => $us->($percentile->(99.9)),
+        max_us          => $us->($latency[-1]),
+        results_per_op  => sprintf('%.1f', $results / $ops) + 0,
+        us_per_1k_results => $results > 0 ? $us->($busy / $results * 1000) : undef,
+        svs_per_op      => $svs,
+        rss_growth_kb   => $rss_growth >= 0 ? $rss_growth : undef,
+        allocs_per_op   => defined $calls ? sprintf('%.2f', $calls / $ops) + 0 : undef,
+        alloc_bytes_per_op => defined $calls ? sprintf('%.0f', $bytes / $ops) + 0 : undef,
+    };
+}
+
+sub start_mock_server {
+    my $tool = "$FindBin::Bin/../tools/mygram_mock_server";
+    die "$tool not built (run make), or pass --host/--port\n" unless -x $tool;
+
+    # The server is not measured: keep the shim out of it and silence its exit counters
+    local $ENV{LD_PRELOAD} = '';
+    open(my $stderr, '>&', \*STDERR) or die "dup: $!";
+    open(STDERR, '>', '/dev/null') or die "/dev/null: $!";
+    my $pid = open(my $out, '-|', $tool, '--port', '0', '--table', "$TABLE:$opt{docs}:4");
+    open(STDERR, '>&', $stderr) or die "dup: $!";
+    die "Cannot run $tool: $!\n" unless $pid;
+    my $line = <$out>;
+    die "mock server did not start\n" unless defined $line && $line =~ /^PORT (\d+)/;
+    return ($pid, $out, $1);
+}
+
+my ($host, $port, $server_pid, $server_out) = ($opt{host}, $opt{port});
+if (!defined $host) {
+    ($server_pid, $server_out, $port) = start_mock_server();
+    $host = '127.0.0.1';
+}
+die "--port is required with --host\n" unless defined $port;
+
+my @columns = (
+    [client => '%-12s'], [mix => '%-7s'], [limit => '%6s'], [concurrency => '%5s'], [ops_per_sec => '%9s'],
+    [p50_us => '%9s'], [p90_us => '%9s'], [p99_us => '%9s'], [max_us => '%9s'], [results_per_op => '%8s'],
+    [us_per_1k_results => '%9s'], [rss_growth_kb => '%8s'], [allocs_per_op => '%9s'], [alloc_bytes_per_op => '%9s'],
+    [svs_per_op => '%7s'],
+);
+my %headers = (concurrency => 'conc', ops_per_sec => 'ops/s', results_per_op => 'res/op',
+               us_per_1k_results => 'us/1k_res', rss_growth_kb => 'rss_kb', allocs_per_op => 'allocs/op',
+               alloc_bytes_per_op => 'bytes/op', svs_per_op => 'svs/op');
+
+my $json = JSON::PP->new->canonical;
+my %meta = (
+    time   => time,
+    perl   => sprintf('%vd', $^V),
+    server => defined $server_pid ? "mock:$opt{docs}" : "$host:$port",
+);
+if (!$opt{json}) {
+    printf("# %s  iterations=%d/worker  warmup=%d\n", $meta{server}, $opt{iterations}, $opt{warmup});
+    print join(' ', map { sprintf($_->[1], $headers{$_->[0]} // $_->[0]) } @columns), "\n";
+}
+
+for my $client (split /,/, $opt{clients}) {
+    die "Unknown client $client\n" unless $CLIENTS{$client};
+    die "$client needs MygramDB::Client::XS\n" if $client =~ /^xs/ && !$has_xs;
+    for my $mix (split /,/, $opt{mixes}) {
+        die "Unknown mix $mix\n" unless $mix =~ /^(?:search|count|get|mixed)$/;
+        next if $CLIENTS{$client}{search_only} && ($mix eq 'count' || $mix eq 'get');
+        my @limits = $mix eq 'search' || $mix eq 'mixed' ? split(/,/, $opt{limits}) : (undef);
+        for my $limit (@limits) {
+            for my $concurrency (split /,/, $opt{concurrency}) {
+                my $record = run_cell({client => $client, mix => $mix, limit => $limit, concurrency => $concurrency},
+                                      $host, $port);
+                if ($opt{json}) {
+                    print $json->encode({%meta, %$record}), "\n";
+                } elsif (defined $record->{error}) {
+                    printf("%-12s %-7s %6s %5s  error: %s\n", @{$record}{qw(client mix)}, $limit // '-', $concurrency,
+                           $record->{error});
+                } else {
+                    print join(' ', map { sprintf($_->[1], $record->{$_->[0]} // ($_->[0] eq 'limit' ? '-' : 'n/a')) }
+                               @columns), "\n";
+                }
+            }
+        }
+    }
+}
+
+if (defined $server_pid) {
+    kill 'TERM', $server_pid;
+    close $server_out;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file client_metrics_bench.cpp
+ * @brief Cost of per-command metrics recording
+ *
+ * Measures MetricsRegistry::Record() alone, from one thread and from several
+ * threads sharing a registry, then runs searches against a loopback server
+ * and checks that the recorded byte and recv() counts match the traffic.
+ * Also checks that Reset() while other threads record leaves the request,
+ * error and latency counts in agreement.
+ *
+ * Usage: client_metrics_bench [iterations]
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "mygramdb/client_metrics.h"
+#include "mygramdb/mygramclient.h"
+
+using mygram::utils::ErrorCode;
+using mygramdb::bench::CannedServer;
+using mygramdb::bench::Measure;
+using mygramdb::bench::PrintResult;
+using mygramdb::client::ClientConfig;
+using mygramdb::client::CommandType;
+using mygramdb::client::MetricsRegistry;
+using mygramdb::client::MygramClient;
+using mygramdb::client::RequestStats;
+using mygramdb::client::SearchResponse;
+
+namespace {
+
+constexpr uint64_t kDefaultIterations = 1000000;
+constexpr int kThreads = 4;
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : kDefaultIterations;
+
+  const RequestStats stats{64, 512, 1};
+
+  {
+    MetricsRegistry registry;
+    uint64_t latency = 0;
+    PrintResult("record/1-thread", Measure(iterations, [&] {
+                  registry.Record(CommandType::kSearch, stats, 20000 + (latency++ & 0xffff), ErrorCode::kSuccess);
+                }));
+    if (registry.Snapshot()[CommandType::kSearch].requests != iterations) {
+      std::abort();
+    }
+  }
+
+  {
+    MetricsRegistry registry;
+    auto result = Measure(1, [&] {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+          for (uint64_t i = 0; i < iterations; ++i) {
+            registry.Record(CommandType::kCount, stats, 20000 + (i & 0xffff), ErrorCode::kSuccess);
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    });
+    // Wall time per record across all threads
+    const double records = static_cast<double>(iterations * kThreads);
+    result.ns_per_op /= records;
+    result.allocs_per_op /= records;
+    result.bytes_per_op /= records;
+    PrintResult("record/4-threads", result);
+    if (registry.Snapshot()[CommandType::kCount].requests != iterations * kThreads) {
+      std::abort();
+    }
+  }
+
+  {
+    // Every other request fails; Reset() runs throughout. Once recording has
+    // stopped, each command's requests, errors and buckets must agree: a
+    // reset half-applied to a shard shows up as a mismatch.
+    MetricsRegistry registry;
+    std::atomic<bool> recording{true};
+    std::thread resetter([&] {
+      while (recording.load(std::memory_order_relaxed)) {
+        registry.Reset();
+      }
+    });
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&] {
+        for (uint64_t i = 0; i < iterations; ++i) {
+          registry.Record(CommandType::kGet, stats, 20000 + (i & 0xffff),
+                          (i & 1) != 0 ? ErrorCode::kClientServerError : ErrorCode::kSuccess);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    recording.store(false, std::memory_order_relaxed);
+    resetter.join();
+
+    const auto metrics = registry.Snapshot();
+    const auto& get = metrics[CommandType::kGet];
+    uint64_t by_code = 0;
+    for (const auto& [code, count] : metrics.errors) {
+      by_code += count;
+    }
+    if (get.latency.count != get.requests || by_code != get.errors || get.errors > get.requests) {
+      std::fprintf(stderr, "reset check: requests=%llu buckets=%llu errors=%llu by code=%llu\n",
+                   static_cast<unsigned long long>(get.requests), static_cast<unsigned long long>(get.latency.count),
+                   static_cast<unsigned long long>(get.errors), static_cast<unsigned long long>(by_code));
+      return 1;
+    }
+    std::printf("reset check: %llu requests after the last reset\n", static_cast<unsigned long long>(get.requests));
+  }
+
+  {
+    const std::string reply = "OK RESULTS 3 101 102 103\r\n";
+    CannedServer server(reply);
+    ClientConfig config;
+    config.port = server.port();
+    MygramClient client(config);
+    if (auto conn = client.Connect(); !conn) {
+      std::fprintf(stderr, "connect failed: %s\n", conn.error().message().c_str());
+      return 1;
+    }
+
+    const uint64_t searches = iterations / 100;
+    SearchResponse resp;
+    PrintResult("search/instrumented", Measure(searches, [&] {
+                  if (!client.Search("articles", "hello", 100, 0, resp) || resp.results.size() != 3) {
+                    std::abort();
+                  }
+                }));
+
+    const auto metrics = client.GetMetrics();
+    const auto& search = metrics[CommandType::kSearch];
+    const uint64_t request_bytes = server.last_request().size() + 2;  // Plus \r\n
+    if (search.requests != searches || search.errors != 0 || search.bytes_sent != searches * request_bytes ||
+        search.bytes_received != searches * reply.size() || search.recv_calls < searches) {
+      std::fprintf(stderr, "unexpected SEARCH metrics\n");
+      return 1;
+    }
+    std::printf("search latency p50 %llu ns, p99 %llu ns, max %llu ns\n",
+                static_cast<unsigned long long>(search.latency.ValueAtPercentile(50.0)),
+                static_cast<unsigned long long>(search.latency.ValueAtPercentile(99.0)),
+                static_cast<unsigned long long>(search.latency.max_ns));
+  }
+
+  return 0;
+}
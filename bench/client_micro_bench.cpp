@@ -0,0 +1,698 @@
+/**
+ * @file client_micro_bench.cpp
+ * @brief Microbenchmark suite for the client library's hot paths
+ *
+ * Covers query validation/escaping, command building, SEARCH/COUNT/GET/INFO
+ * replies at several sizes (SEARCH and GET also through the C API, with
+ * allocated results and with reusable handles), pipelined and submitted
+ * SEARCH batches, document field parsing, search expression parsing, text
+ * normalization, n-gram generation and CIDR matching, and reports ns/op,
+ * allocations/op and bytes/op for each case.
+ *
+ * Reply cases run against a loopback server returning a canned reply, so
+ * their ns/op includes one loopback round trip; "roundtrip/count_floor"
+ * (the smallest reply) is that floor. The "parse/" cases call the reply
+ * parsers (mygramclient_internal.h) on the same replies directly, without
+ * the round trip. Allocation counts are exact either way.
+ *
+ * Before the cases, a check runs several threads against one pooled C API
+ * handle and one prepared search, each with its own result handle, and
+ * verifies their results and that each thread sees only its own errors.
+ * Another checks the phase timing that collect_timing attaches to Search
+ * and Count replies against the latency of the call, and a third executes a
+ * pipeline whose commands and replies both exceed the socket buffers.
+ *
+ * bench/baseline.txt holds the expected numbers. With --baseline the suite
+ * compares against it and exits non-zero when any case allocates more
+ * (allocations and bytes are deterministic); ns/op is reported as a ratio
+ * only, since it depends on the machine. Regenerate the file with
+ * --write-baseline when a change is meant to move the numbers, so the
+ * difference shows up in review.
+ *
+ * Usage: client_micro_bench [--iterations N] [--filter SUBSTRING]
+ *                           [--baseline FILE] [--write-baseline FILE]
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "mygramdb/mygramclient.h"
+#include "mygramdb/mygramclient_c.h"
+#include "mygramdb/mygramclient_internal.h"
+#include "mygramdb/search_expression.h"
+#include "utils/network_utils.h"
+#include "utils/query_scan.h"
+#include "utils/string_utils.h"
+
+using mygramdb::bench::BenchResult;
+using mygramdb::bench::CannedServer;
+using mygramdb::bench::Measure;
+using mygramdb::bench::PrintResult;
+using mygramdb::client::ClientConfig;
+using mygramdb::client::ClientTiming;
+using mygramdb::client::ConvertSearchExpression;
+using mygramdb::client::CountResponse;
+using mygramdb::client::Document;
+using mygramdb::client::DocumentFields;
+using mygramdb::client::MygramClient;
+using mygramdb::client::ParseCountReply;
+using mygramdb::client::ParseGetReply;
+using mygramdb::client::ParseInfoReply;
+using mygramdb::client::ParseSearchExpression;
+using mygramdb::client::ParseSearchReply;
+using mygramdb::client::SearchResponse;
+using mygramdb::client::ServerInfo;
+using mygramdb::utils::CIDR;
+using mygramdb::utils::GenerateHybridNgrams;
+using mygramdb::utils::GenerateNgrams;
+using mygramdb::utils::IsIPAllowed;
+using mygramdb::utils::NormalizeText;
+using mygramdb::utils::ParseIPv4;
+using mygramdb::utils::ScanTerm;
+
+namespace {
+
+constexpr uint64_t kDefaultIterations = 100000;
+constexpr uint64_t kRoundtripDivisor = 10;     // Reply cases run iterations / 10 times
+constexpr double kAllocationTolerance = 0.01;  // Slack for amortized growth in the first iterations
+constexpr double kSlowerRatioToReport = 1.5;   // ns/op ratio worth pointing out
+constexpr int kPooledCheckThreads = 8;
+constexpr int kPooledCheckCalls = 200;  // Per thread; every fourth one fails validation
+constexpr int kTimingCheckCalls = 20;
+constexpr int kMultiChunkIds = 20000;  // ~160 KB reply: several recv() calls into the 64 KB buffer
+constexpr size_t kLargePipelineItems = 2000;
+constexpr size_t kLargePipelineItemBytes = 16384;  // 32 MB each way, well past the loopback socket buffers
+
+volatile size_t g_sink = 0;  // Keeps results observable so calls are not optimized away
+
+void Sink(size_t value) { g_sink = g_sink + value; }
+
+struct Case {
+  std::string name;
+  bool roundtrip;  // Talks to the loopback server
+  std::function<void()> run;
+};
+
+std::string SearchReply(int ids) {
+  std::string reply = "OK RESULTS " + std::to_string(ids * 10);
+  for (int i = 0; i < ids; ++i) {
+    reply += ' ';
+    reply += std::to_string(1000000 + i);
+  }
+  return reply + "\r\n";
+}
+
+std::string DocFields(int fields) {
+  std::string text;
+  for (int i = 0; i < fields; ++i) {
+    text += " field" + std::to_string(i) + "=value" + std::to_string(i * 37);
+  }
+  return text;
+}
+
+std::string InfoReply() {
+  return "OK INFO\r\n# Server\r\nversion: 1.3.0\r\nuptime_seconds: 86400\r\n\r\n# Stats\r\ntotal_requests: 123456\r\n"
+         "\r\n# Clients\r\nactive_connections: 12\r\n\r\n# Memory\r\nindex_size_bytes: 1073741824\r\n\r\n"
+         "# Index\r\ntotal_documents: 1000000\r\ntables: articles,comments,users\r\n";
+}
+
+/**
+ * @brief Loopback server plus a client connected to it
+ */
+struct Endpoint {
+  explicit Endpoint(std::string reply) : server(std::move(reply)) {
+    ClientConfig config;
+    config.port = server.port();
+    client = std::make_unique<MygramClient>(config);
+    if (auto conn = client->Connect(); !conn) {
+      std::fprintf(stderr, "connect failed: %s\n", conn.error().message().c_str());
+      std::exit(1);
+    }
+  }
+
+  CannedServer server;
+  std::unique_ptr<MygramClient> client;
+};
+
+/**
+ * @brief Loopback server plus a C API client connected to it (pooled if pool_size is not 0)
+ */
+struct CEndpoint {
+  explicit CEndpoint(std::string reply, size_t pool_size = 0) : server(std::move(reply)) {
+    MygramClientConfig_C config = {"127.0.0.1", server.port(), 5000, 65536};
+    client = pool_size != 0 ? mygramclient_create_pooled(&config, pool_size) : mygramclient_create(&config);
+    if (client == nullptr || mygramclient_connect(client) != 0) {
+      std::fprintf(stderr, "C API connect failed\n");
+      std::exit(1);
+    }
+  }
+  ~CEndpoint() { mygramclient_destroy(client); }
+
+  CEndpoint(const CEndpoint&) = delete;
+  CEndpoint& operator=(const CEndpoint&) = delete;
+  CEndpoint(CEndpoint&&) = delete;
+  CEndpoint& operator=(CEndpoint&&) = delete;
+
+  CannedServer server;
+  MygramClient_C* client = nullptr;
+};
+
+/**
+ * @brief Share one pooled handle and prepared search between threads
+ *
+ * Each thread fails every fourth call with its own control character in the
+ * query, so a thread reading another thread's error shows up as a wrong
+ * character code in the message.
+ */
+bool CheckPooledThreads() {
+  CEndpoint endpoint(SearchReply(10), kPooledCheckThreads / 2);  // Fewer connections than threads: leases wait
+  MygramPreparedSearch_C* prepared = nullptr;
+  if (mygramclient_prepare_search(endpoint.client, "articles", nullptr, 0, nullptr, 0, nullptr, nullptr, 0, nullptr,
+                                  0, &prepared) != 0) {
+    std::fprintf(stderr, "pooled check: prepare failed: %s\n", mygramclient_last_error());
+    return false;
+  }
+
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kPooledCheckThreads; ++t) {
+    threads.emplace_back([&, t] {
+      MygramSearchResult_C* result = mygramclient_search_result_create();
+      const std::string bad_query = "golang" + std::string(1, static_cast<char>(t + 1));
+      char expected_error[32];
+      std::snprintf(expected_error, sizeof(expected_error), "control character 0x%02X", t + 1);
+      for (int call = 0; call < kPooledCheckCalls; ++call) {
+        if (call % 4 == 3) {
+          if (mygramclient_search_prepared_into(endpoint.client, prepared, bad_query.c_str(), 10, 0, result) == 0 ||
+              std::strstr(mygramclient_last_error(), expected_error) == nullptr ||
+              std::strcmp(mygramclient_get_last_error(endpoint.client), mygramclient_last_error()) != 0) {
+            std::fprintf(stderr, "pooled check: thread %d expected \"%s\", got \"%s\"\n", t, expected_error,
+                         mygramclient_last_error());
+            failures.fetch_add(1, std::memory_order_relaxed);
+          }
+          continue;
+        }
+        if (mygramclient_search_prepared_into(endpoint.client, prepared, "golang", 10, 0, result) != 0 ||
+            result->count != 10 || result->total_count != 100 || std::strcmp(result->primary_keys[0], "1000000") != 0) {
+          std::fprintf(stderr, "pooled check: thread %d got a wrong result: %s\n", t, mygramclient_last_error());
+          failures.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+      mygramclient_search_result_destroy(result);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  mygramclient_free_prepared_search(prepared);
+  return failures.load() == 0;
+}
+
+/**
+ * @brief Check the phase timing attached with collect_timing against the call latency
+ *
+ * The phases are consecutive, so they must add up to no more than the call
+ * as timed around it; a stale or out-of-order mark shows up as a phase
+ * longer than the call (a negative one wraps around). Sending and waiting
+ * for the reply always take time, and a reply spanning several recv() calls
+ * has a transfer phase.
+ */
+bool CheckTiming() {
+  bool ok = true;
+  auto check = [&ok](const char* name, const std::optional<ClientTiming>& timing, uint64_t latency_ns,
+                     bool multi_chunk) {
+    if (!timing) {
+      std::fprintf(stderr, "timing check: %s has no timing\n", name);
+      ok = false;
+      return;
+    }
+    const std::array<uint64_t, 5> phases = {timing->build_ns, timing->send_ns, timing->ttfb_ns, timing->transfer_ns,
+                                            timing->parse_ns};
+    uint64_t sum = 0;
+    bool in_order = true;
+    for (uint64_t phase : phases) {
+      in_order = in_order && phase <= latency_ns;
+      sum += phase;
+    }
+    if (!in_order || sum > latency_ns || timing->send_ns == 0 || timing->ttfb_ns == 0 ||
+        (multi_chunk && timing->transfer_ns == 0)) {
+      std::fprintf(stderr,
+                   "timing check: %s build=%llu send=%llu ttfb=%llu transfer=%llu parse=%llu ns, call took %llu ns\n",
+                   name, static_cast<unsigned long long>(timing->build_ns),
+                   static_cast<unsigned long long>(timing->send_ns), static_cast<unsigned long long>(timing->ttfb_ns),
+                   static_cast<unsigned long long>(timing->transfer_ns),
+                   static_cast<unsigned long long>(timing->parse_ns), static_cast<unsigned long long>(latency_ns));
+      ok = false;
+    }
+  };
+  auto timed_client = [](const CannedServer& server) {
+    ClientConfig config;
+    config.port = server.port();
+    config.collect_timing = true;
+    auto client = std::make_unique<MygramClient>(config);
+    if (auto conn = client->Connect(); !conn) {
+      std::fprintf(stderr, "connect failed: %s\n", conn.error().message().c_str());
+      std::exit(1);
+    }
+    return client;
+  };
+  auto elapsed_ns = [](std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+  };
+
+  for (int ids : {10, kMultiChunkIds}) {
+    CannedServer server(SearchReply(ids));
+    auto client = timed_client(server);
+    SearchResponse response;
+    for (int call = 0; call < kTimingCheckCalls && ok; ++call) {
+      const auto start = std::chrono::steady_clock::now();
+      const bool searched = static_cast<bool>(client->Search("articles", "golang", 100000, 0, response));
+      const uint64_t latency_ns = elapsed_ns(start);
+      if (!searched || response.results.size() != static_cast<size_t>(ids)) {
+        std::fprintf(stderr, "timing check: search of %d results failed\n", ids);
+        return false;
+      }
+      check(ids == kMultiChunkIds ? "search/multi_chunk" : "search", response.timing, latency_ns,
+            ids == kMultiChunkIds);
+    }
+  }
+
+  CannedServer server("OK COUNT 42\r\n");
+  auto client = timed_client(server);
+  for (int call = 0; call < kTimingCheckCalls && ok; ++call) {
+    const auto start = std::chrono::steady_clock::now();
+    auto counted = client->Count("articles", "golang");
+    const uint64_t latency_ns = elapsed_ns(start);
+    if (!counted || counted->count != 42) {
+      std::fprintf(stderr, "timing check: count failed\n");
+      return false;
+    }
+    check("count", counted->timing, latency_ns, false);
+  }
+  return ok;
+}
+
+/**
+ * @brief Execute a pipeline too large to write before reading any reply
+ *
+ * The loopback server stops reading commands while its replies go unread,
+ * so this only completes if the client reads while it is still writing.
+ */
+bool CheckLargePipeline() {
+  // COUNT ignores what follows the count, so padding makes the replies as large as the commands
+  CannedServer server("OK COUNT 1 " + std::string(kLargePipelineItemBytes, 'x') + "\r\n");
+  ClientConfig config;
+  config.port = server.port();
+  MygramClient client(config);
+  if (auto conn = client.Connect(); !conn) {
+    std::fprintf(stderr, "connect failed: %s\n", conn.error().message().c_str());
+    std::exit(1);
+  }
+
+  mygramdb::client::Pipeline pipeline;
+  const std::string query(kLargePipelineItemBytes, 'q');
+  for (size_t i = 0; i < kLargePipelineItems; ++i) {
+    pipeline.AddCount("articles", query);
+  }
+  if (auto status = client.Execute(pipeline); !status) {
+    std::fprintf(stderr, "large pipeline check: %s\n", status.error().message().c_str());
+    return false;
+  }
+  for (size_t i = 0; i < kLargePipelineItems; ++i) {
+    if (!pipeline[i].ok() || pipeline[i].count.count != 1) {
+      std::fprintf(stderr, "large pipeline check: item %zu: %s\n", i, pipeline[i].error.message().c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+struct BaselineEntry {
+  double ns_per_op;
+  double allocs_per_op;
+  double bytes_per_op;
+};
+
+std::map<std::string, BaselineEntry> ReadBaseline(const std::string& path) {
+  std::map<std::string, BaselineEntry> baseline;
+  std::ifstream in(path);
+  if (!in) {
+    std::fprintf(stderr, "cannot read baseline %s\n", path.c_str());
+    std::exit(2);
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string name;
+    BaselineEntry entry{};
+    if (fields >> name >> entry.ns_per_op >> entry.allocs_per_op >> entry.bytes_per_op) {
+      baseline[name] = entry;
+    }
+  }
+  return baseline;
+}
+
+std::vector<Case> BuildCases(std::vector<std::unique_ptr<Endpoint>>& endpoints,
+                             std::vector<std::unique_ptr<CEndpoint>>& c_endpoints) {
+  std::vector<Case> cases;
+  auto add = [&](std::string name, std::function<void()> run) {
+    cases.push_back({std::move(name), false, std::move(run)});
+  };
+  auto add_roundtrip = [&](std::string name, std::function<void()> run) {
+    cases.push_back({std::move(name), true, std::move(run)});
+  };
+  auto endpoint = [&](std::string reply) -> MygramClient& {
+    endpoints.push_back(std::make_unique<Endpoint>(std::move(reply)));
+    return *endpoints.back()->client;
+  };
+  auto c_endpoint = [&](std::string reply, size_t pool_size = 0) -> MygramClient_C* {
+    c_endpoints.push_back(std::make_unique<CEndpoint>(std::move(reply), pool_size));
+    return c_endpoints.back()->client;
+  };
+
+  // Validation and escaping (one ScanTerm pass per argument)
+  static const std::string kShortQuery = "golang tutorial";
+  static const std::string kQuotedQuery = R"(say "hello" to C:\path and 'quotes')";
+  static std::string long_query;
+  for (int i = 0; i < 64; ++i) {
+    long_query += "機械学習 deep learning ";
+  }
+  add("scan/short", [] { Sink(ScanTerm(kShortQuery).escapes); });
+  add("scan/quoted", [] { Sink(ScanTerm(kQuotedQuery).escapes); });
+  add("scan/long_cjk", [] { Sink(ScanTerm(long_query).escapes); });
+
+  // Command building: PrepareSearch validates and serializes a search shape
+  add("build/prepare_simple", [] { Sink(MygramClient::PrepareSearch("articles")->table().size()); });
+  static const std::vector<std::string> kAndTerms = {"tutorial", "beginner guide", "2024"};
+  static const std::vector<std::string> kNotTerms = {"deprecated", "old"};
+  static const std::vector<std::pair<std::string, std::string>> kFilters = {
+      {"status", "1"}, {"lang", "en"}, {"category", "programming"}};
+  add("build/prepare_full", [] {
+    Sink(MygramClient::PrepareSearch("articles", kAndTerms, kNotTerms, kFilters, "created_at", false)->table().size());
+  });
+
+  // Replies (command build + loopback round trip + parse)
+  MygramClient& floor_client = endpoint("OK COUNT 0\r\n");
+  add_roundtrip("roundtrip/count_floor", [&floor_client] { Sink(floor_client.Count("articles", "x")->count); });
+  for (int ids : {0, 10, 100, 1000}) {
+    MygramClient& client = endpoint(SearchReply(ids));
+    add_roundtrip("search/results_" + std::to_string(ids),
+                  [&client] { Sink(client.Search("articles", "golang", 1000)->results.size()); });
+    auto response = std::make_shared<SearchResponse>();
+    add_roundtrip("search_reuse/results_" + std::to_string(ids), [&client, response] {
+      (void)client.Search("articles", "golang", 1000, 0, *response);
+      Sink(response->results.size());
+    });
+    auto view = std::make_shared<mygramdb::client::SearchResponseView>();
+    add_roundtrip("search_view/results_" + std::to_string(ids), [&client, view] {
+      (void)client.Search("articles", "golang", 1000, 0, *view);
+      Sink(view->primary_keys.size());
+    });
+    MygramClient_C* c_client = c_endpoint(SearchReply(ids));
+    add_roundtrip("capi_search/results_" + std::to_string(ids), [c_client] {
+      MygramSearchResult_C* result = nullptr;
+      if (mygramclient_search(c_client, "articles", "golang", 1000, 0, &result) == 0) {
+        Sink(result->count);
+        mygramclient_free_search_result(result);
+      }
+    });
+    MygramClient_C* c_reuse_client = c_endpoint(SearchReply(ids));
+    std::shared_ptr<MygramSearchResult_C> handle(mygramclient_search_result_create(),
+                                                 mygramclient_search_result_destroy);
+    add_roundtrip("capi_search_reuse/results_" + std::to_string(ids), [c_reuse_client, handle] {
+      if (mygramclient_search_into(c_reuse_client, "articles", "golang", 1000, 0, handle.get()) == 0) {
+        Sink(handle->count);
+      }
+    });
+  }
+  // The same through a thread-safe handle: each call leases its connection from the pool
+  MygramClient_C* pooled_client = c_endpoint(SearchReply(10), 4);
+  std::shared_ptr<MygramSearchResult_C> pooled_handle(mygramclient_search_result_create(),
+                                                      mygramclient_search_result_destroy);
+  add_roundtrip("capi_pooled_search_reuse/results_10", [pooled_client, pooled_handle] {
+    if (mygramclient_search_into(pooled_client, "articles", "golang", 1000, 0, pooled_handle.get()) == 0) {
+      Sink(pooled_handle->count);
+    }
+  });
+  // Ten 10-result searches per op in one write (compare with 10x search_reuse/results_10)
+  constexpr size_t kBatch = 10;
+  MygramClient& pipeline_client = endpoint(SearchReply(10));
+  auto pipeline = std::make_shared<mygramdb::client::Pipeline>();
+  add_roundtrip("pipeline/search_10x10", [&pipeline_client, pipeline] {
+    pipeline->Clear();
+    for (size_t i = 0; i < kBatch; ++i) {
+      pipeline->AddSearch("articles", "golang", 1000);
+    }
+    (void)pipeline_client.Execute(*pipeline);
+    Sink((*pipeline)[kBatch - 1].search.results.size());
+  });
+  // The same ten searches submitted without blocking, replies polled into one reused result
+  MygramClient& async_client = endpoint(SearchReply(10));
+  auto polled = std::make_shared<mygramdb::client::AsyncResult>();
+  add_roundtrip("async_search/10x10", [&async_client, polled] {
+    for (size_t i = 0; i < kBatch; ++i) {
+      (void)async_client.SubmitSearch("articles", "golang", 1000);
+    }
+    for (size_t done = 0; done < kBatch;) {
+      (void)async_client.ProcessIo();  // Spins on EAGAIN: the loopback reply is microseconds away
+      while (async_client.PollResult(*polled)) {
+        ++done;
+      }
+    }
+    Sink(polled->search.results.size());
+  });
+  MygramClient_C* batch_client = c_endpoint(SearchReply(10));
+  add_roundtrip("capi_search_batch/10x10", [batch_client] {
+    std::array<MygramSearchRequest_C, kBatch> requests;
+    requests.fill({"articles", "golang", 1000, 0});
+    std::array<MygramSearchResult_C*, kBatch> results{};
+    std::array<int, kBatch> statuses{};
+    if (mygramclient_search_batch(batch_client, requests.data(), kBatch, results.data(), statuses.data()) == 0) {
+      Sink(results[kBatch - 1]->count);
+    }
+    for (auto* result : results) {
+      mygramclient_free_search_result(result);
+    }
+  });
+
+  MygramClient& count_client = endpoint("OK COUNT 123456\r\n");
+  add_roundtrip("count/full_query", [&count_client] {
+    Sink(count_client.Count("articles", "golang", kAndTerms, kNotTerms, kFilters)->count);
+  });
+  for (int fields : {4, 32}) {
+    MygramClient& client = endpoint("OK DOC 1000001" + DocFields(fields) + "\r\n");
+    add_roundtrip("get/fields_" + std::to_string(fields),
+                  [&client] { Sink(client.Get("articles", "1000001")->fields.size()); });
+    MygramClient_C* c_client = c_endpoint("OK DOC 1000001" + DocFields(fields) + "\r\n");
+    add_roundtrip("capi_get/fields_" + std::to_string(fields), [c_client] {
+      MygramDocument_C* doc = nullptr;
+      if (mygramclient_get(c_client, "articles", "1000001", &doc) == 0) {
+        Sink(doc->field_count);
+        mygramclient_free_document(doc);
+      }
+    });
+    MygramClient_C* c_reuse_client = c_endpoint("OK DOC 1000001" + DocFields(fields) + "\r\n");
+    std::shared_ptr<MygramDocument_C> handle(mygramclient_document_create(), mygramclient_document_destroy);
+    add_roundtrip("capi_get_reuse/fields_" + std::to_string(fields), [c_reuse_client, handle] {
+      if (mygramclient_get_into(c_reuse_client, "articles", "1000001", handle.get()) == 0) {
+        Sink(handle->field_count);
+      }
+    });
+  }
+  MygramClient& info_client = endpoint(InfoReply());
+  add_roundtrip("info/sections", [&info_client] { Sink(info_client.Info()->tables.size()); });
+
+  // Reply parsing alone, into reused responses (compare with the reply cases above)
+  for (int ids : {0, 10, 100, 1000}) {
+    auto reply = std::make_shared<std::string>(SearchReply(ids));
+    reply->resize(reply->size() - 2);  // Parsers take the reply without its \r\n
+    auto response = std::make_shared<SearchResponse>();
+    add("parse/search_" + std::to_string(ids), [reply, response] {
+      (void)ParseSearchReply(*reply, *response);
+      Sink(response->results.size());
+    });
+    auto view = std::make_shared<mygramdb::client::SearchResponseView>();
+    add("parse/search_view_" + std::to_string(ids), [reply, view] {
+      (void)ParseSearchReply(*reply, *view);
+      Sink(view->primary_keys.size());
+    });
+  }
+  static const std::string kCountDebugReply =
+      "OK COUNT 123456 DEBUG query_time=1.234 index_time=0.456 filter_time=0.078 terms=3 ngrams=12 "
+      "candidates=45678 after_intersection=2345 after_not=2300 after_filters=1234 final=1234 optimization=none";
+  auto count = std::make_shared<CountResponse>();
+  add("parse/count_debug", [count] {
+    (void)ParseCountReply(kCountDebugReply, *count);
+    Sink(count->count);
+  });
+  for (int fields : {4, 32}) {
+    auto reply = std::make_shared<std::string>("OK DOC 1000001" + DocFields(fields));
+    auto doc = std::make_shared<Document>();
+    add("parse/get_fields_" + std::to_string(fields), [reply, doc] {
+      (void)ParseGetReply(*reply, *doc);
+      Sink(doc->fields.size());
+    });
+  }
+  static const std::string kInfoReply = InfoReply();
+  add("parse/info", [] {
+    ServerInfo info;
+    (void)ParseInfoReply(kInfoReply, info);
+    Sink(info.tables.size());
+  });
+
+  // Document field parsing alone
+  for (int fields : {4, 32}) {
+    auto reply = std::make_shared<std::string>("OK DOC 1000001" + DocFields(fields));
+    auto parsed = std::make_shared<DocumentFields>();
+    add("doc_fields/assign_" + std::to_string(fields), [reply, parsed] {
+      parsed->Assign(*reply, 14);
+      Sink(parsed->size());
+    });
+  }
+
+  // Search expressions
+  static const std::string kSimpleExpression = "+golang tutorial";
+  static const std::string kComplexExpression = R"(+golang +(tutorial OR guide) -old -"deprecated api" "exact phrase")";
+  add("expression/parse_simple", [] { Sink(ParseSearchExpression(kSimpleExpression)->required_terms.size()); });
+  add("expression/parse_complex", [] { Sink(ParseSearchExpression(kComplexExpression)->required_terms.size()); });
+  add("expression/convert_complex", [] { Sink(ConvertSearchExpression(kComplexExpression)->size()); });
+
+  // Text normalization and n-grams
+  static const std::string kAsciiText = "The Quick Brown Fox Jumps Over The Lazy Dog 0123456789";
+  static const std::string kCjkText = "ＭｙｇｒａｍＤＢは全文検索エンジンです。機械学習と自然言語処理";
+  add("normalize/ascii_lower", [] { Sink(NormalizeText(kAsciiText, true, "narrow", true).size()); });
+  add("normalize/cjk_narrow", [] { Sink(NormalizeText(kCjkText).size()); });
+  add("ngrams/ascii_bigram", [] { Sink(GenerateNgrams(kAsciiText, 2).size()); });
+  add("ngrams/cjk_unigram", [] { Sink(GenerateNgrams(kCjkText, 1).size()); });
+  add("ngrams/hybrid_mixed", [] { Sink(GenerateHybridNgrams(kCjkText + kAsciiText).size()); });
+
+  // CIDR matching
+  static const std::vector<std::string> kCidrStrings = {"10.0.0.0/8",     "172.16.0.0/12",   "192.168.0.0/16",
+                                                        "100.64.0.0/10",  "203.0.113.0/24",  "198.51.100.0/24",
+                                                        "192.0.2.0/24",   "127.0.0.0/8"};
+  static std::vector<CIDR> parsed_cidrs;
+  for (const auto& cidr : kCidrStrings) {
+    parsed_cidrs.push_back(*CIDR::Parse(cidr));
+  }
+  static const std::string kClientIp = "127.0.0.1";  // Last entry: worst case
+  add("cidr/parse", [] { Sink(static_cast<size_t>(CIDR::Parse("192.168.100.0/22")->prefix_length)); });
+  add("cidr/parse_ipv4", [] { Sink(*ParseIPv4(kClientIp)); });
+  add("cidr/allowed_parsed_8", [] { Sink(static_cast<size_t>(IsIPAllowed(kClientIp, parsed_cidrs))); });
+  add("cidr/allowed_strings_8", [] { Sink(static_cast<size_t>(IsIPAllowed(kClientIp, kCidrStrings))); });
+
+  return cases;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint64_t iterations = kDefaultIterations;
+  std::string filter;
+  std::string baseline_path;
+  std::string write_path;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--iterations") == 0) {
+      iterations = std::strtoull(argv[i + 1], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--filter") == 0) {
+      filter = argv[i + 1];
+    } else if (std::strcmp(argv[i], "--baseline") == 0) {
+      baseline_path = argv[i + 1];
+    } else if (std::strcmp(argv[i], "--write-baseline") == 0) {
+      write_path = argv[i + 1];
+    }
+  }
+  if (iterations < kRoundtripDivisor) {
+    iterations = kRoundtripDivisor;
+  }
+
+  std::map<std::string, BaselineEntry> baseline;
+  if (!baseline_path.empty()) {
+    baseline = ReadBaseline(baseline_path);
+  }
+
+  if (!CheckPooledThreads()) {
+    std::printf("pooled handle check failed\n");
+    return 1;
+  }
+  if (!CheckTiming()) {
+    std::printf("phase timing check failed\n");
+    return 1;
+  }
+  if (!CheckLargePipeline()) {
+    std::printf("large pipeline check failed\n");
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<Endpoint>> endpoints;
+  std::vector<std::unique_ptr<CEndpoint>> c_endpoints;
+  std::vector<Case> cases = BuildCases(endpoints, c_endpoints);
+
+  std::ostringstream written;
+  written << "# client_micro_bench baseline: name ns/op allocs/op B/op\n"
+          << "# Allocation columns are checked by --baseline; ns/op is informational\n";
+  int regressions = 0;
+  for (const auto& bench_case : cases) {
+    if (!filter.empty() && bench_case.name.find(filter) == std::string::npos) {
+      continue;
+    }
+    const uint64_t case_iterations = bench_case.roundtrip ? iterations / kRoundtripDivisor : iterations;
+    Measure(case_iterations / 10 + 1, bench_case.run);  // Warm up buffers and caches
+    const BenchResult result = Measure(case_iterations, bench_case.run);
+    PrintResult(bench_case.name.c_str(), result);
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "%s %.1f %.2f %.1f\n", bench_case.name.c_str(), result.ns_per_op,
+                  result.allocs_per_op, result.bytes_per_op);
+    written << line;
+
+    if (baseline_path.empty()) {
+      continue;
+    }
+    auto expected = baseline.find(bench_case.name);
+    if (expected == baseline.end()) {
+      std::printf("  (not in baseline)\n");
+      continue;
+    }
+    const BaselineEntry& entry = expected->second;
+    if (result.allocs_per_op > entry.allocs_per_op + kAllocationTolerance ||
+        result.bytes_per_op > (entry.bytes_per_op * (1.0 + kAllocationTolerance)) + 1.0) {
+      std::printf("  REGRESSION: baseline %.2f allocs/op %.1f B/op\n", entry.allocs_per_op, entry.bytes_per_op);
+      ++regressions;
+    }
+    if (entry.ns_per_op > 0 && result.ns_per_op > entry.ns_per_op * kSlowerRatioToReport) {
+      std::printf("  slower: %.2fx baseline ns/op\n", result.ns_per_op / entry.ns_per_op);
+    }
+  }
+
+  if (!write_path.empty()) {
+    std::ofstream out(write_path);
+    out << written.str();
+    if (!out) {
+      std::fprintf(stderr, "cannot write baseline %s\n", write_path.c_str());
+      return 2;
+    }
+  }
+  if (regressions > 0) {
+    std::printf("%d case(s) allocate more than the baseline\n", regressions);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file heavy_hitters_bench.cpp
+ * @brief Cost and accuracy of heavy-hitter tracking
+ *
+ * Feeds a Zipf-distributed stream of SEARCH commands to HeavyHitters from
+ * one thread and from several threads sharing a tracker, then checks the
+ * reported top K against the exact counts. Also checks that Reset() while
+ * other threads record leaves the sketch and the totals in agreement.
+ *
+ * Usage: heavy_hitters_bench [iterations]
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "mygramdb/heavy_hitters.h"
+
+using mygramdb::bench::Measure;
+using mygramdb::bench::PrintResult;
+using mygramdb::client::HeavyHitterOptions;
+using mygramdb::client::HeavyHitters;
+
+namespace {
+
+constexpr uint64_t kDefaultIterations = 1000000;
+constexpr size_t kDistinctQueries = 100000;
+constexpr double kZipfExponent = 1.1;
+constexpr int kThreads = 4;
+constexpr size_t kTopK = 16;
+
+/**
+ * @brief Query ranks drawn from a Zipf distribution (rank 0 most frequent)
+ */
+std::vector<uint32_t> ZipfStream(size_t length, uint32_t seed) {
+  std::vector<double> weights(kDistinctQueries);
+  for (size_t rank = 0; rank < kDistinctQueries; ++rank) {
+    weights[rank] = 1.0 / std::pow(static_cast<double>(rank + 1), kZipfExponent);
+  }
+  std::discrete_distribution<uint32_t> distribution(weights.begin(), weights.end());
+  std::mt19937 rng(seed);
+
+  std::vector<uint32_t> stream(length);
+  for (auto& rank : stream) {
+    rank = distribution(rng);
+  }
+  return stream;
+}
+
+std::string QueryFor(uint32_t rank) { return "SEARCH articles term" + std::to_string(rank) + " LIMIT 20"; }
+
+/**
+ * @brief Check that the reported top K are the K most frequent ranks
+ */
+bool CheckTop(const HeavyHitters& tracker, const std::vector<uint64_t>& exact) {
+  const auto snapshot = tracker.Snapshot();
+  if (snapshot.top.size() != kTopK) {
+    std::fprintf(stderr, "expected %zu heavy hitters, got %zu\n", kTopK, snapshot.top.size());
+    return false;
+  }
+  for (size_t i = 0; i < kTopK; ++i) {
+    const auto& hitter = snapshot.top[i];
+    if (hitter.command != QueryFor(static_cast<uint32_t>(i)) || hitter.count < exact[i]) {
+      std::fprintf(stderr, "rank %zu: got \"%s\" x%llu, expected \"%s\" x%llu\n", i, hitter.command.c_str(),
+                   static_cast<unsigned long long>(hitter.count), QueryFor(static_cast<uint32_t>(i)).c_str(),
+                   static_cast<unsigned long long>(exact[i]));
+      return false;
+    }
+  }
+  std::printf("top-1 \"%s\": estimated %llu, exact %llu, %.1f%% of latency\n", snapshot.top[0].command.c_str(),
+              static_cast<unsigned long long>(snapshot.top[0].count), static_cast<unsigned long long>(exact[0]),
+              snapshot.top[0].latency_share * 100.0);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : kDefaultIterations;
+
+  std::vector<std::string> queries(kDistinctQueries);
+  for (uint32_t rank = 0; rank < kDistinctQueries; ++rank) {
+    queries[rank] = QueryFor(rank);
+  }
+
+  HeavyHitterOptions options;
+  options.top_k = kTopK;
+
+  {
+    const auto stream = ZipfStream(iterations, 1);
+    std::vector<uint64_t> exact(kDistinctQueries);
+    HeavyHitters tracker(options);
+    size_t next = 0;
+    PrintResult("record/1-thread", Measure(iterations, [&] {
+                  const uint32_t rank = stream[next++];
+                  ++exact[rank];
+                  tracker.Record(queries[rank], 20000 + rank);
+                }));
+    if (!CheckTop(tracker, exact)) {
+      return 1;
+    }
+  }
+
+  {
+    std::vector<std::vector<uint32_t>> streams;
+    std::vector<uint64_t> exact(kDistinctQueries);
+    for (int t = 0; t < kThreads; ++t) {
+      streams.push_back(ZipfStream(iterations, static_cast<uint32_t>(t + 2)));
+      for (uint32_t rank : streams.back()) {
+        ++exact[rank];
+      }
+    }
+
+    HeavyHitters tracker(options);
+    auto result = Measure(1, [&] {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+          for (uint32_t rank : streams[t]) {
+            tracker.Record(queries[rank], 20000 + rank);
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    });
+    // Wall time per record across all threads
+    const double records = static_cast<double>(iterations * kThreads);
+    result.ns_per_op /= records;
+    result.allocs_per_op /= records;
+    result.bytes_per_op /= records;
+    PrintResult("record/4-threads", result);
+    if (!CheckTop(tracker, exact)) {
+      return 1;
+    }
+  }
+
+  {
+    // Every thread cycles through the same top_k equally hot commands: all
+    // stay admitted, so recording them must not fall back to the mutex even
+    // where their hashes share a slot of the per-thread admitted table
+    HeavyHitters tracker(options);
+    auto result = Measure(1, [&] {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+          for (uint64_t i = 0; i < iterations; ++i) {
+            const auto rank = static_cast<uint32_t>(i % kTopK);
+            tracker.Record(queries[rank], 20000 + rank);
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    });
+    const double records = static_cast<double>(iterations * kThreads);
+    result.ns_per_op /= records;
+    result.allocs_per_op /= records;
+    result.bytes_per_op /= records;
+    PrintResult("record/4-threads-hot-set", result);
+    if (tracker.Snapshot().top.size() != kTopK) {
+      std::fprintf(stderr, "expected all %zu hot commands to be reported\n", kTopK);
+      return 1;
+    }
+  }
+
+  {
+    // One command only, with Reset() running throughout: every record bumps
+    // its sketch cells and the totals alike, so once recording has stopped
+    // its estimate must equal the totals exactly. A reset half-applied to a
+    // shard shows up as a mismatch.
+    HeavyHitters tracker(options);
+    std::atomic<bool> recording{true};
+    std::thread resetter([&] {
+      while (recording.load(std::memory_order_relaxed)) {
+        tracker.Reset();
+      }
+    });
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&] {
+        for (uint64_t i = 0; i < iterations; ++i) {
+          tracker.Record(queries[0], 20000);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    recording.store(false, std::memory_order_relaxed);
+    resetter.join();
+
+    const auto snapshot = tracker.Snapshot();
+    const bool agree = snapshot.top.empty()
+                           ? snapshot.total_requests == 0
+                           : snapshot.top.size() == 1 && snapshot.top[0].count == snapshot.total_requests &&
+                                 snapshot.top[0].latency_ns == snapshot.total_latency_ns;
+    if (!agree) {
+      std::fprintf(stderr, "reset check: total %llu requests, top %zu entries (first x%llu)\n",
+                   static_cast<unsigned long long>(snapshot.total_requests), snapshot.top.size(),
+                   static_cast<unsigned long long>(snapshot.top.empty() ? 0 : snapshot.top[0].count));
+      return 1;
+    }
+    std::printf("reset check: %llu requests after the last reset\n",
+                static_cast<unsigned long long>(snapshot.total_requests));
+  }
+
+  return 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file pmr_alloc_bench.cpp
+ * @brief Heap allocations per call: std vs. std::pmr Search/Count/Get
+ *
+ * Runs each API against a loopback server returning a canned reply and
+ * reports global-heap allocations per call. The pmr variants use a
+ * monotonic arena over a fixed static buffer that is reset after every call,
+ * the way a per-request arena would be.
+ *
+ * Usage: pmr_alloc_bench [iterations]
+ */
+
+#include <array>
+#include <cstdlib>
+#include <string>
+
+#include "bench_util.h"
+#include "mygramdb/mygramclient.h"
+
+using mygramdb::bench::CannedServer;
+using mygramdb::bench::Measure;
+using mygramdb::bench::PrintResult;
+using mygramdb::client::ClientConfig;
+using mygramdb::client::MygramClient;
+
+namespace {
+
+constexpr uint64_t kDefaultIterations = 20000;
+constexpr int kResultIds = 100;
+constexpr size_t kArenaBytes = 256 * 1024;
+
+std::string SearchReply() {
+  std::string reply = "OK RESULTS 5000";
+  for (int i = 0; i < kResultIds; ++i) {
+    reply += " " + std::to_string(1000000 + i);
+  }
+  return reply + "\r\n";
+}
+
+MygramClient Connect(uint16_t port) {
+  ClientConfig config;
+  config.port = port;
+  MygramClient client(config);
+  if (auto conn = client.Connect(); !conn) {
+    std::fprintf(stderr, "connect failed: %s\n", conn.error().message().c_str());
+    std::exit(1);
+  }
+  return client;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : kDefaultIterations;
+
+#ifndef MYGRAMCLIENT_HAS_PMR
+  std::fprintf(stderr, "std::pmr is not available in this standard library\n");
+  return 0;
+#else
+  const std::vector<std::string> and_terms = {"tutorial"};
+  const std::vector<std::pair<std::string, std::string>> filters = {{"status", "1"}};
+
+  // Arena storage is a static buffer (too large for the stack); nothing
+  // reaches the global heap unless a call outgrows it
+  static std::array<std::byte, kArenaBytes> arena_storage;
+
+  {
+    CannedServer server(SearchReply());
+    MygramClient client = Connect(server.port());
+
+    PrintResult("search/std", Measure(iterations, [&] {
+                  auto resp = client.Search("articles", "hello world", 100, 0, and_terms, {}, filters);
+                  if (!resp || resp->results.size() != kResultIds) {
+                    std::abort();
+                  }
+                }));
+
+    PrintResult("search/pmr", Measure(iterations, [&] {
+                  std::pmr::monotonic_buffer_resource arena(arena_storage.data(), arena_storage.size(),
+                                                            std::pmr::null_memory_resource());
+                  auto resp = client.Search(&arena, "articles", "hello world", 100, 0, and_terms, {}, filters);
+                  if (!resp || resp->primary_keys.size() != kResultIds) {
+                    std::abort();
+                  }
+                }));
+  }
+
+  {
+    CannedServer server("OK COUNT 5000\r\n");
+    MygramClient client = Connect(server.port());
+
+    PrintResult("count/std", Measure(iterations, [&] {
+                  auto resp = client.Count("articles", "hello world", and_terms, {}, filters);
+                  if (!resp || resp->count != 5000) {
+                    std::abort();
+                  }
+                }));
+
+    PrintResult("count/pmr", Measure(iterations, [&] {
+                  std::pmr::monotonic_buffer_resource arena(arena_storage.data(), arena_storage.size(),
+                                                            std::pmr::null_memory_resource());
+                  auto resp = client.Count(&arena, "articles", "hello world", and_terms, {}, filters);
+                  if (!resp || resp->count != 5000) {
+                    std::abort();
+                  }
+                }));
+  }
+
+  {
+    CannedServer server("OK DOC 1000001 status=1 category=news created_at=1700000000 author_id=42\r\n");
+    MygramClient client = Connect(server.port());
+
+    PrintResult("get/std", Measure(iterations, [&] {
+                  auto doc = client.Get("articles", "1000001");
+                  if (!doc || doc->fields.size() != 4) {
+                    std::abort();
+                  }
+                }));
+
+    PrintResult("get/pmr", Measure(iterations, [&] {
+                  std::pmr::monotonic_buffer_resource arena(arena_storage.data(), arena_storage.size(),
+                                                            std::pmr::null_memory_resource());
+                  auto doc = client.Get(&arena, "articles", "1000001");
+                  if (!doc || doc->fields.size() != 4) {
+                    std::abort();
+                  }
+                }));
+  }
+
+  return 0;
+#endif
+}
@@ -0,0 +1,216 @@
+/**
+ * @file query_scan_bench.cpp
+ * @brief Query validation/escaping: differential check and throughput
+ *
+ * First checks every ScanTerm kernel against the byte-by-byte reference
+ * (std::iscntrl plus the quote/escape rules of the original
+ * EscapeQueryString) over random inputs, and checks complete COUNT commands
+ * sent by the client against commands built by that reference. Exits
+ * non-zero on any mismatch. Then reports ns/op for classifying short, long
+ * ASCII and long CJK inputs with each kernel, next to the reference.
+ * With --check it stops after the checks (make bench-check runs that).
+ *
+ * Usage: query_scan_bench [iterations | --check]
+ */
+
+#include <cctype>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "mygramdb/mygramclient.h"
+#include "utils/query_scan.h"
+
+using mygramdb::bench::CannedServer;
+using mygramdb::bench::Measure;
+using mygramdb::bench::PrintResult;
+using mygramdb::client::ClientConfig;
+using mygramdb::client::MygramClient;
+using mygramdb::utils::ScanTerm;
+using mygramdb::utils::ScanTermAvx2;
+using mygramdb::utils::ScanTermKernel;
+using mygramdb::utils::ScanTermScalar;
+using mygramdb::utils::ScanTermSse2;
+using mygramdb::utils::TermScan;
+
+namespace {
+
+constexpr uint64_t kDefaultIterations = 200000;
+constexpr int kRandomCases = 200000;
+constexpr int kCommandCases = 2000;
+constexpr size_t kMaxRandomLen = 150;
+
+// Reference: the original per-byte validation
+size_t ReferenceFirstControl(std::string_view str) {
+  for (size_t i = 0; i < str.size(); ++i) {
+    if (std::iscntrl(static_cast<unsigned char>(str[i])) != 0) {
+      return i;
+    }
+  }
+  return TermScan::kNoControl;
+}
+
+// Reference: the original EscapeQueryString
+std::string ReferenceEscape(std::string_view str) {
+  bool needs_quotes = false;
+  for (char character : str) {
+    if (character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '"' ||
+        character == '\'') {
+      needs_quotes = true;
+      break;
+    }
+  }
+  if (!needs_quotes) {
+    return std::string(str);
+  }
+  std::string escaped = "\"";
+  for (char character : str) {
+    if (character == '"' || character == '\\') {
+      escaped += '\\';
+    }
+    escaped += character;
+  }
+  return escaped + "\"";
+}
+
+// Random string drawn mostly from characters the kernels classify
+std::string RandomTerm(std::mt19937& rng, size_t max_len, bool allow_control) {
+  static const std::string kPlain = "abcXYZ019-_.";
+  static const std::string kSpecial = " \"'\\";
+  static const std::string kControl = std::string("\t\n\r\x01\x1f\x7f", 6) + std::string(1, '\0');
+  static const std::string kCjk = "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e";  // UTF-8, bytes >= 0x80
+  std::uniform_int_distribution<size_t> len_dist(0, max_len);
+  std::uniform_int_distribution<int> kind_dist(0, 99);
+  std::string term;
+  size_t len = len_dist(rng);
+  while (term.size() < len) {
+    int kind = kind_dist(rng);
+    if (kind < 70) {
+      term += kPlain[rng() % kPlain.size()];
+    } else if (kind < 85) {
+      term += kCjk.substr((rng() % 3) * 3, 3);
+    } else if (kind < 98 || !allow_control) {
+      term += kSpecial[rng() % kSpecial.size()];
+    } else {
+      term += kControl[rng() % kControl.size()];
+    }
+  }
+  return term;
+}
+
+bool CheckKernel(const char* name, TermScan (*kernel)(std::string_view), std::string_view term) {
+  TermScan scan = kernel(term);
+  size_t expected_control = ReferenceFirstControl(term);
+  bool ok = scan.first_control == expected_control;
+  if (ok && !scan.HasControl()) {
+    bool expected_quoting = ReferenceEscape(term) != term;
+    size_t expected_escapes = 0;
+    for (char character : term) {
+      expected_escapes += static_cast<size_t>(character == '"' || character == '\\');
+    }
+    ok = scan.needs_quoting == expected_quoting && scan.escapes == expected_escapes;
+  }
+  if (!ok) {
+    std::fprintf(stderr, "%s mismatch on %zu-byte input (first_control=%zu, expected %zu)\n", name, term.size(),
+                 scan.first_control, expected_control);
+  }
+  return ok;
+}
+
+MygramClient Connect(uint16_t port) {
+  ClientConfig config;
+  config.port = port;
+  MygramClient client(config);
+  if (auto conn = client.Connect(); !conn) {
+    std::fprintf(stderr, "connect failed: %s\n", conn.error().message().c_str());
+    std::exit(1);
+  }
+  return client;
+}
+
+bool RunDifferentialChecks() {
+  std::mt19937 rng(42);  // NOLINT(cert-msc32-c,cert-msc51-cpp) - Reproducible inputs
+  for (int i = 0; i < kRandomCases; ++i) {
+    std::string term = RandomTerm(rng, kMaxRandomLen, true);
+    if (!CheckKernel("scalar", ScanTermScalar, term) || !CheckKernel("sse2", ScanTermSse2, term) ||
+        !CheckKernel("avx2", ScanTermAvx2, term) || !CheckKernel("dispatch", ScanTerm, term)) {
+      return false;
+    }
+  }
+
+  // End to end: the command the server receives matches the reference build
+  CannedServer server("OK COUNT 1\r\n");
+  MygramClient client = Connect(server.port());
+  for (int i = 0; i < kCommandCases; ++i) {
+    std::string query = RandomTerm(rng, kMaxRandomLen, false);
+    std::vector<std::string> and_terms = {RandomTerm(rng, 40, false)};
+    std::vector<std::string> not_terms = {RandomTerm(rng, 40, false)};
+    std::vector<std::pair<std::string, std::string>> filters = {{"status", RandomTerm(rng, 40, false)}};
+    if (auto resp = client.Count("articles", query, and_terms, not_terms, filters); !resp) {
+      std::fprintf(stderr, "count failed: %s\n", resp.error().message().c_str());
+      return false;
+    }
+    std::string expected = "COUNT articles " + ReferenceEscape(query) + " AND " + ReferenceEscape(and_terms[0]) +
+                           " NOT " + ReferenceEscape(not_terms[0]) + " FILTER status = " +
+                           ReferenceEscape(filters[0].second);
+    if (server.last_request() != expected) {
+      std::fprintf(stderr, "command mismatch:\n  got:      %s\n  expected: %s\n", server.last_request().c_str(),
+                   expected.c_str());
+      return false;
+    }
+  }
+
+  // Rejected input reports the first control character
+  std::string bad(100, 'a');
+  bad[70] = '\x02';
+  bad[40] = '\x01';
+  auto rejected = client.Count("articles", bad);
+  if (rejected || rejected.error().message().find("0x01") == std::string::npos) {
+    std::fprintf(stderr, "control character was not reported\n");
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool check_only = argc > 1 && std::strcmp(argv[1], "--check") == 0;
+  uint64_t iterations = argc > 1 && !check_only ? std::strtoull(argv[1], nullptr, 10) : kDefaultIterations;
+
+  if (!RunDifferentialChecks()) {
+    return 1;
+  }
+  std::printf("differential check passed (dispatching to %s)\n", ScanTermKernel());
+  if (check_only) {
+    return 0;
+  }
+
+  std::string cjk;
+  while (cjk.size() < 600) {
+    cjk += "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\xa4\x9c\xe7\xb4\xa2 ";
+  }
+  const std::vector<std::pair<const char*, std::string>> inputs = {
+      {"short", "tutorial"},
+      {"ascii-256", std::string(256, 'x')},
+      {"cjk-600", cjk},
+  };
+
+  for (const auto& [label, input] : inputs) {
+    std::string_view view = input;
+    volatile size_t sink = 0;
+    PrintResult((std::string("reference/") + label).c_str(), Measure(iterations, [&] {
+                  sink = sink + ReferenceFirstControl(view) + ReferenceEscape(view).size();
+                }));
+    PrintResult((std::string("scalar/") + label).c_str(),
+                Measure(iterations, [&] { sink = sink + ScanTermScalar(view).escapes; }));
+    PrintResult((std::string("sse2/") + label).c_str(),
+                Measure(iterations, [&] { sink = sink + ScanTermSse2(view).escapes; }));
+    PrintResult((std::string("avx2/") + label).c_str(),
+                Measure(iterations, [&] { sink = sink + ScanTermAvx2(view).escapes; }));
+  }
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file response_reuse_bench.cpp
+ * @brief Heap allocations per call: by-value responses vs. reused responses
+ *
+ * Runs Search/Count/Get against a loopback server returning a canned reply,
+ * once returning a fresh response per call and once refilling a response
+ * object owned by the caller. The C API's reusable search result handle is
+ * measured as well.
+ *
+ * Usage: response_reuse_bench [iterations]
+ */
+
+#include <cstdlib>
+#include <string>
+
+#include "bench_util.h"
+#include "mygramdb/mygramclient.h"
+#include "mygramdb/mygramclient_c.h"
+
+using mygramdb::bench::CannedServer;
+using mygramdb::bench::Measure;
+using mygramdb::bench::PrintResult;
+using mygramdb::client::ClientConfig;
+using mygramdb::client::CountResponse;
+using mygramdb::client::Document;
+using mygramdb::client::MygramClient;
+using mygramdb::client::SearchResponse;
+
+namespace {
+
+constexpr uint64_t kDefaultIterations = 20000;
+constexpr int kResultIds = 100;
+
+std::string SearchReply() {
+  std::string reply = "OK RESULTS 5000";
+  for (int i = 0; i < kResultIds; ++i) {
+    reply += " " + std::to_string(1000000 + i);
+  }
+  return reply + "\r\n";
+}
+
+MygramClient Connect(uint16_t port) {
+  ClientConfig config;
+  config.port = port;
+  MygramClient client(config);
+  if (auto conn = client.Connect(); !conn) {
+    std::fprintf(stderr, "connect failed: %s\n", conn.error().message().c_str());
+    std::exit(1);
+  }
+  return client;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : kDefaultIterations;
+
+  const std::vector<std::string> and_terms = {"tutorial"};
+  const std::vector<std::pair<std::string, std::string>> filters = {{"status", "1"}};
+
+  {
+    CannedServer server(SearchReply());
+    MygramClient client = Connect(server.port());
+
+    PrintResult("search/value", Measure(iterations, [&] {
+                  auto resp = client.Search("articles", "hello world", 100, 0, and_terms, {}, filters);
+                  if (!resp || resp->results.size() != kResultIds) {
+                    std::abort();
+                  }
+                }));
+
+    SearchResponse resp;
+    PrintResult("search/reuse", Measure(iterations, [&] {
+                  auto status =
+                      client.Search("articles", "hello world", 100, 0, and_terms, {}, filters, "", true, resp);
+                  if (!status || resp.results.size() != kResultIds) {
+                    std::abort();
+                  }
+                }));
+  }
+
+  {
+    CannedServer server(SearchReply());
+    MygramClientConfig_C config = {"127.0.0.1", server.port(), 5000, 65536};
+    MygramClient_C* client = mygramclient_create(&config);
+    if (client == nullptr || mygramclient_connect(client) != 0) {
+      std::fprintf(stderr, "connect failed\n");
+      return 1;
+    }
+
+    PrintResult("search/c-alloc", Measure(iterations, [&] {
+                  MygramSearchResult_C* result = nullptr;
+                  if (mygramclient_search(client, "articles", "hello world", 100, 0, &result) != 0 ||
+                      result->count != kResultIds) {
+                    std::abort();
+                  }
+                  mygramclient_free_search_result(result);
+                }));
+
+    MygramSearchResult_C* result = mygramclient_search_result_create();
+    PrintResult("search/c-reuse", Measure(iterations, [&] {
+                  if (mygramclient_search_into(client, "articles", "hello world", 100, 0, result) != 0 ||
+                      result->count != kResultIds) {
+                    std::abort();
+                  }
+                }));
+    mygramclient_search_result_destroy(result);
+    mygramclient_destroy(client);
+  }
+
+  {
+    CannedServer server("OK COUNT 5000\r\n");
+    MygramClient client = Connect(server.port());
+
+    PrintResult("count/value", Measure(iterations, [&] {
+                  auto resp = client.Count("articles", "hello world", and_terms, {}, filters);
+                  if (!resp || resp->count != 5000) {
+                    std::abort();
+                  }
+                }));
+
+    CountResponse resp;
+    PrintResult("count/reuse", Measure(iterations, [&] {
+                  auto status = client.Count("articles", "hello world", and_terms, {}, filters, resp);
+                  if (!status || resp.count != 5000) {
+                    std::abort();
+                  }
+                }));
+  }
+
+  {
+    CannedServer server("OK DOC 1000001 status=1 category=news created_at=1700000000 author_id=42\r\n");
+    MygramClient client = Connect(server.port());
+
+    PrintResult("get/value", Measure(iterations, [&] {
+                  auto doc = client.Get("articles", "1000001");
+                  if (!doc || doc->fields.size() != 4) {
+                    std::abort();
+                  }
+                }));
+
+    Document doc;
+    PrintResult("get/reuse", Measure(iterations, [&] {
+                  auto status = client.Get("articles", "1000001", doc);
+                  if (!status || doc.fields.size() != 4) {
+                    std::abort();
+                  }
+                }));
+  }
+
+  return 0;
+}
@@ -43,11 +43,32 @@ mkdir -p "$SRC_DIR/mygramdb"
 # Copy client source files
 echo "Copying client source files..."
 cp "$MYGRAM_DB_PATH/src/client/mygramclient.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/mygramclient_internal.h" "$SRC_DIR/mygramdb/"
 cp "$MYGRAM_DB_PATH/src/client/mygramclient.cpp" "$SRC_DIR/"
 cp "$MYGRAM_DB_PATH/src/client/mygramclient_c.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/mygramclient_c_internal.h" "$SRC_DIR/mygramdb/"
 cp "$MYGRAM_DB_PATH/src/client/mygramclient_c.cpp" "$SRC_DIR/"
 cp "$MYGRAM_DB_PATH/src/client/search_expression.h" "$SRC_DIR/mygramdb/"
 cp "$MYGRAM_DB_PATH/src/client/search_expression.cpp" "$SRC_DIR/"
+cp "$MYGRAM_DB_PATH/src/client/client_metrics.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/client_metrics.cpp" "$SRC_DIR/"
+cp "$MYGRAM_DB_PATH/src/client/thread_shards.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/request_observer.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/request_observer.cpp" "$SRC_DIR/"
+cp "$MYGRAM_DB_PATH/src/client/query_fingerprint.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/query_fingerprint.cpp" "$SRC_DIR/"
+cp "$MYGRAM_DB_PATH/src/client/debug_profiler.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/debug_profiler.cpp" "$SRC_DIR/"
+cp "$MYGRAM_DB_PATH/src/client/query_stats.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/query_stats.cpp" "$SRC_DIR/"
+cp "$MYGRAM_DB_PATH/src/client/heavy_hitters.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/heavy_hitters.cpp" "$SRC_DIR/"
+cp "$MYGRAM_DB_PATH/src/client/query_capture.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/query_capture.cpp" "$SRC_DIR/"
+cp "$MYGRAM_DB_PATH/src/client/client_pool.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/client_pool.cpp" "$SRC_DIR/"
+cp "$MYGRAM_DB_PATH/src/client/mock_server.h" "$SRC_DIR/mygramdb/"
+cp "$MYGRAM_DB_PATH/src/client/mock_server.cpp" "$SRC_DIR/"
 echo "  Copied client source files"
 
 # Copy utility headers and sources
@@ -59,6 +80,9 @@ cp "$MYGRAM_DB_PATH/src/utils/string_utils.h" "$SRC_DIR/utils/"
 cp "$MYGRAM_DB_PATH/src/utils/string_utils.cpp" "$SRC_DIR/"
 cp "$MYGRAM_DB_PATH/src/utils/network_utils.h" "$SRC_DIR/utils/"
 cp "$MYGRAM_DB_PATH/src/utils/network_utils.cpp" "$SRC_DIR/"
+cp "$MYGRAM_DB_PATH/src/utils/query_scan.h" "$SRC_DIR/utils/"
+cp "$MYGRAM_DB_PATH/src/utils/query_scan.cpp" "$SRC_DIR/"
+cp "$MYGRAM_DB_PATH/src/utils/usdt.h" "$SRC_DIR/utils/"
 echo "  Copied utility files"
 
 # Verify embedded files
@@ -66,17 +90,41 @@ echo ""
 echo "Verifying embedded files..."
 REQUIRED_FILES=(
     "$SRC_DIR/mygramdb/mygramclient.h"
+    "$SRC_DIR/mygramdb/mygramclient_internal.h"
     "$SRC_DIR/mygramclient.cpp"
     "$SRC_DIR/mygramdb/mygramclient_c.h"
+    "$SRC_DIR/mygramdb/mygramclient_c_internal.h"
     "$SRC_DIR/mygramclient_c.cpp"
     "$SRC_DIR/mygramdb/search_expression.h"
     "$SRC_DIR/search_expression.cpp"
+    "$SRC_DIR/mygramdb/client_metrics.h"
+    "$SRC_DIR/client_metrics.cpp"
+    "$SRC_DIR/mygramdb/thread_shards.h"
+    "$SRC_DIR/mygramdb/request_observer.h"
+    "$SRC_DIR/request_observer.cpp"
+    "$SRC_DIR/mygramdb/query_fingerprint.h"
+    "$SRC_DIR/query_fingerprint.cpp"
+    "$SRC_DIR/mygramdb/debug_profiler.h"
+    "$SRC_DIR/debug_profiler.cpp"
+    "$SRC_DIR/mygramdb/query_stats.h"
+    "$SRC_DIR/query_stats.cpp"
+    "$SRC_DIR/mygramdb/heavy_hitters.h"
+    "$SRC_DIR/heavy_hitters.cpp"
+    "$SRC_DIR/mygramdb/query_capture.h"
+    "$SRC_DIR/query_capture.cpp"
+    "$SRC_DIR/mygramdb/client_pool.h"
+    "$SRC_DIR/client_pool.cpp"
+    "$SRC_DIR/mygramdb/mock_server.h"
+    "$SRC_DIR/mock_server.cpp"
     "$SRC_DIR/utils/error.h"
     "$SRC_DIR/utils/expected.h"
     "$SRC_DIR/utils/string_utils.h"
     "$SRC_DIR/string_utils.cpp"
     "$SRC_DIR/utils/network_utils.h"
     "$SRC_DIR/network_utils.cpp"
+    "$SRC_DIR/utils/query_scan.h"
+    "$SRC_DIR/query_scan.cpp"
+    "$SRC_DIR/utils/usdt.h"
 )
 
 ALL_FOUND=1
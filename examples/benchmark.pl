@@ -12,7 +12,7 @@ print "MygramDB Client Benchmark\n";
 print "=" x 50, "\n\n";
 
 # Configuration
-my $host = 'localhost';
+my $host = '127.0.0.1';  # The XS client takes a numeric address
 my $port = 11016;
 my $iterations = 100;
 
@@ -56,9 +56,7 @@ if ($has_xs) {
 
         my $xs_start = time;
         for (1..$iterations) {
-            eval {
-                my $result = $xs_client->search('articles', 'test', 100, 0);
-            };
+            my $result = $xs_client->search('articles', 'test', 100, 0);
         }
         my $xs_elapsed = time - $xs_start;
         my $xs_avg = $xs_elapsed / $iterations;
@@ -76,3 +74,4 @@ if ($has_xs) {
 }
 
 print "\nBenchmark complete\n";
+print "See bench/client_bench.pl for percentiles, concurrency and allocation counts\n";
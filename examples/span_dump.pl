@@ -0,0 +1,36 @@
+#!/usr/bin/env perl
+
+# Dump the span records of a ring file written by set_span_ring(), oldest first
+#
+# Usage: span_dump.pl <ring-file>
+
+use strict;
+use warnings;
+
+my @COMMANDS = qw(SEARCH COUNT GET INFO CONFIG SAVE LOAD REPLICATION DEBUG OTHER);
+
+my $path = shift or die "Usage: $0 <ring-file>\n";
+open(my $fh, '<:raw', $path) or die "Cannot open $path: $!\n";
+local $/;
+my $data = <$fh>;
+close($fh);
+
+die "$path is not a span ring file\n" if length($data) < 64;
+my ($magic, $version, $record_size, $capacity, $next_sequence) = unpack('a8 L L Q Q', $data);
+die "$path is not a span ring file\n" unless $magic eq 'MYGSPAN1' && $version == 1 && $record_size == 64;
+
+my $first = $next_sequence > $capacity ? $next_sequence - $capacity : 0;
+printf "# %d records (%d written, capacity %d)\n", $next_sequence - $first, $next_sequence, $capacity;
+printf "%-8s %-19s %-11s %-10s %10s %10s %10s %8s %8s %5s %s\n",
+    qw(id start command table latency_us write_us first_us sent recvd recvs error);
+
+for my $sequence ($first .. $next_sequence - 1) {
+    my $offset = 64 + ($sequence % $capacity) * 64;
+    my ($id, $start_ns, $latency_ns, $write_ns, $first_byte_ns, $sent, $received, $recv_calls, $error,
+        $command, $table_length, $table) = unpack('Q5 L2 S2 C2 a10', substr($data, $offset, 64));
+    my ($sec, $min, $hour, $mday, $mon, $year) = localtime(int($start_ns / 1e9));
+    printf "%-8d %04d-%02d-%02d %02d:%02d:%02d %-11s %-10s %10.1f %10.1f %10.1f %8d %8d %5d %s\n",
+        $id, $year + 1900, $mon + 1, $mday, $hour, $min, $sec, $COMMANDS[$command] // $command,
+        substr($table, 0, $table_length), $latency_ns / 1e3, $write_ns / 1e3, $first_byte_ns / 1e3,
+        $sent, $received, $recv_calls, $error || '-';
+}
@@ -14,7 +14,7 @@ if ($@) {
 
 # Create client
 my $client = MygramDB::Client::XS->new(
-    'localhost',  # host
+    '127.0.0.1',  # host (numeric address)
     11016,        # port
     5000,         # timeout_ms
     65536,        # recv_buffer_size
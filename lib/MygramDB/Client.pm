@@ -647,8 +647,8 @@ sub _parse_count_response {
 sub _parse_get_response {
     my ($self, $response) = @_;
 
-    # DOC <primary_key> <field1=value1> <field2=value2> ...
-    if ($response =~ /^DOC (\S+)\s*(.*)/) {
+    # OK DOC <primary_key> <field1=value1> <field2=value2> ...
+    if ($response =~ /^(?:OK )?DOC (\S+)\s*(.*)/) {
         my $primary_key = $1;
         my $fields_str = $2 || '';
 
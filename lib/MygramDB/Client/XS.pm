@@ -100,6 +100,23 @@ Parameters (all required):
 
 =back
 
+=head2 new_pooled($host, $port, $max_connections, $timeout_ms, $recv_buffer_size)
+
+Create a client backed by a pool of at most C<$max_connections> connections
+(the C API's thread-safe handle, see C<mygramclient_create_pooled()>). Each
+call borrows a connection for its duration; connections are opened on
+demand and kept. When a request fails midway (timeout, connection closed),
+its connection is reopened for the next call instead of being reused, so a
+pooled client recovers from server restarts without an explicit
+C<connect()>. C<connect()> opens the first connection and C<disconnect()>
+closes the idle ones.
+
+Calls tied to a single connection fail with "Not supported on pooled
+handles": the non-blocking interface (C<fileno()> returns -1),
+C<enable_debug()>/C<disable_debug()>, C<debug_profiles()> and query stats
+(C<set_debug_sampling()> has no effect). Metrics, span rings, heavy hitters
+and captures cover all pooled connections.
+
 =head2 connect()
 
 Connect to MygramDB server. Dies on error.
@@ -144,14 +161,128 @@ Parameters:
 
 =back
 
+=head2 prepare_search($table, $and_terms, $not_terms, $filters, $sort_column, $sort_desc)
+
+Validate and pre-serialize a search shape once, for queries that repeat it
+with different search terms. All arguments but C<$table> are optional and
+take the same values as in C<search_advanced>. Returns a
+C<MygramDB::Client::XS::PreparedSearch> object; does not contact the server.
+
+    my $prepared = $client->prepare_search('articles', [], [], {status => 1}, 'created_at', 1);
+
+=head2 search_prepared($prepared, $query, $limit, $offset)
+
+Execute a prepared search with the given query. Only the query and the
+LIMIT clause are serialized per call. Returns the same hashref as C<search>.
+
+=head2 search_keys($table, $query, $limit, $offset)
+
+=head2 search_ids($table, $query, $limit, $offset)
+
+=head2 search_prepared_keys($prepared, $query, $limit, $offset)
+
+=head2 search_prepared_ids($prepared, $query, $limit, $offset)
+
+Lighter forms of C<search> and C<search_prepared> for callers that only
+need the primary keys. C<*_keys> returns an array ref of key strings, one
+SV per result instead of three. C<*_ids> returns the keys packed as native
+unsigned 64-bit integers in a single string, to be read with
+C<unpack("Q*")>, and dies if a key is not a decimal integer in that range.
+In list context C<total_count> follows the array ref or string, so call
+them in scalar context where a single value is expected.
+
+    my ($ids, $total) = $client->search_prepared_ids($prepared, 'hello', 1000, 0);
+    for my $id (unpack('Q*', $ids)) { ... }
+
 =head2 count($table, $query)
 
 Count matching documents. Returns integer.
 
+=head2 search_batch(\@requests)
+
+Run several searches in one round trip: the commands are written while the
+replies are read in order as they arrive, so batches of any size are fine. Each request is an array ref
+C<[$table, $query, $limit, $offset]> (limit and offset optional). Returns an
+array ref with, per request, the same hashref as C<search>, or
+C<< { error => $message } >> when that request failed. Dies only when the
+exchange itself fails (e.g. not connected).
+
+Batched requests are counted in C<metrics>, but the per-request recorders
+do not see them: debug sampling, query stats, heavy hitters, span rings and
+captures skip C<search_batch> and C<count_batch>.
+
+    my $results = $client->search_batch([['articles', 'hello', 10], ['articles', 'world', 10, 10]]);
+
+=head2 count_batch(\@requests)
+
+Like C<search_batch> for COUNT; each request is C<[$table, $query]> and
+each item is C<< { count => $n } >> or C<< { error => $message } >>.
+
 =head2 get($table, $primary_key)
 
 Get document by primary key. Returns hashref with C<primary_key> and C<fields>.
 
+=head2 Non-blocking requests
+
+For event loops (AnyEvent, IO::Async, Mojo::IOLoop): submit requests, call
+C<process_io> to write them (requests submitted together go out in one
+write), then call it again whenever C<fileno> is readable and collect the
+replies with C<poll_result>. Many requests can be in flight on one
+connection; replies come back in submission order. Blocking methods die
+while requests are in flight. As with C<search_batch>, submitted requests
+are counted in C<metrics> but skipped by debug sampling, query stats, heavy
+hitters, span rings and captures.
+
+    my $id = $client->submit_search('articles', 'hello', 10);
+    my $drain = sub {
+        $client->process_io;
+        while (my $reply = $client->poll_result) {
+            ...;    # $reply->{id} == $id
+        }
+    };
+    $drain->();    # Writes the request (and may already read its reply)
+    my $w; $w = AnyEvent->io(fh => $client->fileno, poll => 'r', cb => sub {
+        $drain->();
+        undef $w unless $client->pending;
+    });
+
+=head3 submit_search($table, $query, $limit, $offset)
+
+=head3 submit_search_prepared($prepared, $query, $limit, $offset)
+
+=head3 submit_count($table, $query)
+
+=head3 submit_get($table, $primary_key)
+
+Queue a request for the next C<process_io> and return its id. Die if the
+request is invalid or the client is not connected.
+
+=head3 fileno()
+
+Socket file descriptor (-1 when not connected).
+
+=head3 wants_write()
+
+True while submitted commands wait to be written by C<process_io> (if a
+call could not write them all, wait for C<fileno> to become writable).
+
+=head3 pending()
+
+Number of requests submitted and not yet returned by C<poll_result>.
+
+=head3 process_io()
+
+Write pending commands and read the replies available, without blocking.
+Returns the number of results ready to poll. Dies when the connection fails;
+the requests in flight then complete with the error, so keep polling.
+
+=head3 poll_result()
+
+Oldest completed request, or undef. The hashref has C<id> plus what the
+blocking method returns: C<total_count> and C<results> for a search,
+C<count> for a count, C<primary_key> and C<fields> for a get, or C<error>
+when the request failed.
+
 =head2 info()
 
 Get server information. Returns hashref.
@@ -176,6 +307,152 @@ Start replication.
 
 Get last error message.
 
+=head2 metrics()
+
+Return this client's per-command metrics, recorded since creation or the
+last C<reset_metrics>. Failed calls are counted, including those rejected
+before reaching the server.
+
+    {
+        commands => {
+            SEARCH => {
+                requests, errors, bytes_sent, bytes_received, recv_calls,
+                latency => {
+                    count, sum_ns, min_ns, max_ns,
+                    p50_ns, p90_ns, p99_ns, p999_ns,
+                    buckets => [ [$upper_ns, $count], ... ],
+                },
+            },
+            COUNT => { ... }, GET => { ... }, INFO => { ... }, CONFIG => { ... },
+            SAVE => { ... }, LOAD => { ... }, REPLICATION => { ... },
+            DEBUG => { ... }, OTHER => { ... },
+        },
+        errors => [ { code => 7000, name => 'Not connected', count => 1 }, ... ],
+    }
+
+Latencies are kept in log-linear buckets (about 6% relative error);
+percentiles report the upper bound of the bucket holding that rank.
+C<buckets> lists only non-empty buckets, in ascending order.
+
+=head2 reset_metrics()
+
+Zero all metrics.
+
+=head2 set_span_ring($path, $capacity)
+
+Record one 64-byte span per request (command, table prefix, wall-clock
+start, latency, write and first-byte offsets, sizes, error code) into a
+memory-mapped ring file of C<$capacity> slots (default: 65536). An existing
+ring of the same capacity is reused, so several clients and processes can
+share one file; open it before forking. Pass C<undef> to stop recording.
+Batched and submitted requests get no span.
+C<examples/span_dump.pl> prints a ring file.
+
+=head2 set_debug_sampling($one_in)
+
+Profile 1 in C<$one_in> blocking search/count requests (0 turns sampling off).
+Sampled requests are sent over a second connection with DEBUG ON, opened on
+the first sample, so the other requests carry no debug overhead.
+
+=head2 debug_profiles()
+
+Return the server DebugInfo of the sampled requests aggregated by query
+fingerprint (literals replaced by C<?>), most sampled first:
+
+    [
+      {
+        fingerprint   => 'SEARCH articles ? FILTER status = ? LIMIT ?',
+        samples       => 12,
+        query_time_ms => 3.2,    # Means over the samples
+        candidates    => 18250,
+        after_intersection => 410,
+        ...                      # index_time_ms, filter_time_ms, terms, ngrams,
+                                 # after_not, after_filters, final
+        optimizations => { intersect => 12 },
+      },
+    ]
+
+=head2 reset_debug_profiles()
+
+Drop all debug profiles.
+
+=head2 enable_query_stats($max_fingerprints)
+
+Start collecting statistics of search/count requests grouped by query
+fingerprint. At most C<$max_fingerprints> shapes (default: 256) are tracked;
+requests of new shapes beyond that are pooled under C<(other)>. Off by
+default, since each request then pays for the fingerprint. Enabling again
+starts over. Only blocking calls are collected; batched and submitted
+requests are not.
+
+=head2 disable_query_stats()
+
+Stop collecting and drop the statistics.
+
+=head2 query_stats()
+
+Return the per-shape statistics, most called first:
+
+    [
+      {
+        fingerprint => 'SEARCH articles ? FILTER status = ? LIMIT ?',
+        calls       => 1200,
+        errors      => 3,
+        latency     => { sum_ns => ..., min_ns => ..., max_ns => ...,
+                         p50_ns => ..., p90_ns => ..., p99_ns => ... },
+        matched     => { sum => ..., max => ..., p50 => ..., p90 => ..., p99 => ... },
+        debug       => undef,    # or DebugInfo means as in debug_profiles()
+      },
+    ]
+
+C<matched> is the total match count (search) or count (count) of the
+successful requests; its percentiles are power-of-two bucket bounds. C<debug>
+is filled from replies that carried DEBUG output, e.g. debug-sampled ones.
+
+=head2 reset_query_stats()
+
+Drop the per-shape statistics.
+
+=head2 enable_heavy_hitters($top_k)
+
+Track the most frequent literal search/count commands (default: top 32) in
+fixed memory, using a count-min sketch. Enabling again starts over; 0 stops
+tracking. Commands sent with C<search_batch>, C<count_batch> or C<submit_*>
+are not counted.
+
+=head2 heavy_hitters()
+
+Return the current top K with estimated frequencies and latency:
+
+    {
+      total_requests   => 52000,
+      total_latency_ns => ...,
+      top => [
+        { command => 'SEARCH articles news LIMIT 20', count => 8012,
+          latency_ns => ..., latency_share => 0.21 },
+        ...
+      ],
+    }
+
+Counts are never underestimated and are close to exact for frequent
+commands. Croaks unless tracking is enabled.
+
+=head2 reset_heavy_hitters()
+
+Zero the tracker.
+
+=head2 set_capture($path)
+
+Log every blocking request (command, start offset, latency, reply size,
+result count and error code) to the binary capture file C<$path>, truncating
+it. Requests sent with C<search_batch>, C<count_batch> or C<submit_*> are
+not logged, so a replay of the capture does not include them. Records
+go through a lock-free in-memory buffer and are written by a background
+thread; if it falls behind, records are dropped rather than slowing down
+requests. The file is complete once capturing stops: pass C<undef> (or
+destroy the client). C<tools/mygram_replay> re-issues a capture against a
+server and compares the result counts.
+
 =head2 parse_search_expression($expression)
 
 Parse web-style search expression into structured components.
@@ -207,6 +484,17 @@ Supported syntax:
 
 =back
 
+=head2 live_sv_count()
+
+Diagnostics: the number of SVs currently allocated in this interpreter
+(Perl's C<PL_sv_count>). A function, not a method. The difference across a
+call is the number of SVs the call left alive, which is how
+C<bench/client_bench.pl> measures what each result holds:
+
+    my $before = MygramDB::Client::XS::live_sv_count();
+    my $result = $client->search('articles', 'hello');
+    my $held = MygramDB::Client::XS::live_sv_count() - $before;
+
 =head1 PERFORMANCE
 
 The XS implementation is significantly faster than the pure Perl version:
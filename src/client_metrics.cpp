@@ -0,0 +1,324 @@
+/**
+ * @file client_metrics.cpp
+ * @brief Per-command client-side metrics for MygramDB clients
+ */
+
+#include "mygramdb/client_metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+
+#include "mygramdb/thread_shards.h"
+
+namespace mygramdb::client {
+
+using mygram::utils::ErrorCode;
+using thread_shards::Bump;
+using thread_shards::Load;
+
+namespace {
+
+// Client error codes are contiguous; each gets its own counter, anything
+// else is counted as kUnknown
+constexpr auto kFirstClientError = static_cast<int>(ErrorCode::kClientNotConnected);
+constexpr auto kLastClientError = static_cast<int>(ErrorCode::kClientProtocolError);
+constexpr size_t kErrorSlots = static_cast<size_t>(kLastClientError - kFirstClientError) + 2;
+constexpr size_t kOtherErrorSlot = kErrorSlots - 1;
+
+
+size_t ErrorSlot(ErrorCode code) {
+  auto value = static_cast<int>(code);
+  if (value < kFirstClientError || value > kLastClientError) {
+    return kOtherErrorSlot;
+  }
+  return static_cast<size_t>(value - kFirstClientError);
+}
+
+ErrorCode SlotError(size_t slot) {
+  if (slot == kOtherErrorSlot) {
+    return ErrorCode::kUnknown;
+  }
+  return static_cast<ErrorCode>(kFirstClientError + static_cast<int>(slot));
+}
+
+std::atomic<uint64_t> next_registry_id{1};
+
+}  // namespace
+
+const char* CommandTypeName(CommandType type) {
+  switch (type) {
+    case CommandType::kSearch:
+      return "SEARCH";
+    case CommandType::kCount:
+      return "COUNT";
+    case CommandType::kGet:
+      return "GET";
+    case CommandType::kInfo:
+      return "INFO";
+    case CommandType::kConfig:
+      return "CONFIG";
+    case CommandType::kSave:
+      return "SAVE";
+    case CommandType::kLoad:
+      return "LOAD";
+    case CommandType::kReplication:
+      return "REPLICATION";
+    case CommandType::kDebug:
+      return "DEBUG";
+    case CommandType::kOther:
+      return "OTHER";
+  }
+  return "OTHER";
+}
+
+// LatencyBuckets
+
+size_t LatencyBuckets::IndexOf(uint64_t value_ns) {
+  if (value_ns < kSubBuckets) {
+    return static_cast<size_t>(value_ns);
+  }
+  const int exponent = 63 - __builtin_clzll(value_ns);
+  if (exponent >= kMaxExponent) {
+    return kCount - 1;
+  }
+  const int shift = exponent - kSubBucketBits;
+  const auto sub_bucket = static_cast<size_t>(value_ns >> shift) - kSubBuckets;
+  return kSubBuckets + (static_cast<size_t>(shift) * kSubBuckets) + sub_bucket;
+}
+
+uint64_t LatencyBuckets::LowerBound(size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const size_t shift = (index - kSubBuckets) / kSubBuckets;
+  const size_t sub_bucket = (index - kSubBuckets) % kSubBuckets;
+  return static_cast<uint64_t>(kSubBuckets + sub_bucket) << shift;
+}
+
+uint64_t LatencyBuckets::UpperBound(size_t index) {
+  if (index + 1 >= kCount) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return LowerBound(index + 1) - 1;
+}
+
+// LatencyHistogram
+
+void LatencyHistogram::Add(uint64_t value_ns) {
+  if (buckets.empty()) {
+    buckets.resize(LatencyBuckets::kCount);
+    min_ns = value_ns;
+    max_ns = value_ns;
+  }
+  ++count;
+  sum_ns += value_ns;
+  min_ns = std::min(min_ns, value_ns);
+  max_ns = std::max(max_ns, value_ns);
+  ++buckets[LatencyBuckets::IndexOf(value_ns)];
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  if (other.count == 0) {
+    return;
+  }
+  if (count == 0) {
+    *this = other;  // min_ns of an empty histogram is not a sample
+    return;
+  }
+  count += other.count;
+  sum_ns += other.sum_ns;
+  min_ns = std::min(min_ns, other.min_ns);
+  max_ns = std::max(max_ns, other.max_ns);
+  for (size_t i = 0; i < LatencyBuckets::kCount; ++i) {
+    buckets[i] += other.buckets[i];
+  }
+}
+
+uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+  if (count == 0 || buckets.empty()) {
+    return 0;
+  }
+  percentile = std::clamp(percentile, 0.0, 100.0);
+  auto rank = static_cast<uint64_t>((percentile / 100.0) * static_cast<double>(count) + 0.5);
+  rank = std::clamp<uint64_t>(rank, 1, count);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return std::clamp(LatencyBuckets::UpperBound(i), min_ns, max_ns);
+    }
+  }
+  return max_ns;
+}
+
+// MetricsRegistry
+
+void ClientMetrics::Merge(const ClientMetrics& other) {
+  for (size_t type = 0; type < kCommandTypeCount; ++type) {
+    const CommandMetrics& source = other.commands[type];
+    CommandMetrics& target = commands[type];
+    target.requests += source.requests;
+    target.errors += source.errors;
+    target.bytes_sent += source.bytes_sent;
+    target.bytes_received += source.bytes_received;
+    target.recv_calls += source.recv_calls;
+    target.latency.Merge(source.latency);
+  }
+
+  for (const auto& [code, count] : other.errors) {
+    auto entry = std::find_if(errors.begin(), errors.end(), [code = code](const auto& error) {
+      return error.first == code;
+    });
+    if (entry != errors.end()) {
+      entry->second += count;
+    } else {
+      errors.emplace_back(code, count);
+    }
+  }
+}
+
+struct MetricsRegistry::Shard : thread_shards::ShardHeader {
+  struct Command {
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> bytes_sent{0};
+    std::atomic<uint64_t> bytes_received{0};
+    std::atomic<uint64_t> recv_calls{0};
+    std::atomic<uint64_t> latency_sum_ns{0};
+    std::atomic<uint64_t> latency_min_ns{std::numeric_limits<uint64_t>::max()};
+    std::atomic<uint64_t> latency_max_ns{0};
+    std::array<std::atomic<uint64_t>, LatencyBuckets::kCount> buckets{};
+  };
+
+  using ShardHeader::ShardHeader;
+
+  /**
+   * @brief Zero every counter; only called by the owner, so no Bump() can interleave
+   */
+  void Clear() {
+    for (auto& command : commands) {
+      command.requests.store(0, std::memory_order_relaxed);
+      command.errors.store(0, std::memory_order_relaxed);
+      command.bytes_sent.store(0, std::memory_order_relaxed);
+      command.bytes_received.store(0, std::memory_order_relaxed);
+      command.recv_calls.store(0, std::memory_order_relaxed);
+      command.latency_sum_ns.store(0, std::memory_order_relaxed);
+      command.latency_min_ns.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+      command.latency_max_ns.store(0, std::memory_order_relaxed);
+      for (auto& bucket : command.buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+    for (auto& error : errors) {
+      error.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Add the counters to metrics and errors (indexed by error slot)
+   */
+  void AddTo(ClientMetrics& metrics, std::array<uint64_t, kErrorSlots>& error_counts) const {
+    for (size_t type = 0; type < kCommandTypeCount; ++type) {
+      const auto& source = commands[type];
+      auto& target = metrics.commands[type];
+      const uint64_t requests = Load(source.requests);
+      if (requests == 0) {
+        continue;
+      }
+
+      target.requests += requests;
+      target.errors += Load(source.errors);
+      target.bytes_sent += Load(source.bytes_sent);
+      target.bytes_received += Load(source.bytes_received);
+      target.recv_calls += Load(source.recv_calls);
+
+      auto& latency = target.latency;
+      const uint64_t shard_min = Load(source.latency_min_ns);
+      latency.min_ns = latency.count == 0 ? shard_min : std::min(latency.min_ns, shard_min);
+      latency.max_ns = std::max(latency.max_ns, Load(source.latency_max_ns));
+      latency.sum_ns += Load(source.latency_sum_ns);
+      if (latency.buckets.empty()) {
+        latency.buckets.assign(LatencyBuckets::kCount, 0);
+      }
+      for (size_t i = 0; i < LatencyBuckets::kCount; ++i) {
+        const uint64_t bucket = Load(source.buckets[i]);
+        latency.buckets[i] += bucket;
+        latency.count += bucket;
+      }
+    }
+    for (size_t slot = 0; slot < kErrorSlots; ++slot) {
+      error_counts[slot] += Load(errors[slot]);
+    }
+  }
+
+  std::array<Command, kCommandTypeCount> commands;
+  std::array<std::atomic<uint64_t>, kErrorSlots> errors{};
+};
+
+MetricsRegistry::MetricsRegistry() : id_(next_registry_id.fetch_add(1, std::memory_order_relaxed)) {}
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+MetricsRegistry::Shard& MetricsRegistry::LocalShard() {
+  return thread_shards::Local(id_, mutex_, shards_, [this](std::thread::id self) {
+    return std::make_unique<Shard>(self, reset_epoch_.load(std::memory_order_acquire));
+  });
+}
+
+void MetricsRegistry::Record(CommandType type, const RequestStats& stats, uint64_t latency_ns, ErrorCode error) {
+  Shard& shard = LocalShard();
+  thread_shards::CatchUp(shard, reset_epoch_.load(std::memory_order_acquire), [&shard] { shard.Clear(); });
+  auto& command = shard.commands[static_cast<size_t>(type)];
+
+  Bump(command.requests, 1);
+  Bump(command.bytes_sent, stats.bytes_sent);
+  Bump(command.bytes_received, stats.bytes_received);
+  Bump(command.recv_calls, stats.recv_calls);
+  Bump(command.latency_sum_ns, latency_ns);
+  if (latency_ns < Load(command.latency_min_ns)) {
+    command.latency_min_ns.store(latency_ns, std::memory_order_relaxed);
+  }
+  if (latency_ns > Load(command.latency_max_ns)) {
+    command.latency_max_ns.store(latency_ns, std::memory_order_relaxed);
+  }
+  Bump(command.buckets[LatencyBuckets::IndexOf(latency_ns)], 1);
+
+  if (error != ErrorCode::kSuccess) {
+    Bump(command.errors, 1);
+    Bump(shard.errors[ErrorSlot(error)], 1);
+  }
+}
+
+ClientMetrics MetricsRegistry::Snapshot() const {
+  ClientMetrics metrics;
+  std::array<uint64_t, kErrorSlots> errors{};
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t epoch = reset_epoch_.load(std::memory_order_acquire);
+  for (const auto& shard : shards_) {
+    ClientMetrics shard_metrics;
+    std::array<uint64_t, kErrorSlots> shard_errors{};
+    if (!thread_shards::Read(*shard, epoch, [&] { shard->AddTo(shard_metrics, shard_errors); })) {
+      continue;  // Counts from before a Reset() the owner has not applied yet
+    }
+
+    metrics.Merge(shard_metrics);
+    for (size_t slot = 0; slot < kErrorSlots; ++slot) {
+      errors[slot] += shard_errors[slot];
+    }
+  }
+
+  for (size_t slot = 0; slot < kErrorSlots; ++slot) {
+    if (errors[slot] != 0) {
+      metrics.errors.emplace_back(SlotError(slot), errors[slot]);
+    }
+  }
+  return metrics;
+}
+
+void MetricsRegistry::Reset() { reset_epoch_.fetch_add(1, std::memory_order_acq_rel); }
+
+}  // namespace mygramdb::client
@@ -0,0 +1,155 @@
+/**
+ * @file client_pool.cpp
+ * @brief Bounded pool of MygramClient connections shared by many threads
+ */
+
+#include "mygramdb/client_pool.h"
+
+#include <chrono>
+#include <utility>
+
+namespace mygramdb::client {
+
+using mygram::utils::Error;
+using mygram::utils::ErrorCode;
+using mygram::utils::Expected;
+using mygram::utils::MakeError;
+using mygram::utils::MakeUnexpected;
+
+ClientPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)), slot_(std::exchange(other.slot_, nullptr)) {}
+
+ClientPool::Lease& ClientPool::Lease::operator=(Lease&& other) noexcept {
+  if (this != &other) {
+    Release();
+    pool_ = std::exchange(other.pool_, nullptr);
+    slot_ = std::exchange(other.slot_, nullptr);
+  }
+  return *this;
+}
+
+MygramClient* ClientPool::Lease::operator->() const { return &slot_->client; }
+
+MygramClient& ClientPool::Lease::operator*() const { return slot_->client; }
+
+void ClientPool::Lease::Release() {
+  if (slot_ != nullptr) {
+    pool_->Release(std::exchange(slot_, nullptr));
+    pool_ = nullptr;
+  }
+}
+
+ClientPool::ClientPool(ClientConfig config, size_t max_connections)
+    : config_(std::move(config)), max_connections_(max_connections != 0 ? max_connections : 1) {
+  slots_.reserve(max_connections_);
+  idle_.reserve(max_connections_);
+}
+
+ClientPool::~ClientPool() = default;
+
+Expected<ClientPool::Lease, Error> ClientPool::Acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto available = [this] { return !idle_.empty() || slots_.size() < max_connections_; };
+  if (config_.timeout_ms == 0) {
+    released_.wait(lock, available);
+  } else if (!released_.wait_for(lock, std::chrono::milliseconds(config_.timeout_ms), available)) {
+    return MakeUnexpected(MakeError(ErrorCode::kClientTimeout,
+                                    "No pooled connection released within " + std::to_string(config_.timeout_ms) +
+                                        " ms (" + std::to_string(max_connections_) + " in use)"));
+  }
+
+  Slot* slot = nullptr;
+  if (!idle_.empty()) {
+    slot = idle_.back();
+    idle_.pop_back();
+  } else {
+    slots_.push_back(std::make_unique<Slot>(config_));
+    slot = slots_.back().get();
+    ApplySettings(*slot);
+  }
+  lock.unlock();
+
+  Lease lease(this, slot);  // Hands the slot back if it cannot be connected
+  if (!slot->client.IsConnected()) {
+    if (auto status = slot->client.Connect(); !status) {
+      return MakeUnexpected(status.error());
+    }
+  }
+  return lease;
+}
+
+void ClientPool::Release(Slot* slot) {
+  if (slot->client.IsBroken()) {
+    slot->client.Disconnect();  // Reconnected by the next Acquire() that picks it
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (slot->settings_version != settings_version_) {
+      ApplySettings(*slot);  // Changed while it was leased
+    }
+    idle_.push_back(slot);
+  }
+  released_.notify_one();
+}
+
+void ClientPool::Disconnect() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (Slot* slot : idle_) {
+    slot->client.Disconnect();
+  }
+}
+
+size_t ClientPool::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return slots_.size();
+}
+
+ClientMetrics ClientPool::GetMetrics() const {
+  ClientMetrics metrics;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& slot : slots_) {
+    metrics.Merge(slot->client.GetMetrics());  // Safe while the client is leased
+  }
+  return metrics;
+}
+
+void ClientPool::ResetMetrics() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& slot : slots_) {
+    slot->client.ResetMetrics();
+  }
+}
+
+void ClientPool::ApplySettings(Slot& slot) {
+  slot.client.SetObserver(observer_);
+  slot.client.SetHeavyHitters(heavy_hitters_);
+  slot.client.SetCapture(capture_);
+  slot.settings_version = settings_version_;
+}
+
+void ClientPool::ApplySettingsToIdle() {
+  ++settings_version_;
+  for (Slot* slot : idle_) {
+    ApplySettings(*slot);
+  }
+}
+
+void ClientPool::SetObserver(std::shared_ptr<RequestObserver> observer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  observer_ = std::move(observer);
+  ApplySettingsToIdle();
+}
+
+void ClientPool::SetHeavyHitters(std::shared_ptr<HeavyHitters> tracker) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  heavy_hitters_ = std::move(tracker);
+  ApplySettingsToIdle();
+}
+
+void ClientPool::SetCapture(std::shared_ptr<QueryCapture> capture) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capture_ = std::move(capture);
+  ApplySettingsToIdle();
+}
+
+}  // namespace mygramdb::client
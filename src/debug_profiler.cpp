@@ -0,0 +1,112 @@
+/**
+ * @file debug_profiler.cpp
+ * @brief Per-fingerprint aggregation of server DebugInfo from sampled requests
+ */
+
+#include "mygramdb/debug_profiler.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+#include "mygramdb/mygramclient.h"
+#include "mygramdb/query_fingerprint.h"
+
+namespace mygramdb::client {
+
+void DebugInfoSums::Add(const DebugInfo& info) {
+  ++samples_;
+  query_time_ms_ += info.query_time_ms;
+  index_time_ms_ += info.index_time_ms;
+  filter_time_ms_ += info.filter_time_ms;
+  terms_ += static_cast<double>(info.terms);
+  ngrams_ += static_cast<double>(info.ngrams);
+  candidates_ += static_cast<double>(info.candidates);
+  after_intersection_ += static_cast<double>(info.after_intersection);
+  after_not_ += static_cast<double>(info.after_not);
+  after_filters_ += static_cast<double>(info.after_filters);
+  final_ += static_cast<double>(info.final);
+  if (info.optimization.empty()) {
+    return;
+  }
+  auto found = std::find_if(optimizations_.begin(), optimizations_.end(),
+                            [&](const auto& entry) { return entry.first == info.optimization; });
+  if (found != optimizations_.end()) {
+    ++found->second;
+  } else {
+    optimizations_.emplace_back(info.optimization, 1);
+  }
+}
+
+DebugProfile DebugInfoSums::Mean(const std::string& fingerprint) const {
+  DebugProfile profile;
+  profile.fingerprint = fingerprint;
+  profile.samples = samples_;
+  if (samples_ == 0) {
+    return profile;
+  }
+
+  const auto n = static_cast<double>(samples_);
+  profile.query_time_ms = query_time_ms_ / n;
+  profile.index_time_ms = index_time_ms_ / n;
+  profile.filter_time_ms = filter_time_ms_ / n;
+  profile.terms = terms_ / n;
+  profile.ngrams = ngrams_ / n;
+  profile.candidates = candidates_ / n;
+  profile.after_intersection = after_intersection_ / n;
+  profile.after_not = after_not_ / n;
+  profile.after_filters = after_filters_ / n;
+  profile.final = final_ / n;
+  profile.optimizations = optimizations_;
+  std::stable_sort(profile.optimizations.begin(), profile.optimizations.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+  return profile;
+}
+
+struct DebugProfiler::State {
+  explicit State(size_t max) : max_fingerprints(max) {}
+
+  const size_t max_fingerprints;
+  mutable std::mutex mutex;
+  std::unordered_map<std::string, DebugInfoSums> profiles;
+};
+
+DebugProfiler::DebugProfiler(size_t max_fingerprints) : state_(std::make_unique<State>(max_fingerprints)) {}
+
+DebugProfiler::~DebugProfiler() = default;
+
+void DebugProfiler::Record(std::string_view command, const DebugInfo& info) {
+  std::string fingerprint = FingerprintCommand(command);
+
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  auto found = state_->profiles.find(fingerprint);
+  if (found == state_->profiles.end()) {
+    if (state_->profiles.size() >= state_->max_fingerprints) {
+      fingerprint = kOverflowFingerprint;
+    }
+    found = state_->profiles.try_emplace(std::move(fingerprint)).first;
+  }
+  found->second.Add(info);
+}
+
+std::vector<DebugProfile> DebugProfiler::Snapshot() const {
+  std::vector<DebugProfile> profiles;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    profiles.reserve(state_->profiles.size());
+    for (const auto& [fingerprint, sums] : state_->profiles) {
+      profiles.push_back(sums.Mean(fingerprint));
+    }
+  }
+  std::sort(profiles.begin(), profiles.end(), [](const DebugProfile& lhs, const DebugProfile& rhs) {
+    return lhs.samples != rhs.samples ? lhs.samples > rhs.samples : lhs.fingerprint < rhs.fingerprint;
+  });
+  return profiles;
+}
+
+void DebugProfiler::Reset() {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->profiles.clear();
+}
+
+}  // namespace mygramdb::client
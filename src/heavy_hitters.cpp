@@ -0,0 +1,301 @@
+/**
+ * @file heavy_hitters.cpp
+ * @brief Streaming detection of the most frequent literal commands
+ */
+
+#include "mygramdb/heavy_hitters.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <thread>
+
+#include "mygramdb/thread_shards.h"
+
+namespace mygramdb::client {
+
+using thread_shards::Bump;
+using thread_shards::Load;
+
+namespace {
+
+constexpr size_t kMaxDepth = 16;
+constexpr size_t kCandidatesPerSlot = 2;  // Candidate table holds 2 * top_k commands
+constexpr size_t kAdmittedPerCandidate = 4;  // Admitted table holds 4 slots per candidate
+constexpr size_t kAdmittedWays = 8;          // Slots per admitted set: one cache line of hashes
+
+std::atomic<uint64_t> next_tracker_id{1};
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+std::string_view StripTerminator(std::string_view command) {
+  if (command.size() >= 2 && command.substr(command.size() - 2) == "\r\n") {
+    command.remove_suffix(2);
+  }
+  return command;
+}
+
+/**
+ * @brief splitmix64 finalizer
+ */
+uint64_t Mix(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xbf58476d1ce4e5b9ULL;
+  value ^= value >> 27;
+  value *= 0x94d049bb133111ebULL;
+  value ^= value >> 31;
+  return value;
+}
+
+/**
+ * @brief 64-bit hash of command; never 0 (the empty marker)
+ */
+uint64_t HashCommand(std::string_view command) {
+  const uint64_t hash = Mix(std::hash<std::string_view>{}(command));  // std::hash may be weak in the low bits
+  return hash != 0 ? hash : 1;
+}
+
+/**
+ * @brief Counter of hash in sketch row
+ *
+ * Each row remixes the hash with its own seed. Deriving rows linearly from
+ * one hash (double hashing) makes two commands that collide in two rows
+ * collide in all of them, which breaks the sketch's error bound.
+ */
+size_t SketchIndex(uint64_t hash, size_t row, size_t width) {
+  constexpr uint64_t kRowSeed = 0x9e3779b97f4a7c15ULL;
+  return (row * width) + (Mix(hash + ((row + 1) * kRowSeed)) & (width - 1));
+}
+
+}  // namespace
+
+struct HeavyHitters::Shard : thread_shards::ShardHeader {
+  // Count and latency side by side: one cache line per row and record
+  struct Cell {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> latency_ns{0};
+  };
+
+  Shard(std::thread::id owner_thread, uint64_t reset_epoch, size_t cell_count, size_t admitted_slots)
+      : ShardHeader(owner_thread, reset_epoch), cells(new Cell[cell_count]), admitted(admitted_slots, 0) {}
+
+  /**
+   * @brief Zero the sketch and totals; only called by the owner
+   */
+  void Clear(size_t cell_count) {
+    for (size_t i = 0; i < cell_count; ++i) {
+      cells[i].count.store(0, std::memory_order_relaxed);
+      cells[i].latency_ns.store(0, std::memory_order_relaxed);
+    }
+    requests.store(0, std::memory_order_relaxed);
+    total_latency_ns.store(0, std::memory_order_relaxed);
+  }
+
+  std::unique_ptr<Cell[]> cells;  // depth x width
+  std::atomic<uint64_t> requests{0};
+  std::atomic<uint64_t> total_latency_ns{0};
+
+  // Owner-thread only: hashes this thread saw admitted, so hot commands skip
+  // the mutex; cleared when generation_ moves on. Set-associative, so hot
+  // commands whose hashes share a set do not evict each other
+  std::vector<uint64_t> admitted;
+  uint64_t admitted_generation = 0;
+};
+
+struct HeavyHitters::Candidate {
+  uint64_t hash = 0;
+  std::string command;
+};
+
+HeavyHitters::HeavyHitters(HeavyHitterOptions options)
+    : options_{std::max<size_t>(options.top_k, 1), RoundUpToPowerOfTwo(std::max<size_t>(options.width, 16)),
+               std::clamp<size_t>(options.depth, 1, kMaxDepth)},
+      id_(next_tracker_id.fetch_add(1, std::memory_order_relaxed)) {
+  candidates_.reserve(options_.top_k * kCandidatesPerSlot);
+}
+
+HeavyHitters::~HeavyHitters() = default;
+
+HeavyHitters::Shard& HeavyHitters::LocalShard() {
+  return thread_shards::Local(id_, mutex_, shards_, [this](std::thread::id self) {
+    const size_t admitted_slots = RoundUpToPowerOfTwo(options_.top_k * kCandidatesPerSlot * kAdmittedPerCandidate);
+    return std::make_unique<Shard>(self, reset_epoch_.load(std::memory_order_acquire),
+                                   options_.depth * options_.width, admitted_slots);
+  });
+}
+
+void HeavyHitters::Record(std::string_view command, uint64_t latency_ns) {
+  command = StripTerminator(command);
+  const uint64_t hash = HashCommand(command);
+  Shard& shard = LocalShard();
+  thread_shards::CatchUp(shard, reset_epoch_.load(std::memory_order_acquire),
+                         [&] { shard.Clear(options_.depth * options_.width); });
+
+  uint64_t estimate = std::numeric_limits<uint64_t>::max();
+  for (size_t row = 0; row < options_.depth; ++row) {
+    Shard::Cell& cell = shard.cells[SketchIndex(hash, row, options_.width)];
+    Bump(cell.count, 1);
+    Bump(cell.latency_ns, latency_ns);
+    estimate = std::min(estimate, Load(cell.count));
+  }
+  Bump(shard.requests, 1);
+  Bump(shard.total_latency_ns, latency_ns);
+
+  if (estimate < threshold_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  const uint64_t generation = generation_.load(std::memory_order_acquire);
+  if (shard.admitted_generation != generation) {
+    std::fill(shard.admitted.begin(), shard.admitted.end(), 0);
+    shard.admitted_generation = generation;
+  }
+  const size_t sets = shard.admitted.size() / kAdmittedWays;
+  uint64_t* set = &shard.admitted[(hash & (sets - 1)) * kAdmittedWays];
+  uint64_t* free_slot = nullptr;
+  for (size_t way = 0; way < kAdmittedWays; ++way) {
+    if (set[way] == hash) {
+      return;
+    }
+    if (set[way] == 0 && free_slot == nullptr) {
+      free_slot = &set[way];
+    }
+  }
+  if (Admit(hash, command)) {
+    // A full set only happens when more than kAdmittedWays candidates share it
+    *(free_slot != nullptr ? free_slot : &set[(hash >> 32) % kAdmittedWays]) = hash;
+  }
+}
+
+bool HeavyHitters::Admit(uint64_t hash, std::string_view command) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& candidate : candidates_) {
+    if (candidate.hash == hash) {
+      return true;
+    }
+  }
+
+  const size_t capacity = options_.top_k * kCandidatesPerSlot;
+  if (candidates_.size() < capacity) {
+    candidates_.push_back({hash, std::string(command)});
+    if (candidates_.size() < capacity) {
+      return true;
+    }
+  }
+
+  // Table full: find the weakest candidate and raise the threshold to it
+  uint64_t count = 0;
+  uint64_t latency_ns = 0;
+  size_t weakest = 0;
+  uint64_t weakest_count = std::numeric_limits<uint64_t>::max();
+  for (size_t i = 0; i < candidates_.size(); ++i) {
+    Estimate(candidates_[i].hash, count, latency_ns);
+    if (count < weakest_count) {
+      weakest = i;
+      weakest_count = count;
+    }
+  }
+
+  if (candidates_[weakest].hash != hash) {
+    Estimate(hash, count, latency_ns);
+    if (count <= weakest_count) {
+      threshold_.store(weakest_count + 1, std::memory_order_relaxed);
+      return false;
+    }
+    candidates_[weakest] = {hash, std::string(command)};
+    generation_.fetch_add(1, std::memory_order_release);  // The evicted command may come back
+  }
+
+  uint64_t new_weakest = std::numeric_limits<uint64_t>::max();
+  for (const auto& candidate : candidates_) {
+    Estimate(candidate.hash, count, latency_ns);
+    new_weakest = std::min(new_weakest, count);
+  }
+  threshold_.store(new_weakest, std::memory_order_relaxed);
+  return true;
+}
+
+void HeavyHitters::Estimate(uint64_t hash, uint64_t& count, uint64_t& latency_ns) const {
+  std::array<size_t, kMaxDepth> indexes{};
+  for (size_t row = 0; row < options_.depth; ++row) {
+    indexes[row] = SketchIndex(hash, row, options_.width);
+  }
+
+  std::array<uint64_t, kMaxDepth> row_counts{};
+  std::array<uint64_t, kMaxDepth> row_latencies{};
+  const uint64_t epoch = reset_epoch_.load(std::memory_order_acquire);
+  for (const auto& shard : shards_) {
+    std::array<uint64_t, kMaxDepth> counts{};
+    std::array<uint64_t, kMaxDepth> latencies{};
+    const bool current = thread_shards::Read(*shard, epoch, [&] {
+      for (size_t row = 0; row < options_.depth; ++row) {
+        counts[row] = Load(shard->cells[indexes[row]].count);
+        latencies[row] = Load(shard->cells[indexes[row]].latency_ns);
+      }
+    });
+    if (!current) {
+      continue;  // Counts from before a Reset() the owner has not applied yet
+    }
+    for (size_t row = 0; row < options_.depth; ++row) {
+      row_counts[row] += counts[row];
+      row_latencies[row] += latencies[row];
+    }
+  }
+
+  count = *std::min_element(row_counts.begin(), row_counts.begin() + options_.depth);
+  latency_ns = *std::min_element(row_latencies.begin(), row_latencies.begin() + options_.depth);
+}
+
+HeavyHittersSnapshot HeavyHitters::Snapshot() const {
+  HeavyHittersSnapshot snapshot;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t epoch = reset_epoch_.load(std::memory_order_acquire);
+  for (const auto& shard : shards_) {
+    uint64_t requests = 0;
+    uint64_t latency_ns = 0;
+    if (thread_shards::Read(*shard, epoch, [&] {
+          requests = Load(shard->requests);
+          latency_ns = Load(shard->total_latency_ns);
+        })) {
+      snapshot.total_requests += requests;
+      snapshot.total_latency_ns += latency_ns;
+    }
+  }
+
+  snapshot.top.reserve(candidates_.size());
+  for (const auto& candidate : candidates_) {
+    HeavyHitter& hitter = snapshot.top.emplace_back();
+    hitter.command = candidate.command;
+    Estimate(candidate.hash, hitter.count, hitter.latency_ns);
+    if (snapshot.total_latency_ns != 0) {
+      hitter.latency_share =
+          static_cast<double>(hitter.latency_ns) / static_cast<double>(snapshot.total_latency_ns);
+    }
+  }
+
+  std::sort(snapshot.top.begin(), snapshot.top.end(), [](const HeavyHitter& lhs, const HeavyHitter& rhs) {
+    return lhs.count != rhs.count ? lhs.count > rhs.count : lhs.command < rhs.command;
+  });
+  if (snapshot.top.size() > options_.top_k) {
+    snapshot.top.resize(options_.top_k);
+  }
+  return snapshot;
+}
+
+void HeavyHitters::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  reset_epoch_.fetch_add(1, std::memory_order_acq_rel);  // Each thread clears its sketch at its next Record()
+  candidates_.clear();
+  threshold_.store(0, std::memory_order_relaxed);
+  generation_.fetch_add(1, std::memory_order_release);
+}
+
+}  // namespace mygramdb::client
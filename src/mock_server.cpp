@@ -0,0 +1,598 @@
+/**
+ * @file mock_server.cpp
+ * @brief In-process MygramDB protocol stand-in for tests and benchmarks
+ */
+
+#include "mygramdb/mock_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <string_view>
+#include <utility>
+
+namespace mygramdb::mock {
+
+using mygram::utils::Error;
+using mygram::utils::ErrorCode;
+using mygram::utils::Expected;
+using mygram::utils::MakeError;
+using mygram::utils::MakeUnexpected;
+
+namespace {
+
+constexpr size_t kRecvChunk = 4096;
+constexpr uint32_t kDefaultLimit = 100;  // Server default when SEARCH has no LIMIT
+constexpr const char* kDefaultDumpPath = "/tmp/mygramdb-mock.dmp";
+constexpr const char* kMockGtid = "3E11FA47-71CA-11E1-9E33-C80AA9429562";
+constexpr const char* kFieldNames[] = {"title", "status", "category", "score", "created_at", "lang"};
+
+uint64_t SplitMix64(uint64_t value) {
+  value += 0x9E3779B97F4A7C15ULL;
+  value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27U)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31U);
+}
+
+uint64_t HashTerm(std::string_view term, uint64_t seed) {
+  uint64_t hash = 0xCBF29CE484222325ULL ^ seed;  // FNV-1a, remixed below
+  for (char c : term) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ULL;
+  }
+  return SplitMix64(hash);
+}
+
+/**
+ * @brief Map a hash to [lo, hi)
+ */
+double Fraction(uint64_t hash, double lo, double hi) {
+  return lo + ((hi - lo) * static_cast<double>(hash >> 11U) * 0x1.0p-53);
+}
+
+/**
+ * @brief Split off the next token: a double-quoted string (with backslash
+ *        escapes, which are removed) or a run of non-space characters
+ */
+std::string NextToken(std::string_view& rest) {
+  size_t start = rest.find_first_not_of(' ');
+  if (start == std::string_view::npos) {
+    rest = {};
+    return {};
+  }
+  rest.remove_prefix(start);
+
+  std::string token;
+  if (rest.front() == '"') {
+    size_t pos = 1;
+    while (pos < rest.size() && rest[pos] != '"') {
+      if (rest[pos] == '\\' && pos + 1 < rest.size()) {
+        ++pos;
+      }
+      token += rest[pos++];
+    }
+    rest.remove_prefix(std::min(pos + 1, rest.size()));
+    return token;
+  }
+
+  size_t end = std::min(rest.find(' '), rest.size());
+  token.assign(rest.substr(0, end));
+  rest.remove_prefix(end);
+  return token;
+}
+
+bool ParseUint(const std::string& text, uint64_t& out) {
+  if (text.empty() || text.size() > 19 || text.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  out = std::stoull(text);
+  return true;
+}
+
+std::string ErrorReply(std::string_view message) {
+  std::string reply = "ERROR ";
+  reply.append(message);
+  reply += "\r\n";
+  return reply;
+}
+
+/**
+ * @brief Parsed SEARCH/COUNT arguments
+ */
+struct Query {
+  const MockTable* table = nullptr;
+  std::string text;
+  std::vector<std::string> and_terms;
+  std::vector<std::string> not_terms;
+  std::vector<std::string> filters;  // "key op value"
+  bool sort_desc = true;             // Primary key descending unless SORT ... ASC
+  uint64_t offset = 0;
+  uint64_t limit = kDefaultLimit;
+};
+
+/**
+ * @brief Synthetic evaluation of a Query: match counts at each stage
+ */
+struct Evaluation {
+  uint64_t candidates = 0;
+  uint64_t after_intersection = 0;
+  uint64_t after_not = 0;
+  uint64_t after_filters = 0;
+};
+
+Evaluation Evaluate(const Query& query, uint64_t seed) {
+  const MockTable& table = *query.table;
+  const auto documents = static_cast<double>(table.documents);
+
+  Evaluation eval;
+  eval.candidates = static_cast<uint64_t>(
+      documents * Fraction(HashTerm(query.text, seed), table.min_selectivity, table.max_selectivity));
+  double matched = static_cast<double>(eval.candidates);
+  for (const auto& term : query.and_terms) {
+    matched *= Fraction(HashTerm(term, seed), 0.05, 0.5);  // Fraction of matches that also contain term
+  }
+  eval.after_intersection = static_cast<uint64_t>(matched);
+  for (const auto& term : query.not_terms) {
+    matched *= Fraction(HashTerm(term, seed), 0.8, 0.99);
+  }
+  eval.after_not = static_cast<uint64_t>(matched);
+  for (const auto& filter : query.filters) {
+    matched *= Fraction(HashTerm(filter, seed), 0.1, 0.9);
+  }
+  eval.after_filters = static_cast<uint64_t>(matched);
+  return eval;
+}
+
+/**
+ * @brief Primary key of the index-th match (0-based, ascending)
+ *
+ * Matches are spread evenly over 1..documents from a query-dependent start,
+ * so they are distinct for index < total.
+ */
+uint64_t MatchKey(uint64_t start, uint64_t stride, uint64_t documents, uint64_t index) {
+  return ((start + (index * stride)) % documents) + 1;
+}
+
+}  // namespace
+
+Expected<std::unique_ptr<MockServer>, Error> MockServer::Start(MockServerOptions options) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return MakeUnexpected(MakeError(ErrorCode::kIOError, std::string("socket failed: ") + std::strerror(errno)));
+  }
+  int reuse = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(options.port);
+  if (inet_pton(AF_INET, options.host.c_str(), &addr.sin_addr) != 1) {
+    close(fd);
+    return MakeUnexpected(MakeError(ErrorCode::kInvalidArgument, "Invalid listen address: " + options.host));
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+    std::string message = std::string("bind/listen failed: ") + std::strerror(errno);
+    close(fd);
+    return MakeUnexpected(MakeError(ErrorCode::kIOError, message));
+  }
+
+  socklen_t len = sizeof(addr);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+
+  std::unique_ptr<MockServer> server(new MockServer(std::move(options), fd, ntohs(addr.sin_port)));
+  server->acceptor_ = std::thread([raw = server.get()] { raw->AcceptLoop(); });
+  return server;
+}
+
+MockServer::MockServer(MockServerOptions options, int listen_fd, uint16_t port)
+    : options_(std::move(options)), listen_fd_(listen_fd), port_(port), started_(std::chrono::steady_clock::now()) {}
+
+MockServer::~MockServer() { Stop(); }
+
+MockServerStats MockServer::Stats() const {
+  MockServerStats stats;
+  stats.connections = connections_.load();
+  stats.requests = requests_.load();
+  stats.errors_injected = errors_injected_.load();
+  stats.disconnects = disconnects_.load();
+  stats.bytes_sent = bytes_sent_.load();
+  return stats;
+}
+
+void MockServer::Stop() {
+  if (stopping_.exchange(true)) {
+    return;
+  }
+  // shutdown() wakes the blocked accept()/recv() calls
+  shutdown(listen_fd_, SHUT_RDWR);
+  if (acceptor_.joinable()) {
+    acceptor_.join();
+  }
+
+  std::vector<std::thread> workers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int conn : connection_fds_) {
+      shutdown(conn, SHUT_RDWR);
+    }
+    workers.swap(workers_);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  close(listen_fd_);
+}
+
+void MockServer::AcceptLoop() {
+  while (!stopping_.load()) {
+    int conn = accept(listen_fd_, nullptr, nullptr);
+    if (conn < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      return;
+    }
+    int nodelay = 1;
+    setsockopt(conn, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_.load()) {
+      close(conn);
+      return;
+    }
+    // Join the workers of connections that have ended, so a long run with
+    // reconnecting clients does not pile up finished threads
+    for (const std::thread::id id : finished_workers_) {
+      auto worker = std::find_if(workers_.begin(), workers_.end(),
+                                 [id](const std::thread& thread) { return thread.get_id() == id; });
+      if (worker != workers_.end()) {
+        worker->join();
+        workers_.erase(worker);
+      }
+    }
+    finished_workers_.clear();
+
+    const uint64_t index = connections_++;
+    connection_fds_.push_back(conn);
+    workers_.emplace_back([this, conn, index] { Serve(conn, index); });
+  }
+}
+
+void MockServer::Serve(int conn, uint64_t index) {
+  // Each connection draws faults and latencies from its own stream, so runs
+  // with one connection are reproducible
+  std::mt19937_64 rng(SplitMix64(options_.seed + index));
+  std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+  const LatencyModel& latency = options_.latency;
+  auto sample_latency_us = [&]() -> double {
+    switch (latency.distribution) {
+      case LatencyModel::Distribution::kFixed:
+        return latency.a_us;
+      case LatencyModel::Distribution::kUniform:
+        return std::uniform_real_distribution<double>(latency.a_us, std::max(latency.a_us, latency.b))(rng);
+      case LatencyModel::Distribution::kExponential:
+        return latency.a_us > 0 ? std::exponential_distribution<double>(1.0 / latency.a_us)(rng) : 0.0;
+      case LatencyModel::Distribution::kLogNormal:
+        return latency.a_us > 0 ? std::lognormal_distribution<double>(std::log(latency.a_us), latency.b)(rng) : 0.0;
+      case LatencyModel::Distribution::kNone:
+        break;
+    }
+    return 0.0;
+  };
+
+  // Write reply in segments; false when the peer is gone
+  auto send_reply = [&](const std::string& reply) {
+    size_t sent = 0;
+    while (sent < reply.size()) {
+      size_t chunk = options_.segment_bytes > 0 ? std::min(options_.segment_bytes, reply.size() - sent)
+                                                : reply.size() - sent;
+      // The client takes a read ending in \r\n as a complete reply, so never
+      // end a segment right after an inner line terminator of a multi-line reply
+      if (sent + chunk < reply.size() && reply[sent + chunk - 1] == '\n') {
+        ++chunk;
+      }
+      if (sent > 0 && options_.segment_delay_us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(options_.segment_delay_us));
+      }
+      ssize_t written = send(conn, reply.data() + sent, chunk, MSG_NOSIGNAL);
+      if (written <= 0) {
+        return false;
+      }
+      sent += static_cast<size_t>(written);
+      bytes_sent_ += static_cast<uint64_t>(written);
+    }
+    return true;
+  };
+
+  bool debug = false;
+  std::string buffer;
+  char chunk[kRecvChunk];
+  bool open = true;
+  while (open && !stopping_.load()) {
+    ssize_t received = recv(conn, chunk, sizeof(chunk), 0);
+    if (received <= 0) {
+      break;
+    }
+    buffer.append(chunk, static_cast<size_t>(received));
+
+    size_t line_end = 0;
+    while (open && (line_end = buffer.find('\n')) != std::string::npos) {
+      std::string line = buffer.substr(0, line_end);
+      buffer.erase(0, line_end + 1);
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+      if (line.empty()) {
+        continue;
+      }
+
+      const uint64_t request = ++requests_;
+      if ((options_.disconnect_every > 0 && request % options_.disconnect_every == 0) ||
+          (options_.disconnect_rate > 0 && coin(rng) < options_.disconnect_rate)) {
+        ++disconnects_;
+        open = false;
+        break;
+      }
+
+      std::string reply;
+      if ((options_.error_every > 0 && request % options_.error_every == 0) ||
+          (options_.error_rate > 0 && coin(rng) < options_.error_rate)) {
+        ++errors_injected_;
+        reply = ErrorReply("Injected failure");
+      } else {
+        reply = Respond(line, debug);
+      }
+
+      if (double delay_us = sample_latency_us(); delay_us > 0) {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(delay_us));
+      }
+      open = send_reply(reply);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    connection_fds_.erase(std::remove(connection_fds_.begin(), connection_fds_.end(), conn), connection_fds_.end());
+    finished_workers_.push_back(std::this_thread::get_id());
+  }
+  close(conn);
+}
+
+std::string MockServer::Respond(const std::string& line, bool& debug) const {
+  std::string_view rest = line;
+  const std::string verb = NextToken(rest);
+
+  auto find_table = [&](const std::string& name) -> const MockTable* {
+    for (const auto& table : options_.tables) {
+      if (table.name == name) {
+        return &table;
+      }
+    }
+    return nullptr;
+  };
+
+  if (verb == "SEARCH" || verb == "COUNT") {
+    const auto begin = std::chrono::steady_clock::now();
+    Query query;
+    const std::string table_name = NextToken(rest);
+    query.table = find_table(table_name);
+    if (query.table == nullptr) {
+      return ErrorReply("Table not found: " + table_name);
+    }
+    query.text = NextToken(rest);
+    if (query.text.empty()) {
+      return ErrorReply("Missing query");
+    }
+
+    for (std::string token = NextToken(rest); !token.empty(); token = NextToken(rest)) {
+      if (token == "AND") {
+        query.and_terms.push_back(NextToken(rest));
+      } else if (token == "NOT") {
+        query.not_terms.push_back(NextToken(rest));
+      } else if (token == "FILTER") {
+        std::string key = NextToken(rest);
+        std::string op = NextToken(rest);
+        std::string value = NextToken(rest);
+        if (value.empty()) {
+          return ErrorReply("Invalid FILTER clause");
+        }
+        query.filters.push_back(key + ' ' + op + ' ' + value);
+      } else if (token == "SORT") {
+        std::string next = NextToken(rest);
+        if (next != "ASC" && next != "DESC") {
+          next = NextToken(rest);  // SORT <column> [ASC|DESC]; the column does not change the mock order
+        }
+        query.sort_desc = next != "ASC";
+      } else if (token == "LIMIT") {
+        std::string value = NextToken(rest);
+        size_t comma = value.find(',');
+        bool valid = comma == std::string::npos
+                         ? ParseUint(value, query.limit)
+                         : ParseUint(value.substr(0, comma), query.offset) &&
+                               ParseUint(value.substr(comma + 1), query.limit);
+        if (!valid) {
+          return ErrorReply("Invalid LIMIT: " + value);
+        }
+      } else {
+        return ErrorReply("Unexpected token: " + token);
+      }
+    }
+
+    const Evaluation eval = Evaluate(query, options_.seed);
+    const uint64_t total = eval.after_filters;
+    std::string reply;
+    if (verb == "COUNT") {
+      reply = "OK COUNT " + std::to_string(total);
+    } else {
+      reply = "OK RESULTS " + std::to_string(total);
+      const uint64_t documents = query.table->documents;
+      const uint64_t start = HashTerm(query.text, options_.seed) % documents;
+      const uint64_t stride = total > 0 ? std::max<uint64_t>(documents / total, 1) : 1;
+      const uint64_t end = std::min(total, query.offset + query.limit);
+      for (uint64_t i = query.offset; i < end; ++i) {
+        reply += ' ';
+        reply += std::to_string(MatchKey(start, stride, documents, query.sort_desc ? total - 1 - i : i));
+      }
+    }
+
+    if (debug) {
+      const double elapsed_ms =
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+      const size_t terms = 1 + query.and_terms.size() + query.not_terms.size();
+      char timings[96];
+      std::snprintf(timings, sizeof(timings), "query_time=%.3f index_time=%.3f filter_time=%.3f", elapsed_ms,
+                    elapsed_ms * 0.8, query.filters.empty() ? 0.0 : elapsed_ms * 0.1);
+      reply += " DEBUG ";
+      reply += timings;
+      reply += " terms=" + std::to_string(terms);
+      reply += " ngrams=" + std::to_string(terms * 2);
+      reply += " candidates=" + std::to_string(eval.candidates);
+      reply += " after_intersection=" + std::to_string(eval.after_intersection);
+      reply += " after_not=" + std::to_string(eval.after_not);
+      reply += " after_filters=" + std::to_string(eval.after_filters);
+      reply += " final=" + std::to_string(total);
+      reply += query.and_terms.empty() ? " optimization=single_term" : " optimization=intersection";
+    }
+    reply += "\r\n";
+    return reply;
+  }
+
+  if (verb == "GET") {
+    const std::string table_name = NextToken(rest);
+    const MockTable* table = find_table(table_name);
+    if (table == nullptr) {
+      return ErrorReply("Table not found: " + table_name);
+    }
+    const std::string key = NextToken(rest);
+    uint64_t pk = 0;
+    if (!ParseUint(key, pk) || pk == 0 || pk > table->documents) {
+      return ErrorReply("Document not found: " + key);
+    }
+
+    std::string reply = "OK DOC " + key;
+    const uint64_t hash = SplitMix64(options_.seed ^ pk);
+    for (uint32_t i = 0; i < table->fields; ++i) {
+      reply += ' ';
+      if (i < std::size(kFieldNames)) {
+        reply += kFieldNames[i];
+      } else {
+        reply += "field" + std::to_string(i);
+      }
+      reply += '=';
+      switch (i) {
+        case 0:
+          reply += "Document_" + key;
+          break;
+        case 1:
+          reply += std::to_string(hash % 3);
+          break;
+        case 2:
+          reply += "cat" + std::to_string((hash >> 8U) % 16);
+          break;
+        default:
+          reply += std::to_string((hash >> (i * 4U)) % 1000);
+          break;
+      }
+    }
+    reply += "\r\n";
+    return reply;
+  }
+
+  if (verb == "INFO") {
+    uint64_t documents = 0;
+    std::string tables;
+    for (const auto& table : options_.tables) {
+      documents += table.documents;
+      tables += tables.empty() ? table.name : ',' + table.name;
+    }
+    const auto uptime =
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - started_).count();
+    size_t active = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      active = connection_fds_.size();
+    }
+
+    std::string reply = "OK INFO\r\n# Server\r\nversion: mock\r\n";
+    reply += "uptime_seconds: " + std::to_string(uptime) + "\r\n\r\n";
+    reply += "# Stats\r\ntotal_requests: " + std::to_string(requests_.load()) + "\r\n\r\n";
+    reply += "# Clients\r\nactive_connections: " + std::to_string(active) + "\r\n\r\n";
+    reply += "# Memory\r\nindex_size_bytes: " + std::to_string(documents * 64) + "\r\n\r\n";
+    reply += "# Index\r\ntotal_documents: " + std::to_string(documents) + "\r\ntables: " + tables + "\r\n";
+    return reply;
+  }
+
+  if (verb == "CONFIG") {
+    std::string reply = "OK CONFIG\r\nmysql:\r\n  host: mock\r\ntables:\r\n";
+    for (const auto& table : options_.tables) {
+      reply += "  - name: " + table.name + "\r\n    documents: " + std::to_string(table.documents) + "\r\n";
+    }
+    return reply;
+  }
+
+  if (verb == "SAVE") {
+    std::string path = NextToken(rest);
+    return "OK SAVED " + (path.empty() ? std::string(kDefaultDumpPath) : path) + "\r\n";
+  }
+
+  if (verb == "LOAD") {
+    std::string path = NextToken(rest);
+    if (path.empty()) {
+      return ErrorReply("LOAD requires a file path");
+    }
+    return "OK LOADED " + path + "\r\n";
+  }
+
+  if (verb == "REPLICATION") {
+    const std::string action = NextToken(rest);
+    if (action == "STATUS") {
+      return std::string("OK REPLICATION status=") + (replication_running_.load() ? "running" : "stopped") +
+             " gtid=" + kMockGtid + ":1-" + std::to_string(requests_.load()) + "\r\n";
+    }
+    if (action == "STOP") {
+      replication_running_.store(false);
+      return "OK REPLICATION STOPPED\r\n";
+    }
+    if (action == "START") {
+      replication_running_.store(true);
+      return "OK REPLICATION STARTED\r\n";
+    }
+    return ErrorReply("Unknown REPLICATION command: " + action);
+  }
+
+  if (verb == "DEBUG") {
+    const std::string mode = NextToken(rest);
+    if (mode != "ON" && mode != "OFF") {
+      return ErrorReply("DEBUG requires ON or OFF");
+    }
+    debug = mode == "ON";
+    return "OK DEBUG_" + mode + "\r\n";
+  }
+
+  if (verb == "SYNC") {
+    const std::string target = NextToken(rest);
+    if (target == "STATUS") {
+      return "OK SYNC STATUS status=IDLE\r\n";
+    }
+    if (find_table(target) == nullptr) {
+      return ErrorReply("Table not found: " + target);
+    }
+    return "OK SYNC STARTED table=" + target + "\r\n";
+  }
+
+  return ErrorReply("Unknown command: " + verb);
+}
+
+}  // namespace mygramdb::mock
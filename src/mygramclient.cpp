@@ -7,34 +7,67 @@
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <unistd.h>
 
-#include <cctype>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
+#include <initializer_list>
 #include <iomanip>
 #include <sstream>
-#include <thread>
 #include <utility>
 
+#include "mygramdb/mygramclient_internal.h"
+#include "mygramdb/query_fingerprint.h"
 #include "utils/error.h"
 #include "utils/expected.h"
+#include "utils/query_scan.h"
+#include "utils/usdt.h"
 
 using namespace mygram::utils;
 
+MYGRAM_USDT_SEMAPHORE(command_build);
+MYGRAM_USDT_SEMAPHORE(send);
+MYGRAM_USDT_SEMAPHORE(recv_chunk);
+MYGRAM_USDT_SEMAPHORE(response_complete);
+MYGRAM_USDT_SEMAPHORE(parse_complete);
+
 namespace mygramdb::client {
 
 namespace {
 
+using mygramdb::utils::ScanTerm;
+using mygramdb::utils::TermScan;
+
 // Protocol constants
-constexpr size_t kErrorPrefixLen = 6;    // Length of "ERROR "
-constexpr size_t kSavedPrefixLen = 9;    // Length of "SNAPSHOT "
-constexpr size_t kLoadedPrefixLen = 10;  // Length of "SNAPSHOT: "
+constexpr std::string_view kErrorPrefix = "ERROR";
+constexpr size_t kErrorPrefixLen = 6;     // Length of "ERROR "
+constexpr size_t kSavedPrefixLen = 9;     // Length of "SNAPSHOT "
+constexpr size_t kLoadedPrefixLen = 10;   // Length of "SNAPSHOT: "
+constexpr size_t kDocPrefixLen = 6;       // Length of "OK DOC"
+constexpr size_t kResultsPrefixLen = 10;  // Length of "OK RESULTS"
+constexpr size_t kCountPrefixLen = 8;     // Length of "OK COUNT"
+constexpr size_t kMaxUint64Digits = 20;   // Decimal digits in UINT64_MAX
+constexpr double kNanosPerMilli = 1e6;    // DebugInfo times are in ms
+constexpr size_t kInsertionSortMaxFields = 64;  // DocumentFields index: insertion sort up to this size
 constexpr int kMillisecondsPerSecond = 1000;
 constexpr int kMicrosecondsPerMillisecond = 1000;
 
+/**
+ * @brief Whitespace separating tokens in single-line replies
+ */
+bool IsTokenSeparator(char character) {
+  return character == ' ' || character == '\t' || character == '\r' || character == '\n';
+}
+
 /**
  * @brief Parse key=value pairs from string
  */
@@ -56,46 +89,91 @@ std::vector<std::pair<std::string, std::string>> ParseKeyValuePairs(const std::s
 }
 
 /**
- * @brief Extract debug info from response tokens
+ * @brief Split the next whitespace-separated token off the front of a view
  */
-std::optional<DebugInfo> ParseDebugInfo(const std::vector<std::string>& tokens, size_t start_index) {
-  if (start_index >= tokens.size() || tokens[start_index] != "DEBUG") {
-    return std::nullopt;
+std::string_view NextToken(std::string_view& rest) {
+  size_t pos = 0;
+  while (pos < rest.size() && IsTokenSeparator(rest[pos])) {
+    ++pos;
+  }
+  size_t end = pos;
+  while (end < rest.size() && !IsTokenSeparator(rest[end])) {
+    ++end;
+  }
+  std::string_view token = rest.substr(pos, end - pos);
+  rest.remove_prefix(end);
+  return token;
+}
+
+/**
+ * @brief Parse an unsigned integer token (whole token must be numeric)
+ */
+template <typename T>
+bool ParseUnsigned(std::string_view token, T& out) {
+  const char* last = token.data() + token.size();
+  auto [ptr, ec] = std::from_chars(token.data(), last, out);
+  return ec == std::errc() && ptr == last && !token.empty();
+}
+
+/**
+ * @brief Parse a floating-point token (whole token must be numeric)
+ */
+bool ParseDouble(std::string_view token, double& out) {
+  if (token.empty()) {
+    return false;
   }
+#if defined(__cpp_lib_to_chars)
+  const char* last = token.data() + token.size();
+  auto [ptr, ec] = std::from_chars(token.data(), last, out);
+  return ec == std::errc() && ptr == last;
+#else
+  // Standard library without floating-point from_chars: tokens are not
+  // NUL-terminated inside the reply buffer, so parse a copy
+  std::string copy(token);
+  char* end = nullptr;
+  out = std::strtod(copy.c_str(), &end);
+  return end == copy.c_str() + copy.size();
+#endif
+}
 
+/**
+ * @brief Parse debug info from the key=value tokens following "DEBUG"
+ *
+ * Values that fail to parse leave the corresponding field at its default.
+ */
+DebugInfo ParseDebugInfo(std::string_view rest) {
   DebugInfo info;
-  for (size_t i = start_index + 1; i < tokens.size(); ++i) {
-    const auto& token = tokens[i];
+  for (std::string_view token = NextToken(rest); !token.empty(); token = NextToken(rest)) {
     size_t pos = token.find('=');
-    if (pos == std::string::npos) {
+    if (pos == std::string_view::npos) {
       continue;
     }
 
-    std::string key = token.substr(0, pos);
-    std::string value = token.substr(pos + 1);
+    std::string_view key = token.substr(0, pos);
+    std::string_view value = token.substr(pos + 1);
 
     if (key == "query_time") {
-      info.query_time_ms = std::stod(value);
+      ParseDouble(value, info.query_time_ms);
     } else if (key == "index_time") {
-      info.index_time_ms = std::stod(value);
+      ParseDouble(value, info.index_time_ms);
     } else if (key == "filter_time") {
-      info.filter_time_ms = std::stod(value);
+      ParseDouble(value, info.filter_time_ms);
     } else if (key == "terms") {
-      info.terms = static_cast<uint32_t>(std::stoul(value));
+      ParseUnsigned(value, info.terms);
     } else if (key == "ngrams") {
-      info.ngrams = static_cast<uint32_t>(std::stoul(value));
+      ParseUnsigned(value, info.ngrams);
     } else if (key == "candidates") {
-      info.candidates = std::stoull(value);
+      ParseUnsigned(value, info.candidates);
     } else if (key == "after_intersection") {
-      info.after_intersection = std::stoull(value);
+      ParseUnsigned(value, info.after_intersection);
     } else if (key == "after_not") {
-      info.after_not = std::stoull(value);
+      ParseUnsigned(value, info.after_not);
     } else if (key == "after_filters") {
-      info.after_filters = std::stoull(value);
+      ParseUnsigned(value, info.after_filters);
     } else if (key == "final") {
-      info.final = std::stoull(value);
+      ParseUnsigned(value, info.final);
     } else if (key == "optimization") {
-      info.optimization = value;
+      info.optimization = std::string(value);
     }
   }
 
@@ -103,59 +181,763 @@ std::optional<DebugInfo> ParseDebugInfo(const std::vector<std::string>& tokens,
 }
 
 /**
- * @brief Validate that a string does not contain ASCII control characters
+ * @brief Map an "ERROR ..." reply to a server error, or anything not starting
+ *        with the expected prefix to a protocol error
+ */
+Expected<void, Error> CheckReplyPrefix(std::string_view response, std::string_view expected_prefix) {
+  if (response.substr(0, kErrorPrefix.size()) == kErrorPrefix) {
+    std::string_view message = response.substr(std::min(kErrorPrefixLen, response.size()));
+    return MakeUnexpected(MakeError(ErrorCode::kClientServerError, std::string(message)));
+  }
+  if (response.substr(0, expected_prefix.size()) != expected_prefix) {
+    return MakeUnexpected(MakeError(ErrorCode::kClientProtocolError, "Unexpected response format"));
+  }
+  return {};
+}
+
+/**
+ * @brief Parse a SEARCH reply: OK RESULTS <total_count> [<id1> <id2> ...] [DEBUG ...]
+ *
+ * Result IDs are handed to on_key in reply order as views into response, so
+ * the caller decides where (and with which allocator) they are stored.
+ */
+template <typename OnKey>
+Expected<void, Error> ParseSearchReply(std::string_view response, uint64_t& total_count,
+                                       std::optional<DebugInfo>& debug, OnKey&& on_key) {
+  if (auto status = CheckReplyPrefix(response, "OK RESULTS"); !status) {
+    return status;
+  }
+
+  std::string_view rest = response.substr(kResultsPrefixLen);
+  total_count = 0;
+  ParseUnsigned(NextToken(rest), total_count);
+
+  for (std::string_view token = NextToken(rest); !token.empty(); token = NextToken(rest)) {
+    if (token == "DEBUG") {
+      debug = ParseDebugInfo(rest);
+      break;
+    }
+    on_key(token);
+  }
+
+  return {};
+}
+
+}  // namespace
+
+/**
+ * @brief Parse a SEARCH reply into a reused response
+ *
+ * Existing result elements (and their string capacity) are reused. On error
+ * the contents of out are unspecified.
+ */
+Expected<void, Error> ParseSearchReply(std::string_view response, SearchResponse& out) {
+  size_t count = 0;
+  out.debug.reset();
+  out.timing.reset();
+  auto parsed = ParseSearchReply(response, out.total_count, out.debug, [&out, &count](std::string_view key) {
+    if (count < out.results.size()) {
+      out.results[count].primary_key.assign(key.data(), key.size());
+    } else {
+      out.results.emplace_back(std::string(key));
+    }
+    ++count;
+  });
+  out.results.resize(count);
+  return parsed;
+}
+
+/**
+ * @brief Parse a SEARCH reply into views of its keys, valid as long as response
+ */
+Expected<void, Error> ParseSearchReply(std::string_view response, SearchResponseView& out) {
+  out.primary_keys.clear();
+  out.debug.reset();
+  out.timing.reset();
+  return ParseSearchReply(response, out.total_count, out.debug,
+                          [&out](std::string_view key) { out.primary_keys.push_back(key); });
+}
+
+/**
+ * @brief Parse a GET reply: OK DOC <primary_key> [<key=value>...]
+ */
+Expected<void, Error> ParseGetReply(std::string_view response, Document& out) {
+  if (auto status = CheckReplyPrefix(response, "OK DOC"); !status) {
+    return status;
+  }
+
+  std::string_view rest = response.substr(kDocPrefixLen);
+  std::string_view doc_pk = NextToken(rest);
+  out.primary_key.assign(doc_pk.data(), doc_pk.size());
+
+  // Remaining key=value pairs are sliced out of a copy of the reply kept by the fields
+  out.fields.Assign(response, response.size() - rest.size());
+  return {};
+}
+
+/**
+ * @brief Parse a COUNT reply: OK COUNT <n> [DEBUG ...]
+ */
+Expected<void, Error> ParseCountReply(std::string_view response, CountResponse& resp) {
+  if (auto status = CheckReplyPrefix(response, "OK COUNT"); !status) {
+    return status;
+  }
+
+  std::string_view rest = response.substr(kCountPrefixLen);
+  resp.count = 0;
+  ParseUnsigned(NextToken(rest), resp.count);
+
+  if (NextToken(rest) == "DEBUG") {
+    resp.debug = ParseDebugInfo(rest);
+  }
+
+  return {};
+}
+
+/**
+ * @brief Parse an INFO reply: OK INFO followed by Redis-style "key: value" lines
+ */
+Expected<void, Error> ParseInfoReply(std::string_view response, ServerInfo& out) {
+  if (auto status = CheckReplyPrefix(response, "OK INFO"); !status) {
+    return status;
+  }
+
+  std::istringstream iss{std::string(response)};
+  std::string line;
+
+  // Skip first line "OK INFO"
+  std::getline(iss, line);
+
+  while (std::getline(iss, line)) {
+    // Skip empty lines and section headers (lines starting with #)
+    if (line.empty() || line[0] == '#' || line[0] == '\r') {
+      continue;
+    }
+
+    // Parse "key: value" format
+    size_t colon_pos = line.find(':');
+    if (colon_pos != std::string::npos) {
+      std::string key = line.substr(0, colon_pos);
+      std::string value = line.substr(colon_pos + 1);
+
+      // Trim leading/trailing whitespace from value
+      size_t start = value.find_first_not_of(" \t\r\n");
+      size_t end = value.find_last_not_of(" \t\r\n");
+      if (start != std::string::npos) {
+        value = value.substr(start, end - start + 1);
+      }
+
+      if (key == "version") {
+        out.version = value;
+      } else if (key == "uptime_seconds") {
+        out.uptime_seconds = std::stoull(value);
+      } else if (key == "total_requests") {
+        out.total_requests = std::stoull(value);
+      } else if (key == "active_connections") {
+        out.active_connections = std::stoull(value);
+      } else if (key == "index_size_bytes") {
+        out.index_size_bytes = std::stoull(value);
+      } else if (key == "doc_count" || key == "total_documents") {
+        out.doc_count = std::stoull(value);
+      } else if (key == "tables") {
+        // Parse comma-separated table names
+        std::istringstream table_iss(value);
+        std::string table;
+        while (std::getline(table_iss, table, ',')) {
+          if (!table.empty()) {
+            out.tables.push_back(table);
+          }
+        }
+      }
+    }
+  }
+
+  return {};
+}
+
+namespace {
+
+/**
+ * @brief Parse the reply to a pipelined or submitted command into the response of its type
+ */
+Expected<void, Error> ParseTypedReply(CommandType type, std::string_view reply, SearchResponse& search,
+                                      CountResponse& count, Document& document) {
+  if (type == CommandType::kSearch) {
+    return ParseSearchReply(reply, search);
+  }
+  if (type == CommandType::kCount) {
+    count.debug.reset();
+    count.timing.reset();
+    return ParseCountReply(reply, count);
+  }
+  return ParseGetReply(reply, document);
+}
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief SEARCH/COUNT in flight, recorded by the query stats and heavy
+ *        hitters once its latency is known
+ */
+struct PendingQuery {
+  bool pending = false;     // A SEARCH/COUNT was built while either (or a capture) is enabled
+  std::string command;      // Heavy hitters only
+  std::string fingerprint;  // Query stats only
+  uint64_t matched = 0;
+  std::optional<DebugInfo> debug;
+};
+
+/**
+ * @brief Phase boundaries of one request, stamped when timing is enabled
+ */
+struct PhaseMarks {
+  Clock::time_point start;       // Before the command is built
+  Clock::time_point built;       // Command ready to send
+  Clock::time_point sent;        // send() returned
+  Clock::time_point first_byte;  // First reply bytes received
+  Clock::time_point received;    // Reply complete
+};
+
+uint64_t ElapsedNs(Clock::time_point from, Clock::time_point to) {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+/**
+ * @brief Request submitted on the non-blocking interface
+ */
+struct AsyncRequest {
+  AsyncResult result;
+  size_t command_bytes = 0;
+  Clock::time_point start;  // Submitted
+};
+
+/**
+ * @brief Requests of the non-blocking interface, in submission order
+ *
+ * Replies arrive in submission order too, so the requests form a ring whose
+ * first `ready` entries are answered and wait for PollResult() while the rest
+ * are in flight. Slots are reused: polling swaps the result with the
+ * caller's, so a slot keeps the caller's old response storage.
  */
-std::optional<std::string> ValidateNoControlCharacters(const std::string& value, const char* field_name) {
-  for (unsigned char character : value) {
-    if (std::iscntrl(character) != 0) {
-      std::ostringstream oss;
-      oss << "Input for " << field_name << " contains control character 0x" << std::uppercase << std::hex
-          << std::setw(2) << std::setfill('0') << static_cast<int>(character) << ", which is not allowed";
-      return oss.str();
+struct AsyncQueue {
+  std::vector<AsyncRequest> slots;
+  size_t head = 0;
+  size_t size = 0;
+  size_t ready = 0;
+  uint64_t last_id = 0;
+  std::string output;       // Commands not completely written yet
+  size_t written = 0;       // Bytes of output already written
+  std::string input;        // Received bytes not parsed yet
+  size_t scanned = 0;       // No reply terminator in input before this offset
+  uint64_t recv_calls = 0;  // recv() calls since the last reply completed
+
+  AsyncRequest& At(size_t index) { return slots[(head + index) % slots.size()]; }
+
+  AsyncRequest& Push() {
+    if (size == slots.size()) {
+      std::vector<AsyncRequest> grown(std::max<size_t>(kMinSlots, slots.size() * 2));
+      for (size_t i = 0; i < size; ++i) {
+        grown[i] = std::move(At(i));
+      }
+      slots.swap(grown);
+      head = 0;
     }
+    return At(size++);
+  }
+
+  void Pop() {
+    head = (head + 1) % slots.size();
+    --size;
+    --ready;
   }
 
+  [[nodiscard]] bool InFlight() const { return ready < size; }
+
+  static constexpr size_t kMinSlots = 8;
+};
+
+/**
+ * @brief Error message for a control character found in user input
+ */
+std::string ControlCharacterMessage(const char* field_name, unsigned char character) {
+  std::ostringstream oss;
+  oss << "Input for " << field_name << " contains control character 0x" << std::uppercase << std::hex << std::setw(2)
+      << std::setfill('0') << static_cast<int>(character) << ", which is not allowed";
+  return oss.str();
+}
+
+/**
+ * @brief Validate that a string does not contain ASCII control characters
+ */
+std::optional<std::string> ValidateNoControlCharacters(std::string_view value, const char* field_name) {
+  TermScan scan = ScanTerm(value);
+  if (scan.HasControl()) {
+    return ControlCharacterMessage(field_name, static_cast<unsigned char>(value[scan.first_control]));
+  }
   return std::nullopt;
 }
 
 /**
- * @brief Escape special characters in query strings
+ * @brief Builds one protocol command into a reusable output string
+ *
+ * Begin() clears the string and reserves room for the whole command from a
+ * size hint, so in steady state (capacity already grown by earlier commands)
+ * building a command does not allocate. Finish() appends the \r\n terminator
+ * in place and returns the wire message.
+ *
+ * User-supplied arguments are validated as they are appended: each is
+ * scanned once (see ScanTerm) for control characters and, for query terms,
+ * for the characters that require quoting. The first invalid argument is
+ * reported by Finish(); anything appended after it is ignored.
+ *
+ * String may be any contiguous string type (std::string, std::pmr::string).
  */
-std::string EscapeQueryString(const std::string& str) {
-  // Check if string needs quoting (contains spaces or special chars)
-  bool needs_quotes = false;
-  for (char character : str) {
-    if (character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '"' ||
-        character == '\'') {
-      needs_quotes = true;
-      break;
+template <typename String>
+class CommandBuilder {
+ public:
+  static constexpr std::string_view kTerminator = "\r\n";
+
+  explicit CommandBuilder(String& out) : out_(out) {}
+
+  /**
+   * @brief Start a new command
+   * @param size_hint Expected command length without terminator
+   */
+  CommandBuilder& Begin(size_t size_hint) {
+    out_.clear();
+    out_.reserve(size_hint + kTerminator.size());
+    error_.reset();
+    return *this;
+  }
+
+  /**
+   * @brief Append protocol text verbatim (keywords, pre-validated fragments)
+   */
+  CommandBuilder& Append(std::string_view str) {
+    out_.append(str.data(), str.size());
+    return *this;
+  }
+
+  CommandBuilder& Append(char character) {
+    out_.push_back(character);
+    return *this;
+  }
+
+  /**
+   * @brief Append an unsigned integer in decimal
+   */
+  CommandBuilder& AppendNumber(uint64_t value) {
+    std::array<char, kMaxUint64Digits> digits{};
+    auto [ptr, ec] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    (void)ec;  // Cannot fail: buffer fits any uint64_t
+    out_.append(digits.data(), static_cast<size_t>(ptr - digits.data()));
+    return *this;
+  }
+
+  /**
+   * @brief Append an unquoted argument (table, column, key), rejecting control characters
+   */
+  CommandBuilder& AppendChecked(std::string_view str, const char* field_name) {
+    if (error_) {
+      return *this;
     }
+    TermScan scan = ScanTerm(str);
+    if (scan.HasControl()) {
+      return Reject(field_name, str[scan.first_control]);
+    }
+    return Append(str);
   }
 
-  if (!needs_quotes) {
-    return str;
+  /**
+   * @brief Append a query term, rejecting control characters and quoting it if needed
+   *
+   * Terms containing whitespace or quotes are wrapped in double quotes with
+   * internal quotes and backslashes escaped; other terms are appended as-is.
+   * The scan that validates the term also counts the escapes, so the quoted
+   * form is written into exactly the space it needs.
+   */
+  CommandBuilder& AppendTerm(std::string_view term, const char* field_name) {
+    if (error_) {
+      return *this;
+    }
+    TermScan scan = ScanTerm(term);
+    if (scan.HasControl()) {
+      return Reject(field_name, term[scan.first_control]);
+    }
+    if (!scan.needs_quoting) {
+      return Append(term);
+    }
+
+    // Use double quotes and escape internal quotes
+    out_.push_back('"');
+    if (scan.escapes == 0) {
+      out_.append(term.data(), term.size());
+    } else {
+      size_t run = 0;
+      for (size_t pos = 0; pos < term.size(); ++pos) {
+        if (term[pos] == '"' || term[pos] == '\\') {
+          out_.append(term.data() + run, pos - run);
+          out_.push_back('\\');
+          run = pos;
+        }
+      }
+      out_.append(term.data() + run, term.size() - run);
+    }
+    out_.push_back('"');
+    return *this;
+  }
+
+  /**
+   * @brief Finish the fragment built so far without a terminator
+   * @return Error for the first invalid argument, if any
+   */
+  Expected<void, Error> Status() const {
+    if (error_) {
+      return MakeUnexpected(*error_);
+    }
+    return {};
   }
 
-  // Use double quotes and escape internal quotes
-  std::string result = "\"";
-  for (char character : str) {
-    if (character == '"' || character == '\\') {
-      result += '\\';
+  /**
+   * @brief Append the terminator and return the complete message
+   * @return Message, or the error for the first invalid argument
+   */
+  Expected<std::string_view, Error> Finish() {
+    if (error_) {
+      return MakeUnexpected(*error_);
     }
-    result += character;
+    out_.append(kTerminator.data(), kTerminator.size());
+    return std::string_view(out_.data(), out_.size());
+  }
+
+ private:
+  CommandBuilder& Reject(const char* field_name, char character) {
+    error_ = MakeError(ErrorCode::kClientInvalidArgument,
+                       ControlCharacterMessage(field_name, static_cast<unsigned char>(character)));
+    return *this;
+  }
+
+  String& out_;
+  std::optional<Error> error_;  // First invalid argument
+};
+
+/**
+ * @brief Upper-bound length of " [AND ..] [NOT ..] [FILTER ..]"
+ *
+ * Assumes every term is quoted; escaped quotes/backslashes are rare enough
+ * that they are left to grow the buffer if they occur.
+ */
+size_t TermClausesSizeHint(const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+                           const std::vector<std::pair<std::string, std::string>>& filters) {
+  constexpr size_t kQuoted = 2;
+  constexpr size_t kAndLen = 5;      // " AND "
+  constexpr size_t kFilterLen = 11;  // " FILTER " + " = "
+  size_t size = 0;
+  for (const auto& term : and_terms) {
+    size += kAndLen + term.size() + kQuoted;
+  }
+  for (const auto& term : not_terms) {
+    size += kAndLen + term.size() + kQuoted;
+  }
+  for (const auto& [key, value] : filters) {
+    size += kFilterLen + key.size() + value.size() + kQuoted;
+  }
+  return size;
+}
+
+/**
+ * @brief Upper-bound length of "<table> <query> [AND ..] [NOT ..] [FILTER ..]"
+ */
+size_t QueryClausesSizeHint(std::string_view table, std::string_view query, const std::vector<std::string>& and_terms,
+                            const std::vector<std::string>& not_terms,
+                            const std::vector<std::pair<std::string, std::string>>& filters) {
+  constexpr size_t kQuoted = 2;
+  return table.size() + 1 + query.size() + kQuoted + TermClausesSizeHint(and_terms, not_terms, filters);
+}
+
+// SEARCH clause lengths used for size hints
+constexpr size_t kSearchLen = 7;                                // "SEARCH "
+constexpr size_t kSortLen = 11;                                 // " SORT " + " DESC"
+constexpr size_t kLimitLen = 7 + (2 * kMaxUint64Digits) + 1;  // " LIMIT <offset>,<limit>"
+
+/**
+ * @brief Append " [AND ..] [NOT ..] [FILTER ..]" following the query
+ */
+template <typename String>
+void AppendTermClauses(CommandBuilder<String>& builder, const std::vector<std::string>& and_terms,
+                       const std::vector<std::string>& not_terms,
+                       const std::vector<std::pair<std::string, std::string>>& filters) {
+  for (const auto& term : and_terms) {
+    builder.Append(" AND ").AppendTerm(term, "AND term");
+  }
+
+  for (const auto& term : not_terms) {
+    builder.Append(" NOT ").AppendTerm(term, "NOT term");
+  }
+
+  for (const auto& [key, value] : filters) {
+    builder.Append(" FILTER ").AppendChecked(key, "filter key").Append(" = ").AppendTerm(value, "filter value");
+  }
+}
+
+/**
+ * @brief Append "<table> <query> [AND ..] [NOT ..] [FILTER ..]" shared by SEARCH and COUNT
+ */
+template <typename String>
+void AppendQueryClauses(CommandBuilder<String>& builder, std::string_view table, std::string_view query,
+                        const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+                        const std::vector<std::pair<std::string, std::string>>& filters) {
+  builder.AppendChecked(table, "table name").Append(' ').AppendTerm(query, "search query");
+  AppendTermClauses(builder, and_terms, not_terms, filters);
+}
+
+/**
+ * @brief Append the SEARCH sort clause, if any
+ */
+template <typename String>
+void AppendSortClause(CommandBuilder<String>& builder, std::string_view sort_column, bool sort_desc) {
+  // SORT clause (replaces ORDER BY)
+  if (!sort_column.empty()) {
+    builder.Append(" SORT ").AppendChecked(sort_column, "sort column").Append(sort_desc ? " DESC" : " ASC");
+  } else if (!sort_desc) {
+    // Only add SORT ASC if explicitly requesting ascending order for primary key
+    builder.Append(" SORT ASC");
+  }
+  // Default is SORT DESC (primary key descending), so no need to add it explicitly
+}
+
+/**
+ * @brief Append the SEARCH limit clause, if any
+ */
+template <typename String>
+void AppendLimitClause(CommandBuilder<String>& builder, uint32_t limit, uint32_t offset) {
+  // LIMIT clause - MySQL-style offset,count format when both are specified
+  if (limit > 0) {
+    builder.Append(" LIMIT ");
+    if (offset > 0) {
+      builder.AppendNumber(offset).Append(',');
+    }
+    builder.AppendNumber(limit);
+  }
+}
+
+/**
+ * @brief Build a complete, terminated SEARCH command into out, validating every argument
+ */
+template <typename String>
+Expected<std::string_view, Error> BuildSearchCommand(String& out, const std::string& table, const std::string& query,
+                                                     uint32_t limit, uint32_t offset,
+                                                     const std::vector<std::string>& and_terms,
+                                                     const std::vector<std::string>& not_terms,
+                                                     const std::vector<std::pair<std::string, std::string>>& filters,
+                                                     const std::string& sort_column, bool sort_desc) {
+  CommandBuilder<String> builder(out);
+  builder.Begin(kSearchLen + QueryClausesSizeHint(table, query, and_terms, not_terms, filters) + kSortLen +
+                sort_column.size() + kLimitLen);
+
+  builder.Append("SEARCH ");
+  AppendQueryClauses(builder, table, query, and_terms, not_terms, filters);
+  AppendSortClause(builder, sort_column, sort_desc);
+  AppendLimitClause(builder, limit, offset);
+  return builder.Finish();
+}
+
+/**
+ * @brief Render the query-independent parts of a SEARCH command
+ */
+Expected<void, Error> RenderPreparedSearch(const std::string& table, const std::vector<std::string>& and_terms,
+                                           const std::vector<std::string>& not_terms,
+                                           const std::vector<std::pair<std::string, std::string>>& filters,
+                                           const std::string& sort_column, bool sort_desc, std::string& prefix,
+                                           std::string& suffix) {
+  CommandBuilder<std::string> prefix_builder(prefix);
+  prefix_builder.Begin(kSearchLen + table.size() + 1);
+  prefix_builder.Append("SEARCH ").AppendChecked(table, "table name").Append(' ');
+  if (auto status = prefix_builder.Status(); !status) {
+    return status;
   }
-  result += '"';
-  return result;
+
+  CommandBuilder<std::string> suffix_builder(suffix);
+  suffix_builder.Begin(TermClausesSizeHint(and_terms, not_terms, filters) + kSortLen + sort_column.size());
+  AppendTermClauses(suffix_builder, and_terms, not_terms, filters);
+  AppendSortClause(suffix_builder, sort_column, sort_desc);
+  return suffix_builder.Status();
+}
+
+/**
+ * @brief Build a terminated SEARCH command from a prepared prefix and suffix
+ *
+ * Produces the same bytes as BuildSearchCommand() with the arguments the
+ * prefix and suffix were rendered from.
+ */
+template <typename String>
+Expected<std::string_view, Error> BuildPreparedSearchCommand(String& out, std::string_view prefix,
+                                                             std::string_view suffix, std::string_view query,
+                                                             uint32_t limit, uint32_t offset) {
+  constexpr size_t kQuoted = 2;
+  CommandBuilder<String> builder(out);
+  builder.Begin(prefix.size() + query.size() + kQuoted + suffix.size() + kLimitLen);
+  builder.Append(prefix).AppendTerm(query, "search query").Append(suffix);
+  AppendLimitClause(builder, limit, offset);
+  return builder.Finish();
+}
+
+/**
+ * @brief Build a complete, terminated GET command into out
+ */
+template <typename String>
+Expected<std::string_view, Error> BuildGetCommand(String& out, std::string_view table, std::string_view primary_key) {
+  constexpr size_t kGetLen = 5;  // "GET " + separator
+  CommandBuilder<String> builder(out);
+  builder.Begin(kGetLen + table.size() + primary_key.size());
+  builder.Append("GET ").AppendChecked(table, "table name").Append(' ').AppendChecked(primary_key, "primary key");
+  return builder.Finish();
+}
+
+/**
+ * @brief Build a complete, terminated COUNT command into out
+ */
+template <typename String>
+Expected<std::string_view, Error> BuildCountCommand(String& out, const std::string& table, const std::string& query,
+                                                    const std::vector<std::string>& and_terms,
+                                                    const std::vector<std::string>& not_terms,
+                                                    const std::vector<std::pair<std::string, std::string>>& filters) {
+  constexpr size_t kCountLen = 6;  // "COUNT "
+  CommandBuilder<String> builder(out);
+  builder.Begin(kCountLen + QueryClausesSizeHint(table, query, and_terms, not_terms, filters));
+  builder.Append("COUNT ");
+  AppendQueryClauses(builder, table, query, and_terms, not_terms, filters);
+  return builder.Finish();
 }
 
 }  // namespace
 
+// DocumentFields implementation
+
+DocumentFields::DocumentFields(std::string buffer, size_t offset) : buffer_(std::move(buffer)) {
+  Index(offset);
+}
+
+void DocumentFields::Assign(std::string_view reply, size_t offset) {
+  buffer_.assign(reply.data(), reply.size());
+  Index(offset);
+}
+
+void DocumentFields::Index(size_t offset) {
+  slices_.clear();
+  const size_t len = buffer_.size();
+  size_t pos = std::min(offset, len);
+
+  while (pos < len) {
+    while (pos < len && IsTokenSeparator(buffer_[pos])) {
+      ++pos;
+    }
+    const size_t token_start = pos;
+    size_t equals_pos = std::string::npos;
+    while (pos < len && !IsTokenSeparator(buffer_[pos])) {
+      if (buffer_[pos] == '=' && equals_pos == std::string::npos) {
+        equals_pos = pos;
+      }
+      ++pos;
+    }
+    if (equals_pos != std::string::npos) {
+      slices_.push_back({static_cast<uint32_t>(token_start), static_cast<uint32_t>(equals_pos - token_start),
+                         static_cast<uint32_t>(equals_pos + 1), static_cast<uint32_t>(pos - equals_pos - 1)});
+    }
+  }
+
+  // Sort must be stable so that Find() returns the first occurrence of a
+  // duplicate key. Documents carry few fields, so an in-place insertion sort
+  // avoids std::stable_sort's temporary buffer for the common case.
+  index_.resize(slices_.size());
+  for (size_t i = 0; i < index_.size(); ++i) {
+    index_[i] = static_cast<uint32_t>(i);
+  }
+  auto key_less = [this](uint32_t lhs, uint32_t rhs) { return KeyAt(lhs) < KeyAt(rhs); };
+  if (index_.size() > kInsertionSortMaxFields) {
+    std::stable_sort(index_.begin(), index_.end(), key_less);
+    return;
+  }
+  for (size_t i = 1; i < index_.size(); ++i) {
+    uint32_t current = index_[i];
+    size_t j = i;
+    while (j > 0 && key_less(current, index_[j - 1])) {
+      index_[j] = index_[j - 1];
+      --j;
+    }
+    index_[j] = current;
+  }
+}
+
+std::string_view DocumentFields::KeyAt(size_t index) const {
+  const Slice& slice = slices_[index];
+  return std::string_view(buffer_).substr(slice.key_pos, slice.key_len);
+}
+
+DocumentFields::value_type DocumentFields::operator[](size_t index) const {
+  const Slice& slice = slices_[index];
+  std::string_view view(buffer_);
+  return {view.substr(slice.key_pos, slice.key_len), view.substr(slice.value_pos, slice.value_len)};
+}
+
+std::optional<std::string_view> DocumentFields::Find(std::string_view key) const {
+  auto iter = std::lower_bound(index_.begin(), index_.end(), key,
+                               [this](uint32_t lhs, std::string_view rhs) { return KeyAt(lhs) < rhs; });
+  if (iter == index_.end() || KeyAt(*iter) != key) {
+    return std::nullopt;
+  }
+  return (*this)[*iter].second;
+}
+
+std::optional<int64_t> DocumentFields::GetInt64(std::string_view key) const {
+  auto value = Find(key);
+  if (!value || value->empty()) {
+    return std::nullopt;
+  }
+  int64_t parsed = 0;
+  const char* last = value->data() + value->size();
+  auto [ptr, ec] = std::from_chars(value->data(), last, parsed);
+  if (ec != std::errc() || ptr != last) {
+    return std::nullopt;
+  }
+  return parsed;
+}
+
+std::optional<double> DocumentFields::GetDouble(std::string_view key) const {
+  auto value = Find(key);
+  if (!value || value->empty()) {
+    return std::nullopt;
+  }
+  double parsed = 0.0;
+#if defined(__cpp_lib_to_chars)
+  const char* last = value->data() + value->size();
+  auto [ptr, ec] = std::from_chars(value->data(), last, parsed);
+  if (ec != std::errc() || ptr != last) {
+    return std::nullopt;
+  }
+#else
+  // Standard library without floating-point from_chars: values are not
+  // NUL-terminated inside the reply buffer, so parse a copy
+  std::string copy(*value);
+  char* end = nullptr;
+  parsed = std::strtod(copy.c_str(), &end);
+  if (end != copy.c_str() + copy.size()) {
+    return std::nullopt;
+  }
+#endif
+  return parsed;
+}
+
 /**
  * @brief PIMPL implementation class
  */
 class MygramClient::Impl {
  public:
-  explicit Impl(ClientConfig config) : config_(std::move(config)) {}
+  explicit Impl(ClientConfig config)
+      : config_(std::move(config)),
+        debug_sample_rate_(config_.debug_sample_rate),
+        metrics_(std::make_unique<MetricsRegistry>()),
+        profiler_(std::make_unique<DebugProfiler>()) {}
 
   ~Impl() { Disconnect(); }
 
@@ -170,8 +952,24 @@ class MygramClient::Impl {
       return MakeUnexpected(MakeError(ErrorCode::kClientAlreadyConnected, "Already connected"));
     }
 
-    sock_ = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock_ < 0) {
+    auto sock = OpenSocket();
+    if (!sock) {
+      return MakeUnexpected(sock.error());
+    }
+    sock_ = *sock;
+    broken_ = false;
+
+    recv_buffer_.resize(config_.recv_buffer_size);
+
+    return {};
+  }
+
+  /**
+   * @brief Open a socket connected to the configured server, with timeouts set
+   */
+  Expected<int, Error> OpenSocket() const {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
       return MakeUnexpected(
           MakeError(ErrorCode::kClientConnectionFailed, std::string("Failed to create socket: ") + strerror(errno)));
     }
@@ -181,59 +979,266 @@ class MygramClient::Impl {
     timeout_val.tv_sec = static_cast<decltype(timeout_val.tv_sec)>(config_.timeout_ms / kMillisecondsPerSecond);
     timeout_val.tv_usec = static_cast<decltype(timeout_val.tv_usec)>((config_.timeout_ms % kMillisecondsPerSecond) *
                                                                      kMicrosecondsPerMillisecond);
-    setsockopt(sock_, SOL_SOCKET, SO_RCVTIMEO, &timeout_val, sizeof(timeout_val));
-    setsockopt(sock_, SOL_SOCKET, SO_SNDTIMEO, &timeout_val, sizeof(timeout_val));
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout_val, sizeof(timeout_val));
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout_val, sizeof(timeout_val));
 
     struct sockaddr_in server_addr = {};
     server_addr.sin_family = AF_INET;
     server_addr.sin_port = htons(config_.port);
 
     if (inet_pton(AF_INET, config_.host.c_str(), &server_addr.sin_addr) <= 0) {
-      close(sock_);
-      sock_ = -1;
+      close(sock);
       return MakeUnexpected(MakeError(ErrorCode::kClientConnectionFailed, "Invalid address: " + config_.host));
     }
 
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) - Required for socket API
-    if (connect(sock_, reinterpret_cast<struct sockaddr*>(&server_addr), sizeof(server_addr)) < 0) {
+    if (connect(sock, reinterpret_cast<struct sockaddr*>(&server_addr), sizeof(server_addr)) < 0) {
       std::string error_msg = std::string("Connection failed: ") + strerror(errno);
-      close(sock_);
-      sock_ = -1;
+      close(sock);
       return MakeUnexpected(MakeError(ErrorCode::kClientConnectionFailed, error_msg));
     }
 
-    return {};
+    return sock;
   }
 
   void Disconnect() {
+    CloseDebugConnection();
+    if (async_.InFlight()) {
+      FailAsync(MakeError(ErrorCode::kClientNotConnected, "Disconnected"));
+    }
     if (sock_ >= 0) {
       close(sock_);
       sock_ = -1;
     }
+    broken_ = false;
+  }
+
+  [[nodiscard]] bool IsBroken() const { return broken_; }
+
+  void SetDebugSampling(uint32_t one_in) { debug_sample_rate_ = one_in; }
+
+  [[nodiscard]] std::vector<DebugProfile> GetDebugProfiles() const { return profiler_->Snapshot(); }
+
+  void ResetDebugProfiles() { profiler_->Reset(); }
+
+  void EnableQueryStats(size_t max_fingerprints) {
+    query_stats_ = std::make_unique<QueryStatsAggregator>(max_fingerprints);
+  }
+
+  void DisableQueryStats() { query_stats_.reset(); }
+
+  [[nodiscard]] std::vector<QueryShapeStats> GetQueryStats() const {
+    return query_stats_ != nullptr ? query_stats_->Snapshot() : std::vector<QueryShapeStats>{};
+  }
+
+  void ResetQueryStats() {
+    if (query_stats_ != nullptr) {
+      query_stats_->Reset();
+    }
+  }
+
+  void SetHeavyHitters(std::shared_ptr<HeavyHitters> tracker) { heavy_hitters_ = std::move(tracker); }
+
+  void SetCapture(std::shared_ptr<QueryCapture> capture) {
+    capture_connection_ = capture != nullptr ? capture->NextConnectionId() : 0;
+    capture_ = std::move(capture);
+  }
+
+  /**
+   * @brief Bookkeeping for a built SEARCH/COUNT, right before its Roundtrip()
+   *
+   * Notes the command for the query stats and heavy hitters (recorded by
+   * Instrument() once the latency is known) and decides whether the request
+   * is debug-sampled.
+   *
+   * @return Whether the request was routed to the debug connection
+   */
+  bool BeginQuery(std::string_view message) const {
+    if (query_stats_ != nullptr || heavy_hitters_ != nullptr || capture_ != nullptr) {
+      query_.pending = true;
+      query_.matched = 0;
+      query_.debug.reset();
+      if (query_stats_ != nullptr) {
+        FingerprintCommand(message, query_.fingerprint);
+      }
+      if (heavy_hitters_ != nullptr) {
+        query_.command.assign(message);
+      }
+    }
+    return BeginSample();
+  }
+
+  /**
+   * @brief Bookkeeping for a SEARCH/COUNT whose reply parsed successfully
+   * @param matched Total matches (SEARCH) or count (COUNT)
+   */
+  void EndQuery(bool sampled, std::string_view message, uint64_t matched,
+                const std::optional<DebugInfo>& debug) const {
+    if (sampled && debug) {
+      profiler_->Record(message, *debug);
+    }
+    if (query_.pending) {
+      query_.matched = matched;
+      query_.debug = debug;
+    }
+  }
+
+  /**
+   * @brief Decide whether the next SEARCH/COUNT is debug-sampled
+   *
+   * A sampled request is routed to a second connection with DEBUG ON,
+   * opened on first use, so the primary connection never pays for debug
+   * output.
+   */
+  bool BeginSample() const {
+    if (debug_sample_rate_ == 0 || ++sample_counter_ % debug_sample_rate_ != 0 || !IsConnected()) {
+      return false;
+    }
+    if (debug_sock_ < 0 && !OpenDebugConnection()) {
+      return false;  // Not sampled; the next sample retries
+    }
+    route_debug_ = true;
+    return true;
+  }
+
+  /**
+   * @brief Open the debug connection and switch it to DEBUG ON
+   *
+   * The handshake runs on the raw socket rather than through Roundtrip(),
+   * so it is not counted in the stats, metrics, observer callbacks, probes
+   * or capture of the request that triggered it.
+   */
+  bool OpenDebugConnection() const {
+    auto sock = OpenSocket();
+    if (!sock) {
+      return false;
+    }
+    debug_sock_ = *sock;
+
+    constexpr std::string_view kDebugOn = "DEBUG ON\r\n";
+    bool enabled = send(debug_sock_, kDebugOn.data(), kDebugOn.size(), 0) == static_cast<ssize_t>(kDebugOn.size());
+    std::string reply;
+    while (enabled && (reply.size() < 2 || reply.compare(reply.size() - 2, 2, "\r\n") != 0)) {
+      ssize_t received = recv(debug_sock_, recv_buffer_.data(), recv_buffer_.size(), 0);
+      enabled = received > 0;
+      if (enabled) {
+        reply.append(recv_buffer_.data(), static_cast<size_t>(received));
+      }
+    }
+    if (!enabled || reply.compare(0, kErrorPrefix.size(), kErrorPrefix) == 0) {
+      CloseDebugConnection();
+      return false;
+    }
+    return true;
+  }
+
+  void CloseDebugConnection() const {
+    if (debug_sock_ >= 0) {
+      close(debug_sock_);
+      debug_sock_ = -1;
+    }
   }
 
   [[nodiscard]] bool IsConnected() const { return sock_ >= 0; }
 
-  Expected<std::string, Error> SendCommand(const std::string& command) const {
+  [[nodiscard]] int GetFd() const { return sock_; }
+
+  static Error AsyncInFlightError() {
+    return MakeError(ErrorCode::kClientCommandFailed, "Submitted requests are in flight; call ProcessIo() first");
+  }
+
+  Expected<std::string, Error> SendCommand(const std::string& command) const { return SendCommand({command}); }
+
+  /**
+   * @brief Send the concatenation of parts as one command
+   *
+   * The command is assembled in the per-connection command buffer, so callers
+   * with variable arguments (SAVE/LOAD) need not concatenate strings first.
+   */
+  Expected<std::string, Error> SendCommand(std::initializer_list<std::string_view> parts) const {
+    size_t size_hint = 0;
+    for (auto part : parts) {
+      size_hint += part.size();
+    }
+
+    CommandBuilder<std::string> builder(command_buffer_);
+    builder.Begin(size_hint);
+    for (auto part : parts) {
+      builder.Append(part);
+    }
+
+    if (auto status = Roundtrip(*builder.Finish(), reply_buffer_); !status) {
+      return MakeUnexpected(status.error());
+    }
+    return reply_buffer_;
+  }
+
+  /**
+   * @brief Send a terminated message and receive one complete reply
+   *
+   * String may be any contiguous string type (std::string, std::pmr::string),
+   * so the reply is stored wherever the caller's string allocates. The trailing
+   * \r\n is stripped.
+   */
+  template <typename String>
+  Expected<void, Error> Roundtrip(std::string_view message, String& response) const {
+    if (capture_ != nullptr) {
+      captured_command_.assign(message);  // The last command of the call is the one captured
+    }
+    if (!std::exchange(route_debug_, false)) {
+      return RoundtripOn(sock_, message, response);
+    }
+    auto status = RoundtripOn(debug_sock_, message, response);
+    if (!status) {
+      CloseDebugConnection();  // Reopened by the next sample
+    }
+    return status;
+  }
+
+  template <typename String>
+  Expected<void, Error> RoundtripOn(int sock, std::string_view message, String& response) const {
     if (!IsConnected()) {
       return MakeUnexpected(MakeError(ErrorCode::kClientNotConnected, "Not connected"));
     }
+    if (sock == sock_ && async_.InFlight()) {
+      return MakeUnexpected(AsyncInFlightError());
+    }
+
+    const auto kind = static_cast<unsigned>(request_.command);
+    if (MYGRAM_USDT_ENABLED(command_build)) {
+      MYGRAM_USDT3(command_build, kind, message.size(), ElapsedNs(request_.start, Clock::now()));
+    }
 
-    // Send command with \r\n terminator
-    std::string msg = command + "\r\n";
-    ssize_t sent = send(sock_, msg.c_str(), msg.length(), 0);
+    const bool timed = config_.collect_timing || observer_ != nullptr;
+    if (timed) {
+      marks_.built = Clock::now();
+    }
+
+    ssize_t sent = send(sock, message.data(), message.size(), 0);
     if (sent < 0) {
+      broken_ = broken_ || sock == sock_;
       return MakeUnexpected(
           MakeError(ErrorCode::kClientCommandFailed, std::string("Failed to send command: ") + strerror(errno)));
     }
+    stats_.bytes_sent += static_cast<uint64_t>(sent);
+    if (MYGRAM_USDT_ENABLED(send)) {
+      MYGRAM_USDT3(send, kind, sent, ElapsedNs(request_.start, Clock::now()));
+    }
+    if (timed) {
+      marks_.sent = Clock::now();
+      if (observer_ != nullptr) {
+        observer_->OnBytesWritten(request_, static_cast<uint64_t>(sent), ElapsedNs(request_.start, marks_.sent));
+      }
+    }
 
     // Receive response (loop until complete response is received)
-    std::string response;
-    std::vector<char> buffer(config_.recv_buffer_size);
+    response.clear();
 
     while (true) {
-      ssize_t received = recv(sock_, buffer.data(), buffer.size() - 1, 0);
+      ssize_t received = recv(sock, recv_buffer_.data(), recv_buffer_.size(), 0);
+      ++stats_.recv_calls;
       if (received <= 0) {
+        broken_ = broken_ || sock == sock_;  // A late reply would be read as the next one
         if (received == 0) {
           return MakeUnexpected(MakeError(ErrorCode::kClientConnectionClosed, "Connection closed by server"));
         }
@@ -241,23 +1246,29 @@ class MygramClient::Impl {
             MakeError(ErrorCode::kClientCommandFailed, std::string("Failed to receive response: ") + strerror(errno)));
       }
 
-      buffer[received] = '\0';
-      response.append(buffer.data(), received);
+      if (timed && response.empty()) {
+        marks_.first_byte = Clock::now();
+        if (observer_ != nullptr) {
+          observer_->OnFirstByte(request_, ElapsedNs(request_.start, marks_.first_byte));
+        }
+      }
+      response.append(recv_buffer_.data(), static_cast<size_t>(received));
+      stats_.bytes_received += static_cast<uint64_t>(received);
+      MYGRAM_USDT3(recv_chunk, kind, received, response.size());
 
       // Check if response is complete by looking for \r\n terminator
-      // All protocol responses end with \r\n
+      // All protocol responses end with \r\n. Otherwise the server is still
+      // sending in chunks; the blocking recv() waits for the rest.
       if (response.size() >= 2 && response[response.size() - 2] == '\r' && response[response.size() - 1] == '\n') {
         // Response is complete
+        if (MYGRAM_USDT_ENABLED(response_complete)) {
+          MYGRAM_USDT3(response_complete, kind, response.size(), ElapsedNs(request_.start, Clock::now()));
+        }
+        if (timed) {
+          marks_.received = Clock::now();
+        }
         break;
       }
-
-      // If we received less than buffer size, server has no more data (for now)
-      // But response doesn't end with \r\n yet, so keep reading
-      // This handles the case where server sends data in chunks
-      if (static_cast<size_t>(received) < buffer.size() - 1) {
-        // Small delay to allow more data to arrive
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-      }
     }
 
     // Remove trailing \r\n
@@ -265,7 +1276,7 @@ class MygramClient::Impl {
       response.pop_back();
     }
 
-    return response;
+    return {};
   }
 
   Expected<SearchResponse, Error> Search(const std::string& table, const std::string& query, uint32_t limit,
@@ -273,251 +1284,460 @@ class MygramClient::Impl {
                                          const std::vector<std::string>& not_terms,
                                          const std::vector<std::pair<std::string, std::string>>& filters,
                                          const std::string& sort_column, bool sort_desc) const {
-    if (auto err = ValidateNoControlCharacters(table, "table name")) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
-    }
-    if (auto err = ValidateNoControlCharacters(query, "search query")) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
-    }
-    for (const auto& term : and_terms) {
-      if (auto err = ValidateNoControlCharacters(term, "AND term")) {
-        return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
-      }
-    }
-    for (const auto& term : not_terms) {
-      if (auto err = ValidateNoControlCharacters(term, "NOT term")) {
-        return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
-      }
+    SearchResponse resp;
+    if (auto status =
+            Search(table, query, limit, offset, and_terms, not_terms, filters, sort_column, sort_desc, resp);
+        !status) {
+      return MakeUnexpected(status.error());
     }
-    for (const auto& [key, value] : filters) {
-      if (auto err = ValidateNoControlCharacters(key, "filter key")) {
-        return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
-      }
-      if (auto err = ValidateNoControlCharacters(value, "filter value")) {
-        return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
-      }
+    return resp;
+  }
+
+  template <typename Response>
+  Expected<void, Error> Search(const std::string& table, const std::string& query, uint32_t limit, uint32_t offset,
+                               const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+                               const std::vector<std::pair<std::string, std::string>>& filters,
+                               const std::string& sort_column, bool sort_desc, Response& out) const {
+    MarkStart();
+    auto message = BuildSearchCommand(command_buffer_, table, query, limit, offset, and_terms, not_terms, filters,
+                                      sort_column, sort_desc);
+    if (!message) {
+      return MakeUnexpected(message.error());
+    }
+    return ExecuteSearch(*message, out);
+  }
+
+  template <typename Response>
+  Expected<void, Error> SearchPrepared(std::string_view prefix, std::string_view suffix, const std::string& query,
+                                       uint32_t limit, uint32_t offset, Response& out) const {
+    MarkStart();
+    auto message = BuildPreparedSearchCommand(command_buffer_, prefix, suffix, query, limit, offset);
+    if (!message) {
+      return MakeUnexpected(message.error());
     }
-    if (!sort_column.empty()) {
-      if (auto err = ValidateNoControlCharacters(sort_column, "sort column")) {
-        return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
-      }
+    return ExecuteSearch(*message, out);
+  }
+
+  /**
+   * @brief Send a built SEARCH command and refill out (SearchResponse or SearchResponseView) from the reply
+   */
+  template <typename Response>
+  Expected<void, Error> ExecuteSearch(std::string_view message, Response& out) const {
+    const bool sampled = BeginQuery(message);
+    if (auto status = Roundtrip(message, reply_buffer_); !status) {
+      return status;
     }
 
-    // Build command
-    std::ostringstream cmd;
-    cmd << "SEARCH " << table << " " << EscapeQueryString(query);
+    auto parsed = ParseSearchReply(reply_buffer_, out);
+    if (parsed) {
+      EndQuery(sampled, message, out.total_count, out.debug);
+      FillTiming(out);
+    }
+    return parsed;
+  }
 
-    for (const auto& term : and_terms) {
-      cmd << " AND " << EscapeQueryString(term);
+  Expected<CountResponse, Error> Count(const std::string& table, const std::string& query,
+                                       const std::vector<std::string>& and_terms,
+                                       const std::vector<std::string>& not_terms,
+                                       const std::vector<std::pair<std::string, std::string>>& filters) const {
+    CountResponse resp;
+    if (auto status = Count(table, query, and_terms, not_terms, filters, resp); !status) {
+      return MakeUnexpected(status.error());
     }
+    return resp;
+  }
 
-    for (const auto& term : not_terms) {
-      cmd << " NOT " << EscapeQueryString(term);
+  Expected<void, Error> Count(const std::string& table, const std::string& query,
+                              const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+                              const std::vector<std::pair<std::string, std::string>>& filters,
+                              CountResponse& out) const {
+    MarkStart();
+    auto message = BuildCountCommand(command_buffer_, table, query, and_terms, not_terms, filters);
+    if (!message) {
+      return MakeUnexpected(message.error());
     }
-
-    for (const auto& [key, value] : filters) {
-      cmd << " FILTER " << key << " = " << EscapeQueryString(value);
+    const bool sampled = BeginQuery(*message);
+    if (auto status = Roundtrip(*message, reply_buffer_); !status) {
+      return status;
     }
 
-    // SORT clause (replaces ORDER BY)
-    if (!sort_column.empty()) {
-      cmd << " SORT " << sort_column << (sort_desc ? " DESC" : " ASC");
-    } else if (!sort_desc) {
-      // Only add SORT ASC if explicitly requesting ascending order for primary key
-      cmd << " SORT ASC";
+    out.debug.reset();
+    out.timing.reset();
+    if (auto parsed = ParseCountReply(reply_buffer_, out); !parsed) {
+      return parsed;
     }
-    // Default is SORT DESC (primary key descending), so no need to add it explicitly
+    EndQuery(sampled, *message, out.count, out.debug);
+    FillTiming(out);
+    return {};
+  }
 
-    // LIMIT clause - support MySQL-style offset,count format when both are specified
-    if (limit > 0 && offset > 0) {
-      cmd << " LIMIT " << offset << "," << limit;
-    } else if (limit > 0) {
-      cmd << " LIMIT " << limit;
+  Expected<Document, Error> Get(const std::string& table, const std::string& primary_key) const {
+    Document doc;
+    if (auto status = Get(table, primary_key, doc); !status) {
+      return MakeUnexpected(status.error());
     }
+    return doc;
+  }
 
-    // OFFSET clause - only needed if LIMIT didn't use offset,count format
-    // (This is redundant if we used LIMIT offset,count above, but kept for clarity)
-    // Note: The LIMIT offset,count format above already handles offset, so we skip this
-    // if (offset > 0 && limit == 0) {
-    //   cmd << " OFFSET " << offset;
-    // }
-
-    auto result = SendCommand(cmd.str());
-    if (!result) {
-      return MakeUnexpected(result.error());
+  Expected<void, Error> Get(const std::string& table, const std::string& primary_key, Document& out) const {
+    auto message = BuildGetCommand(command_buffer_, table, primary_key);
+    if (!message) {
+      return MakeUnexpected(message.error());
     }
-
-    std::string response = *result;
-    if (response.find("ERROR") == 0) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientServerError, response.substr(kErrorPrefixLen)));
+    if (auto status = Roundtrip(*message, reply_buffer_); !status) {
+      return status;
     }
+    return ParseGetReply(reply_buffer_, out);
+  }
 
-    // Parse response: OK RESULTS <total_count> [<id1> <id2> ...] [DEBUG ...]
-    if (response.find("OK RESULTS") != 0) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientProtocolError, "Unexpected response format"));
-    }
+  /**
+   * @brief Write a pipeline's commands and read and parse the replies in order
+   *
+   * Writing and reading are interleaved with poll(), so a batch larger than
+   * the socket buffers cannot deadlock with the server blocked on writing
+   * replies nobody reads yet. SEARCH/COUNT/GET replies are single lines, so
+   * they are split on \r\n as they arrive; the bytes already scanned for a
+   * terminator are not scanned again. Each answered item is recorded in the
+   * metrics with its own bytes and the latency from the start of the batch to
+   * its reply.
+   */
+  Expected<void, Error> Execute(Pipeline::Item* items, size_t count, std::string_view commands) const {
+    auto fail = [items, count](size_t from, const Error& error) {
+      for (size_t i = from; i < count; ++i) {
+        if (items[i].command_bytes > 0) {
+          items[i].error = error;
+        }
+      }
+      return MakeUnexpected(error);
+    };
+    if (!IsConnected()) {
+      return fail(0, MakeError(ErrorCode::kClientNotConnected, "Not connected"));
+    }
+    if (async_.InFlight()) {
+      return fail(0, AsyncInFlightError());
+    }
+
+    const auto start = Clock::now();
+    const int timeout_ms = config_.timeout_ms > 0 ? static_cast<int>(config_.timeout_ms) : -1;
+    std::string& replies = reply_buffer_;
+    replies.clear();
+    size_t sent = 0;
+    size_t line = 0;     // Start of the next unparsed reply
+    size_t scanned = 0;  // No terminator starts before this offset
+    uint64_t recv_calls = 0;
+    size_t next = 0;  // Next item owed a reply
+    auto skip_unsent = [&] {
+      while (next < count && items[next].command_bytes == 0) {
+        ++next;  // Rejected before sending
+      }
+    };
+    skip_unsent();
 
-    std::istringstream iss(response);
-    std::string status;
-    std::string results_str;
-    uint64_t total_count = 0;
-    iss >> status >> results_str >> total_count;
+    while (next < count) {
+      pollfd fd = {sock_, POLLIN, 0};
+      if (sent < commands.size()) {
+        fd.events |= POLLOUT;
+      }
+      const int ready = poll(&fd, 1, timeout_ms);
+      if (ready < 0 && errno == EINTR) {
+        continue;
+      }
+      if (ready <= 0) {
+        broken_ = true;
+        return fail(next, ready == 0 ? MakeError(ErrorCode::kClientTimeout, "Timed out waiting for the server")
+                                     : MakeError(ErrorCode::kClientCommandFailed,
+                                                 std::string("Failed to wait for the socket: ") + strerror(errno)));
+      }
 
-    SearchResponse resp;
-    resp.total_count = total_count;
+      if ((fd.revents & POLLOUT) != 0) {
+        ssize_t written = send(sock_, commands.data() + sent, commands.size() - sent, MSG_DONTWAIT);
+        if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+          broken_ = true;
+          return fail(next, MakeError(ErrorCode::kClientCommandFailed,
+                                      std::string("Failed to send command: ") + strerror(errno)));
+        }
+        sent += written > 0 ? static_cast<size_t>(written) : 0;
+      }
+      if ((fd.revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+        continue;
+      }
 
-    std::vector<std::string> tokens;
-    std::string token;
-    while (iss >> token) {
-      tokens.push_back(token);
-    }
+      ssize_t received = recv(sock_, recv_buffer_.data(), recv_buffer_.size(), MSG_DONTWAIT);
+      if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        continue;
+      }
+      ++recv_calls;
+      if (received <= 0) {
+        broken_ = true;
+        return fail(next, received == 0 ? MakeError(ErrorCode::kClientConnectionClosed, "Connection closed by server")
+                                         : MakeError(ErrorCode::kClientCommandFailed,
+                                                     std::string("Failed to receive response: ") + strerror(errno)));
+      }
+      replies.append(recv_buffer_.data(), static_cast<size_t>(received));
 
-    // Find DEBUG marker if present
-    size_t debug_index = tokens.size();
-    for (size_t i = 0; i < tokens.size(); ++i) {
-      if (tokens[i] == "DEBUG") {
-        debug_index = i;
-        break;
+      while (next < count) {
+        const size_t end = replies.find("\r\n", std::max(line, scanned));
+        if (end == std::string::npos) {
+          scanned = replies.size() - 1;  // The terminator may straddle the next chunk
+          break;
+        }
+        Pipeline::Item& item = items[next];
+        const std::string_view reply(replies.data() + line, end - line);
+        line = end + 2;
+
+        auto parsed = ParseTypedReply(item.type, reply, item.search, item.count, item.document);
+        item.error = parsed ? Error() : parsed.error();
+        RequestStats stats{item.command_bytes, reply.size() + 2, std::exchange(recv_calls, 0)};
+        metrics_->Record(item.type, stats, ElapsedNs(start, Clock::now()), item.error.code());
+        ++next;
+        skip_unsent();
       }
     }
+    return {};
+  }
 
-    // Extract result IDs (before DEBUG)
-    for (size_t i = 0; i < debug_index; ++i) {
-      resp.results.emplace_back(tokens[i]);
+  /**
+   * @brief Queue a command on the non-blocking interface, to be written by the next ProcessIo()
+   *
+   * @param build Serializes the command into the string it is given
+   */
+  template <typename Build>
+  Expected<uint64_t, Error> Submit(CommandType type, Build&& build) const {
+    if (!IsConnected()) {
+      return MakeUnexpected(MakeError(ErrorCode::kClientNotConnected, "Not connected"));
     }
-
-    // Parse debug info if present
-    if (debug_index < tokens.size()) {
-      resp.debug = ParseDebugInfo(tokens, debug_index);
+    auto message = build(command_buffer_);
+    if (!message) {
+      return MakeUnexpected(message.error());
     }
 
-    return resp;
+    AsyncRequest& request = async_.Push();
+    request.result.id = ++async_.last_id;
+    request.result.type = type;
+    request.result.error = Error();
+    request.command_bytes = message->size();
+    request.start = Clock::now();
+    async_.output.append(*message);
+    return request.result.id;
   }
 
-  Expected<CountResponse, Error> Count(const std::string& table, const std::string& query,
-                                       const std::vector<std::string>& and_terms,
-                                       const std::vector<std::string>& not_terms,
-                                       const std::vector<std::pair<std::string, std::string>>& filters) const {
-    if (auto err = ValidateNoControlCharacters(table, "table name")) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
+  [[nodiscard]] bool WantsWrite() const { return async_.written < async_.output.size(); }
+
+  [[nodiscard]] size_t PendingRequests() const { return async_.size; }
+
+  Expected<size_t, Error> ProcessIo() const {
+    if (!IsConnected()) {
+      return MakeUnexpected(MakeError(ErrorCode::kClientNotConnected, "Not connected"));
     }
-    if (auto err = ValidateNoControlCharacters(query, "search query")) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
+    if (auto status = FlushAsync(); !status) {
+      return MakeUnexpected(status.error());
     }
-    for (const auto& term : and_terms) {
-      if (auto err = ValidateNoControlCharacters(term, "AND term")) {
-        return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
+
+    // Read only while replies are owed, until the socket runs dry
+    while (async_.InFlight()) {
+      ssize_t received = recv(sock_, recv_buffer_.data(), recv_buffer_.size(), MSG_DONTWAIT);
+      if (received < 0 && errno == EINTR) {
+        continue;
       }
-    }
-    for (const auto& term : not_terms) {
-      if (auto err = ValidateNoControlCharacters(term, "NOT term")) {
-        return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
+      if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        break;
+      }
+      ++async_.recv_calls;
+      if (received <= 0) {
+        Error error = received == 0 ? MakeError(ErrorCode::kClientConnectionClosed, "Connection closed by server")
+                                    : MakeError(ErrorCode::kClientCommandFailed,
+                                                std::string("Failed to receive response: ") + strerror(errno));
+        broken_ = true;
+        FailAsync(error);
+        return MakeUnexpected(error);
       }
+      async_.input.append(recv_buffer_.data(), static_cast<size_t>(received));
+      ParseAsyncReplies();
     }
-    for (const auto& [key, value] : filters) {
-      if (auto err = ValidateNoControlCharacters(key, "filter key")) {
-        return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
+    return async_.ready;
+  }
+
+  bool PollResult(AsyncResult& result) const {
+    if (async_.ready == 0) {
+      return false;
+    }
+    std::swap(result, async_.At(0).result);
+    async_.Pop();
+    return true;
+  }
+
+  /**
+   * @brief Write as much of the submitted commands as the socket accepts
+   */
+  Expected<void, Error> FlushAsync() const {
+    while (WantsWrite()) {
+      ssize_t written =
+          send(sock_, async_.output.data() + async_.written, async_.output.size() - async_.written, MSG_DONTWAIT);
+      if (written < 0 && errno == EINTR) {
+        continue;
       }
-      if (auto err = ValidateNoControlCharacters(value, "filter value")) {
-        return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
+      if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return {};  // Socket buffer full: the rest goes once it is writable
+      }
+      if (written < 0) {
+        Error error =
+            MakeError(ErrorCode::kClientCommandFailed, std::string("Failed to send command: ") + strerror(errno));
+        broken_ = true;
+        FailAsync(error);
+        return MakeUnexpected(error);
       }
+      async_.written += static_cast<size_t>(written);
     }
+    async_.output.clear();
+    async_.written = 0;
+    return {};
+  }
 
-    // Build command
-    std::ostringstream cmd;
-    cmd << "COUNT " << table << " " << EscapeQueryString(query);
+  /**
+   * @brief Complete the received replies of the requests in flight
+   */
+  void ParseAsyncReplies() const {
+    std::string& input = async_.input;
+    size_t line = 0;  // Start of the next unparsed reply
+    while (async_.InFlight()) {
+      const size_t end = input.find("\r\n", std::max(line, async_.scanned));
+      if (end == std::string::npos) {
+        async_.scanned = input.size() - 1;  // The terminator may straddle the next chunk
+        break;
+      }
+      AsyncRequest& request = async_.At(async_.ready++);
+      AsyncResult& result = request.result;
+      const std::string_view reply(input.data() + line, end - line);
+      auto parsed = ParseTypedReply(result.type, reply, result.search, result.count, result.document);
+      result.error = parsed ? Error() : parsed.error();
+      RequestStats stats{request.command_bytes, reply.size() + 2, std::exchange(async_.recv_calls, 0)};
+      metrics_->Record(result.type, stats, ElapsedNs(request.start, Clock::now()), result.error.code());
+      line = end + 2;
+    }
+    input.erase(0, line);
+    async_.scanned = async_.scanned > line ? async_.scanned - line : 0;
+  }
 
-    for (const auto& term : and_terms) {
-      cmd << " AND " << EscapeQueryString(term);
-    }
+  /**
+   * @brief Complete every request in flight with an error and drop the unsent and unparsed bytes
+   */
+  void FailAsync(const Error& error) const {
+    const auto now = Clock::now();
+    while (async_.InFlight()) {
+      AsyncRequest& request = async_.At(async_.ready++);
+      request.result.error = error;
+      metrics_->Record(request.result.type, RequestStats{}, ElapsedNs(request.start, now), error.code());
+    }
+    async_.output.clear();
+    async_.written = 0;
+    async_.input.clear();
+    async_.scanned = 0;
+    async_.recv_calls = 0;
+  }
 
-    for (const auto& term : not_terms) {
-      cmd << " NOT " << EscapeQueryString(term);
+#ifdef MYGRAMCLIENT_HAS_PMR
+  Expected<pmr::SearchResponse, Error> Search(std::pmr::memory_resource* resource, const std::string& table,
+                                              const std::string& query, uint32_t limit, uint32_t offset,
+                                              const std::vector<std::string>& and_terms,
+                                              const std::vector<std::string>& not_terms,
+                                              const std::vector<std::pair<std::string, std::string>>& filters,
+                                              const std::string& sort_column, bool sort_desc) const {
+    if (resource == nullptr) {
+      resource = std::pmr::get_default_resource();
     }
 
-    for (const auto& [key, value] : filters) {
-      cmd << " FILTER " << key << " = " << EscapeQueryString(value);
+    MarkStart();
+    std::pmr::string cmd(resource);
+    auto message =
+        BuildSearchCommand(cmd, table, query, limit, offset, and_terms, not_terms, filters, sort_column, sort_desc);
+    if (!message) {
+      return MakeUnexpected(message.error());
     }
 
-    auto result = SendCommand(cmd.str());
-    if (!result) {
-      return MakeUnexpected(result.error());
+    const bool sampled = BeginQuery(*message);
+    std::pmr::string response(resource);
+    if (auto status = Roundtrip(*message, response); !status) {
+      return MakeUnexpected(status.error());
     }
 
-    std::string response = *result;
-    if (response.find("ERROR") == 0) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientServerError, response.substr(kErrorPrefixLen)));
+    pmr::SearchResponse resp(resource);
+    auto parsed = ParseSearchReply(response, resp.total_count, resp.debug,
+                                   [&resp](std::string_view key) { resp.primary_keys.emplace_back(key); });
+    if (!parsed) {
+      return MakeUnexpected(parsed.error());
     }
+    EndQuery(sampled, *message, resp.total_count, resp.debug);
+    FillTiming(resp);
 
-    // Parse response: OK COUNT <n> [DEBUG ...]
-    if (response.find("OK COUNT") != 0) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientProtocolError, "Unexpected response format"));
-    }
+    return resp;
+  }
 
-    std::istringstream iss(response);
-    std::string status;
-    std::string count_str;
-    uint64_t count = 0;
-    iss >> status >> count_str >> count;
+  Expected<CountResponse, Error> Count(std::pmr::memory_resource* resource, const std::string& table,
+                                       const std::string& query, const std::vector<std::string>& and_terms,
+                                       const std::vector<std::string>& not_terms,
+                                       const std::vector<std::pair<std::string, std::string>>& filters) const {
+    if (resource == nullptr) {
+      resource = std::pmr::get_default_resource();
+    }
 
-    CountResponse resp;
-    resp.count = count;
+    MarkStart();
+    std::pmr::string cmd(resource);
+    auto message = BuildCountCommand(cmd, table, query, and_terms, not_terms, filters);
+    if (!message) {
+      return MakeUnexpected(message.error());
+    }
 
-    // Check for debug info
-    std::vector<std::string> tokens;
-    std::string token;
-    while (iss >> token) {
-      tokens.push_back(token);
+    const bool sampled = BeginQuery(*message);
+    std::pmr::string response(resource);
+    if (auto status = Roundtrip(*message, response); !status) {
+      return MakeUnexpected(status.error());
     }
 
-    if (!tokens.empty() && tokens[0] == "DEBUG") {
-      resp.debug = ParseDebugInfo(tokens, 0);
+    CountResponse resp;
+    if (auto parsed = ParseCountReply(response, resp); !parsed) {
+      return MakeUnexpected(parsed.error());
     }
+    EndQuery(sampled, *message, resp.count, resp.debug);
+    FillTiming(resp);
 
     return resp;
   }
 
-  Expected<Document, Error> Get(const std::string& table, const std::string& primary_key) const {
-    if (auto err = ValidateNoControlCharacters(table, "table name")) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
-    }
-    if (auto err = ValidateNoControlCharacters(primary_key, "primary key")) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
+  Expected<pmr::Document, Error> Get(std::pmr::memory_resource* resource, const std::string& table,
+                                     const std::string& primary_key) const {
+    if (resource == nullptr) {
+      resource = std::pmr::get_default_resource();
     }
 
-    std::ostringstream cmd;
-    cmd << "GET " << table << " " << primary_key;
-
-    auto result = SendCommand(cmd.str());
-    if (!result) {
-      return MakeUnexpected(result.error());
+    std::pmr::string cmd(resource);
+    auto message = BuildGetCommand(cmd, table, primary_key);
+    if (!message) {
+      return MakeUnexpected(message.error());
     }
 
-    std::string response = *result;
-    if (response.find("ERROR") == 0) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientServerError, response.substr(kErrorPrefixLen)));
+    std::pmr::string response(resource);
+    if (auto status = Roundtrip(*message, response); !status) {
+      return MakeUnexpected(status.error());
     }
 
-    // Parse response: OK DOC <primary_key> [<key=value>...]
-    if (response.find("OK DOC") != 0) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientProtocolError, "Unexpected response format"));
+    if (auto status = CheckReplyPrefix(response, "OK DOC"); !status) {
+      return MakeUnexpected(status.error());
     }
 
-    std::istringstream iss(response);
-    std::string status;
-    std::string doc_str;
-    std::string doc_pk;
-    iss >> status >> doc_str >> doc_pk;
-
-    Document doc(doc_pk);
+    std::string_view rest = std::string_view(response).substr(kDocPrefixLen);
+    pmr::Document doc(resource);
+    doc.primary_key = NextToken(rest);
 
-    // Parse remaining key=value pairs
-    std::string rest;
-    std::getline(iss, rest);
-    doc.fields = ParseKeyValuePairs(rest);
+    for (std::string_view token = NextToken(rest); !token.empty(); token = NextToken(rest)) {
+      size_t pos = token.find('=');
+      if (pos != std::string_view::npos) {
+        doc.fields.emplace_back(token.substr(0, pos), token.substr(pos + 1));
+      }
+    }
 
     return doc;
   }
+#endif
 
   Expected<ServerInfo, Error> Info() const {
     auto result = SendCommand("INFO");
@@ -525,67 +1745,10 @@ class MygramClient::Impl {
       return MakeUnexpected(result.error());
     }
 
-    std::string response = *result;
-    if (response.find("ERROR") == 0) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientServerError, response.substr(kErrorPrefixLen)));
-    }
-
-    if (response.find("OK INFO") != 0) {
-      return MakeUnexpected(MakeError(ErrorCode::kClientProtocolError, "Unexpected response format"));
-    }
-
-    // Parse Redis-style INFO response (multi-line key: value format)
     ServerInfo info;
-    std::istringstream iss(response);
-    std::string line;
-
-    // Skip first line "OK INFO"
-    std::getline(iss, line);
-
-    while (std::getline(iss, line)) {
-      // Skip empty lines and section headers (lines starting with #)
-      if (line.empty() || line[0] == '#' || line[0] == '\r') {
-        continue;
-      }
-
-      // Parse "key: value" format
-      size_t colon_pos = line.find(':');
-      if (colon_pos != std::string::npos) {
-        std::string key = line.substr(0, colon_pos);
-        std::string value = line.substr(colon_pos + 1);
-
-        // Trim leading/trailing whitespace from value
-        size_t start = value.find_first_not_of(" \t\r\n");
-        size_t end = value.find_last_not_of(" \t\r\n");
-        if (start != std::string::npos) {
-          value = value.substr(start, end - start + 1);
-        }
-
-        if (key == "version") {
-          info.version = value;
-        } else if (key == "uptime_seconds") {
-          info.uptime_seconds = std::stoull(value);
-        } else if (key == "total_requests") {
-          info.total_requests = std::stoull(value);
-        } else if (key == "active_connections") {
-          info.active_connections = std::stoull(value);
-        } else if (key == "index_size_bytes") {
-          info.index_size_bytes = std::stoull(value);
-        } else if (key == "doc_count" || key == "total_documents") {
-          info.doc_count = std::stoull(value);
-        } else if (key == "tables") {
-          // Parse comma-separated table names
-          std::istringstream table_iss(value);
-          std::string table;
-          while (std::getline(table_iss, table, ',')) {
-            if (!table.empty()) {
-              info.tables.push_back(table);
-            }
-          }
-        }
-      }
+    if (auto parsed = ParseInfoReply(*result, info); !parsed) {
+      return MakeUnexpected(parsed.error());
     }
-
     return info;
   }
 
@@ -611,9 +1774,7 @@ class MygramClient::Impl {
       }
     }
 
-    std::string cmd = filepath.empty() ? "SAVE" : "SAVE " + filepath;
-
-    auto result = SendCommand(cmd);
+    auto result = filepath.empty() ? SendCommand({"SAVE"}) : SendCommand({"SAVE ", filepath});
     if (!result) {
       return MakeUnexpected(result.error());
     }
@@ -636,7 +1797,7 @@ class MygramClient::Impl {
       return MakeUnexpected(MakeError(ErrorCode::kClientInvalidArgument, *err));
     }
 
-    auto result = SendCommand("LOAD " + filepath);
+    auto result = SendCommand({"LOAD ", filepath});
     if (!result) {
       return MakeUnexpected(result.error());
     }
@@ -740,11 +1901,187 @@ class MygramClient::Impl {
     return {};
   }
 
+  /**
+   * @brief Run one client call, recording it under type and reporting it to the observer
+   *
+   * Latency covers the whole call (validation, I/O and parsing); byte and
+   * recv() counts are accumulated by Roundtrip() while the call runs.
+   */
+  template <typename Call>
+  auto Instrument(CommandType type, std::string_view table, Call&& call) const {
+    stats_ = RequestStats{};
+    const auto start = Clock::now();
+    request_.command = type;  // Kept current for the USDT probes in Roundtrip()
+    request_.start = start;
+    RequestObserver* observer = observer_.get();
+    if (observer != nullptr) {
+      marks_ = PhaseMarks{};
+      request_ = RequestInfo{++request_sequence_, type, table, start, std::chrono::system_clock::now()};
+      observer->OnRequestStart(request_);
+    }
+
+    query_.pending = false;
+    if (capture_ != nullptr) {
+      captured_command_.clear();
+    }
+
+    auto result = std::forward<Call>(call)();
+    const uint64_t latency_ns = ElapsedNs(start, Clock::now());
+    const ErrorCode code = result ? ErrorCode::kSuccess : result.error().code();
+    metrics_->Record(type, stats_, latency_ns, code);
+    if (query_.pending) {
+      if (query_stats_ != nullptr) {
+        query_stats_->Record(query_.fingerprint, latency_ns, code, query_.matched,
+                             query_.debug ? &*query_.debug : nullptr);
+      }
+      if (heavy_hitters_ != nullptr) {
+        heavy_hitters_->Record(query_.command, latency_ns);
+      }
+    }
+    if (capture_ != nullptr && !captured_command_.empty()) {
+      const bool found = type == CommandType::kGet && result;  // GET has no count; record whether it found the doc
+      const uint64_t matched = query_.pending ? query_.matched : static_cast<uint64_t>(found);
+      capture_->Record(capture_connection_, start, type, captured_command_, latency_ns, stats_.bytes_received, matched,
+                       code);
+    }
+    MYGRAM_USDT3(parse_complete, static_cast<unsigned>(type), static_cast<unsigned>(code), latency_ns);
+
+    if (observer != nullptr) {
+      RequestSummary summary{stats_.bytes_sent, stats_.bytes_received, stats_.recv_calls, 0, 0, latency_ns};
+      if (marks_.sent != Clock::time_point{}) {
+        summary.write_ns = ElapsedNs(start, marks_.sent);
+      }
+      if (marks_.first_byte != Clock::time_point{}) {
+        summary.first_byte_ns = ElapsedNs(start, marks_.first_byte);
+      }
+      if (result) {
+        observer->OnComplete(request_, summary);
+      } else {
+        observer->OnError(request_, result.error(), summary);
+      }
+    }
+    return result;
+  }
+
+  void SetObserver(std::shared_ptr<RequestObserver> observer) { observer_ = std::move(observer); }
+
+  [[nodiscard]] ClientMetrics GetMetrics() const { return metrics_->Snapshot(); }
+
+  /**
+   * @brief Stamp the start of a timed request (no-op unless collect_timing)
+   */
+  void MarkStart() const {
+    if (config_.collect_timing) {
+      marks_.start = Clock::now();
+    }
+  }
+
+  /**
+   * @brief Attach the phase timing of the request just parsed to out
+   *
+   * Must follow a successful Roundtrip() of a request begun with MarkStart().
+   */
+  template <typename Response>
+  void FillTiming(Response& out) const {
+    if (!config_.collect_timing) {
+      return;
+    }
+    const auto parsed = Clock::now();
+    ClientTiming& timing = out.timing.emplace();
+    timing.build_ns = ElapsedNs(marks_.start, marks_.built);
+    timing.send_ns = ElapsedNs(marks_.built, marks_.sent);
+    timing.ttfb_ns = ElapsedNs(marks_.sent, marks_.first_byte);
+    timing.transfer_ns = ElapsedNs(marks_.first_byte, marks_.received);
+    timing.parse_ns = ElapsedNs(marks_.received, parsed);
+    if (out.debug) {
+      timing.server_ns = static_cast<uint64_t>(std::llround(out.debug->query_time_ms * kNanosPerMilli));
+    }
+  }
+
+  void ResetMetrics() { metrics_->Reset(); }
+
  private:
   ClientConfig config_;
   int sock_{-1};
+  mutable bool broken_ = false;                        // sock_ failed mid-request; replies may be out of step
+  mutable int debug_sock_{-1};                         // DEBUG ON connection for sampled requests (lazily opened)
+  mutable bool route_debug_ = false;                   // Send the next Roundtrip() over debug_sock_
+  uint32_t debug_sample_rate_ = 0;                     // Sample 1 in N SEARCH/COUNT requests (0: off)
+  mutable uint64_t sample_counter_ = 0;
+  mutable std::vector<char> recv_buffer_;              // Receive scratch buffer, reused across commands
+  mutable std::string command_buffer_;                 // Outgoing command, reused across commands
+  mutable std::string reply_buffer_;                   // Last complete reply, reused across commands
+  mutable RequestStats stats_;                         // I/O counters of the call in progress
+  mutable PhaseMarks marks_;                           // Phase timestamps of the call in progress (timing or observer)
+  std::unique_ptr<MetricsRegistry> metrics_;
+  std::shared_ptr<RequestObserver> observer_;          // Lifecycle hooks (null: none)
+  mutable RequestInfo request_;                        // Call in progress (fully filled only for observer_)
+  mutable uint64_t request_sequence_ = 0;
+  std::unique_ptr<DebugProfiler> profiler_;
+  std::unique_ptr<QueryStatsAggregator> query_stats_;  // Null unless query stats are enabled
+  std::shared_ptr<HeavyHitters> heavy_hitters_;        // Null unless set
+  std::shared_ptr<QueryCapture> capture_;              // Null unless set
+  uint32_t capture_connection_ = 0;                    // This client's connection id in capture_
+  mutable std::string captured_command_;               // Last command sent by the call in progress (capture_ only)
+  mutable PendingQuery query_;                         // SEARCH/COUNT in flight
+  mutable AsyncQueue async_;                           // Non-blocking interface requests
 };
 
+// Pipeline implementation
+
+size_t Pipeline::AddSearch(const std::string& table, const std::string& query, uint32_t limit, uint32_t offset,
+                           const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+                           const std::vector<std::pair<std::string, std::string>>& filters,
+                           const std::string& sort_column, bool sort_desc) {
+  Item& item = NextItem(CommandType::kSearch);
+  return Queue(item, BuildSearchCommand(scratch_, table, query, limit, offset, and_terms, not_terms, filters,
+                                        sort_column, sort_desc));
+}
+
+size_t Pipeline::AddSearch(const PreparedSearch& prepared, const std::string& query, uint32_t limit,
+                           uint32_t offset) {
+  Item& item = NextItem(CommandType::kSearch);
+  return Queue(item, BuildPreparedSearchCommand(scratch_, prepared.prefix_, prepared.suffix_, query, limit, offset));
+}
+
+size_t Pipeline::AddCount(const std::string& table, const std::string& query,
+                          const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+                          const std::vector<std::pair<std::string, std::string>>& filters) {
+  Item& item = NextItem(CommandType::kCount);
+  return Queue(item, BuildCountCommand(scratch_, table, query, and_terms, not_terms, filters));
+}
+
+size_t Pipeline::AddGet(const std::string& table, const std::string& primary_key) {
+  Item& item = NextItem(CommandType::kGet);
+  return Queue(item, BuildGetCommand(scratch_, table, primary_key));
+}
+
+void Pipeline::Clear() {
+  commands_.clear();
+  size_ = 0;
+}
+
+Pipeline::Item& Pipeline::NextItem(CommandType type) {
+  if (size_ == items_.size()) {
+    items_.emplace_back();
+  }
+  Item& item = items_[size_];
+  item.type = type;
+  item.command_bytes = 0;
+  item.error = Error();
+  return item;
+}
+
+size_t Pipeline::Queue(Item& item, const Expected<std::string_view, Error>& message) {
+  if (message) {
+    commands_.append(*message);
+    item.command_bytes = message->size();
+  } else {
+    item.error = message.error();
+  }
+  return size_++;
+}
+
 // MygramClient public interface implementation
 
 MygramClient::MygramClient(ClientConfig config) : impl_(std::make_unique<Impl>(std::move(config))) {}
@@ -766,63 +2103,296 @@ bool MygramClient::IsConnected() const {
   return impl_->IsConnected();
 }
 
+bool MygramClient::IsBroken() const {
+  return impl_->IsBroken();
+}
+
 mygram::utils::Expected<SearchResponse, mygram::utils::Error> MygramClient::Search(
     const std::string& table, const std::string& query, uint32_t limit, uint32_t offset,
     const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
     const std::vector<std::pair<std::string, std::string>>& filters, const std::string& sort_column,
     bool sort_desc) const {
-  return impl_->Search(table, query, limit, offset, and_terms, not_terms, filters, sort_column, sort_desc);
+  return impl_->Instrument(CommandType::kSearch, table, [&] {
+    return impl_->Search(table, query, limit, offset, and_terms, not_terms, filters, sort_column, sort_desc);
+  });
+}
+
+mygram::utils::Expected<void, mygram::utils::Error> MygramClient::Search(
+    const std::string& table, const std::string& query, uint32_t limit, uint32_t offset,
+    const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+    const std::vector<std::pair<std::string, std::string>>& filters, const std::string& sort_column, bool sort_desc,
+    SearchResponse& out) const {
+  return impl_->Instrument(CommandType::kSearch, table, [&] {
+    return impl_->Search(table, query, limit, offset, and_terms, not_terms, filters, sort_column, sort_desc, out);
+  });
+}
+
+mygram::utils::Expected<void, mygram::utils::Error> MygramClient::Search(const std::string& table,
+                                                                         const std::string& query, uint32_t limit,
+                                                                         uint32_t offset, SearchResponse& out) const {
+  return impl_->Instrument(CommandType::kSearch, table,
+                           [&] { return impl_->Search(table, query, limit, offset, {}, {}, {}, "", true, out); });
+}
+
+mygram::utils::Expected<PreparedSearch, mygram::utils::Error> MygramClient::PrepareSearch(
+    const std::string& table, const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+    const std::vector<std::pair<std::string, std::string>>& filters, const std::string& sort_column,
+    bool sort_desc) {
+  PreparedSearch prepared;
+  if (auto status = RenderPreparedSearch(table, and_terms, not_terms, filters, sort_column, sort_desc,
+                                         prepared.prefix_, prepared.suffix_);
+      !status) {
+    return MakeUnexpected(status.error());
+  }
+  prepared.table_ = table;
+  return prepared;
+}
+
+mygram::utils::Expected<SearchResponse, mygram::utils::Error> MygramClient::Search(const PreparedSearch& prepared,
+                                                                                  const std::string& query,
+                                                                                  uint32_t limit,
+                                                                                  uint32_t offset) const {
+  using Result = mygram::utils::Expected<SearchResponse, mygram::utils::Error>;
+  return impl_->Instrument(CommandType::kSearch, prepared.table_, [&]() -> Result {
+    SearchResponse resp;
+    if (auto status = impl_->SearchPrepared(prepared.prefix_, prepared.suffix_, query, limit, offset, resp); !status) {
+      return MakeUnexpected(status.error());
+    }
+    return resp;
+  });
+}
+
+mygram::utils::Expected<void, mygram::utils::Error> MygramClient::Search(const PreparedSearch& prepared,
+                                                                         const std::string& query, uint32_t limit,
+                                                                         uint32_t offset, SearchResponse& out) const {
+  return impl_->Instrument(CommandType::kSearch, prepared.table_, [&] {
+    return impl_->SearchPrepared(prepared.prefix_, prepared.suffix_, query, limit, offset, out);
+  });
+}
+
+mygram::utils::Expected<void, mygram::utils::Error> MygramClient::Search(
+    const std::string& table, const std::string& query, uint32_t limit, uint32_t offset,
+    const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+    const std::vector<std::pair<std::string, std::string>>& filters, const std::string& sort_column, bool sort_desc,
+    SearchResponseView& out) const {
+  return impl_->Instrument(CommandType::kSearch, table, [&] {
+    return impl_->Search(table, query, limit, offset, and_terms, not_terms, filters, sort_column, sort_desc, out);
+  });
+}
+
+mygram::utils::Expected<void, mygram::utils::Error> MygramClient::Search(const std::string& table,
+                                                                         const std::string& query, uint32_t limit,
+                                                                         uint32_t offset,
+                                                                         SearchResponseView& out) const {
+  return impl_->Instrument(CommandType::kSearch, table,
+                           [&] { return impl_->Search(table, query, limit, offset, {}, {}, {}, "", true, out); });
+}
+
+mygram::utils::Expected<void, mygram::utils::Error> MygramClient::Search(const PreparedSearch& prepared,
+                                                                         const std::string& query, uint32_t limit,
+                                                                         uint32_t offset,
+                                                                         SearchResponseView& out) const {
+  return impl_->Instrument(CommandType::kSearch, prepared.table_, [&] {
+    return impl_->SearchPrepared(prepared.prefix_, prepared.suffix_, query, limit, offset, out);
+  });
+}
+
+mygram::utils::Expected<void, mygram::utils::Error> MygramClient::Execute(Pipeline& pipeline) const {
+  return impl_->Execute(pipeline.items_.data(), pipeline.size_, pipeline.commands_);
+}
+
+mygram::utils::Expected<uint64_t, mygram::utils::Error> MygramClient::SubmitSearch(
+    const std::string& table, const std::string& query, uint32_t limit, uint32_t offset,
+    const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+    const std::vector<std::pair<std::string, std::string>>& filters, const std::string& sort_column,
+    bool sort_desc) const {
+  return impl_->Submit(CommandType::kSearch, [&](std::string& buffer) {
+    return BuildSearchCommand(buffer, table, query, limit, offset, and_terms, not_terms, filters, sort_column,
+                              sort_desc);
+  });
+}
+
+mygram::utils::Expected<uint64_t, mygram::utils::Error> MygramClient::SubmitSearch(const PreparedSearch& prepared,
+                                                                                   const std::string& query,
+                                                                                   uint32_t limit,
+                                                                                   uint32_t offset) const {
+  return impl_->Submit(CommandType::kSearch, [&](std::string& buffer) {
+    return BuildPreparedSearchCommand(buffer, prepared.prefix_, prepared.suffix_, query, limit, offset);
+  });
+}
+
+mygram::utils::Expected<uint64_t, mygram::utils::Error> MygramClient::SubmitCount(
+    const std::string& table, const std::string& query, const std::vector<std::string>& and_terms,
+    const std::vector<std::string>& not_terms, const std::vector<std::pair<std::string, std::string>>& filters) const {
+  return impl_->Submit(CommandType::kCount, [&](std::string& buffer) {
+    return BuildCountCommand(buffer, table, query, and_terms, not_terms, filters);
+  });
+}
+
+mygram::utils::Expected<uint64_t, mygram::utils::Error> MygramClient::SubmitGet(
+    const std::string& table, const std::string& primary_key) const {
+  return impl_->Submit(CommandType::kGet,
+                       [&](std::string& buffer) { return BuildGetCommand(buffer, table, primary_key); });
+}
+
+int MygramClient::GetFd() const {
+  return impl_->GetFd();
+}
+
+bool MygramClient::WantsWrite() const {
+  return impl_->WantsWrite();
+}
+
+size_t MygramClient::PendingRequests() const {
+  return impl_->PendingRequests();
+}
+
+mygram::utils::Expected<size_t, mygram::utils::Error> MygramClient::ProcessIo() const {
+  return impl_->ProcessIo();
+}
+
+bool MygramClient::PollResult(AsyncResult& result) const {
+  return impl_->PollResult(result);
 }
 
 mygram::utils::Expected<CountResponse, mygram::utils::Error> MygramClient::Count(
     const std::string& table, const std::string& query, const std::vector<std::string>& and_terms,
     const std::vector<std::string>& not_terms, const std::vector<std::pair<std::string, std::string>>& filters) const {
-  return impl_->Count(table, query, and_terms, not_terms, filters);
+  return impl_->Instrument(CommandType::kCount, table,
+                           [&] { return impl_->Count(table, query, and_terms, not_terms, filters); });
+}
+
+mygram::utils::Expected<void, mygram::utils::Error> MygramClient::Count(
+    const std::string& table, const std::string& query, const std::vector<std::string>& and_terms,
+    const std::vector<std::string>& not_terms, const std::vector<std::pair<std::string, std::string>>& filters,
+    CountResponse& out) const {
+  return impl_->Instrument(CommandType::kCount, table,
+                           [&] { return impl_->Count(table, query, and_terms, not_terms, filters, out); });
 }
 
 mygram::utils::Expected<Document, mygram::utils::Error> MygramClient::Get(const std::string& table,
                                                                           const std::string& primary_key) const {
-  return impl_->Get(table, primary_key);
+  return impl_->Instrument(CommandType::kGet, table, [&] { return impl_->Get(table, primary_key); });
+}
+
+mygram::utils::Expected<void, mygram::utils::Error> MygramClient::Get(const std::string& table,
+                                                                      const std::string& primary_key,
+                                                                      Document& out) const {
+  return impl_->Instrument(CommandType::kGet, table, [&] { return impl_->Get(table, primary_key, out); });
+}
+
+#ifdef MYGRAMCLIENT_HAS_PMR
+mygram::utils::Expected<pmr::SearchResponse, mygram::utils::Error> MygramClient::Search(
+    std::pmr::memory_resource* resource, const std::string& table, const std::string& query, uint32_t limit,
+    uint32_t offset, const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+    const std::vector<std::pair<std::string, std::string>>& filters, const std::string& sort_column,
+    bool sort_desc) const {
+  return impl_->Instrument(CommandType::kSearch, table, [&] {
+    return impl_->Search(resource, table, query, limit, offset, and_terms, not_terms, filters, sort_column, sort_desc);
+  });
+}
+
+mygram::utils::Expected<CountResponse, mygram::utils::Error> MygramClient::Count(
+    std::pmr::memory_resource* resource, const std::string& table, const std::string& query,
+    const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+    const std::vector<std::pair<std::string, std::string>>& filters) const {
+  return impl_->Instrument(CommandType::kCount, table,
+                           [&] { return impl_->Count(resource, table, query, and_terms, not_terms, filters); });
+}
+
+mygram::utils::Expected<pmr::Document, mygram::utils::Error> MygramClient::Get(std::pmr::memory_resource* resource,
+                                                                               const std::string& table,
+                                                                               const std::string& primary_key) const {
+  return impl_->Instrument(CommandType::kGet, table, [&] { return impl_->Get(resource, table, primary_key); });
 }
+#endif
 
 mygram::utils::Expected<ServerInfo, mygram::utils::Error> MygramClient::Info() const {
-  return impl_->Info();
+  return impl_->Instrument(CommandType::kInfo, {}, [&] { return impl_->Info(); });
 }
 
 mygram::utils::Expected<std::string, mygram::utils::Error> MygramClient::GetConfig() const {
-  return impl_->GetConfig();
+  return impl_->Instrument(CommandType::kConfig, {}, [&] { return impl_->GetConfig(); });
 }
 
 mygram::utils::Expected<std::string, mygram::utils::Error> MygramClient::Save(const std::string& filepath) const {
-  return impl_->Save(filepath);
+  return impl_->Instrument(CommandType::kSave, {}, [&] { return impl_->Save(filepath); });
 }
 
 mygram::utils::Expected<std::string, mygram::utils::Error> MygramClient::Load(const std::string& filepath) const {
-  return impl_->Load(filepath);
+  return impl_->Instrument(CommandType::kLoad, {}, [&] { return impl_->Load(filepath); });
 }
 
 mygram::utils::Expected<ReplicationStatus, mygram::utils::Error> MygramClient::GetReplicationStatus() const {
-  return impl_->GetReplicationStatus();
+  return impl_->Instrument(CommandType::kReplication, {}, [&] { return impl_->GetReplicationStatus(); });
 }
 
 mygram::utils::Expected<void, mygram::utils::Error> MygramClient::StopReplication() const {
-  return impl_->StopReplication();
+  return impl_->Instrument(CommandType::kReplication, {}, [&] { return impl_->StopReplication(); });
 }
 
 mygram::utils::Expected<void, mygram::utils::Error> MygramClient::StartReplication() const {
-  return impl_->StartReplication();
+  return impl_->Instrument(CommandType::kReplication, {}, [&] { return impl_->StartReplication(); });
 }
 
 mygram::utils::Expected<void, mygram::utils::Error> MygramClient::EnableDebug() const {
-  return impl_->EnableDebug();
+  return impl_->Instrument(CommandType::kDebug, {}, [&] { return impl_->EnableDebug(); });
 }
 
 mygram::utils::Expected<void, mygram::utils::Error> MygramClient::DisableDebug() const {
-  return impl_->DisableDebug();
+  return impl_->Instrument(CommandType::kDebug, {}, [&] { return impl_->DisableDebug(); });
 }
 
 mygram::utils::Expected<std::string, mygram::utils::Error> MygramClient::SendCommand(const std::string& command) const {
-  return impl_->SendCommand(command);
+  return impl_->Instrument(CommandType::kOther, {}, [&] { return impl_->SendCommand(command); });
+}
+
+ClientMetrics MygramClient::GetMetrics() const {
+  return impl_->GetMetrics();
+}
+
+void MygramClient::ResetMetrics() {
+  impl_->ResetMetrics();
+}
+
+void MygramClient::SetObserver(std::shared_ptr<RequestObserver> observer) {
+  impl_->SetObserver(std::move(observer));
+}
+
+void MygramClient::SetDebugSampling(uint32_t one_in) {
+  impl_->SetDebugSampling(one_in);
+}
+
+std::vector<DebugProfile> MygramClient::GetDebugProfiles() const {
+  return impl_->GetDebugProfiles();
+}
+
+void MygramClient::ResetDebugProfiles() {
+  impl_->ResetDebugProfiles();
+}
+
+void MygramClient::EnableQueryStats(size_t max_fingerprints) {
+  impl_->EnableQueryStats(max_fingerprints);
+}
+
+void MygramClient::DisableQueryStats() {
+  impl_->DisableQueryStats();
+}
+
+std::vector<QueryShapeStats> MygramClient::GetQueryStats() const {
+  return impl_->GetQueryStats();
+}
+
+void MygramClient::ResetQueryStats() {
+  impl_->ResetQueryStats();
+}
+
+void MygramClient::SetHeavyHitters(std::shared_ptr<HeavyHitters> tracker) {
+  impl_->SetHeavyHitters(std::move(tracker));
+}
+
+void MygramClient::SetCapture(std::shared_ptr<QueryCapture> capture) {
+  impl_->SetCapture(std::move(capture));
 }
 
 }  // namespace mygramdb::client
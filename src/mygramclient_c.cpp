@@ -11,28 +11,264 @@
 
 #include "mygramdb/mygramclient_c.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
 #include <cstring>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include "mygramdb/client_pool.h"
 #include "mygramdb/mygramclient.h"
+#include "mygramdb/mygramclient_c_internal.h"
 #include "mygramdb/search_expression.h"
+#include "utils/usdt.h"
 
 using namespace mygramdb::client;
 
-// Opaque handle structure
+MYGRAM_USDT_SEMAPHORE(capi_entry);
+MYGRAM_USDT_SEMAPHORE(capi_return);
+
+// Key pointers and lengths behind a MygramSearchResult_C view of a SearchResponse
+struct SearchKeys {
+  std::vector<char*> primary_keys;
+  std::vector<size_t> key_lengths;
+};
+
+// NUL-terminated copies of a document's strings behind a MygramDocument_C
+// view (the reply fields are views); every part keeps its capacity
+struct DocumentText {
+  std::string text;
+  std::vector<char*> field_keys;
+  std::vector<char*> field_values;
+  std::vector<size_t> field_key_lengths;
+  std::vector<size_t> field_value_lengths;
+};
+
+// C arguments converted to C++ strings, kept so that converting them does not
+// allocate once warmed up
+struct CommandArgs {
+  std::string table;
+  std::string query;
+  std::string primary_key;
+  std::string sort_column;
+  std::vector<std::string> and_terms;
+  std::vector<std::string> not_terms;
+  std::vector<std::pair<std::string, std::string>> filters;
+};
+
+// Public views of one pipeline item or polled result, refreshed when it is read
+struct ResultView {
+  MygramSearchResult_C search;
+  SearchKeys keys;
+  MygramDocument_C document;
+  DocumentText text;
+};
+
+// Opaque handle structure. A pooled handle has no client of its own: every
+// call leases one from the pool, so the handle may be shared between threads.
 struct MygramClient_C {
-  std::unique_ptr<MygramClient> client;
-  std::string last_error;
+  std::unique_ptr<MygramClient> client;         // Null for pooled handles
+  std::unique_ptr<ClientPool> pool;             // Set by mygramclient_create_pooled
+  std::atomic<bool> pool_connected{false};      // A lease succeeded since the last mygramclient_disconnect
+  std::string last_error;                       // Unpooled handles only; see set_error()
+  std::mutex heavy_hitters_mutex;               // Guards heavy_hitters against concurrent enable/get
+  std::shared_ptr<HeavyHitters> heavy_hitters;  // Set by mygramclient_enable_heavy_hitters
+};
+
+// Per-thread scratch of the calls that convert arguments or build a batch,
+// so that they do not allocate once warmed up and pooled handles can share it
+struct CallScratch {
+  Pipeline batch;    // mygramclient_search_batch/count_batch
+  CommandArgs args;  // Converted arguments of batch, submit and prepared calls
+};
+
+static CallScratch& call_scratch() {
+  thread_local CallScratch scratch;
+  return scratch;
+}
+
+struct MygramPipeline_C {
+  Pipeline pipeline;
+  CommandArgs args;
+  std::vector<ResultView> views;  // One per item once read
+};
+
+// Storage behind a reusable search result handle. Argument strings are kept
+// here too so that converting C arguments does not allocate once warmed up.
+struct SearchResultStorage {
+  SearchResponse response;
+  SearchKeys keys;
+  std::string table;
+  std::string query;
+  std::string sort_column;
+  std::vector<std::string> and_terms;
+  std::vector<std::string> not_terms;
+  std::vector<std::pair<std::string, std::string>> filters;
+};
+
+// Reusable search result handle. The public struct is the first member of a
+// standard-layout type, so the MygramSearchResult_C* handed out converts back.
+struct SearchResultHandle {
+  MygramSearchResult_C view;
+  SearchResultStorage* storage;
+};
+static_assert(std::is_standard_layout_v<SearchResultHandle>, "handle must be convertible from its first member");
+
+// Storage behind a reusable document handle
+struct DocumentStorage {
+  Document document;
+  std::string table;
+  std::string primary_key;
+  DocumentText text;
+};
+
+// Reusable document handle, laid out like SearchResultHandle
+struct DocumentHandle {
+  MygramDocument_C view;
+  DocumentStorage* storage;
+};
+static_assert(std::is_standard_layout_v<DocumentHandle>, "handle must be convertible from its first member");
+
+// Storage behind a result handle of the non-blocking interface
+struct AsyncResultStorage {
+  AsyncResult result;
+  ResultView view;
+};
+
+// Result handle of the non-blocking interface, laid out like SearchResultHandle
+struct AsyncResultHandle {
+  MygramAsyncResult_C view;
+  AsyncResultStorage* storage;
+};
+static_assert(std::is_standard_layout_v<AsyncResultHandle>, "handle must be convertible from its first member");
+
+// Helper: Fire the capi_entry/capi_return USDT probes around a C API call
+class CApiProbe {
+ public:
+  explicit CApiProbe(const char* function) : function_(function) {
+    MYGRAM_USDT1(capi_entry, function_);
+    if (MYGRAM_USDT_ENABLED(capi_return)) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~CApiProbe() {
+    // Skipped if the tracer attached after the call began
+    if (MYGRAM_USDT_ENABLED(capi_return) && start_ != std::chrono::steady_clock::time_point{}) {
+      auto elapsed = std::chrono::steady_clock::now() - start_;
+      MYGRAM_USDT2(capi_return, function_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+  }
+
+  CApiProbe(const CApiProbe&) = delete;
+  CApiProbe& operator=(const CApiProbe&) = delete;
+
+ private:
+  const char* function_;
+  std::chrono::steady_clock::time_point start_;
 };
 
+// Message of the last failed call on this thread, whatever the handle
+static thread_local std::string thread_last_error;
+
+// Helper: Record the error of a failed call. Pooled handles are shared, so
+// their errors are only kept per thread.
+static void set_error(MygramClient_C* client, std::string message) {
+  if (client->pool == nullptr) {
+    client->last_error = message;
+  }
+  thread_last_error = std::move(message);
+}
+
+// Helper: Whether client is a handle calls can run on
+static bool usable(const MygramClient_C* client) {
+  return client != nullptr && (client->client != nullptr || client->pool != nullptr);
+}
+
+// Helper: Whether client is an unpooled handle; the calls that need one fail
+// on pooled handles, since their state belongs to a single connection
+static bool unpooled(const MygramClient_C* client) {
+  if (client != nullptr && client->pool != nullptr) {
+    thread_last_error = "Not supported on pooled handles";
+    return false;
+  }
+  return client != nullptr && client->client != nullptr;
+}
+
+namespace mygramdb::client {
+
+ClientLease::ClientLease(MygramClient_C* handle) {
+  if (handle->pool == nullptr) {
+    client_ = handle->client.get();
+    return;
+  }
+  auto lease = handle->pool->Acquire();
+  if (!lease) {
+    error_ = lease.error();
+    set_error(handle, error_.to_string());
+    return;
+  }
+  lease_ = std::move(*lease);
+  client_ = &*lease_;
+  handle->pool_connected.store(true, std::memory_order_relaxed);
+}
+
+void SetHandleError(MygramClient_C* handle, std::string message) { set_error(handle, std::move(message)); }
+
+}  // namespace mygramdb::client
+
+// Helper: Overwrite a string vector from a C array, skipping NULL entries
+// and reusing existing elements' capacity
+static void assign_c_strings(std::vector<std::string>& dst, const char** src, size_t count) {
+  size_t used = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (src[i] == nullptr) {
+      continue;
+    }
+    if (used < dst.size()) {
+      dst[used].assign(src[i]);
+    } else {
+      dst.emplace_back(src[i]);
+    }
+    ++used;
+  }
+  dst.resize(used);
+}
+
+// Helper: Overwrite a filter vector from C key/value arrays, skipping
+// incomplete pairs and reusing existing elements' capacity
+static void assign_c_filters(std::vector<std::pair<std::string, std::string>>& dst, const char** keys,
+                             const char** values, size_t count) {
+  size_t used = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (keys[i] == nullptr || values[i] == nullptr) {
+      continue;
+    }
+    if (used < dst.size()) {
+      dst[used].first.assign(keys[i]);
+      dst[used].second.assign(values[i]);
+    } else {
+      dst.emplace_back(keys[i], values[i]);
+    }
+    ++used;
+  }
+  dst.resize(used);
+}
+
 // Helper: Allocate C string copy
 // cppcoreguidelines-no-malloc)
-static char* strdup_safe(const std::string& str) {
+static char* strdup_safe(std::string_view str) {
   char* result = static_cast<char*>(malloc(str.size() + 1));
   if (result != nullptr) {
-    std::memcpy(result, str.c_str(), str.size() + 1);
+    std::memcpy(result, str.data(), str.size());
+    result[str.size()] = '\0';
   }
   return result;
 }
@@ -68,6 +304,188 @@ static void free_c_string_array(char** array, size_t count) {
   free(array);
 }
 
+// Helper: Copy a DebugProfile's statistics into dst (fingerprint is left
+// alone); false if allocation fails
+static bool fill_debug_profile(const DebugProfile& src, MygramDebugProfile_C& dst) {
+  dst.samples = src.samples;
+  dst.query_time_ms = src.query_time_ms;
+  dst.index_time_ms = src.index_time_ms;
+  dst.filter_time_ms = src.filter_time_ms;
+  dst.terms = src.terms;
+  dst.ngrams = src.ngrams;
+  dst.candidates = src.candidates;
+  dst.after_intersection = src.after_intersection;
+  dst.after_not = src.after_not;
+  dst.after_filters = src.after_filters;
+  dst.final = src.final;
+  if (src.optimizations.empty()) {
+    return true;
+  }
+
+  dst.optimizations =
+      static_cast<MygramOptimizationCount_C*>(calloc(src.optimizations.size(), sizeof(MygramOptimizationCount_C)));
+  if (dst.optimizations == nullptr) {
+    return false;
+  }
+  for (const auto& [name, times] : src.optimizations) {
+    MygramOptimizationCount_C& entry = dst.optimizations[dst.optimization_count++];
+    entry = {strdup_safe(name), times};
+    if (entry.name == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Helper: Free what fill_debug_profile() and the caller allocated in profile
+static void free_debug_profile_fields(MygramDebugProfile_C& profile) {
+  free(profile.fingerprint);
+  for (size_t i = 0; i < profile.optimization_count; ++i) {
+    free(profile.optimizations[i].name);
+  }
+  free(profile.optimizations);
+}
+
+// Helper: Copy a search response into a newly allocated C result
+//
+// Everything goes into one block: the struct, then the key pointers, the
+// key lengths and the NUL-terminated key bytes. All parts are 8-byte
+// multiples except the bytes, which come last.
+static int copy_search_result(MygramClient_C* client, const SearchResponse& resp, MygramSearchResult_C** result) {
+  const size_t count = resp.results.size();
+  size_t key_bytes = 0;
+  for (const auto& item : resp.results) {
+    key_bytes += item.primary_key.size() + 1;
+  }
+
+  const size_t pointers_offset = sizeof(MygramSearchResult_C);
+  const size_t lengths_offset = pointers_offset + (count * sizeof(char*));
+  const size_t keys_offset = lengths_offset + (count * sizeof(size_t));
+  static_assert(sizeof(MygramSearchResult_C) % alignof(char*) == 0 && alignof(char*) == alignof(size_t),
+                "result parts must stay aligned");
+
+  auto* block = static_cast<char*>(malloc(keys_offset + key_bytes));
+  if (block == nullptr) {
+    set_error(client, "Memory allocation failed");
+    return -1;
+  }
+
+  auto* result_c = reinterpret_cast<MygramSearchResult_C*>(block);
+  result_c->count = count;
+  result_c->total_count = resp.total_count;
+  result_c->primary_keys = reinterpret_cast<char**>(block + pointers_offset);
+  result_c->key_lengths = reinterpret_cast<size_t*>(block + lengths_offset);
+
+  char* key = block + keys_offset;
+  for (size_t i = 0; i < count; ++i) {
+    const std::string& primary_key = resp.results[i].primary_key;
+    std::memcpy(key, primary_key.data(), primary_key.size());
+    key[primary_key.size()] = '\0';
+    result_c->primary_keys[i] = key;
+    result_c->key_lengths[i] = primary_key.size();
+    key += primary_key.size() + 1;
+  }
+
+  *result = result_c;
+  return 0;
+}
+
+// Helper: Bytes needed for a document's NUL-terminated primary key, keys and values
+static size_t document_text_bytes(const Document& document) {
+  size_t bytes = document.primary_key.size() + 1;
+  for (const auto& [key, value] : document.fields) {
+    bytes += key.size() + value.size() + 2;
+  }
+  return bytes;
+}
+
+// Helper: Copy a document's strings into text (document_text_bytes() long)
+// and point doc at them. The four arrays hold one entry per field.
+static void fill_document_view(const Document& document, char* text, char** keys, char** values, size_t* key_lengths,
+                               size_t* value_lengths, MygramDocument_C* doc) {
+  auto append = [&text](std::string_view str) {
+    char* start = text;
+    std::memcpy(text, str.data(), str.size());
+    text[str.size()] = '\0';
+    text += str.size() + 1;
+    return start;
+  };
+
+  doc->primary_key_length = document.primary_key.size();
+  doc->primary_key = append(document.primary_key);
+  size_t i = 0;
+  for (const auto& [key, value] : document.fields) {
+    key_lengths[i] = key.size();
+    keys[i] = append(key);
+    value_lengths[i] = value.size();
+    values[i] = append(value);
+    ++i;
+  }
+  doc->field_count = i;
+  doc->field_keys = keys;
+  doc->field_values = values;
+  doc->field_key_lengths = key_lengths;
+  doc->field_value_lengths = value_lengths;
+}
+
+// Helper: Point a search result view at a response. Keys are exposed in
+// place: the pointers refer to the response strings.
+static void publish_search_view(SearchResponse& response, SearchKeys& keys, MygramSearchResult_C* result) {
+  auto& results = response.results;
+  keys.primary_keys.resize(results.size());
+  keys.key_lengths.resize(results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    keys.primary_keys[i] = results[i].primary_key.data();
+    keys.key_lengths[i] = results[i].primary_key.size();
+  }
+
+  result->primary_keys = keys.primary_keys.data();
+  result->key_lengths = keys.key_lengths.data();
+  result->count = results.size();
+  result->total_count = response.total_count;
+}
+
+// Helper: Copy a document into text and point a document view at the copy
+static void publish_document_view(const Document& document, DocumentText& text, MygramDocument_C* doc) {
+  const size_t count = document.fields.size();
+  text.text.resize(document_text_bytes(document));
+  text.field_keys.resize(count);
+  text.field_values.resize(count);
+  text.field_key_lengths.resize(count);
+  text.field_value_lengths.resize(count);
+  fill_document_view(document, text.text.data(), text.field_keys.data(), text.field_values.data(),
+                     text.field_key_lengths.data(), text.field_value_lengths.data(), doc);
+}
+
+// Helper: Point a reusable handle's public view at its stored response, or
+// reset it on error
+static int publish_search_handle(MygramClient_C* client,
+                                 const mygram::utils::Expected<void, mygram::utils::Error>& status,
+                                 MygramSearchResult_C* result) {
+  if (!status) {
+    set_error(client, status.error().to_string());
+    result->primary_keys = nullptr;
+    result->key_lengths = nullptr;
+    result->count = 0;
+    result->total_count = 0;
+    return -1;
+  }
+
+  SearchResultStorage& storage = *reinterpret_cast<SearchResultHandle*>(result)->storage;
+  publish_search_view(storage.response, storage.keys, result);
+  return 0;
+}
+
+// Helper: C++ configuration for a C one, where 0 or NULL fields take their defaults
+static ClientConfig to_client_config(const MygramClientConfig_C& config) {
+  ClientConfig cpp_config;
+  cpp_config.host = (config.host != nullptr) ? config.host : "127.0.0.1";
+  cpp_config.port = config.port != 0 ? config.port : 11016;
+  cpp_config.timeout_ms = config.timeout_ms != 0 ? config.timeout_ms : 5000;
+  cpp_config.recv_buffer_size = config.recv_buffer_size != 0 ? config.recv_buffer_size : 65536;
+  return cpp_config;
+}
+
 MygramClient_C* mygramclient_create(const MygramClientConfig_C* config) {
   if (config == nullptr) {
     return nullptr;
@@ -75,13 +493,19 @@ MygramClient_C* mygramclient_create(const MygramClientConfig_C* config) {
 
   auto* client_c = new MygramClient_C();
 
-  ClientConfig cpp_config;
-  cpp_config.host = (config->host != nullptr) ? config->host : "127.0.0.1";
-  cpp_config.port = config->port != 0 ? config->port : 11016;
-  cpp_config.timeout_ms = config->timeout_ms != 0 ? config->timeout_ms : 5000;
-  cpp_config.recv_buffer_size = config->recv_buffer_size != 0 ? config->recv_buffer_size : 65536;
+  client_c->client = std::make_unique<MygramClient>(to_client_config(*config));
+
+  return client_c;
+}
+
+MygramClient_C* mygramclient_create_pooled(const MygramClientConfig_C* config, size_t max_connections) {
+  if (config == nullptr) {
+    return nullptr;
+  }
+
+  auto* client_c = new MygramClient_C();
 
-  client_c->client = std::make_unique<MygramClient>(cpp_config);
+  client_c->pool = std::make_unique<ClientPool>(to_client_config(*config), max_connections);
 
   return client_c;
 }
@@ -91,13 +515,19 @@ void mygramclient_destroy(MygramClient_C* client) {
 }
 
 int mygramclient_connect(MygramClient_C* client) {
-  if (client == nullptr || client->client == nullptr) {
+  CApiProbe probe(__func__);
+  if (!usable(client)) {
     return -1;
   }
 
+  if (client->pool != nullptr) {
+    ClientLease lease(client);  // Opens the first connection (or checks an idle one is there)
+    return lease ? 0 : -1;
+  }
+
   auto result = client->client->Connect();
   if (!result) {
-    client->last_error = result.error().to_string();
+    set_error(client, result.error().to_string());
     return -1;
   }
 
@@ -105,15 +535,21 @@ int mygramclient_connect(MygramClient_C* client) {
 }
 
 void mygramclient_disconnect(MygramClient_C* client) {
-  if (client != nullptr && client->client != nullptr) {
+  if (client != nullptr && client->pool != nullptr) {
+    client->pool_connected.store(false, std::memory_order_relaxed);
+    client->pool->Disconnect();
+  } else if (client != nullptr && client->client != nullptr) {
     client->client->Disconnect();
   }
 }
 
 int mygramclient_is_connected(const MygramClient_C* client) {
-  if (client == nullptr || client->client == nullptr) {
+  if (!usable(client)) {
     return 0;
   }
+  if (client->pool != nullptr) {
+    return client->pool_connected.load(std::memory_order_relaxed) ? 1 : 0;
+  }
 
   return client->client->IsConnected() ? 1 : 0;
 }
@@ -129,268 +565,844 @@ int mygramclient_search_advanced(MygramClient_C* client, const char* table, cons
                                  size_t not_count, const char** filter_keys, const char** filter_values,
                                  size_t filter_count, const char* sort_column, int sort_desc,
                                  MygramSearchResult_C** result) {
-  if (client == nullptr || client->client == nullptr || table == nullptr || query == nullptr || result == nullptr) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || table == nullptr || query == nullptr || result == nullptr) {
     return -1;
   }
 
   // Convert C arrays to C++ vectors
   std::vector<std::string> and_terms_vec;
-  for (size_t i = 0; i < and_count; ++i) {
-    if (and_terms[i] != nullptr) {
-      and_terms_vec.emplace_back(and_terms[i]);
-    }
-  }
+  assign_c_strings(and_terms_vec, and_terms, and_count);
 
   std::vector<std::string> not_terms_vec;
-  for (size_t i = 0; i < not_count; ++i) {
-    if (not_terms[i] != nullptr) {
-      not_terms_vec.emplace_back(not_terms[i]);
-    }
-  }
+  assign_c_strings(not_terms_vec, not_terms, not_count);
 
   std::vector<std::pair<std::string, std::string>> filters_vec;
-  for (size_t i = 0; i < filter_count; ++i) {
-    if (filter_keys[i] != nullptr && filter_values[i] != nullptr) {
-      filters_vec.emplace_back(filter_keys[i], filter_values[i]);
-    }
-  }
+  assign_c_filters(filters_vec, filter_keys, filter_values, filter_count);
 
   std::string sort_column_str = sort_column != nullptr ? sort_column : "";
 
-  auto search_result = client->client->Search(table, query, limit, offset, and_terms_vec, not_terms_vec, filters_vec,
-                                              sort_column_str, sort_desc != 0);
+  ClientLease lease(client);
+  if (!lease) {
+    return -1;
+  }
+  auto search_result = lease->Search(table, query, limit, offset, and_terms_vec, not_terms_vec, filters_vec,
+                                     sort_column_str, sort_desc != 0);
 
   if (!search_result) {
-    client->last_error = search_result.error().to_string();
+    set_error(client, search_result.error().to_string());
     return -1;
   }
 
-  auto& resp = *search_result;
+  return copy_search_result(client, *search_result, result);
+}
 
-  auto* result_c = static_cast<MygramSearchResult_C*>(malloc(sizeof(MygramSearchResult_C)));
-  if (result_c == nullptr) {
-    client->last_error = "Memory allocation failed";
-    return -1;
+MygramSearchResult_C* mygramclient_search_result_create(void) {
+  auto* handle = new (std::nothrow) SearchResultHandle();
+  if (handle == nullptr) {
+    return nullptr;
+  }
+  handle->storage = new (std::nothrow) SearchResultStorage();
+  if (handle->storage == nullptr) {
+    delete handle;
+    return nullptr;
   }
+  handle->view.primary_keys = nullptr;
+  handle->view.key_lengths = nullptr;
+  handle->view.count = 0;
+  handle->view.total_count = 0;
+  return &handle->view;
+}
 
-  result_c->count = resp.results.size();
-  result_c->total_count = resp.total_count;
+void mygramclient_search_result_destroy(MygramSearchResult_C* result) {
+  if (result == nullptr) {
+    return;
+  }
+  auto* handle = reinterpret_cast<SearchResultHandle*>(result);
+  delete handle->storage;
+  delete handle;
+}
+
+int mygramclient_search_into(MygramClient_C* client, const char* table, const char* query, uint32_t limit,
+                             uint32_t offset, MygramSearchResult_C* result) {
+  return mygramclient_search_advanced_into(client, table, query, limit, offset, nullptr, 0, nullptr, 0, nullptr,
+                                           nullptr, 0, nullptr, 1, result);  // Default sort_desc = 1 (descending)
+}
 
-  // Allocate array for primary keys
-  result_c->primary_keys = static_cast<char**>(malloc(sizeof(char*) * resp.results.size()));
-  if (result_c->primary_keys == nullptr) {
-    free(result_c);
-    client->last_error = "Memory allocation failed";
+int mygramclient_search_advanced_into(MygramClient_C* client, const char* table, const char* query, uint32_t limit,
+                                      uint32_t offset, const char** and_terms, size_t and_count,
+                                      const char** not_terms, size_t not_count, const char** filter_keys,
+                                      const char** filter_values, size_t filter_count, const char* sort_column,
+                                      int sort_desc, MygramSearchResult_C* result) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || table == nullptr || query == nullptr || result == nullptr) {
     return -1;
   }
 
-  for (size_t i = 0; i < resp.results.size(); ++i) {
-    result_c->primary_keys[i] = strdup_safe(resp.results[i].primary_key);
-  }
+  auto* handle = reinterpret_cast<SearchResultHandle*>(result);
+  SearchResultStorage& storage = *handle->storage;
 
-  *result = result_c;
-  return 0;
-}
+  storage.table.assign(table);
+  storage.query.assign(query);
+  storage.sort_column.assign(sort_column != nullptr ? sort_column : "");
+  assign_c_strings(storage.and_terms, and_terms, and_count);
+  assign_c_strings(storage.not_terms, not_terms, not_count);
+  assign_c_filters(storage.filters, filter_keys, filter_values, filter_count);
 
-int mygramclient_count(MygramClient_C* client, const char* table, const char* query, uint64_t* count) {
-  return mygramclient_count_advanced(client, table, query, nullptr, 0, nullptr, 0, nullptr, nullptr, 0, count);
+  ClientLease lease(client);
+  if (!lease) {
+    return -1;
+  }
+  auto status = lease->Search(storage.table, storage.query, limit, offset, storage.and_terms, storage.not_terms,
+                              storage.filters, storage.sort_column, sort_desc != 0, storage.response);
+  return publish_search_handle(client, status, result);
 }
 
-int mygramclient_count_advanced(MygramClient_C* client, const char* table, const char* query, const char** and_terms,
-                                size_t and_count, const char** not_terms, size_t not_count, const char** filter_keys,
-                                const char** filter_values, size_t filter_count, uint64_t* count) {
-  if (client == nullptr || client->client == nullptr || table == nullptr || query == nullptr || count == nullptr) {
+int mygramclient_prepare_search(MygramClient_C* client, const char* table, const char** and_terms, size_t and_count,
+                                const char** not_terms, size_t not_count, const char** filter_keys,
+                                const char** filter_values, size_t filter_count, const char* sort_column,
+                                int sort_desc, MygramPreparedSearch_C** prepared) {
+  if (!usable(client) || table == nullptr || prepared == nullptr) {
     return -1;
   }
 
-  // Convert C arrays to C++ vectors
   std::vector<std::string> and_terms_vec;
-  for (size_t i = 0; i < and_count; ++i) {
-    if (and_terms[i] != nullptr) {
-      and_terms_vec.emplace_back(and_terms[i]);
-    }
-  }
+  assign_c_strings(and_terms_vec, and_terms, and_count);
 
   std::vector<std::string> not_terms_vec;
-  for (size_t i = 0; i < not_count; ++i) {
-    if (not_terms[i] != nullptr) {
-      not_terms_vec.emplace_back(not_terms[i]);
-    }
-  }
+  assign_c_strings(not_terms_vec, not_terms, not_count);
 
   std::vector<std::pair<std::string, std::string>> filters_vec;
-  for (size_t i = 0; i < filter_count; ++i) {
-    if (filter_keys[i] != nullptr && filter_values[i] != nullptr) {
-      filters_vec.emplace_back(filter_keys[i], filter_values[i]);
-    }
-  }
+  assign_c_filters(filters_vec, filter_keys, filter_values, filter_count);
 
-  auto count_result = client->client->Count(table, query, and_terms_vec, not_terms_vec, filters_vec);
-
-  if (!count_result) {
-    client->last_error = count_result.error().to_string();
+  // Preparing needs no connection, so pooled handles do not lease one for it
+  auto prepare_result = MygramClient::PrepareSearch(table, and_terms_vec, not_terms_vec, filters_vec,
+                                                    sort_column != nullptr ? sort_column : "", sort_desc != 0);
+  if (!prepare_result) {
+    set_error(client, prepare_result.error().to_string());
     return -1;
   }
 
-  auto& resp = *count_result;
-  *count = resp.count;
+  auto* prepared_c = new (std::nothrow) MygramPreparedSearch_C{std::move(*prepare_result)};
+  if (prepared_c == nullptr) {
+    set_error(client, "Memory allocation failed");
+    return -1;
+  }
 
+  *prepared = prepared_c;
   return 0;
 }
 
-int mygramclient_get(MygramClient_C* client, const char* table, const char* primary_key, MygramDocument_C** doc) {
-  if (client == nullptr || client->client == nullptr || table == nullptr || primary_key == nullptr || doc == nullptr) {
+int mygramclient_search_prepared(MygramClient_C* client, MygramPreparedSearch_C* prepared, const char* query,
+                                 uint32_t limit, uint32_t offset, MygramSearchResult_C** result) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || prepared == nullptr || query == nullptr || result == nullptr) {
     return -1;
   }
 
-  auto get_result = client->client->Get(table, primary_key);
-
-  if (!get_result) {
-    client->last_error = get_result.error().to_string();
+  std::string& bound_query = call_scratch().args.query;
+  bound_query.assign(query);
+  ClientLease lease(client);
+  if (!lease) {
     return -1;
   }
-
-  auto& document = *get_result;
-
-  auto* doc_c = static_cast<MygramDocument_C*>(malloc(sizeof(MygramDocument_C)));
-  if (doc_c == nullptr) {
-    client->last_error = "Memory allocation failed";
+  auto search_result = lease->Search(prepared->prepared, bound_query, limit, offset);
+  if (!search_result) {
+    set_error(client, search_result.error().to_string());
     return -1;
   }
 
-  doc_c->primary_key = strdup_safe(document.primary_key);
-  doc_c->field_count = document.fields.size();
-
-  if (doc_c->field_count > 0) {
-    doc_c->field_keys = static_cast<char**>(malloc(sizeof(char*) * doc_c->field_count));
-    doc_c->field_values = static_cast<char**>(malloc(sizeof(char*) * doc_c->field_count));
+  return copy_search_result(client, *search_result, result);
+}
 
-    if (doc_c->field_keys == nullptr || doc_c->field_values == nullptr) {
-      free(doc_c->primary_key);
-      free(doc_c->field_keys);
-      free(doc_c->field_values);
-      free(doc_c);
-      client->last_error = "Memory allocation failed";
-      return -1;
-    }
+int mygramclient_search_prepared_into(MygramClient_C* client, MygramPreparedSearch_C* prepared, const char* query,
+                                      uint32_t limit, uint32_t offset, MygramSearchResult_C* result) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || prepared == nullptr || query == nullptr || result == nullptr) {
+    return -1;
+  }
 
-    for (size_t i = 0; i < doc_c->field_count; ++i) {
-      doc_c->field_keys[i] = strdup_safe(document.fields[i].first);
-      doc_c->field_values[i] = strdup_safe(document.fields[i].second);
-    }
-  } else {
-    doc_c->field_keys = nullptr;
-    doc_c->field_values = nullptr;
+  SearchResultStorage& storage = *reinterpret_cast<SearchResultHandle*>(result)->storage;
+  storage.query.assign(query);
+  ClientLease lease(client);
+  if (!lease) {
+    return -1;
   }
+  auto status = lease->Search(prepared->prepared, storage.query, limit, offset, storage.response);
+  return publish_search_handle(client, status, result);
+}
 
-  *doc = doc_c;
-  return 0;
+void mygramclient_free_prepared_search(MygramPreparedSearch_C* prepared) { delete prepared; }
+
+int mygramclient_count(MygramClient_C* client, const char* table, const char* query, uint64_t* count) {
+  return mygramclient_count_advanced(client, table, query, nullptr, 0, nullptr, 0, nullptr, nullptr, 0, count);
 }
 
-int mygramclient_info(MygramClient_C* client, MygramServerInfo_C** info) {
-  if (client == nullptr || client->client == nullptr || info == nullptr) {
+int mygramclient_count_advanced(MygramClient_C* client, const char* table, const char* query, const char** and_terms,
+                                size_t and_count, const char** not_terms, size_t not_count, const char** filter_keys,
+                                const char** filter_values, size_t filter_count, uint64_t* count) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || table == nullptr || query == nullptr || count == nullptr) {
     return -1;
   }
 
-  auto info_result = client->client->Info();
+  // Convert C arrays to C++ vectors
+  std::vector<std::string> and_terms_vec;
+  assign_c_strings(and_terms_vec, and_terms, and_count);
 
-  if (!info_result) {
-    client->last_error = info_result.error().to_string();
+  std::vector<std::string> not_terms_vec;
+  assign_c_strings(not_terms_vec, not_terms, not_count);
+
+  std::vector<std::pair<std::string, std::string>> filters_vec;
+  assign_c_filters(filters_vec, filter_keys, filter_values, filter_count);
+
+  ClientLease lease(client);
+  if (!lease) {
     return -1;
   }
+  auto count_result = lease->Count(table, query, and_terms_vec, not_terms_vec, filters_vec);
 
-  auto& server_info = *info_result;
-
-  auto* info_c = static_cast<MygramServerInfo_C*>(malloc(sizeof(MygramServerInfo_C)));
-  if (info_c == nullptr) {
-    client->last_error = "Memory allocation failed";
+  if (!count_result) {
+    set_error(client, count_result.error().to_string());
     return -1;
   }
 
-  info_c->version = strdup_safe(server_info.version);
-  info_c->uptime_seconds = server_info.uptime_seconds;
-  info_c->total_requests = server_info.total_requests;
-  info_c->active_connections = server_info.active_connections;
-  info_c->index_size_bytes = server_info.index_size_bytes;
-  info_c->doc_count = server_info.doc_count;
-  info_c->table_count = server_info.tables.size();
-  info_c->tables = string_vector_to_c_array(server_info.tables);
+  auto& resp = *count_result;
+  *count = resp.count;
 
-  *info = info_c;
   return 0;
 }
 
-int mygramclient_get_config(MygramClient_C* client, char** config_str) {
-  if (client == nullptr || client->client == nullptr || config_str == nullptr) {
+int mygramclient_get(MygramClient_C* client, const char* table, const char* primary_key, MygramDocument_C** doc) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || table == nullptr || primary_key == nullptr || doc == nullptr) {
     return -1;
   }
 
-  auto config_result = client->client->GetConfig();
-
-  if (!config_result) {
-    client->last_error = config_result.error().to_string();
+  ClientLease lease(client);
+  if (!lease) {
     return -1;
   }
+  auto get_result = lease->Get(table, primary_key);
 
-  *config_str = strdup_safe(*config_result);
-  return 0;
-}
-
-int mygramclient_save(MygramClient_C* client, const char* filepath, char** saved_path) {
-  if (client == nullptr || client->client == nullptr || saved_path == nullptr) {
+  if (!get_result) {
+    set_error(client, get_result.error().to_string());
     return -1;
   }
 
-  std::string filepath_str = filepath != nullptr ? filepath : "";
-  auto save_result = client->client->Save(filepath_str);
-
-  if (!save_result) {
-    client->last_error = save_result.error().to_string();
+  // One block, as in copy_search_result(): struct, key and value pointers,
+  // key and value lengths, then the string bytes
+  const Document& document = *get_result;
+  const size_t count = document.fields.size();
+  const size_t arrays_offset = sizeof(MygramDocument_C);
+  const size_t text_offset = arrays_offset + (2 * count * sizeof(char*)) + (2 * count * sizeof(size_t));
+  static_assert(sizeof(MygramDocument_C) % alignof(char*) == 0 && alignof(char*) == alignof(size_t),
+                "document parts must stay aligned");
+
+  auto* block = static_cast<char*>(malloc(text_offset + document_text_bytes(document)));
+  if (block == nullptr) {
+    set_error(client, "Memory allocation failed");
     return -1;
   }
 
-  *saved_path = strdup_safe(*save_result);
+  auto* doc_c = reinterpret_cast<MygramDocument_C*>(block);
+  auto* keys = reinterpret_cast<char**>(block + arrays_offset);
+  auto* lengths = reinterpret_cast<size_t*>(keys + (2 * count));
+  fill_document_view(document, block + text_offset, keys, keys + count, lengths, lengths + count, doc_c);
+
+  *doc = doc_c;
   return 0;
 }
 
-int mygramclient_load(MygramClient_C* client, const char* filepath, char** loaded_path) {
-  if (client == nullptr || client->client == nullptr || filepath == nullptr || loaded_path == nullptr) {
-    return -1;
+MygramDocument_C* mygramclient_document_create(void) {
+  auto* handle = new (std::nothrow) DocumentHandle();
+  if (handle == nullptr) {
+    return nullptr;
+  }
+  handle->storage = new (std::nothrow) DocumentStorage();
+  if (handle->storage == nullptr) {
+    delete handle;
+    return nullptr;
   }
+  handle->view = MygramDocument_C{};
+  handle->view.primary_key = const_cast<char*>("");
+  return &handle->view;
+}
 
-  auto load_result = client->client->Load(filepath);
+void mygramclient_document_destroy(MygramDocument_C* doc) {
+  if (doc == nullptr) {
+    return;
+  }
+  auto* handle = reinterpret_cast<DocumentHandle*>(doc);
+  delete handle->storage;
+  delete handle;
+}
 
-  if (!load_result) {
-    client->last_error = load_result.error().to_string();
+int mygramclient_get_into(MygramClient_C* client, const char* table, const char* primary_key, MygramDocument_C* doc) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || table == nullptr || primary_key == nullptr || doc == nullptr) {
     return -1;
   }
 
-  *loaded_path = strdup_safe(*load_result);
-  return 0;
-}
+  DocumentStorage& storage = *reinterpret_cast<DocumentHandle*>(doc)->storage;
+  storage.table.assign(table);
+  storage.primary_key.assign(primary_key);
 
-int mygramclient_replication_stop(MygramClient_C* client) {
-  if (client == nullptr || client->client == nullptr) {
+  ClientLease lease(client);
+  if (!lease) {
     return -1;
   }
-
-  auto result = client->client->StopReplication();
-  if (!result) {
-    client->last_error = result.error().to_string();
+  auto status = lease->Get(storage.table, storage.primary_key, storage.document);
+  if (!status) {
+    set_error(client, status.error().to_string());
+    *doc = MygramDocument_C{};
+    doc->primary_key = const_cast<char*>("");
     return -1;
   }
 
+  publish_document_view(storage.document, storage.text, doc);
   return 0;
 }
 
-int mygramclient_replication_start(MygramClient_C* client) {
-  if (client == nullptr || client->client == nullptr) {
+// Helper: C status of a pipeline item (0 or its error code)
+static int pipeline_item_status(const Pipeline::Item& item) {
+  return static_cast<int>(item.error.code());
+}
+
+int mygramclient_search_batch(MygramClient_C* client, const MygramSearchRequest_C* requests, size_t count,
+                              MygramSearchResult_C** results, int* statuses) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || (count > 0 && (requests == nullptr || results == nullptr || statuses == nullptr))) {
+    return -1;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (requests[i].table == nullptr || requests[i].query == nullptr) {
+      set_error(client, "Request " + std::to_string(i) + " has no table or query");
+      return -1;
+    }
+  }
+
+  CallScratch& scratch = call_scratch();
+  Pipeline& batch = scratch.batch;
+  CommandArgs& args = scratch.args;
+  batch.Clear();
+  for (size_t i = 0; i < count; ++i) {
+    args.table.assign(requests[i].table);
+    args.query.assign(requests[i].query);
+    batch.AddSearch(args.table, args.query, requests[i].limit, requests[i].offset);
+  }
+
+  ClientLease lease(client);
+  if (!lease) {
+    std::fill_n(results, count, nullptr);
+    std::fill_n(statuses, count, static_cast<int>(lease.error().code()));
+    return -1;
+  }
+  auto status = lease->Execute(batch);
+  if (!status) {
+    set_error(client, status.error().to_string());
+  }
+  for (size_t i = 0; i < count; ++i) {
+    results[i] = nullptr;
+    statuses[i] = pipeline_item_status(batch[i]);
+    if (batch[i].ok() && copy_search_result(client, batch[i].search, &results[i]) != 0) {
+      statuses[i] = static_cast<int>(mygram::utils::ErrorCode::kInternalError);
+    }
+  }
+  return status ? 0 : -1;
+}
+
+int mygramclient_count_batch(MygramClient_C* client, const MygramCountRequest_C* requests, size_t count,
+                             uint64_t* counts, int* statuses) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || (count > 0 && (requests == nullptr || counts == nullptr || statuses == nullptr))) {
+    return -1;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (requests[i].table == nullptr || requests[i].query == nullptr) {
+      set_error(client, "Request " + std::to_string(i) + " has no table or query");
+      return -1;
+    }
+  }
+
+  CallScratch& scratch = call_scratch();
+  Pipeline& batch = scratch.batch;
+  CommandArgs& args = scratch.args;
+  batch.Clear();
+  for (size_t i = 0; i < count; ++i) {
+    args.table.assign(requests[i].table);
+    args.query.assign(requests[i].query);
+    batch.AddCount(args.table, args.query);
+  }
+
+  ClientLease lease(client);
+  if (!lease) {
+    std::fill_n(counts, count, 0);
+    std::fill_n(statuses, count, static_cast<int>(lease.error().code()));
+    return -1;
+  }
+  auto status = lease->Execute(batch);
+  if (!status) {
+    set_error(client, status.error().to_string());
+  }
+  for (size_t i = 0; i < count; ++i) {
+    statuses[i] = pipeline_item_status(batch[i]);
+    counts[i] = batch[i].ok() ? batch[i].count.count : 0;
+  }
+  return status ? 0 : -1;
+}
+
+MygramPipeline_C* mygramclient_pipeline_create(void) {
+  return new (std::nothrow) MygramPipeline_C();
+}
+
+void mygramclient_pipeline_destroy(MygramPipeline_C* pipeline) {
+  delete pipeline;
+}
+
+void mygramclient_pipeline_clear(MygramPipeline_C* pipeline) {
+  if (pipeline != nullptr) {
+    pipeline->pipeline.Clear();
+  }
+}
+
+size_t mygramclient_pipeline_size(const MygramPipeline_C* pipeline) {
+  return pipeline != nullptr ? pipeline->pipeline.size() : 0;
+}
+
+// Helper: 0 if the item just added was queued, -1 if validation rejected it
+static int pipeline_added(const MygramPipeline_C* pipeline, size_t index) {
+  return pipeline->pipeline[index].ok() ? 0 : -1;
+}
+
+int mygramclient_pipeline_add_search(MygramPipeline_C* pipeline, const char* table, const char* query, uint32_t limit,
+                                     uint32_t offset) {
+  if (pipeline == nullptr || table == nullptr || query == nullptr) {
+    return -1;
+  }
+  CommandArgs& args = pipeline->args;
+  args.table.assign(table);
+  args.query.assign(query);
+  return pipeline_added(pipeline, pipeline->pipeline.AddSearch(args.table, args.query, limit, offset));
+}
+
+int mygramclient_pipeline_add_search_advanced(MygramPipeline_C* pipeline, const char* table, const char* query,
+                                              uint32_t limit, uint32_t offset, const char** and_terms,
+                                              size_t and_count, const char** not_terms, size_t not_count,
+                                              const char** filter_keys, const char** filter_values,
+                                              size_t filter_count, const char* sort_column, int sort_desc) {
+  if (pipeline == nullptr || table == nullptr || query == nullptr) {
+    return -1;
+  }
+  CommandArgs& args = pipeline->args;
+  args.table.assign(table);
+  args.query.assign(query);
+  args.sort_column.assign(sort_column != nullptr ? sort_column : "");
+  assign_c_strings(args.and_terms, and_terms, and_count);
+  assign_c_strings(args.not_terms, not_terms, not_count);
+  assign_c_filters(args.filters, filter_keys, filter_values, filter_count);
+  return pipeline_added(pipeline,
+                        pipeline->pipeline.AddSearch(args.table, args.query, limit, offset, args.and_terms,
+                                                     args.not_terms, args.filters, args.sort_column, sort_desc != 0));
+}
+
+int mygramclient_pipeline_add_search_prepared(MygramPipeline_C* pipeline, const MygramPreparedSearch_C* prepared,
+                                              const char* query, uint32_t limit, uint32_t offset) {
+  if (pipeline == nullptr || prepared == nullptr || query == nullptr) {
+    return -1;
+  }
+  pipeline->args.query.assign(query);
+  return pipeline_added(pipeline,
+                        pipeline->pipeline.AddSearch(prepared->prepared, pipeline->args.query, limit, offset));
+}
+
+int mygramclient_pipeline_add_count(MygramPipeline_C* pipeline, const char* table, const char* query) {
+  if (pipeline == nullptr || table == nullptr || query == nullptr) {
+    return -1;
+  }
+  CommandArgs& args = pipeline->args;
+  args.table.assign(table);
+  args.query.assign(query);
+  return pipeline_added(pipeline, pipeline->pipeline.AddCount(args.table, args.query));
+}
+
+int mygramclient_pipeline_add_get(MygramPipeline_C* pipeline, const char* table, const char* primary_key) {
+  if (pipeline == nullptr || table == nullptr || primary_key == nullptr) {
+    return -1;
+  }
+  CommandArgs& args = pipeline->args;
+  args.table.assign(table);
+  args.primary_key.assign(primary_key);
+  return pipeline_added(pipeline, pipeline->pipeline.AddGet(args.table, args.primary_key));
+}
+
+int mygramclient_pipeline_execute(MygramClient_C* client, MygramPipeline_C* pipeline) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || pipeline == nullptr) {
+    return -1;
+  }
+  if (pipeline->views.size() < pipeline->pipeline.size()) {
+    pipeline->views.resize(pipeline->pipeline.size());
+  }
+  ClientLease lease(client);
+  if (!lease) {
+    for (size_t i = 0; i < pipeline->pipeline.size(); ++i) {
+      if (pipeline->pipeline[i].command_bytes > 0) {
+        pipeline->pipeline[i].error = lease.error();  // As if sending had failed
+      }
+    }
+    return -1;
+  }
+  auto status = lease->Execute(pipeline->pipeline);
+  if (!status) {
+    set_error(client, status.error().to_string());
+    return -1;
+  }
+  return 0;
+}
+
+int mygramclient_pipeline_status(const MygramPipeline_C* pipeline, size_t index) {
+  if (pipeline == nullptr || index >= pipeline->pipeline.size()) {
+    return -1;
+  }
+  return pipeline_item_status(pipeline->pipeline[index]);
+}
+
+const char* mygramclient_pipeline_error(const MygramPipeline_C* pipeline, size_t index) {
+  if (pipeline == nullptr || index >= pipeline->pipeline.size() || pipeline->pipeline[index].ok()) {
+    return nullptr;
+  }
+  return pipeline->pipeline[index].error.message().c_str();
+}
+
+const MygramSearchResult_C* mygramclient_pipeline_search_result(MygramPipeline_C* pipeline, size_t index) {
+  if (pipeline == nullptr || index >= pipeline->pipeline.size() || index >= pipeline->views.size()) {
+    return nullptr;
+  }
+  Pipeline::Item& item = pipeline->pipeline[index];
+  if (item.type != CommandType::kSearch || !item.ok()) {
+    return nullptr;
+  }
+  ResultView& view = pipeline->views[index];
+  publish_search_view(item.search, view.keys, &view.search);
+  return &view.search;
+}
+
+int mygramclient_pipeline_count_result(const MygramPipeline_C* pipeline, size_t index, uint64_t* count) {
+  if (pipeline == nullptr || count == nullptr || index >= pipeline->pipeline.size()) {
+    return -1;
+  }
+  const Pipeline::Item& item = pipeline->pipeline[index];
+  if (item.type != CommandType::kCount || !item.ok()) {
+    return -1;
+  }
+  *count = item.count.count;
+  return 0;
+}
+
+const MygramDocument_C* mygramclient_pipeline_document(MygramPipeline_C* pipeline, size_t index) {
+  if (pipeline == nullptr || index >= pipeline->pipeline.size() || index >= pipeline->views.size()) {
+    return nullptr;
+  }
+  Pipeline::Item& item = pipeline->pipeline[index];
+  if (item.type != CommandType::kGet || !item.ok()) {
+    return nullptr;
+  }
+  ResultView& view = pipeline->views[index];
+  publish_document_view(item.document, view.text, &view.document);
+  return &view.document;
+}
+
+int mygramclient_get_fd(const MygramClient_C* client) {
+  if (!unpooled(client)) {
+    return -1;
+  }
+  return client->client->GetFd();
+}
+
+// Helper: Report the id of a submitted request, or its error
+static int submitted(MygramClient_C* client, const mygram::utils::Expected<uint64_t, mygram::utils::Error>& result,
+                     uint64_t* id) {
+  if (!result) {
+    set_error(client, result.error().to_string());
+    return -1;
+  }
+  *id = *result;
+  return 0;
+}
+
+int mygramclient_submit_search(MygramClient_C* client, const char* table, const char* query, uint32_t limit,
+                               uint32_t offset, uint64_t* id) {
+  return mygramclient_submit_search_advanced(client, table, query, limit, offset, nullptr, 0, nullptr, 0, nullptr,
+                                             nullptr, 0, nullptr, 1, id);  // Default sort_desc = 1 (descending)
+}
+
+int mygramclient_submit_search_advanced(MygramClient_C* client, const char* table, const char* query, uint32_t limit,
+                                        uint32_t offset, const char** and_terms, size_t and_count,
+                                        const char** not_terms, size_t not_count, const char** filter_keys,
+                                        const char** filter_values, size_t filter_count, const char* sort_column,
+                                        int sort_desc, uint64_t* id) {
+  CApiProbe probe(__func__);
+  if (!unpooled(client) || table == nullptr || query == nullptr || id == nullptr) {
+    return -1;
+  }
+  CommandArgs& args = call_scratch().args;
+  args.table.assign(table);
+  args.query.assign(query);
+  args.sort_column.assign(sort_column != nullptr ? sort_column : "");
+  assign_c_strings(args.and_terms, and_terms, and_count);
+  assign_c_strings(args.not_terms, not_terms, not_count);
+  assign_c_filters(args.filters, filter_keys, filter_values, filter_count);
+  return submitted(client,
+                   client->client->SubmitSearch(args.table, args.query, limit, offset, args.and_terms, args.not_terms,
+                                                args.filters, args.sort_column, sort_desc != 0),
+                   id);
+}
+
+int mygramclient_submit_search_prepared(MygramClient_C* client, MygramPreparedSearch_C* prepared, const char* query,
+                                        uint32_t limit, uint32_t offset, uint64_t* id) {
+  CApiProbe probe(__func__);
+  if (!unpooled(client) || prepared == nullptr || query == nullptr || id == nullptr) {
+    return -1;
+  }
+  std::string& bound_query = call_scratch().args.query;
+  bound_query.assign(query);
+  return submitted(client, client->client->SubmitSearch(prepared->prepared, bound_query, limit, offset), id);
+}
+
+int mygramclient_submit_count(MygramClient_C* client, const char* table, const char* query, uint64_t* id) {
+  CApiProbe probe(__func__);
+  if (!unpooled(client) || table == nullptr || query == nullptr || id == nullptr) {
+    return -1;
+  }
+  CommandArgs& args = call_scratch().args;
+  args.table.assign(table);
+  args.query.assign(query);
+  return submitted(client, client->client->SubmitCount(args.table, args.query), id);
+}
+
+int mygramclient_submit_get(MygramClient_C* client, const char* table, const char* primary_key, uint64_t* id) {
+  CApiProbe probe(__func__);
+  if (!unpooled(client) || table == nullptr || primary_key == nullptr || id == nullptr) {
+    return -1;
+  }
+  CommandArgs& args = call_scratch().args;
+  args.table.assign(table);
+  args.primary_key.assign(primary_key);
+  return submitted(client, client->client->SubmitGet(args.table, args.primary_key), id);
+}
+
+int mygramclient_wants_write(const MygramClient_C* client) {
+  if (!unpooled(client)) {
+    return 0;
+  }
+  return client->client->WantsWrite() ? 1 : 0;
+}
+
+size_t mygramclient_pending(const MygramClient_C* client) {
+  if (!unpooled(client)) {
+    return 0;
+  }
+  return client->client->PendingRequests();
+}
+
+int mygramclient_process_io(MygramClient_C* client) {
+  CApiProbe probe(__func__);
+  if (!unpooled(client)) {
+    return -1;
+  }
+  auto ready = client->client->ProcessIo();
+  if (!ready) {
+    set_error(client, ready.error().to_string());
+    return -1;
+  }
+  return static_cast<int>(std::min<size_t>(*ready, INT_MAX));
+}
+
+MygramAsyncResult_C* mygramclient_async_result_create(void) {
+  auto* handle = new (std::nothrow) AsyncResultHandle();
+  if (handle == nullptr) {
+    return nullptr;
+  }
+  handle->storage = new (std::nothrow) AsyncResultStorage();
+  if (handle->storage == nullptr) {
+    delete handle;
+    return nullptr;
+  }
+  handle->view = MygramAsyncResult_C{};
+  return &handle->view;
+}
+
+void mygramclient_async_result_destroy(MygramAsyncResult_C* result) {
+  if (result == nullptr) {
+    return;
+  }
+  auto* handle = reinterpret_cast<AsyncResultHandle*>(result);
+  delete handle->storage;
+  delete handle;
+}
+
+int mygramclient_poll_result(MygramClient_C* client, MygramAsyncResult_C* result) {
+  if (!unpooled(client) || result == nullptr) {
+    return -1;
+  }
+  AsyncResultStorage& storage = *reinterpret_cast<AsyncResultHandle*>(result)->storage;
+  if (!client->client->PollResult(storage.result)) {
+    return 0;
+  }
+
+  const AsyncResult& polled = storage.result;
+  *result = MygramAsyncResult_C{};
+  result->id = polled.id;
+  result->status = static_cast<int>(polled.error.code());
+  if (!polled.ok()) {
+    result->error = polled.error.message().c_str();
+  } else if (polled.type == CommandType::kSearch) {
+    publish_search_view(storage.result.search, storage.view.keys, &storage.view.search);
+    result->search = &storage.view.search;
+  } else if (polled.type == CommandType::kCount) {
+    result->count = polled.count.count;
+  } else {
+    publish_document_view(polled.document, storage.view.text, &storage.view.document);
+    result->document = &storage.view.document;
+  }
+  return 1;
+}
+
+int mygramclient_info(MygramClient_C* client, MygramServerInfo_C** info) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || info == nullptr) {
+    return -1;
+  }
+
+  ClientLease lease(client);
+  if (!lease) {
+    return -1;
+  }
+  auto info_result = lease->Info();
+
+  if (!info_result) {
+    set_error(client, info_result.error().to_string());
+    return -1;
+  }
+
+  auto& server_info = *info_result;
+
+  auto* info_c = static_cast<MygramServerInfo_C*>(malloc(sizeof(MygramServerInfo_C)));
+  if (info_c == nullptr) {
+    set_error(client, "Memory allocation failed");
+    return -1;
+  }
+
+  info_c->version = strdup_safe(server_info.version);
+  info_c->uptime_seconds = server_info.uptime_seconds;
+  info_c->total_requests = server_info.total_requests;
+  info_c->active_connections = server_info.active_connections;
+  info_c->index_size_bytes = server_info.index_size_bytes;
+  info_c->doc_count = server_info.doc_count;
+  info_c->table_count = server_info.tables.size();
+  info_c->tables = string_vector_to_c_array(server_info.tables);
+
+  *info = info_c;
+  return 0;
+}
+
+int mygramclient_get_config(MygramClient_C* client, char** config_str) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || config_str == nullptr) {
+    return -1;
+  }
+
+  ClientLease lease(client);
+  if (!lease) {
+    return -1;
+  }
+  auto config_result = lease->GetConfig();
+
+  if (!config_result) {
+    set_error(client, config_result.error().to_string());
+    return -1;
+  }
+
+  *config_str = strdup_safe(*config_result);
+  return 0;
+}
+
+int mygramclient_save(MygramClient_C* client, const char* filepath, char** saved_path) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || saved_path == nullptr) {
+    return -1;
+  }
+
+  std::string filepath_str = filepath != nullptr ? filepath : "";
+  ClientLease lease(client);
+  if (!lease) {
+    return -1;
+  }
+  auto save_result = lease->Save(filepath_str);
+
+  if (!save_result) {
+    set_error(client, save_result.error().to_string());
+    return -1;
+  }
+
+  *saved_path = strdup_safe(*save_result);
+  return 0;
+}
+
+int mygramclient_load(MygramClient_C* client, const char* filepath, char** loaded_path) {
+  CApiProbe probe(__func__);
+  if (!usable(client) || filepath == nullptr || loaded_path == nullptr) {
+    return -1;
+  }
+
+  ClientLease lease(client);
+  if (!lease) {
+    return -1;
+  }
+  auto load_result = lease->Load(filepath);
+
+  if (!load_result) {
+    set_error(client, load_result.error().to_string());
+    return -1;
+  }
+
+  *loaded_path = strdup_safe(*load_result);
+  return 0;
+}
+
+int mygramclient_replication_stop(MygramClient_C* client) {
+  CApiProbe probe(__func__);
+  if (!usable(client)) {
     return -1;
   }
 
-  auto result = client->client->StartReplication();
+  ClientLease lease(client);
+  if (!lease) {
+    return -1;
+  }
+  auto result = lease->StopReplication();
   if (!result) {
-    client->last_error = result.error().to_string();
+    set_error(client, result.error().to_string());
+    return -1;
+  }
+
+  return 0;
+}
+
+int mygramclient_replication_start(MygramClient_C* client) {
+  CApiProbe probe(__func__);
+  if (!usable(client)) {
+    return -1;
+  }
+
+  ClientLease lease(client);
+  if (!lease) {
+    return -1;
+  }
+  auto result = lease->StartReplication();
+  if (!result) {
+    set_error(client, result.error().to_string());
     return -1;
   }
 
@@ -398,13 +1410,14 @@ int mygramclient_replication_start(MygramClient_C* client) {
 }
 
 int mygramclient_debug_on(MygramClient_C* client) {
-  if (client == nullptr || client->client == nullptr) {
+  CApiProbe probe(__func__);
+  if (!unpooled(client)) {
     return -1;
   }
 
   auto result = client->client->EnableDebug();
   if (!result) {
-    client->last_error = result.error().to_string();
+    set_error(client, result.error().to_string());
     return -1;
   }
 
@@ -412,16 +1425,347 @@ int mygramclient_debug_on(MygramClient_C* client) {
 }
 
 int mygramclient_debug_off(MygramClient_C* client) {
-  if (client == nullptr || client->client == nullptr) {
+  CApiProbe probe(__func__);
+  if (!unpooled(client)) {
     return -1;
   }
 
   auto result = client->client->DisableDebug();
   if (!result) {
-    client->last_error = result.error().to_string();
+    set_error(client, result.error().to_string());
+    return -1;
+  }
+
+  return 0;
+}
+
+int mygramclient_get_metrics(MygramClient_C* client, MygramClientMetrics_C** metrics) {
+  if (!usable(client) || metrics == nullptr) {
+    return -1;
+  }
+
+  const ClientMetrics snapshot = client->pool != nullptr ? client->pool->GetMetrics() : client->client->GetMetrics();
+
+  auto* metrics_c = static_cast<MygramClientMetrics_C*>(calloc(1, sizeof(MygramClientMetrics_C)));
+  if (metrics_c == nullptr) {
+    set_error(client, "Memory allocation failed");
+    return -1;
+  }
+  metrics_c->commands = static_cast<MygramCommandMetrics_C*>(calloc(kCommandTypeCount, sizeof(MygramCommandMetrics_C)));
+  if (!snapshot.errors.empty()) {
+    metrics_c->errors = static_cast<MygramErrorCount_C*>(calloc(snapshot.errors.size(), sizeof(MygramErrorCount_C)));
+  }
+  if (metrics_c->commands == nullptr || (!snapshot.errors.empty() && metrics_c->errors == nullptr)) {
+    mygramclient_free_metrics(metrics_c);
+    set_error(client, "Memory allocation failed");
+    return -1;
+  }
+
+  for (size_t i = 0; i < kCommandTypeCount; ++i) {
+    const CommandMetrics& src = snapshot.commands[i];
+    MygramCommandMetrics_C& dst = metrics_c->commands[i];
+    const LatencyHistogram& latency = src.latency;
+    ++metrics_c->command_count;  // Counted as filled so a failure below frees it
+
+    dst.command = CommandTypeName(static_cast<CommandType>(i));
+    dst.requests = src.requests;
+    dst.errors = src.errors;
+    dst.bytes_sent = src.bytes_sent;
+    dst.bytes_received = src.bytes_received;
+    dst.recv_calls = src.recv_calls;
+    dst.latency_count = latency.count;
+    dst.latency_sum_ns = latency.sum_ns;
+    dst.latency_min_ns = latency.min_ns;
+    dst.latency_max_ns = latency.max_ns;
+    dst.latency_p50_ns = latency.ValueAtPercentile(50.0);
+    dst.latency_p90_ns = latency.ValueAtPercentile(90.0);
+    dst.latency_p99_ns = latency.ValueAtPercentile(99.0);
+    dst.latency_p999_ns = latency.ValueAtPercentile(99.9);
+
+    const size_t used = static_cast<size_t>(
+        std::count_if(latency.buckets.begin(), latency.buckets.end(), [](uint64_t count) { return count != 0; }));
+    if (used == 0) {
+      continue;
+    }
+    dst.buckets = static_cast<MygramLatencyBucket_C*>(malloc(used * sizeof(MygramLatencyBucket_C)));
+    if (dst.buckets == nullptr) {
+      mygramclient_free_metrics(metrics_c);
+      set_error(client, "Memory allocation failed");
+      return -1;
+    }
+    for (size_t b = 0; b < latency.buckets.size(); ++b) {
+      if (latency.buckets[b] != 0) {
+        dst.buckets[dst.bucket_count++] = {LatencyBuckets::UpperBound(b), latency.buckets[b]};
+      }
+    }
+  }
+
+  for (const auto& [code, count] : snapshot.errors) {
+    metrics_c->errors[metrics_c->error_count++] = {static_cast<int>(code), mygram::utils::ErrorCodeToString(code),
+                                                   count};
+  }
+
+  *metrics = metrics_c;
+  return 0;
+}
+
+void mygramclient_reset_metrics(MygramClient_C* client) {
+  if (client != nullptr && client->pool != nullptr) {
+    client->pool->ResetMetrics();
+  } else if (client != nullptr && client->client != nullptr) {
+    client->client->ResetMetrics();
+  }
+}
+
+// Helper: Install a request observer on a handle's client or every pooled client
+static void set_observer(MygramClient_C* client, std::shared_ptr<RequestObserver> observer) {
+  if (client->pool != nullptr) {
+    client->pool->SetObserver(std::move(observer));
+  } else {
+    client->client->SetObserver(std::move(observer));
+  }
+}
+
+int mygramclient_set_span_ring(MygramClient_C* client, const char* path, size_t capacity) {
+  if (!usable(client)) {
+    return -1;
+  }
+
+  if (path == nullptr) {
+    set_observer(client, nullptr);
+    return 0;
+  }
+
+  auto observer = RingFileObserver::Open(path, capacity);
+  if (!observer) {
+    set_error(client, observer.error().to_string());
+    return -1;
+  }
+
+  set_observer(client, std::move(*observer));
+  return 0;
+}
+
+void mygramclient_set_debug_sampling(MygramClient_C* client, uint32_t one_in) {
+  if (!unpooled(client)) {
+    return;
+  }
+  client->client->SetDebugSampling(one_in);
+}
+
+int mygramclient_get_debug_profiles(MygramClient_C* client, MygramDebugProfile_C** profiles, size_t* count) {
+  if (!unpooled(client) || profiles == nullptr || count == nullptr) {
+    return -1;
+  }
+
+  const std::vector<DebugProfile> snapshot = client->client->GetDebugProfiles();
+  *profiles = nullptr;
+  *count = 0;
+  if (snapshot.empty()) {
+    return 0;
+  }
+
+  auto* profiles_c = static_cast<MygramDebugProfile_C*>(calloc(snapshot.size(), sizeof(MygramDebugProfile_C)));
+  if (profiles_c == nullptr) {
+    set_error(client, "Memory allocation failed");
+    return -1;
+  }
+
+  for (size_t i = 0; i < snapshot.size(); ++i) {
+    profiles_c[i].fingerprint = strdup_safe(snapshot[i].fingerprint);
+    if (profiles_c[i].fingerprint == nullptr || !fill_debug_profile(snapshot[i], profiles_c[i])) {
+      mygramclient_free_debug_profiles(profiles_c, i + 1);
+      set_error(client, "Memory allocation failed");
+      return -1;
+    }
+  }
+
+  *profiles = profiles_c;
+  *count = snapshot.size();
+  return 0;
+}
+
+void mygramclient_reset_debug_profiles(MygramClient_C* client) {
+  if (!unpooled(client)) {
+    return;
+  }
+  client->client->ResetDebugProfiles();
+}
+
+int mygramclient_enable_query_stats(MygramClient_C* client, size_t max_fingerprints) {
+  if (!unpooled(client)) {
+    return -1;
+  }
+
+  if (max_fingerprints == 0) {
+    client->client->DisableQueryStats();
+  } else {
+    client->client->EnableQueryStats(max_fingerprints);
+  }
+  return 0;
+}
+
+int mygramclient_get_query_stats(MygramClient_C* client, MygramQueryStats_C** stats, size_t* count) {
+  if (!unpooled(client) || stats == nullptr || count == nullptr) {
+    return -1;
+  }
+
+  const std::vector<QueryShapeStats> snapshot = client->client->GetQueryStats();
+  *stats = nullptr;
+  *count = 0;
+  if (snapshot.empty()) {
+    return 0;
+  }
+
+  auto* stats_c = static_cast<MygramQueryStats_C*>(calloc(snapshot.size(), sizeof(MygramQueryStats_C)));
+  if (stats_c == nullptr) {
+    set_error(client, "Memory allocation failed");
+    return -1;
+  }
+
+  for (size_t i = 0; i < snapshot.size(); ++i) {
+    const QueryShapeStats& src = snapshot[i];
+    MygramQueryStats_C& dst = stats_c[i];
+
+    dst.fingerprint = strdup_safe(src.fingerprint);
+    dst.calls = src.calls;
+    dst.errors = src.errors;
+    dst.latency_sum_ns = src.latency.sum_ns;
+    dst.latency_min_ns = src.latency.min_ns;
+    dst.latency_max_ns = src.latency.max_ns;
+    dst.latency_p50_ns = src.latency.ValueAtPercentile(50.0);
+    dst.latency_p90_ns = src.latency.ValueAtPercentile(90.0);
+    dst.latency_p99_ns = src.latency.ValueAtPercentile(99.0);
+    dst.matched_sum = src.matched.sum;
+    dst.matched_max = src.matched.max;
+    dst.matched_p50 = src.matched.ValueAtPercentile(50.0);
+    dst.matched_p90 = src.matched.ValueAtPercentile(90.0);
+    dst.matched_p99 = src.matched.ValueAtPercentile(99.0);
+    if (dst.fingerprint == nullptr || !fill_debug_profile(src.debug, dst.debug)) {
+      mygramclient_free_query_stats(stats_c, i + 1);
+      set_error(client, "Memory allocation failed");
+      return -1;
+    }
+  }
+
+  *stats = stats_c;
+  *count = snapshot.size();
+  return 0;
+}
+
+void mygramclient_reset_query_stats(MygramClient_C* client) {
+  if (!unpooled(client)) {
+    return;
+  }
+  client->client->ResetQueryStats();
+}
+
+// Helper: The heavy hitters tracker of a handle (null if not enabled)
+static std::shared_ptr<HeavyHitters> heavy_hitters_of(MygramClient_C* client) {
+  std::lock_guard<std::mutex> lock(client->heavy_hitters_mutex);
+  return client->heavy_hitters;
+}
+
+int mygramclient_enable_heavy_hitters(MygramClient_C* client, size_t top_k) {
+  if (!usable(client)) {
+    return -1;
+  }
+
+  std::shared_ptr<HeavyHitters> tracker;
+  if (top_k != 0) {
+    HeavyHitterOptions options;
+    options.top_k = top_k;
+    tracker = std::make_shared<HeavyHitters>(options);
+  }
+  std::lock_guard<std::mutex> lock(client->heavy_hitters_mutex);
+  client->heavy_hitters = tracker;
+  if (client->pool != nullptr) {
+    client->pool->SetHeavyHitters(std::move(tracker));
+  } else {
+    client->client->SetHeavyHitters(std::move(tracker));
+  }
+  return 0;
+}
+
+int mygramclient_get_heavy_hitters(MygramClient_C* client, MygramHeavyHitters_C** hitters) {
+  if (!usable(client) || hitters == nullptr) {
+    return -1;
+  }
+  const std::shared_ptr<HeavyHitters> tracker = heavy_hitters_of(client);
+  if (tracker == nullptr) {
+    set_error(client, "Heavy hitters are not enabled");
+    return -1;
+  }
+
+  const HeavyHittersSnapshot snapshot = tracker->Snapshot();
+
+  auto* hitters_c = static_cast<MygramHeavyHitters_C*>(calloc(1, sizeof(MygramHeavyHitters_C)));
+  if (hitters_c == nullptr) {
+    set_error(client, "Memory allocation failed");
+    return -1;
+  }
+  hitters_c->total_requests = snapshot.total_requests;
+  hitters_c->total_latency_ns = snapshot.total_latency_ns;
+  if (!snapshot.top.empty()) {
+    hitters_c->top = static_cast<MygramHeavyHitter_C*>(calloc(snapshot.top.size(), sizeof(MygramHeavyHitter_C)));
+    if (hitters_c->top == nullptr) {
+      mygramclient_free_heavy_hitters(hitters_c);
+      set_error(client, "Memory allocation failed");
+      return -1;
+    }
+  }
+
+  for (const HeavyHitter& src : snapshot.top) {
+    MygramHeavyHitter_C& dst = hitters_c->top[hitters_c->count++];
+    dst = {strdup_safe(src.command), src.count, src.latency_ns, src.latency_share};
+    if (dst.command == nullptr) {
+      mygramclient_free_heavy_hitters(hitters_c);
+      set_error(client, "Memory allocation failed");
+      return -1;
+    }
+  }
+
+  *hitters = hitters_c;
+  return 0;
+}
+
+void mygramclient_reset_heavy_hitters(MygramClient_C* client) {
+  if (client == nullptr) {
+    return;
+  }
+  if (const std::shared_ptr<HeavyHitters> tracker = heavy_hitters_of(client); tracker != nullptr) {
+    tracker->Reset();
+  }
+}
+
+// Helper: Install a capture on a handle's client or every pooled client
+static void set_capture(MygramClient_C* client, std::shared_ptr<QueryCapture> capture) {
+  if (client->pool != nullptr) {
+    client->pool->SetCapture(std::move(capture));
+  } else {
+    client->client->SetCapture(std::move(capture));
+  }
+}
+
+int mygramclient_set_capture(MygramClient_C* client, const char* path) {
+  if (!usable(client)) {
     return -1;
   }
 
+  // Completes the previous file before a new one may truncate it (on a
+  // pooled handle, once the clients leased at the moment are released)
+  set_capture(client, nullptr);
+  if (path == nullptr) {
+    return 0;
+  }
+
+  auto capture = QueryCapture::Open(path);
+  if (!capture) {
+    set_error(client, capture.error().to_string());
+    return -1;
+  }
+
+  set_capture(client, std::move(*capture));
   return 0;
 }
 
@@ -429,17 +1773,23 @@ const char* mygramclient_get_last_error(const MygramClient_C* client) {
   if (client == nullptr) {
     return "Invalid client handle";
   }
+  if (client->pool != nullptr) {
+    return thread_last_error.c_str();
+  }
 
   return client->last_error.c_str();
 }
 
+const char* mygramclient_last_error(void) {
+  return thread_last_error.c_str();
+}
+
 void mygramclient_free_search_result(MygramSearchResult_C* result) {
   if (result == nullptr) {
     return;
   }
 
-  free_c_string_array(result->primary_keys, result->count);
-  free(result);
+  free(result);  // One block, see copy_search_result()
 }
 
 void mygramclient_free_document(MygramDocument_C* doc) {
@@ -447,10 +1797,7 @@ void mygramclient_free_document(MygramDocument_C* doc) {
     return;
   }
 
-  free(doc->primary_key);
-  free_c_string_array(doc->field_keys, doc->field_count);
-  free_c_string_array(doc->field_values, doc->field_count);
-  free(doc);
+  free(doc);  // One block, see mygramclient_get()
 }
 
 void mygramclient_free_server_info(MygramServerInfo_C* info) {
@@ -463,6 +1810,54 @@ void mygramclient_free_server_info(MygramServerInfo_C* info) {
   free(info);
 }
 
+void mygramclient_free_metrics(MygramClientMetrics_C* metrics) {
+  if (metrics == nullptr) {
+    return;
+  }
+
+  for (size_t i = 0; i < metrics->command_count; ++i) {
+    free(metrics->commands[i].buckets);
+  }
+  free(metrics->commands);
+  free(metrics->errors);
+  free(metrics);
+}
+
+void mygramclient_free_debug_profiles(MygramDebugProfile_C* profiles, size_t count) {
+  if (profiles == nullptr) {
+    return;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    free_debug_profile_fields(profiles[i]);
+  }
+  free(profiles);
+}
+
+void mygramclient_free_query_stats(MygramQueryStats_C* stats, size_t count) {
+  if (stats == nullptr) {
+    return;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    free(stats[i].fingerprint);
+    free_debug_profile_fields(stats[i].debug);
+  }
+  free(stats);
+}
+
+void mygramclient_free_heavy_hitters(MygramHeavyHitters_C* hitters) {
+  if (hitters == nullptr) {
+    return;
+  }
+
+  for (size_t i = 0; i < hitters->count; ++i) {
+    free(hitters->top[i].command);
+  }
+  free(hitters->top);
+  free(hitters);
+}
+
 void mygramclient_free_string(char* str) {
   free(str);
 }
@@ -0,0 +1,192 @@
+/**
+ * @file client_metrics.h
+ * @brief Per-command client-side metrics for MygramDB clients
+ *
+ * Every MygramClient records, per command type, the request and error
+ * counts, bytes sent and received, recv() calls and a latency histogram.
+ * Recording happens in per-thread shards without locks or atomic
+ * read-modify-write operations; shards are merged when a snapshot is taken.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "utils/error.h"
+
+namespace mygramdb::client {
+
+/**
+ * @brief Command categories metrics are kept for
+ */
+enum class CommandType : uint8_t {
+  kSearch = 0,
+  kCount,
+  kGet,
+  kInfo,
+  kConfig,
+  kSave,
+  kLoad,
+  kReplication,  // REPLICATION STATUS/START/STOP
+  kDebug,        // DEBUG ON/OFF
+  kOther,        // Raw SendCommand()
+};
+
+constexpr size_t kCommandTypeCount = static_cast<size_t>(CommandType::kOther) + 1;
+
+/**
+ * @brief Protocol name of a command category ("SEARCH", "COUNT", ...)
+ */
+const char* CommandTypeName(CommandType type);
+
+/**
+ * @brief Log-linear (HDR-style) latency bucket layout, in nanoseconds
+ *
+ * Values below 2^kSubBucketBits get one bucket each; above that, every
+ * power-of-two range is split into 2^kSubBucketBits equal buckets, which
+ * bounds the relative error of any reported value to about 6%. Values at or
+ * above 2^kMaxExponent ns (~68 s) land in the last bucket.
+ */
+struct LatencyBuckets {
+  static constexpr int kSubBucketBits = 4;
+  static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+  static constexpr int kMaxExponent = 36;
+  static constexpr size_t kCount = kSubBuckets * (kMaxExponent - kSubBucketBits + 1);
+
+  /**
+   * @brief Bucket holding value_ns
+   */
+  static size_t IndexOf(uint64_t value_ns);
+
+  /**
+   * @brief Smallest value that maps to bucket index
+   */
+  static uint64_t LowerBound(size_t index);
+
+  /**
+   * @brief Largest value that maps to bucket index
+   */
+  static uint64_t UpperBound(size_t index);
+};
+
+/**
+ * @brief Merged latency histogram of one command type
+ */
+struct LatencyHistogram {
+  uint64_t count = 0;
+  uint64_t sum_ns = 0;
+  uint64_t min_ns = 0;
+  uint64_t max_ns = 0;
+  std::vector<uint64_t> buckets;  // LatencyBuckets::kCount counts (empty if count == 0)
+
+  /**
+   * @brief Count one latency (not thread-safe; for histograms owned by one writer)
+   */
+  void Add(uint64_t value_ns);
+
+  /**
+   * @brief Add the counts of another histogram (e.g. of another client)
+   */
+  void Merge(const LatencyHistogram& other);
+
+  /**
+   * @brief Latency at or below which percentile% of requests completed
+   *
+   * Reported as the upper bound of the bucket holding that rank, clamped to
+   * max_ns. Returns 0 when the histogram is empty.
+   *
+   * @param percentile 0-100
+   */
+  [[nodiscard]] uint64_t ValueAtPercentile(double percentile) const;
+};
+
+/**
+ * @brief Metrics of one command type
+ */
+struct CommandMetrics {
+  uint64_t requests = 0;        // Completed calls (successful or not)
+  uint64_t errors = 0;          // Calls that returned an error
+  uint64_t bytes_sent = 0;      // Request bytes written to the socket
+  uint64_t bytes_received = 0;  // Reply bytes read from the socket
+  uint64_t recv_calls = 0;      // recv() calls needed to read replies
+  LatencyHistogram latency;     // Call latency, including validation and parsing
+};
+
+/**
+ * @brief Snapshot of a client's metrics
+ */
+struct ClientMetrics {
+  std::array<CommandMetrics, kCommandTypeCount> commands;             // Indexed by CommandType
+  std::vector<std::pair<mygram::utils::ErrorCode, uint64_t>> errors;  // Error counts by code (non-zero only)
+
+  [[nodiscard]] const CommandMetrics& operator[](CommandType type) const {
+    return commands[static_cast<size_t>(type)];
+  }
+
+  /**
+   * @brief Add the metrics of another client, e.g. to total a connection pool
+   */
+  void Merge(const ClientMetrics& other);
+};
+
+/**
+ * @brief I/O counters of one request, filled in while it runs
+ */
+struct RequestStats {
+  uint64_t bytes_sent = 0;
+  uint64_t bytes_received = 0;
+  uint64_t recv_calls = 0;
+};
+
+/**
+ * @brief Thread-sharded metrics store behind MygramClient::GetMetrics()
+ *
+ * Record() writes to the calling thread's shard, found through a small
+ * thread-local cache; only the first call from a new thread takes the lock.
+ * Snapshot() locks the shard list and reads every shard with relaxed
+ * atomics, so it is safe while other threads record.
+ *
+ * Only the owning thread writes a shard. Reset() therefore advances a reset
+ * epoch instead of zeroing the shards: Snapshot() ignores shards of an older
+ * epoch, and each thread clears its own shard at its next Record(). A request
+ * recorded while Reset() runs is counted wholly before or wholly after it.
+ */
+class MetricsRegistry {
+ public:
+  MetricsRegistry();
+  ~MetricsRegistry();
+
+  MetricsRegistry(const MetricsRegistry&) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+  MetricsRegistry(MetricsRegistry&&) = delete;
+  MetricsRegistry& operator=(MetricsRegistry&&) = delete;
+
+  /**
+   * @brief Record one completed request
+   * @param error kSuccess if the call succeeded
+   */
+  void Record(CommandType type, const RequestStats& stats, uint64_t latency_ns, mygram::utils::ErrorCode error);
+
+  [[nodiscard]] ClientMetrics Snapshot() const;
+
+  void Reset();
+
+ private:
+  struct Shard;
+
+  Shard& LocalShard();
+
+  const uint64_t id_;  // Process-unique; keys the thread-local shard cache
+  std::atomic<uint64_t> reset_epoch_{0};
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace mygramdb::client
@@ -0,0 +1,182 @@
+/**
+ * @file client_pool.h
+ * @brief Bounded pool of MygramClient connections shared by many threads
+ *
+ * A MygramClient owns one socket and is not safe to call from several
+ * threads at once. A ClientPool hands out clients one caller at a time:
+ * Acquire() lends an idle connection (most recently used first), opens a
+ * new one while fewer than max_connections exist, or waits for one to be
+ * released. Connections are opened lazily and kept across leases, so a
+ * steady workload of N threads settles on at most N connections.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "mygramdb/client_metrics.h"
+#include "mygramdb/mygramclient.h"
+#include "utils/error.h"
+#include "utils/expected.h"
+
+namespace mygramdb::client {
+
+/**
+ * @brief Connection pool behind thread-safe C API handles
+ *
+ * Acquire() and the lease destructor are safe from any number of threads.
+ * The instrumentation installed with SetObserver(), SetHeavyHitters() and
+ * SetCapture() is shared by every pooled client. Idle clients pick it up
+ * at once and leased ones when they are released, so requests already in
+ * progress finish with the previous settings (and keep a replaced capture
+ * open until then). A client whose connection failed mid-request (see
+ * MygramClient::IsBroken()) is disconnected when it is released and
+ * reconnected by the next Acquire() that picks it.
+ *
+ * Example:
+ * @code
+ *   ClientPool pool(config, 8);
+ *   auto lease = pool.Acquire();
+ *   if (lease) {
+ *     auto result = (*lease)->Search("articles", "hello", 10);
+ *   }
+ * @endcode
+ */
+class ClientPool {
+ private:
+  struct Slot;
+
+ public:
+  /**
+   * @brief Exclusive use of one pooled client until destroyed or moved from
+   */
+  class Lease {
+   public:
+    Lease() = default;
+    ~Lease() { Release(); }
+
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&& other) noexcept;
+
+    MygramClient* operator->() const;
+    MygramClient& operator*() const;
+
+    /**
+     * @brief Return the client to the pool early
+     */
+    void Release();
+
+   private:
+    friend class ClientPool;
+    Lease(ClientPool* pool, Slot* slot) : pool_(pool), slot_(slot) {}
+
+    ClientPool* pool_ = nullptr;
+    Slot* slot_ = nullptr;
+  };
+
+  /**
+   * @param config Configuration of every pooled client; timeout_ms also
+   *        bounds how long Acquire() waits for a connection to be released
+   * @param max_connections Connections opened at most (0 is taken as 1)
+   */
+  ClientPool(ClientConfig config, size_t max_connections);
+
+  /**
+   * @brief Close every connection; all leases must have been released
+   */
+  ~ClientPool();
+
+  ClientPool(const ClientPool&) = delete;
+  ClientPool& operator=(const ClientPool&) = delete;
+  ClientPool(ClientPool&&) = delete;
+  ClientPool& operator=(ClientPool&&) = delete;
+
+  /**
+   * @brief Borrow a connected client
+   *
+   * Fails with kClientTimeout if every connection stays leased for
+   * timeout_ms, or with the connection error if a new connection (or the
+   * reconnection of a closed one) fails.
+   */
+  mygram::utils::Expected<Lease, mygram::utils::Error> Acquire();
+
+  /**
+   * @brief Close the idle connections; leased ones stay open
+   */
+  void Disconnect();
+
+  /**
+   * @brief Clients created so far, leased or idle
+   */
+  [[nodiscard]] size_t Size() const;
+
+  [[nodiscard]] size_t MaxConnections() const { return max_connections_; }
+
+  /**
+   * @brief Metrics of all pooled clients, merged
+   */
+  [[nodiscard]] ClientMetrics GetMetrics() const;
+
+  void ResetMetrics();
+
+  /**
+   * @brief Install (or with nullptr remove) an observer on every pooled client
+   *
+   * The observer is called from every thread using the pool, so it must be
+   * thread-safe.
+   */
+  void SetObserver(std::shared_ptr<RequestObserver> observer);
+
+  /**
+   * @brief Feed the commands of every pooled client to tracker (nullptr: stop)
+   */
+  void SetHeavyHitters(std::shared_ptr<HeavyHitters> tracker);
+
+  /**
+   * @brief Log the requests of every pooled client to capture (nullptr: stop)
+   *
+   * Each pooled connection gets its own connection id in the capture.
+   */
+  void SetCapture(std::shared_ptr<QueryCapture> capture);
+
+ private:
+  struct Slot {
+    explicit Slot(const ClientConfig& config) : client(config) {}
+
+    MygramClient client;
+    uint64_t settings_version = 0;  // settings_version_ last applied to client
+  };
+
+  void Release(Slot* slot);
+
+  /**
+   * @brief Install the current settings on a client that is not in use (mutex_ held)
+   */
+  void ApplySettings(Slot& slot);
+
+  /**
+   * @brief Start a new settings version and install it on the idle clients (mutex_ held)
+   */
+  void ApplySettingsToIdle();
+
+  const ClientConfig config_;
+  const size_t max_connections_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable released_;
+  std::vector<std::unique_ptr<Slot>> slots_;  // Every client created, leased or not
+  std::vector<Slot*> idle_;                   // Released clients, most recent last
+  uint64_t settings_version_ = 0;
+  std::shared_ptr<RequestObserver> observer_;
+  std::shared_ptr<HeavyHitters> heavy_hitters_;
+  std::shared_ptr<QueryCapture> capture_;
+};
+
+}  // namespace mygramdb::client
@@ -0,0 +1,108 @@
+/**
+ * @file debug_profiler.h
+ * @brief Per-fingerprint aggregation of server DebugInfo from sampled requests
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mygramdb::client {
+
+struct DebugInfo;
+
+/**
+ * @brief Aggregated server DebugInfo of one query fingerprint
+ *
+ * Numeric fields are means over the samples.
+ */
+struct DebugProfile {
+  std::string fingerprint;  // FingerprintCommand() of the sampled commands
+  uint64_t samples = 0;     // Requests aggregated
+  double query_time_ms = 0.0;
+  double index_time_ms = 0.0;
+  double filter_time_ms = 0.0;
+  double terms = 0.0;
+  double ngrams = 0.0;
+  double candidates = 0.0;
+  double after_intersection = 0.0;
+  double after_not = 0.0;
+  double after_filters = 0.0;
+  double final = 0.0;
+  std::vector<std::pair<std::string, uint64_t>> optimizations;  // Strategy and sample count, most frequent first
+};
+
+/**
+ * @brief Running sums of DebugInfo, averaged into a DebugProfile
+ */
+class DebugInfoSums {
+ public:
+  void Add(const DebugInfo& info);
+
+  [[nodiscard]] uint64_t Samples() const { return samples_; }
+
+  /**
+   * @brief Means over the samples added so far (zeros when there are none)
+   */
+  [[nodiscard]] DebugProfile Mean(const std::string& fingerprint) const;
+
+ private:
+  uint64_t samples_ = 0;
+  double query_time_ms_ = 0.0;
+  double index_time_ms_ = 0.0;
+  double filter_time_ms_ = 0.0;
+  double terms_ = 0.0;
+  double ngrams_ = 0.0;
+  double candidates_ = 0.0;
+  double after_intersection_ = 0.0;
+  double after_not_ = 0.0;
+  double after_filters_ = 0.0;
+  double final_ = 0.0;
+  std::vector<std::pair<std::string, uint64_t>> optimizations_;  // Few distinct strategies, so a vector
+};
+
+/**
+ * @brief Thread-safe store of DebugProfiles keyed by fingerprint
+ *
+ * Fed only by debug-sampled requests, so a mutex is cheap enough. The number
+ * of fingerprints is bounded; samples of new fingerprints beyond the bound
+ * are aggregated under kOverflowFingerprint.
+ */
+class DebugProfiler {
+ public:
+  static constexpr size_t kDefaultMaxFingerprints = 1024;
+  static constexpr const char* kOverflowFingerprint = "(other)";
+
+  explicit DebugProfiler(size_t max_fingerprints = kDefaultMaxFingerprints);
+  ~DebugProfiler();
+
+  DebugProfiler(const DebugProfiler&) = delete;
+  DebugProfiler& operator=(const DebugProfiler&) = delete;
+  DebugProfiler(DebugProfiler&&) = delete;
+  DebugProfiler& operator=(DebugProfiler&&) = delete;
+
+  /**
+   * @brief Add the DebugInfo returned for command
+   * @param command SEARCH/COUNT command as sent
+   */
+  void Record(std::string_view command, const DebugInfo& info);
+
+  /**
+   * @brief Current profiles, most sampled first
+   */
+  [[nodiscard]] std::vector<DebugProfile> Snapshot() const;
+
+  void Reset();
+
+ private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+}  // namespace mygramdb::client
@@ -0,0 +1,110 @@
+/**
+ * @file heavy_hitters.h
+ * @brief Streaming detection of the most frequent literal commands
+ *
+ * A count-min sketch estimates how often each command was sent and how much
+ * latency it accounted for, in fixed memory; a bounded candidate table keeps
+ * the text of the commands whose estimate is high enough to be in the top K.
+ * Every thread writes its own sketch without locks or atomic
+ * read-modify-write operations; sketches are merged when candidates compete
+ * for a slot and when a snapshot is taken.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mygramdb::client {
+
+struct HeavyHitterOptions {
+  size_t top_k = 32;    // Commands reported by Snapshot()
+  size_t width = 2048;  // Counters per sketch row (rounded up to a power of two)
+  size_t depth = 4;     // Sketch rows (independent hashes)
+};
+
+/**
+ * @brief One frequent command with its estimates
+ *
+ * Estimates never undercount; they overcount by at most about
+ * e * total / width with probability 1 - e^-depth.
+ */
+struct HeavyHitter {
+  std::string command;         // Command as sent, without the trailing \r\n
+  uint64_t count = 0;          // Estimated requests
+  uint64_t latency_ns = 0;     // Estimated summed latency
+  double latency_share = 0.0;  // latency_ns / total latency of all recorded requests
+};
+
+struct HeavyHittersSnapshot {
+  uint64_t total_requests = 0;    // Requests recorded
+  uint64_t total_latency_ns = 0;  // Their summed latency
+  std::vector<HeavyHitter> top;   // Most frequent first, at most top_k
+};
+
+/**
+ * @brief Count-min sketch plus top-K candidates, shareable between clients
+ *
+ * Record() is safe from any number of threads. It only takes the mutex
+ * when a command's estimate in the calling thread's sketch reaches the
+ * admission threshold (the smallest candidate estimate once the table is
+ * full) and that thread has not yet seen it admitted, so steady-state
+ * recording of hot and cold commands alike is lock-free. A command spread
+ * thinly over many threads is admitted later than one sent from a single
+ * thread, since admission looks at one thread's counts.
+ *
+ * Only the owning thread writes a sketch shard, so Reset() drops the
+ * candidates at once but leaves clearing the shards to their owners (see
+ * thread_shards.h); snapshots ignore shards that have not caught up.
+ */
+class HeavyHitters {
+ public:
+  explicit HeavyHitters(HeavyHitterOptions options = {});
+  ~HeavyHitters();
+
+  HeavyHitters(const HeavyHitters&) = delete;
+  HeavyHitters& operator=(const HeavyHitters&) = delete;
+  HeavyHitters(HeavyHitters&&) = delete;
+  HeavyHitters& operator=(HeavyHitters&&) = delete;
+
+  /**
+   * @brief Count one request
+   * @param command Command as sent (a trailing \r\n is ignored)
+   */
+  void Record(std::string_view command, uint64_t latency_ns);
+
+  [[nodiscard]] HeavyHittersSnapshot Snapshot() const;
+
+  void Reset();
+
+  [[nodiscard]] const HeavyHitterOptions& options() const { return options_; }
+
+ private:
+  struct Shard;
+  struct Candidate;
+
+  Shard& LocalShard();
+  bool Admit(uint64_t hash, std::string_view command);
+
+  /**
+   * @brief Merged estimates of hash over all shards (mutex_ held)
+   */
+  void Estimate(uint64_t hash, uint64_t& count, uint64_t& latency_ns) const;
+
+  const HeavyHitterOptions options_;
+  const uint64_t id_;  // Process-unique; keys the thread-local shard cache
+  std::atomic<uint64_t> reset_epoch_{0};
+  std::atomic<uint64_t> threshold_{0};
+  std::atomic<uint64_t> generation_{0};  // Bumped when candidates are evicted or reset
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::vector<Candidate> candidates_;
+};
+
+}  // namespace mygramdb::client
@@ -0,0 +1,161 @@
+/**
+ * @file mock_server.h
+ * @brief In-process MygramDB protocol stand-in for tests and benchmarks
+ *
+ * MockServer speaks the text protocol the client uses (SEARCH, COUNT, GET,
+ * INFO, CONFIG, SAVE, LOAD, REPLICATION, DEBUG, SYNC) over loopback TCP and
+ * answers from synthetic tables, so the client can be exercised and
+ * benchmarked without a real server. Replies are deterministic for a given
+ * seed; knobs inject latency, split replies into segments, trickle them
+ * out slowly, drop connections and return errors.
+ *
+ * Synthetic data: table documents have primary keys 1..documents. A query
+ * term matches a fixed fraction of them, derived from a hash of the term
+ * (between min_selectivity and max_selectivity); every AND term, NOT term
+ * and filter narrows the match further. Matching keys are spread over the
+ * table in a term-dependent order, so different queries return different
+ * keys. GET returns `fields` synthetic fields for any existing key.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/error.h"
+#include "utils/expected.h"
+
+namespace mygramdb::mock {
+
+/**
+ * @brief One synthetic table
+ */
+struct MockTable {
+  std::string name = "articles";
+  uint64_t documents = 100000;      // Primary keys 1..documents
+  uint32_t fields = 4;              // Fields returned by GET
+  double min_selectivity = 0.0001;  // Smallest fraction of documents a term matches
+  double max_selectivity = 0.05;    // Largest fraction of documents a term matches
+};
+
+/**
+ * @brief Server-side delay added before each reply
+ */
+struct LatencyModel {
+  enum class Distribution : uint8_t {
+    kNone = 0,
+    kFixed,        // Always a_us
+    kUniform,      // Uniform in [a_us, b_us]
+    kExponential,  // Exponential with mean a_us
+    kLogNormal,    // Log-normal with median a_us and shape (sigma) b
+  };
+
+  Distribution distribution = Distribution::kNone;
+  double a_us = 0.0;
+  double b = 0.0;  // b_us for kUniform, sigma for kLogNormal
+};
+
+/**
+ * @brief MockServer configuration
+ */
+struct MockServerOptions {
+  std::string host = "127.0.0.1";
+  uint16_t port = 0;                              // 0: pick a free port (see MockServer::port())
+  std::vector<MockTable> tables = {MockTable{}};  // Served tables
+  uint64_t seed = 1;                              // Seeds synthetic data and injected faults
+  LatencyModel latency;
+
+  // Reply delivery
+  size_t segment_bytes = 0;       // Write replies in chunks of this size (0: whole reply)
+  uint32_t segment_delay_us = 0;  // Pause between chunks (slow trickle)
+
+  // Fault injection
+  uint64_t disconnect_every = 0;  // Close the connection instead of replying to every Nth request (0: never)
+  double disconnect_rate = 0.0;   // Probability of the same per request
+  uint64_t error_every = 0;       // Reply "ERROR Injected failure" to every Nth request (0: never)
+  double error_rate = 0.0;        // Probability of the same per request
+};
+
+/**
+ * @brief Counters of a running MockServer
+ */
+struct MockServerStats {
+  uint64_t connections = 0;      // Connections accepted
+  uint64_t requests = 0;         // Request lines received
+  uint64_t errors_injected = 0;  // Injected ERROR replies
+  uint64_t disconnects = 0;      // Injected disconnects
+  uint64_t bytes_sent = 0;       // Reply bytes written
+};
+
+/**
+ * @brief Loopback MygramDB stand-in serving each connection on its own thread
+ */
+class MockServer {
+ public:
+  /**
+   * @brief Listen and start serving
+   */
+  static mygram::utils::Expected<std::unique_ptr<MockServer>, mygram::utils::Error> Start(MockServerOptions options);
+
+  ~MockServer();
+
+  MockServer(const MockServer&) = delete;
+  MockServer& operator=(const MockServer&) = delete;
+  MockServer(MockServer&&) = delete;
+  MockServer& operator=(MockServer&&) = delete;
+
+  [[nodiscard]] uint16_t port() const { return port_; }
+
+  [[nodiscard]] MockServerStats Stats() const;
+
+  /**
+   * @brief Stop accepting, close every connection and join the threads
+   *
+   * Called by the destructor.
+   */
+  void Stop();
+
+  /**
+   * @brief Reply to one request line (without terminator)
+   *
+   * What a connection would send, minus latency and fault injection; the
+   * reply ends with \r\n. Exposed for tests and for generating fixtures.
+   *
+   * @param debug Whether the connection has DEBUG ON (updated by DEBUG ON/OFF)
+   */
+  [[nodiscard]] std::string Respond(const std::string& line, bool& debug) const;
+
+ private:
+  MockServer(MockServerOptions options, int listen_fd, uint16_t port);
+
+  void AcceptLoop();
+  void Serve(int conn, uint64_t index);
+
+  const MockServerOptions options_;
+  const int listen_fd_;
+  const uint16_t port_;
+  const std::chrono::steady_clock::time_point started_;
+
+  std::atomic<bool> stopping_{false};
+  std::atomic<uint64_t> connections_{0};
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> errors_injected_{0};
+  std::atomic<uint64_t> disconnects_{0};
+  std::atomic<uint64_t> bytes_sent_{0};
+  mutable std::atomic<bool> replication_running_{true};
+
+  std::thread acceptor_;
+  mutable std::mutex mutex_;
+  std::vector<int> connection_fds_;  // Open connections, for Stop() and INFO
+  std::vector<std::thread> workers_;
+  std::vector<std::thread::id> finished_workers_;  // Workers whose connection ended, joined by AcceptLoop()
+};
+
+}  // namespace mygramdb::mock
@@ -9,15 +9,35 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+#include "mygramdb/client_metrics.h"
+#include "mygramdb/debug_profiler.h"
+#include "mygramdb/heavy_hitters.h"
+#include "mygramdb/query_capture.h"
+#include "mygramdb/query_stats.h"
+#include "mygramdb/request_observer.h"
 #include "utils/error.h"
 #include "utils/expected.h"
 
+// Allocator-aware (std::pmr) API variants are available when the standard
+// library ships <memory_resource> (libc++ only does so in recent releases)
+#if defined(__cpp_lib_memory_resource)
+#define MYGRAMCLIENT_HAS_PMR 1
+#endif
+
 namespace mygramdb::client {
 
 /**
@@ -30,12 +50,121 @@ struct SearchResult {
   explicit SearchResult(std::string primary_key_value) : primary_key(std::move(primary_key_value)) {}
 };
 
+/**
+ * @brief Filter fields of a document, backed by the raw GET reply
+ *
+ * The reply buffer is kept as-is and every key/value is a slice of it, so a
+ * document costs one buffer and one offset table regardless of its field
+ * count. Lookups by key go through a sorted index, and the typed accessors
+ * parse the value only when they are called.
+ */
+class DocumentFields {
+ public:
+  using value_type = std::pair<std::string_view, std::string_view>;  // (key, value)
+
+  /**
+   * @brief Forward iterator yielding (key, value) views
+   */
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = DocumentFields::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    const_iterator() = default;
+    const_iterator(const DocumentFields* fields, size_t index) : fields_(fields), index_(index) {}
+
+    value_type operator*() const { return (*fields_)[index_]; }
+    const_iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator prev = *this;
+      ++index_;
+      return prev;
+    }
+    bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+    bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+
+   private:
+    const DocumentFields* fields_ = nullptr;
+    size_t index_ = 0;
+  };
+
+  DocumentFields() = default;
+
+  /**
+   * @brief Parse whitespace-separated key=value tokens
+   *
+   * Tokens without '=' are ignored. Duplicate keys are kept; Find() returns
+   * the first occurrence in reply order.
+   *
+   * @param buffer Raw reply buffer (taken by value and kept)
+   * @param offset Position in buffer where the field list starts
+   */
+  explicit DocumentFields(std::string buffer, size_t offset = 0);
+
+  /**
+   * @brief Replace the contents with a copy of reply, reusing existing capacity
+   * @param reply Raw reply bytes
+   * @param offset Position in reply where the field list starts
+   */
+  void Assign(std::string_view reply, size_t offset = 0);
+
+  [[nodiscard]] size_t size() const { return slices_.size(); }
+  [[nodiscard]] bool empty() const { return slices_.empty(); }
+
+  /**
+   * @brief Field at position (reply order)
+   */
+  value_type operator[](size_t index) const;
+
+  [[nodiscard]] const_iterator begin() const { return {this, 0}; }
+  [[nodiscard]] const_iterator end() const { return {this, slices_.size()}; }
+
+  /**
+   * @brief Look up a field value by key
+   * @return Value view, or nullopt if the key is absent
+   */
+  [[nodiscard]] std::optional<std::string_view> Find(std::string_view key) const;
+
+  /**
+   * @brief Look up a field and parse it as a signed 64-bit integer
+   * @return Parsed value, or nullopt if absent or not an integer
+   */
+  [[nodiscard]] std::optional<int64_t> GetInt64(std::string_view key) const;
+
+  /**
+   * @brief Look up a field and parse it as a double
+   * @return Parsed value, or nullopt if absent or not a number
+   */
+  [[nodiscard]] std::optional<double> GetDouble(std::string_view key) const;
+
+ private:
+  struct Slice {
+    uint32_t key_pos;
+    uint32_t key_len;
+    uint32_t value_pos;
+    uint32_t value_len;
+  };
+
+  void Index(size_t offset);
+  [[nodiscard]] std::string_view KeyAt(size_t index) const;
+
+  std::string buffer_;           // Raw reply (owns all key/value bytes)
+  std::vector<Slice> slices_;    // Fields in reply order
+  std::vector<uint32_t> index_;  // Slice indices sorted by key
+};
+
 /**
  * @brief Document with filter fields
  */
 struct Document {
-  std::string primary_key;                                  // Document primary key
-  std::vector<std::pair<std::string, std::string>> fields;  // Filter fields (key=value)
+  std::string primary_key;  // Document primary key
+  DocumentFields fields;    // Filter fields (key=value)
 
   Document() = default;
   explicit Document(std::string primary_key_value) : primary_key(std::move(primary_key_value)) {}
@@ -58,23 +187,234 @@ struct DebugInfo {
   std::string optimization;         // Optimization strategy used
 };
 
+/**
+ * @brief Client-side phase timing of one request (nanoseconds)
+ *
+ * Collected when ClientConfig::collect_timing is set. The phases are
+ * consecutive, so their sum is the client-observed latency. When the reply
+ * carries DebugInfo, server_ns holds the server's query time, and
+ * NetworkNs() is the part of the wait for the first byte that the server did
+ * not spend executing the query (network plus server queuing).
+ */
+struct ClientTiming {
+  uint64_t build_ns = 0;     // Validation and command serialization
+  uint64_t send_ns = 0;      // send() of the command
+  uint64_t ttfb_ns = 0;      // From send() returning to the first reply byte
+  uint64_t transfer_ns = 0;  // From the first to the last reply byte
+  uint64_t parse_ns = 0;     // Reply parsing into the response
+  uint64_t server_ns = 0;    // DebugInfo::query_time_ms in ns (0 without debug mode)
+
+  [[nodiscard]] uint64_t TotalNs() const { return build_ns + send_ns + ttfb_ns + transfer_ns + parse_ns; }
+
+  [[nodiscard]] uint64_t NetworkNs() const { return ttfb_ns > server_ns ? ttfb_ns - server_ns : 0; }
+};
+
 /**
  * @brief Search query response with results and metadata
  */
 struct SearchResponse {
-  std::vector<SearchResult> results;  // Search results
-  uint64_t total_count = 0;           // Total matching documents (may exceed results.size())
-  std::optional<DebugInfo> debug;     // Debug info (if debug mode enabled)
+  std::vector<SearchResult> results;   // Search results
+  uint64_t total_count = 0;            // Total matching documents (may exceed results.size())
+  std::optional<DebugInfo> debug;      // Debug info (if debug mode enabled)
+  std::optional<ClientTiming> timing;  // Client phase timing (if collect_timing enabled)
+};
+
+/**
+ * @brief Search response whose keys are read in place from the reply
+ *
+ * Filled by the Search overloads that take one. The keys are views into the
+ * client's receive buffer, valid until the next request on the same client,
+ * so nothing is copied per result. Suited to callers that consume the reply
+ * at once, such as language bindings copying each key into their own
+ * strings.
+ */
+struct SearchResponseView {
+  std::vector<std::string_view> primary_keys;  // Result primary keys, in server order
+  uint64_t total_count = 0;                    // Total matching documents (may exceed primary_keys.size())
+  std::optional<DebugInfo> debug;              // Debug info (if debug mode enabled)
+  std::optional<ClientTiming> timing;          // Client phase timing (if collect_timing enabled)
 };
 
 /**
  * @brief Count query response
  */
 struct CountResponse {
-  uint64_t count = 0;              // Total matching documents
-  std::optional<DebugInfo> debug;  // Debug info (if debug mode enabled)
+  uint64_t count = 0;                  // Total matching documents
+  std::optional<DebugInfo> debug;      // Debug info (if debug mode enabled)
+  std::optional<ClientTiming> timing;  // Client phase timing (if collect_timing enabled)
+};
+
+class MygramClient;
+
+/**
+ * @brief Search template with everything but the query pre-serialized
+ *
+ * Created by MygramClient::PrepareSearch(). The table, AND/NOT terms,
+ * filters and sort clause are validated and rendered into protocol text
+ * once; executing the template only escapes the query and appends LIMIT.
+ * A prepared search does not refer to the client that created it and may be
+ * executed on any client (and concurrently on different clients).
+ */
+class PreparedSearch {
+ public:
+  PreparedSearch() = default;
+
+  /**
+   * @brief Table the template searches
+   */
+  [[nodiscard]] const std::string& table() const { return table_; }
+
+ private:
+  friend class MygramClient;
+  friend class Pipeline;
+
+  std::string table_;
+  std::string prefix_;  // "SEARCH <table> "
+  std::string suffix_;  // AND/NOT/FILTER/SORT clauses following the query
+};
+
+/**
+ * @brief SEARCH/COUNT/GET commands sent together and answered in order
+ *
+ * Commands are validated and serialized as they are added.
+ * MygramClient::Execute() writes the commands as fast as the socket accepts
+ * them and reads the replies in order as they arrive, so N commands cost one
+ * round trip instead of N, and a batch of any size cannot stall on full
+ * socket buffers. Every item has its own status: a command rejected by
+ * validation is never sent, and an ERROR reply fails only its own item.
+ * Clear() keeps the command buffer and the per-item responses, so a reused
+ * pipeline stops allocating.
+ *
+ * Pipelined commands are counted in the client metrics but bypass debug
+ * sampling, query stats, heavy hitters, capture and the request observer.
+ */
+class Pipeline {
+ public:
+  /**
+   * @brief One queued command and, after MygramClient::Execute(), its outcome
+   */
+  struct Item {
+    CommandType type = CommandType::kSearch;
+    size_t command_bytes = 0;    // Serialized command size (0: rejected by validation, not sent)
+    mygram::utils::Error error;  // ErrorCode::kSuccess unless the command failed
+    SearchResponse search;       // SEARCH reply
+    CountResponse count;         // COUNT reply
+    Document document;           // GET reply
+
+    [[nodiscard]] bool ok() const { return !error.is_error(); }
+  };
+
+  Pipeline() = default;
+
+  /**
+   * @brief Queue a SEARCH (same arguments as MygramClient::Search)
+   * @return Item index
+   */
+  size_t AddSearch(const std::string& table, const std::string& query,
+                   uint32_t limit = 1000,  // NOLINT(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
+                   uint32_t offset = 0, const std::vector<std::string>& and_terms = {},
+                   const std::vector<std::string>& not_terms = {},
+                   const std::vector<std::pair<std::string, std::string>>& filters = {},
+                   const std::string& sort_column = "", bool sort_desc = true);
+
+  /**
+   * @brief Queue an execution of a prepared search
+   * @return Item index
+   */
+  size_t AddSearch(const PreparedSearch& prepared, const std::string& query,
+                   uint32_t limit = 1000,  // NOLINT(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
+                   uint32_t offset = 0);
+
+  /**
+   * @brief Queue a COUNT (same arguments as MygramClient::Count)
+   * @return Item index
+   */
+  size_t AddCount(const std::string& table, const std::string& query, const std::vector<std::string>& and_terms = {},
+                  const std::vector<std::string>& not_terms = {},
+                  const std::vector<std::pair<std::string, std::string>>& filters = {});
+
+  /**
+   * @brief Queue a GET
+   * @return Item index
+   */
+  size_t AddGet(const std::string& table, const std::string& primary_key);
+
+  [[nodiscard]] size_t size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  [[nodiscard]] Item& operator[](size_t index) { return items_[index]; }
+  [[nodiscard]] const Item& operator[](size_t index) const { return items_[index]; }
+
+  /**
+   * @brief Drop all items, keeping their storage for the next batch
+   */
+  void Clear();
+
+ private:
+  friend class MygramClient;
+
+  Item& NextItem(CommandType type);
+  size_t Queue(Item& item, const mygram::utils::Expected<std::string_view, mygram::utils::Error>& message);
+
+  std::string commands_;     // Serialized commands of the items that passed validation
+  std::string scratch_;      // Command being built
+  std::vector<Item> items_;  // The first size_ are in use; the rest are kept for reuse
+  size_t size_ = 0;
 };
 
+/**
+ * @brief Completed request of the non-blocking interface
+ *
+ * Filled by MygramClient::PollResult(), which swaps the result in: keep
+ * passing the same AsyncResult and its response storage is recycled.
+ */
+struct AsyncResult {
+  uint64_t id = 0;  // Returned by the Submit call
+  CommandType type = CommandType::kSearch;
+  mygram::utils::Error error;  // ErrorCode::kSuccess unless the request failed
+  SearchResponse search;       // SEARCH reply
+  CountResponse count;         // COUNT reply
+  Document document;           // GET reply
+
+  [[nodiscard]] bool ok() const { return !error.is_error(); }
+};
+
+#ifdef MYGRAMCLIENT_HAS_PMR
+namespace pmr {
+
+/**
+ * @brief Search response allocated from a caller-supplied memory resource
+ *
+ * Returned by the MygramClient::Search overload that takes a
+ * std::pmr::memory_resource*. With a per-request arena such as
+ * std::pmr::monotonic_buffer_resource, the response and every temporary of
+ * the call are released together when the arena is.
+ */
+struct SearchResponse {
+  using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+  explicit SearchResponse(allocator_type alloc = {}) : primary_keys(alloc) {}
+
+  std::pmr::vector<std::pmr::string> primary_keys;  // Result primary keys, in server order
+  uint64_t total_count = 0;                         // Total matching documents (may exceed primary_keys.size())
+  std::optional<DebugInfo> debug;                   // Debug info (if debug mode enabled; global heap)
+  std::optional<ClientTiming> timing;               // Client phase timing (if collect_timing enabled)
+};
+
+/**
+ * @brief Document allocated from a caller-supplied memory resource
+ */
+struct Document {
+  using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+  explicit Document(allocator_type alloc = {}) : primary_key(alloc), fields(alloc) {}
+
+  std::pmr::string primary_key;                                           // Document primary key
+  std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>> fields;  // Filter fields (key=value)
+};
+
+}  // namespace pmr
+#endif
+
 /**
  * @brief Server information
  */
@@ -107,6 +447,8 @@ struct ClientConfig {
   uint16_t port = 11016;              // Default port for MygramDB protocol
   uint32_t timeout_ms = 5000;         // Default timeout in milliseconds
   uint32_t recv_buffer_size = 65536;  // Default buffer size (64KB)
+  bool collect_timing = false;        // Attach ClientTiming to Search/Count responses
+  uint32_t debug_sample_rate = 0;     // Debug-sample 1 in N Search/Count requests (0: off)
 };
 // NOLINTEND(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
 
@@ -176,6 +518,15 @@ class MygramClient {
    */
   [[nodiscard]] bool IsConnected() const;
 
+  /**
+   * @brief Check if a send or receive on the connection failed since Connect()
+   *
+   * After a timeout or a short read, a late reply could be taken for the
+   * answer to the next command, so a broken connection should be closed and
+   * reopened rather than reused. Disconnect() and Connect() clear the flag.
+   */
+  [[nodiscard]] bool IsBroken() const;
+
   /**
    * @brief Search for documents
    *
@@ -199,6 +550,33 @@ class MygramClient {
       const std::vector<std::pair<std::string, std::string>>& filters = {}, const std::string& sort_column = "",
       bool sort_desc = true) const;
 
+  /**
+   * @brief Search for documents into a caller-owned response
+   *
+   * Clears and refills out instead of constructing a new response. The
+   * results vector and the strings inside it keep their capacity, so calling
+   * this repeatedly with the same object avoids re-allocating the response.
+   * On error the contents of out are unspecified.
+   *
+   * @param out Response to overwrite
+   * @return Expected<void, Error>
+   */
+  mygram::utils::Expected<void, mygram::utils::Error> Search(
+      const std::string& table, const std::string& query, uint32_t limit, uint32_t offset,
+      const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+      const std::vector<std::pair<std::string, std::string>>& filters, const std::string& sort_column,
+      bool sort_desc, SearchResponse& out) const;
+
+  /**
+   * @brief Search for documents into a caller-owned response (no AND/NOT/FILTER/SORT)
+   *
+   * @param out Response to overwrite
+   * @return Expected<void, Error>
+   */
+  mygram::utils::Expected<void, mygram::utils::Error> Search(const std::string& table, const std::string& query,
+                                                             uint32_t limit, uint32_t offset,
+                                                             SearchResponse& out) const;
+
   /**
    * @brief Count matching documents
    *
@@ -214,6 +592,17 @@ class MygramClient {
       const std::vector<std::string>& not_terms = {},
       const std::vector<std::pair<std::string, std::string>>& filters = {}) const;
 
+  /**
+   * @brief Count matching documents into a caller-owned response
+   *
+   * @param out Response to overwrite
+   * @return Expected<void, Error>
+   */
+  mygram::utils::Expected<void, mygram::utils::Error> Count(
+      const std::string& table, const std::string& query, const std::vector<std::string>& and_terms,
+      const std::vector<std::string>& not_terms, const std::vector<std::pair<std::string, std::string>>& filters,
+      CountResponse& out) const;
+
   /**
    * @brief Get document by primary key
    *
@@ -224,6 +613,233 @@ class MygramClient {
   mygram::utils::Expected<Document, mygram::utils::Error> Get(const std::string& table,
                                                               const std::string& primary_key) const;
 
+  /**
+   * @brief Get document by primary key into a caller-owned document
+   *
+   * The document's reply buffer and field index keep their capacity.
+   *
+   * @param out Document to overwrite
+   * @return Expected<void, Error>
+   */
+  mygram::utils::Expected<void, mygram::utils::Error> Get(const std::string& table, const std::string& primary_key,
+                                                          Document& out) const;
+
+  /**
+   * @brief Validate and pre-serialize a search shape for repeated execution
+   *
+   * Does not talk to the server and needs no client, so a template can be
+   * prepared before any connection exists.
+   *
+   * @param table Table name
+   * @param and_terms Additional required terms
+   * @param not_terms Excluded terms
+   * @param filters Filter conditions (key=value pairs)
+   * @param sort_column Column name for SORT clause (empty for primary key)
+   * @param sort_desc Sort descending (default: true = descending)
+   * @return Expected<PreparedSearch, Error>
+   */
+  [[nodiscard]] static mygram::utils::Expected<PreparedSearch, mygram::utils::Error> PrepareSearch(
+      const std::string& table, const std::vector<std::string>& and_terms = {},
+      const std::vector<std::string>& not_terms = {},
+      const std::vector<std::pair<std::string, std::string>>& filters = {}, const std::string& sort_column = "",
+      bool sort_desc = true);
+
+  /**
+   * @brief Execute a prepared search with the given query
+   *
+   * @param prepared Template from PrepareSearch()
+   * @param query Search query text
+   * @param limit Maximum number of results to return (default: 1000)
+   * @param offset Result offset for pagination (default: 0)
+   * @return Expected<SearchResponse, Error>
+   */
+  mygram::utils::Expected<SearchResponse, mygram::utils::Error> Search(
+      const PreparedSearch& prepared, const std::string& query,
+      uint32_t limit = 1000,  // NOLINT(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
+                              // - Default result limit
+      uint32_t offset = 0) const;
+
+  /**
+   * @brief Execute a prepared search into a caller-owned response
+   *
+   * @param out Response to overwrite
+   * @return Expected<void, Error>
+   */
+  mygram::utils::Expected<void, mygram::utils::Error> Search(const PreparedSearch& prepared, const std::string& query,
+                                                             uint32_t limit, uint32_t offset,
+                                                             SearchResponse& out) const;
+
+  /**
+   * @brief Search for documents, reading the result keys in place
+   *
+   * Same as the SearchResponse& overload, but out.primary_keys point into
+   * this client's receive buffer and are invalidated by its next request.
+   *
+   * @param out Response to overwrite
+   * @return Expected<void, Error>
+   */
+  mygram::utils::Expected<void, mygram::utils::Error> Search(
+      const std::string& table, const std::string& query, uint32_t limit, uint32_t offset,
+      const std::vector<std::string>& and_terms, const std::vector<std::string>& not_terms,
+      const std::vector<std::pair<std::string, std::string>>& filters, const std::string& sort_column,
+      bool sort_desc, SearchResponseView& out) const;
+
+  /**
+   * @brief Search for documents, reading the result keys in place (no AND/NOT/FILTER/SORT)
+   *
+   * @param out Response to overwrite; valid until the next request on this client
+   * @return Expected<void, Error>
+   */
+  mygram::utils::Expected<void, mygram::utils::Error> Search(const std::string& table, const std::string& query,
+                                                             uint32_t limit, uint32_t offset,
+                                                             SearchResponseView& out) const;
+
+  /**
+   * @brief Execute a prepared search, reading the result keys in place
+   *
+   * @param out Response to overwrite; valid until the next request on this client
+   * @return Expected<void, Error>
+   */
+  mygram::utils::Expected<void, mygram::utils::Error> Search(const PreparedSearch& prepared, const std::string& query,
+                                                             uint32_t limit, uint32_t offset,
+                                                             SearchResponseView& out) const;
+
+  /**
+   * @brief Send every queued command of a pipeline and read the replies
+   *
+   * Per-command failures are reported in the items. An error is returned only
+   * when the exchange itself fails (not connected, send or receive error);
+   * the items left unanswered then carry that error as well.
+   *
+   * @param pipeline Commands to run; their items receive the replies
+   * @return Expected<void, Error>
+   */
+  mygram::utils::Expected<void, mygram::utils::Error> Execute(Pipeline& pipeline) const;
+
+  // Non-blocking interface
+  //
+  // For event loops: Submit*() only queues a command, so commands submitted
+  // together leave in one write. ProcessIo() writes what the socket accepts
+  // and parses the replies that arrived, without blocking; call it after
+  // submitting (or once GetFd() is writable while WantsWrite()) and whenever
+  // GetFd() is readable. PollResult() then hands the completed requests out
+  // in submission order. Like pipelined commands, submitted requests are
+  // counted in the metrics but bypass debug sampling, query stats, heavy
+  // hitters, capture and the request observer. Blocking calls fail while
+  // requests are in flight, since their replies would interleave.
+
+  /**
+   * @brief Submit a SEARCH (same arguments as Search)
+   * @return Request id, reported again by PollResult()
+   */
+  mygram::utils::Expected<uint64_t, mygram::utils::Error> SubmitSearch(
+      const std::string& table, const std::string& query,
+      uint32_t limit = 1000,  // NOLINT(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
+      uint32_t offset = 0, const std::vector<std::string>& and_terms = {},
+      const std::vector<std::string>& not_terms = {},
+      const std::vector<std::pair<std::string, std::string>>& filters = {}, const std::string& sort_column = "",
+      bool sort_desc = true) const;
+
+  /**
+   * @brief Submit an execution of a prepared search
+   * @return Request id
+   */
+  mygram::utils::Expected<uint64_t, mygram::utils::Error> SubmitSearch(
+      const PreparedSearch& prepared, const std::string& query,
+      uint32_t limit = 1000,  // NOLINT(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
+      uint32_t offset = 0) const;
+
+  /**
+   * @brief Submit a COUNT (same arguments as Count)
+   * @return Request id
+   */
+  mygram::utils::Expected<uint64_t, mygram::utils::Error> SubmitCount(
+      const std::string& table, const std::string& query, const std::vector<std::string>& and_terms = {},
+      const std::vector<std::string>& not_terms = {},
+      const std::vector<std::pair<std::string, std::string>>& filters = {}) const;
+
+  /**
+   * @brief Submit a GET
+   * @return Request id
+   */
+  mygram::utils::Expected<uint64_t, mygram::utils::Error> SubmitGet(const std::string& table,
+                                                                    const std::string& primary_key) const;
+
+  /**
+   * @brief Socket to watch for readiness (-1 when not connected)
+   */
+  [[nodiscard]] int GetFd() const;
+
+  /**
+   * @brief Whether submitted commands are waiting to be written by ProcessIo()
+   */
+  [[nodiscard]] bool WantsWrite() const;
+
+  /**
+   * @brief Requests submitted and not yet returned by PollResult()
+   */
+  [[nodiscard]] size_t PendingRequests() const;
+
+  /**
+   * @brief Write pending commands and read available replies, without blocking
+   *
+   * An error means the connection failed: every request in flight then
+   * completes with that error.
+   *
+   * @return Number of results ready for PollResult()
+   */
+  mygram::utils::Expected<size_t, mygram::utils::Error> ProcessIo() const;
+
+  /**
+   * @brief Take the oldest completed request
+   *
+   * @param result Receives the result (its previous storage is kept for reuse)
+   * @return false when no request has completed
+   */
+  bool PollResult(AsyncResult& result) const;
+
+#ifdef MYGRAMCLIENT_HAS_PMR
+  /**
+   * @brief Search for documents, allocating from a memory resource
+   *
+   * Same as Search() above, but the command buffer, the receive buffer and
+   * the returned response are all allocated from resource. Nothing is
+   * released individually, which suits per-request monotonic arenas.
+   *
+   * @param resource Memory resource (nullptr selects std::pmr::get_default_resource())
+   * @return Expected<pmr::SearchResponse, Error>
+   */
+  mygram::utils::Expected<pmr::SearchResponse, mygram::utils::Error> Search(
+      std::pmr::memory_resource* resource, const std::string& table, const std::string& query,
+      uint32_t limit = 1000,  // NOLINT(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
+                              // - Default result limit
+      uint32_t offset = 0, const std::vector<std::string>& and_terms = {},
+      const std::vector<std::string>& not_terms = {},
+      const std::vector<std::pair<std::string, std::string>>& filters = {}, const std::string& sort_column = "",
+      bool sort_desc = true) const;
+
+  /**
+   * @brief Count matching documents, allocating temporaries from a memory resource
+   *
+   * @param resource Memory resource (nullptr selects std::pmr::get_default_resource())
+   * @return Expected<CountResponse, Error>
+   */
+  mygram::utils::Expected<CountResponse, mygram::utils::Error> Count(
+      std::pmr::memory_resource* resource, const std::string& table, const std::string& query,
+      const std::vector<std::string>& and_terms = {}, const std::vector<std::string>& not_terms = {},
+      const std::vector<std::pair<std::string, std::string>>& filters = {}) const;
+
+  /**
+   * @brief Get document by primary key, allocating from a memory resource
+   *
+   * @param resource Memory resource (nullptr selects std::pmr::get_default_resource())
+   * @return Expected<pmr::Document, Error>
+   */
+  mygram::utils::Expected<pmr::Document, mygram::utils::Error> Get(std::pmr::memory_resource* resource,
+                                                                   const std::string& table,
+                                                                   const std::string& primary_key) const;
+#endif
+
   /**
    * @brief Get server information
    * @return Expected<ServerInfo, Error>
@@ -291,6 +907,86 @@ class MygramClient {
    */
   mygram::utils::Expected<std::string, mygram::utils::Error> SendCommand(const std::string& command) const;
 
+  /**
+   * @brief Snapshot of this client's per-command metrics
+   *
+   * Every call above except Connect/Disconnect/PrepareSearch is recorded,
+   * including calls that fail before reaching the server. Safe to call from
+   * any thread.
+   */
+  [[nodiscard]] ClientMetrics GetMetrics() const;
+
+  /**
+   * @brief Zero all metrics
+   */
+  void ResetMetrics();
+
+  /**
+   * @brief Install (or with nullptr remove) a request lifecycle observer
+   *
+   * The observer sees the same calls as GetMetrics(). Install it before
+   * issuing requests; it is not synchronized with calls in progress.
+   */
+  void SetObserver(std::shared_ptr<RequestObserver> observer);
+
+  /**
+   * @brief Profile 1 in one_in Search/Count requests with server DebugInfo
+   *
+   * Sampled requests are sent over a second connection that has DEBUG ON,
+   * opened on the first sample, so other requests carry no debug overhead.
+   * Their DebugInfo is aggregated per query fingerprint (see
+   * GetDebugProfiles()) and also returned in the response. 0 turns sampling
+   * off. Overrides ClientConfig::debug_sample_rate.
+   */
+  void SetDebugSampling(uint32_t one_in);
+
+  /**
+   * @brief DebugInfo aggregates of the debug-sampled requests, most sampled first
+   */
+  [[nodiscard]] std::vector<DebugProfile> GetDebugProfiles() const;
+
+  /**
+   * @brief Drop all debug profiles
+   */
+  void ResetDebugProfiles();
+
+  /**
+   * @brief Start collecting per-shape statistics of Search/Count requests
+   *
+   * Requests are grouped by FingerprintCommand(); see QueryShapeStats for
+   * what is kept. Off by default, since every request then pays for a
+   * fingerprint and a mutex. Enabling again starts over.
+   *
+   * @param max_fingerprints Shapes tracked before new ones are pooled
+   */
+  void EnableQueryStats(size_t max_fingerprints = QueryStatsAggregator::kDefaultMaxFingerprints);
+
+  void DisableQueryStats();
+
+  /**
+   * @brief Per-shape statistics, most called first (empty when disabled)
+   */
+  [[nodiscard]] std::vector<QueryShapeStats> GetQueryStats() const;
+
+  void ResetQueryStats();
+
+  /**
+   * @brief Feed every Search/Count command and its latency to tracker
+   *
+   * The tracker may be shared by several clients and threads to find the
+   * hottest literal queries across them. Pass nullptr to stop.
+   */
+  void SetHeavyHitters(std::shared_ptr<HeavyHitters> tracker);
+
+  /**
+   * @brief Log every call's command, timing, reply size and result count to capture
+   *
+   * The client is given its own connection id in the capture, so a replay
+   * can reproduce the concurrency of several clients sharing one capture.
+   * Install it before issuing requests; pass nullptr to stop.
+   */
+  void SetCapture(std::shared_ptr<QueryCapture> capture);
+
  private:
   class Impl;  // Forward declaration for PIMPL
   mutable std::unique_ptr<Impl> impl_;
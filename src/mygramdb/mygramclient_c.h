@@ -6,7 +6,14 @@
  * suitable for use with FFI bindings (node-gyp, ctypes, etc.).
  *
  * All functions return 0 on success, non-zero on error.
- * Use mygramclient_get_last_error() to retrieve error messages.
+ * Use mygramclient_get_last_error() or mygramclient_last_error() to retrieve
+ * error messages.
+ *
+ * A handle from mygramclient_create() owns one connection and must not be
+ * used by two threads at once. A handle from mygramclient_create_pooled()
+ * leases a connection from its pool for each call, so any number of threads
+ * may share it; its errors are reported per thread. Result, document,
+ * pipeline and async result handles always belong to one thread at a time.
  *
  * Note: This is a C API header, so typedef is used instead of using declarations
  * for C compatibility. The modernize-use-using check is disabled for this file.
@@ -28,6 +35,16 @@ extern "C" {
  */
 typedef struct MygramClient_C MygramClient_C;
 
+/**
+ * @brief Opaque prepared search handle
+ */
+typedef struct MygramPreparedSearch_C MygramPreparedSearch_C;
+
+/**
+ * @brief Opaque pipeline of SEARCH/COUNT/GET commands
+ */
+typedef struct MygramPipeline_C MygramPipeline_C;
+
 /**
  * @brief Client configuration
  */
@@ -40,21 +57,33 @@ typedef struct {
 
 /**
  * @brief Search result
+ *
+ * Results returned by mygramclient_search() and friends live in a single
+ * allocation: this struct, the key pointer and length arrays and the key
+ * bytes (each key NUL-terminated) follow each other in one block, released
+ * by one mygramclient_free_search_result() call.
  */
 typedef struct {
   char** primary_keys;   // Array of primary key strings
   size_t count;          // Number of results
   uint64_t total_count;  // Total matching documents (may exceed count)
+  size_t* key_lengths;   // Length of each primary key, so callers need not strlen()
 } MygramSearchResult_C;
 
 /**
  * @brief Document with fields
+ *
+ * Like search results, a document returned by mygramclient_get() is a single
+ * allocation; all strings are NUL-terminated and their lengths are given too.
  */
 typedef struct {
-  char* primary_key;    // Document primary key
-  char** field_keys;    // Array of field keys
-  char** field_values;  // Array of field values
-  size_t field_count;   // Number of fields
+  char* primary_key;            // Document primary key
+  char** field_keys;            // Array of field keys
+  char** field_values;          // Array of field values
+  size_t field_count;           // Number of fields
+  size_t primary_key_length;    // Length of primary_key
+  size_t* field_key_lengths;    // Length of each field key
+  size_t* field_value_lengths;  // Length of each field value
 } MygramDocument_C;
 
 /**
@@ -71,6 +100,124 @@ typedef struct {
   size_t table_count;  // Number of tables
 } MygramServerInfo_C;
 
+/**
+ * @brief Non-empty latency histogram bucket
+ */
+typedef struct {
+  uint64_t upper_ns;  // Largest latency counted in this bucket
+  uint64_t count;     // Requests in this bucket
+} MygramLatencyBucket_C;
+
+/**
+ * @brief Metrics of one command type
+ */
+typedef struct {
+  const char* command;  // "SEARCH", "COUNT", ... (static, do not free)
+  uint64_t requests;
+  uint64_t errors;
+  uint64_t bytes_sent;
+  uint64_t bytes_received;
+  uint64_t recv_calls;
+  uint64_t latency_count;
+  uint64_t latency_sum_ns;
+  uint64_t latency_min_ns;
+  uint64_t latency_max_ns;
+  uint64_t latency_p50_ns;
+  uint64_t latency_p90_ns;
+  uint64_t latency_p99_ns;
+  uint64_t latency_p999_ns;
+  MygramLatencyBucket_C* buckets;  // Non-empty buckets in ascending order
+  size_t bucket_count;             // Number of buckets
+} MygramCommandMetrics_C;
+
+/**
+ * @brief Error count for one error code
+ */
+typedef struct {
+  int code;          // mygram::utils::ErrorCode value
+  const char* name;  // Error code name (static, do not free)
+  uint64_t count;
+} MygramErrorCount_C;
+
+/**
+ * @brief Client metrics snapshot
+ */
+typedef struct {
+  MygramCommandMetrics_C* commands;  // One entry per command type
+  size_t command_count;              // Number of command types
+  MygramErrorCount_C* errors;        // Non-zero error counts
+  size_t error_count;                // Number of error entries
+} MygramClientMetrics_C;
+
+/**
+ * @brief Optimization strategy chosen by the server and how often
+ */
+typedef struct {
+  char* name;
+  uint64_t count;
+} MygramOptimizationCount_C;
+
+/**
+ * @brief Aggregated DebugInfo of one query fingerprint (means over samples)
+ */
+typedef struct {
+  char* fingerprint;  // Query shape, e.g. "SEARCH articles ? LIMIT ?"
+  uint64_t samples;
+  double query_time_ms;
+  double index_time_ms;
+  double filter_time_ms;
+  double terms;
+  double ngrams;
+  double candidates;
+  double after_intersection;
+  double after_not;
+  double after_filters;
+  double final;
+  MygramOptimizationCount_C* optimizations;  // Most frequent first
+  size_t optimization_count;                 // Number of optimizations
+} MygramDebugProfile_C;
+
+/**
+ * @brief Statistics of one query shape
+ */
+typedef struct {
+  char* fingerprint;  // Query shape, e.g. "SEARCH articles ? LIMIT ?"
+  uint64_t calls;     // Completed requests
+  uint64_t errors;    // Requests that returned an error
+  uint64_t latency_sum_ns;
+  uint64_t latency_min_ns;
+  uint64_t latency_max_ns;
+  uint64_t latency_p50_ns;
+  uint64_t latency_p90_ns;
+  uint64_t latency_p99_ns;
+  uint64_t matched_sum;  // Total matches (SEARCH) or count (COUNT) of successful requests
+  uint64_t matched_max;
+  uint64_t matched_p50;
+  uint64_t matched_p90;
+  uint64_t matched_p99;
+  MygramDebugProfile_C debug;  // Server DebugInfo means (fingerprint NULL; samples 0 without DEBUG output)
+} MygramQueryStats_C;
+
+/**
+ * @brief One frequent command with its estimated frequency and latency
+ */
+typedef struct {
+  char* command;         // Command as sent, without \r\n
+  uint64_t count;        // Estimated requests (never undercounted)
+  uint64_t latency_ns;   // Estimated summed latency
+  double latency_share;  // latency_ns / total_latency_ns
+} MygramHeavyHitter_C;
+
+/**
+ * @brief Heavy hitters snapshot
+ */
+typedef struct {
+  uint64_t total_requests;    // Requests recorded
+  uint64_t total_latency_ns;  // Their summed latency
+  MygramHeavyHitter_C* top;   // Most frequent first
+  size_t count;               // Number of entries in top
+} MygramHeavyHitters_C;
+
 /**
  * @brief Create a new MygramDB client
  *
@@ -79,6 +226,30 @@ typedef struct {
  */
 MygramClient_C* mygramclient_create(const MygramClientConfig_C* config);
 
+/**
+ * @brief Create a client handle that several threads may share
+ *
+ * Each call on the handle borrows a connection from a pool of at most
+ * max_connections, opened on demand and kept open between calls; when all
+ * are in use, a call waits up to timeout_ms for one and then fails. A
+ * connection whose request failed midway is reopened rather than reused.
+ *
+ * Errors are kept per thread: mygramclient_get_last_error() on a pooled
+ * handle returns the same message as mygramclient_last_error().
+ * mygramclient_connect() opens the first connection (to check that the
+ * server can be reached) and mygramclient_disconnect() closes the idle
+ * ones. Metrics, span rings, heavy hitters and captures cover every pooled
+ * connection. Calls tied to one connection fail with "Not supported on
+ * pooled handles": the non-blocking interface (mygramclient_get_fd(),
+ * mygramclient_submit_*() and the calls polling them), DEBUG ON/OFF, debug
+ * sampling and per-shape query statistics.
+ *
+ * @param config Client configuration
+ * @param max_connections Connections opened at most (0 is taken as 1)
+ * @return Client handle, or NULL on error
+ */
+MygramClient_C* mygramclient_create_pooled(const MygramClientConfig_C* config, size_t max_connections);
+
 /**
  * @brief Destroy a MygramDB client and free resources
  *
@@ -149,6 +320,112 @@ int mygramclient_search_advanced(MygramClient_C* client, const char* table, cons
                                  size_t filter_count, const char* sort_column, int sort_desc,
                                  MygramSearchResult_C** result);
 
+/**
+ * @brief Create a reusable search result handle
+ *
+ * The handle is filled by mygramclient_search_into() and
+ * mygramclient_search_advanced_into(). Every call clears and refills it while
+ * keeping the capacity it has already grown to, so a loop that searches
+ * through the same handle stops allocating once it reaches its working-set
+ * size. primary_keys point into storage owned by the handle and remain valid
+ * until the handle is filled again or destroyed.
+ *
+ * @return Handle, or NULL on allocation failure (release with mygramclient_search_result_destroy,
+ *         not mygramclient_free_search_result)
+ */
+MygramSearchResult_C* mygramclient_search_result_create(void);
+
+/**
+ * @brief Destroy a reusable search result handle
+ *
+ * @param result Handle created by mygramclient_search_result_create (NULL is ignored)
+ */
+void mygramclient_search_result_destroy(MygramSearchResult_C* result);
+
+/**
+ * @brief Search for documents into a reusable result handle
+ *
+ * Same as mygramclient_search(), but fills a handle created by
+ * mygramclient_search_result_create() instead of allocating a new result.
+ *
+ * @param client Client handle
+ * @param table Table name
+ * @param query Search query text
+ * @param limit Maximum number of results (0 for default)
+ * @param offset Result offset for pagination
+ * @param result Reusable result handle (contents are replaced; unspecified on error)
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_search_into(MygramClient_C* client, const char* table, const char* query, uint32_t limit,
+                             uint32_t offset, MygramSearchResult_C* result);
+
+/**
+ * @brief Search with AND/NOT/FILTER clauses into a reusable result handle
+ *
+ * Same parameters as mygramclient_search_advanced(), except that result is a
+ * handle created by mygramclient_search_result_create().
+ *
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_search_advanced_into(MygramClient_C* client, const char* table, const char* query, uint32_t limit,
+                                      uint32_t offset, const char** and_terms, size_t and_count,
+                                      const char** not_terms, size_t not_count, const char** filter_keys,
+                                      const char** filter_values, size_t filter_count, const char* sort_column,
+                                      int sort_desc, MygramSearchResult_C* result);
+
+/**
+ * @brief Prepare a search shape for repeated execution
+ *
+ * Validates the table, AND/NOT terms, filters and sort clause and renders
+ * them into protocol text once. Executing the prepared search only escapes
+ * the query and appends LIMIT. Does not contact the server; the prepared
+ * search may be executed on any client.
+ *
+ * @param client Client handle (receives the error message on failure)
+ * @param table Table name
+ * @param and_terms Array of AND terms (can be NULL)
+ * @param and_count Number of AND terms
+ * @param not_terms Array of NOT terms (can be NULL)
+ * @param not_count Number of NOT terms
+ * @param filter_keys Array of filter keys (can be NULL)
+ * @param filter_values Array of filter values (can be NULL)
+ * @param filter_count Number of filters
+ * @param sort_column Column name for SORT clause (NULL or empty for primary key)
+ * @param sort_desc Sort descending (1) or ascending (0)
+ * @param prepared Output handle (caller must free with mygramclient_free_prepared_search)
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_prepare_search(MygramClient_C* client, const char* table, const char** and_terms, size_t and_count,
+                                const char** not_terms, size_t not_count, const char** filter_keys,
+                                const char** filter_values, size_t filter_count, const char* sort_column,
+                                int sort_desc, MygramPreparedSearch_C** prepared);
+
+/**
+ * @brief Execute a prepared search
+ *
+ * A prepared search handle is not modified by its use, so several threads
+ * may execute it at once.
+ *
+ * @param client Client handle
+ * @param prepared Prepared search handle
+ * @param query Search query text
+ * @param limit Maximum number of results (0 for default)
+ * @param offset Result offset for pagination
+ * @param result Output search results (caller must free with mygramclient_free_search_result)
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_search_prepared(MygramClient_C* client, MygramPreparedSearch_C* prepared, const char* query,
+                                 uint32_t limit, uint32_t offset, MygramSearchResult_C** result);
+
+/**
+ * @brief Execute a prepared search into a reusable result handle
+ *
+ * @param result Handle created by mygramclient_search_result_create (contents are replaced)
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_search_prepared_into(MygramClient_C* client, MygramPreparedSearch_C* prepared, const char* query,
+                                      uint32_t limit, uint32_t offset, MygramSearchResult_C* result);
+
 /**
  * @brief Count matching documents
  *
@@ -191,6 +468,339 @@ int mygramclient_count_advanced(MygramClient_C* client, const char* table, const
  */
 int mygramclient_get(MygramClient_C* client, const char* table, const char* primary_key, MygramDocument_C** doc);
 
+/**
+ * @brief Create a reusable document handle
+ *
+ * The handle is filled by mygramclient_get_into(). As with search result
+ * handles, every call refills it in place and keeps the capacity it has
+ * grown to, so repeated lookups stop allocating. The strings belong to the
+ * handle and remain valid until it is filled again or destroyed.
+ *
+ * @return Handle, or NULL on allocation failure (release with mygramclient_document_destroy,
+ *         not mygramclient_free_document)
+ */
+MygramDocument_C* mygramclient_document_create(void);
+
+/**
+ * @brief Destroy a reusable document handle
+ *
+ * @param doc Handle created by mygramclient_document_create (NULL is ignored)
+ */
+void mygramclient_document_destroy(MygramDocument_C* doc);
+
+/**
+ * @brief Get document by primary key into a reusable document handle
+ *
+ * @param client Client handle
+ * @param table Table name
+ * @param primary_key Primary key value
+ * @param doc Handle created by mygramclient_document_create() (contents are replaced; empty on error)
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_get_into(MygramClient_C* client, const char* table, const char* primary_key, MygramDocument_C* doc);
+
+/**
+ * @brief One request of mygramclient_search_batch()
+ */
+typedef struct {
+  const char* table;
+  const char* query;
+  uint32_t limit;  // Maximum number of results (0 for default)
+  uint32_t offset;
+} MygramSearchRequest_C;
+
+/**
+ * @brief One request of mygramclient_count_batch()
+ */
+typedef struct {
+  const char* table;
+  const char* query;
+} MygramCountRequest_C;
+
+/**
+ * @brief Run several searches in one round trip
+ *
+ * Commands are written while replies are read in order (see
+ * mygramclient_pipeline_create() for the general form). Every request gets
+ * its own status: 0 on success, otherwise the nonzero error code of the
+ * validation or server error. results[i] is a newly allocated result for each
+ * successful request (free with mygramclient_free_search_result) and NULL
+ * otherwise, also when -1 is returned.
+ *
+ * @param client Client handle
+ * @param requests Requests (table and query must not be NULL)
+ * @param count Number of requests
+ * @param results Output array of count results
+ * @param statuses Output array of count statuses
+ * @return 0 when every reply was read (individual requests may still have failed), -1 on error
+ */
+int mygramclient_search_batch(MygramClient_C* client, const MygramSearchRequest_C* requests, size_t count,
+                              MygramSearchResult_C** results, int* statuses);
+
+/**
+ * @brief Run several counts in one round trip
+ *
+ * Same conventions as mygramclient_search_batch(); counts[i] is 0 for failed
+ * requests.
+ *
+ * @param client Client handle
+ * @param requests Requests (table and query must not be NULL)
+ * @param count Number of requests
+ * @param counts Output array of count counts
+ * @param statuses Output array of count statuses
+ * @return 0 when every reply was read (individual requests may still have failed), -1 on error
+ */
+int mygramclient_count_batch(MygramClient_C* client, const MygramCountRequest_C* requests, size_t count,
+                             uint64_t* counts, int* statuses);
+
+/**
+ * @brief Create an empty pipeline
+ *
+ * A pipeline queues SEARCH/COUNT/GET commands (validated and serialized as
+ * they are added; items are numbered from 0 in that order) and
+ * mygramclient_pipeline_execute() writes them as fast as the socket accepts
+ * them while reading the replies in order as they arrive, so batches of any
+ * size go through in one round trip. mygramclient_pipeline_clear() empties
+ * it for the next batch while keeping its buffers, so a reused pipeline stops
+ * allocating.
+ *
+ * @return Pipeline, or NULL on allocation failure (release with mygramclient_pipeline_destroy)
+ */
+MygramPipeline_C* mygramclient_pipeline_create(void);
+
+/**
+ * @brief Destroy a pipeline
+ *
+ * @param pipeline Pipeline (NULL is ignored)
+ */
+void mygramclient_pipeline_destroy(MygramPipeline_C* pipeline);
+
+/**
+ * @brief Remove every item from a pipeline
+ */
+void mygramclient_pipeline_clear(MygramPipeline_C* pipeline);
+
+/**
+ * @brief Number of items in a pipeline
+ */
+size_t mygramclient_pipeline_size(const MygramPipeline_C* pipeline);
+
+/**
+ * @brief Queue a SEARCH (arguments as for mygramclient_search)
+ *
+ * @return 0 when queued, -1 when rejected (the item is still added, with the
+ *         error as its status)
+ */
+int mygramclient_pipeline_add_search(MygramPipeline_C* pipeline, const char* table, const char* query, uint32_t limit,
+                                     uint32_t offset);
+
+/**
+ * @brief Queue a SEARCH with AND/NOT/FILTER clauses (arguments as for mygramclient_search_advanced)
+ *
+ * @return 0 when queued, -1 when rejected
+ */
+int mygramclient_pipeline_add_search_advanced(MygramPipeline_C* pipeline, const char* table, const char* query,
+                                              uint32_t limit, uint32_t offset, const char** and_terms,
+                                              size_t and_count, const char** not_terms, size_t not_count,
+                                              const char** filter_keys, const char** filter_values,
+                                              size_t filter_count, const char* sort_column, int sort_desc);
+
+/**
+ * @brief Queue an execution of a prepared search
+ *
+ * @return 0 when queued, -1 when rejected
+ */
+int mygramclient_pipeline_add_search_prepared(MygramPipeline_C* pipeline, const MygramPreparedSearch_C* prepared,
+                                              const char* query, uint32_t limit, uint32_t offset);
+
+/**
+ * @brief Queue a COUNT
+ *
+ * @return 0 when queued, -1 when rejected
+ */
+int mygramclient_pipeline_add_count(MygramPipeline_C* pipeline, const char* table, const char* query);
+
+/**
+ * @brief Queue a GET
+ *
+ * @return 0 when queued, -1 when rejected
+ */
+int mygramclient_pipeline_add_get(MygramPipeline_C* pipeline, const char* table, const char* primary_key);
+
+/**
+ * @brief Send every queued command and read the replies
+ *
+ * @param client Client handle
+ * @param pipeline Pipeline whose items receive the replies
+ * @return 0 when every reply was read (check each item's status), -1 on error
+ *         (items left unanswered carry the error)
+ */
+int mygramclient_pipeline_execute(MygramClient_C* client, MygramPipeline_C* pipeline);
+
+/**
+ * @brief Status of a pipeline item
+ *
+ * @return 0 on success, the nonzero error code of a failed item, or -1 for an index out of range
+ */
+int mygramclient_pipeline_status(const MygramPipeline_C* pipeline, size_t index);
+
+/**
+ * @brief Error message of a failed pipeline item
+ *
+ * @return Message (owned by the pipeline), or NULL when the item succeeded or the index is out of range
+ */
+const char* mygramclient_pipeline_error(const MygramPipeline_C* pipeline, size_t index);
+
+/**
+ * @brief Result of a successful SEARCH item
+ *
+ * The result is a view owned by the pipeline, valid until the pipeline is
+ * cleared, executed again or destroyed. Do not free it.
+ *
+ * @return Result, or NULL when the item is not a successful SEARCH
+ */
+const MygramSearchResult_C* mygramclient_pipeline_search_result(MygramPipeline_C* pipeline, size_t index);
+
+/**
+ * @brief Count of a successful COUNT item
+ *
+ * @return 0 on success, -1 when the item is not a successful COUNT
+ */
+int mygramclient_pipeline_count_result(const MygramPipeline_C* pipeline, size_t index, uint64_t* count);
+
+/**
+ * @brief Document of a successful GET item
+ *
+ * A view owned by the pipeline, with the same lifetime as
+ * mygramclient_pipeline_search_result() results. Do not free it.
+ *
+ * @return Document, or NULL when the item is not a successful GET
+ */
+const MygramDocument_C* mygramclient_pipeline_document(MygramPipeline_C* pipeline, size_t index);
+
+/*
+ * Non-blocking interface
+ *
+ * For event loops: mygramclient_submit_*() only queue a command, so commands
+ * submitted together leave in one write. mygramclient_process_io() writes
+ * what the socket accepts and reads the replies that arrived, without
+ * blocking: call it after submitting (or when mygramclient_get_fd() becomes
+ * writable while mygramclient_wants_write() is set) and whenever the socket
+ * is readable. mygramclient_poll_result() then returns the completed
+ * requests in submission order. Blocking calls on the same client fail
+ * while requests are in flight.
+ */
+
+/**
+ * @brief Completed request of the non-blocking interface
+ *
+ * Create with mygramclient_async_result_create() and fill with
+ * mygramclient_poll_result(). The pointers are owned by the handle and valid
+ * until it is filled again or destroyed; the handle keeps its storage, so
+ * polling into the same handle stops allocating.
+ */
+typedef struct {
+  uint64_t id;                         // Id returned by the submit call
+  int status;                          // 0 on success, otherwise the error code
+  const char* error;                   // Error message (NULL on success)
+  const MygramSearchResult_C* search;  // SEARCH result (NULL for other commands and on error)
+  uint64_t count;                      // COUNT result
+  const MygramDocument_C* document;    // GET result (NULL for other commands and on error)
+} MygramAsyncResult_C;
+
+/**
+ * @brief Socket of a connected client, for registration with an event loop
+ *
+ * @return File descriptor, or -1 when not connected
+ */
+int mygramclient_get_fd(const MygramClient_C* client);
+
+/**
+ * @brief Submit a SEARCH without waiting for the reply (arguments as for mygramclient_search)
+ *
+ * @param id Output request id, reported again by mygramclient_poll_result()
+ * @return 0 when submitted, -1 on error (not connected, invalid arguments)
+ */
+int mygramclient_submit_search(MygramClient_C* client, const char* table, const char* query, uint32_t limit,
+                               uint32_t offset, uint64_t* id);
+
+/**
+ * @brief Submit a SEARCH with AND/NOT/FILTER clauses (arguments as for mygramclient_search_advanced)
+ *
+ * @return 0 when submitted, -1 on error
+ */
+int mygramclient_submit_search_advanced(MygramClient_C* client, const char* table, const char* query, uint32_t limit,
+                                        uint32_t offset, const char** and_terms, size_t and_count,
+                                        const char** not_terms, size_t not_count, const char** filter_keys,
+                                        const char** filter_values, size_t filter_count, const char* sort_column,
+                                        int sort_desc, uint64_t* id);
+
+/**
+ * @brief Submit an execution of a prepared search
+ *
+ * @return 0 when submitted, -1 on error
+ */
+int mygramclient_submit_search_prepared(MygramClient_C* client, MygramPreparedSearch_C* prepared, const char* query,
+                                        uint32_t limit, uint32_t offset, uint64_t* id);
+
+/**
+ * @brief Submit a COUNT
+ *
+ * @return 0 when submitted, -1 on error
+ */
+int mygramclient_submit_count(MygramClient_C* client, const char* table, const char* query, uint64_t* id);
+
+/**
+ * @brief Submit a GET
+ *
+ * @return 0 when submitted, -1 on error
+ */
+int mygramclient_submit_get(MygramClient_C* client, const char* table, const char* primary_key, uint64_t* id);
+
+/**
+ * @brief Whether submitted commands wait to be written by mygramclient_process_io()
+ *
+ * @return 1 if so, 0 otherwise
+ */
+int mygramclient_wants_write(const MygramClient_C* client);
+
+/**
+ * @brief Number of requests submitted and not yet polled
+ */
+size_t mygramclient_pending(const MygramClient_C* client);
+
+/**
+ * @brief Write pending commands and read available replies without blocking
+ *
+ * @param client Client handle
+ * @return Number of results ready to poll, or -1 on error (the connection
+ *         failed and every request in flight completed with the error)
+ */
+int mygramclient_process_io(MygramClient_C* client);
+
+/**
+ * @brief Create a reusable result handle for mygramclient_poll_result()
+ *
+ * @return Handle, or NULL on allocation failure (release with mygramclient_async_result_destroy)
+ */
+MygramAsyncResult_C* mygramclient_async_result_create(void);
+
+/**
+ * @brief Destroy a result handle
+ *
+ * @param result Handle (NULL is ignored)
+ */
+void mygramclient_async_result_destroy(MygramAsyncResult_C* result);
+
+/**
+ * @brief Take the oldest completed request
+ *
+ * @param client Client handle
+ * @param result Handle created by mygramclient_async_result_create() (contents are replaced)
+ * @return 1 when a result was stored, 0 when no request has completed, -1 on invalid arguments
+ */
+int mygramclient_poll_result(MygramClient_C* client, MygramAsyncResult_C* result);
+
 /**
  * @brief Get server information
  *
@@ -261,24 +871,171 @@ int mygramclient_debug_on(MygramClient_C* client);
  */
 int mygramclient_debug_off(MygramClient_C* client);
 
+/**
+ * @brief Snapshot the client's per-command metrics
+ *
+ * @param client Client handle
+ * @param metrics Output metrics (must be freed with mygramclient_free_metrics)
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_get_metrics(MygramClient_C* client, MygramClientMetrics_C** metrics);
+
+/**
+ * @brief Zero the client's metrics
+ *
+ * @param client Client handle
+ */
+void mygramclient_reset_metrics(MygramClient_C* client);
+
+/**
+ * @brief Record a span per request into a memory-mapped ring file
+ *
+ * Installs a RingFileObserver (see request_observer.h for the file format)
+ * on the client, replacing any previous one. The file is created or
+ * reinitialized unless it already holds a ring of the same capacity.
+ *
+ * @param client Client handle
+ * @param path Ring file path, or NULL to stop recording
+ * @param capacity Number of record slots (ignored when path is NULL)
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_set_span_ring(MygramClient_C* client, const char* path, size_t capacity);
+
+/**
+ * @brief Debug-sample 1 in one_in SEARCH/COUNT requests (0: off)
+ *
+ * Sampled requests go over a second, DEBUG ON connection and their
+ * DebugInfo is aggregated per query fingerprint.
+ *
+ * @param client Client handle
+ * @param one_in Sampling interval
+ */
+void mygramclient_set_debug_sampling(MygramClient_C* client, uint32_t one_in);
+
+/**
+ * @brief Snapshot the debug profiles, most sampled first
+ *
+ * @param client Client handle
+ * @param profiles Output array (must be freed with mygramclient_free_debug_profiles)
+ * @param count Output number of profiles
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_get_debug_profiles(MygramClient_C* client, MygramDebugProfile_C** profiles, size_t* count);
+
+/**
+ * @brief Drop the client's debug profiles
+ *
+ * @param client Client handle
+ */
+void mygramclient_reset_debug_profiles(MygramClient_C* client);
+
+/**
+ * @brief Collect per-shape statistics of SEARCH/COUNT requests
+ *
+ * @param client Client handle
+ * @param max_fingerprints Shapes tracked before new ones are pooled, or 0 to disable
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_enable_query_stats(MygramClient_C* client, size_t max_fingerprints);
+
+/**
+ * @brief Snapshot the per-shape statistics, most called first
+ *
+ * @param client Client handle
+ * @param stats Output array (must be freed with mygramclient_free_query_stats)
+ * @param count Output number of shapes
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_get_query_stats(MygramClient_C* client, MygramQueryStats_C** stats, size_t* count);
+
+/**
+ * @brief Drop the client's per-shape statistics
+ *
+ * @param client Client handle
+ */
+void mygramclient_reset_query_stats(MygramClient_C* client);
+
+/**
+ * @brief Track the most frequent SEARCH/COUNT commands in fixed memory
+ *
+ * Replaces any previous tracker of this client, starting over.
+ *
+ * @param client Client handle
+ * @param top_k Commands to report, or 0 to stop tracking
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_enable_heavy_hitters(MygramClient_C* client, size_t top_k);
+
+/**
+ * @brief Snapshot the most frequent commands
+ *
+ * @param client Client handle
+ * @param hitters Output snapshot (must be freed with mygramclient_free_heavy_hitters)
+ * @return 0 on success, -1 on error (including when tracking is off)
+ */
+int mygramclient_get_heavy_hitters(MygramClient_C* client, MygramHeavyHitters_C** hitters);
+
+/**
+ * @brief Zero the heavy hitters tracker
+ *
+ * @param client Client handle
+ */
+void mygramclient_reset_heavy_hitters(MygramClient_C* client);
+
+/**
+ * @brief Log every request of the client to a binary capture file
+ *
+ * See query_capture.h for the format; tools/mygram_replay re-issues a
+ * capture. Records are written by a background thread and the file is
+ * complete once capture is stopped (path NULL) or the client destroyed.
+ * Replaces (and completes) any previous capture.
+ *
+ * @param client Client handle
+ * @param path Capture file path (truncated), or NULL to stop capturing
+ * @return 0 on success, -1 on error
+ */
+int mygramclient_set_capture(MygramClient_C* client, const char* path);
+
 /**
  * @brief Get last error message
  *
+ * For a pooled handle, this is the last error of the calling thread.
+ *
  * @param client Client handle
  * @return Error message string (do not free)
  */
 const char* mygramclient_get_last_error(const MygramClient_C* client);
 
+/**
+ * @brief Get the message of the last error on the calling thread, whatever the handle
+ *
+ * @return Error message string, valid until the thread's next failing call (do not free)
+ */
+const char* mygramclient_last_error(void);
+
 /**
  * @brief Free search result
  *
+ * Releases the whole result (struct, key arrays and key bytes) with a single
+ * free(). Not for handles from mygramclient_search_result_create().
+ *
  * @param result Search result to free
  */
 void mygramclient_free_search_result(MygramSearchResult_C* result);
 
+/**
+ * @brief Free prepared search handle
+ *
+ * @param prepared Prepared search to free (NULL is ignored)
+ */
+void mygramclient_free_prepared_search(MygramPreparedSearch_C* prepared);
+
 /**
  * @brief Free document
  *
+ * Releases the whole document with a single free(). Not for handles from
+ * mygramclient_document_create().
+ *
  * @param doc Document to free
  */
 void mygramclient_free_document(MygramDocument_C* doc);
@@ -290,6 +1047,36 @@ void mygramclient_free_document(MygramDocument_C* doc);
  */
 void mygramclient_free_server_info(MygramServerInfo_C* info);
 
+/**
+ * @brief Free metrics snapshot
+ *
+ * @param metrics Metrics to free (NULL is ignored)
+ */
+void mygramclient_free_metrics(MygramClientMetrics_C* metrics);
+
+/**
+ * @brief Free debug profiles
+ *
+ * @param profiles Profiles to free (NULL is ignored)
+ * @param count Number of profiles
+ */
+void mygramclient_free_debug_profiles(MygramDebugProfile_C* profiles, size_t count);
+
+/**
+ * @brief Free query statistics
+ *
+ * @param stats Statistics to free (NULL is ignored)
+ * @param count Number of entries
+ */
+void mygramclient_free_query_stats(MygramQueryStats_C* stats, size_t count);
+
+/**
+ * @brief Free heavy hitters snapshot
+ *
+ * @param hitters Snapshot to free (NULL is ignored)
+ */
+void mygramclient_free_heavy_hitters(MygramHeavyHitters_C* hitters);
+
 /**
  * @brief Free string
  *
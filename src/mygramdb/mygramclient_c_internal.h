@@ -0,0 +1,57 @@
+/**
+ * @file mygramclient_c_internal.h
+ * @brief C++ access to the client behind a C API handle
+ *
+ * For bindings compiled together with the library, such as the Perl XS
+ * module in embedded-source builds. The C API copies every reply into its
+ * result handles, because they must outlive the call. A binding that turns
+ * the reply into its own values at once can instead call MygramClient on
+ * the handle's client and read the reply in place (SearchResponseView,
+ * Document fields) while it holds the client.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mygramdb/client_pool.h"
+#include "mygramdb/mygramclient.h"
+#include "mygramdb/mygramclient_c.h"
+#include "utils/error.h"
+
+struct MygramPreparedSearch_C {
+  mygramdb::client::PreparedSearch prepared;  // Only read, so one prepared search may be used from several threads
+};
+
+namespace mygramdb::client {
+
+/**
+ * @brief The client one call runs on: the handle's own, or one leased from its pool
+ *
+ * A pooled handle's client is returned to the pool when the lease is
+ * destroyed, so replies read in place must be consumed before that. Check
+ * the lease before use; on failure error() has already been recorded on the
+ * handle.
+ */
+class ClientLease {
+ public:
+  explicit ClientLease(MygramClient_C* handle);
+
+  explicit operator bool() const { return client_ != nullptr; }
+  MygramClient* operator->() const { return client_; }
+  [[nodiscard]] const mygram::utils::Error& error() const { return error_; }
+
+ private:
+  ClientPool::Lease lease_;
+  MygramClient* client_ = nullptr;
+  mygram::utils::Error error_;
+};
+
+/**
+ * @brief Record the error of a failed call on handle, as the C API functions do
+ *
+ * mygramclient_get_last_error() and mygramclient_last_error() then report it.
+ */
+void SetHandleError(MygramClient_C* handle, std::string message);
+
+}  // namespace mygramdb::client
@@ -0,0 +1,51 @@
+/**
+ * @file mygramclient_internal.h
+ * @brief Reply parsers behind MygramClient
+ *
+ * Not part of the client API: exposed so benchmarks can time parsing on its
+ * own, without the network round trip that every reply case through
+ * MygramClient includes. Each parser takes one complete reply without its
+ * trailing \r\n and maps "ERROR ..." to a server error and any other
+ * unexpected prefix to a protocol error.
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include "mygramdb/mygramclient.h"
+#include "utils/error.h"
+#include "utils/expected.h"
+
+namespace mygramdb::client {
+
+/**
+ * @brief Parse a SEARCH reply into a reused response
+ *
+ * Existing result elements (and their string capacity) are reused. On error
+ * the contents of out are unspecified.
+ */
+mygram::utils::Expected<void, mygram::utils::Error> ParseSearchReply(std::string_view response, SearchResponse& out);
+
+/**
+ * @brief Parse a SEARCH reply into views of its keys, valid as long as response
+ */
+mygram::utils::Expected<void, mygram::utils::Error> ParseSearchReply(std::string_view response,
+                                                                     SearchResponseView& out);
+
+/**
+ * @brief Parse a COUNT reply; out.debug is set when the reply carries DEBUG
+ */
+mygram::utils::Expected<void, mygram::utils::Error> ParseCountReply(std::string_view response, CountResponse& out);
+
+/**
+ * @brief Parse a GET reply into a reused document
+ */
+mygram::utils::Expected<void, mygram::utils::Error> ParseGetReply(std::string_view response, Document& out);
+
+/**
+ * @brief Parse a multi-line INFO reply; fields it does not contain are left untouched
+ */
+mygram::utils::Expected<void, mygram::utils::Error> ParseInfoReply(std::string_view response, ServerInfo& out);
+
+}  // namespace mygramdb::client
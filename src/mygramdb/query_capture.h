@@ -0,0 +1,156 @@
+/**
+ * @file query_capture.h
+ * @brief Binary capture log of the commands a client sends, for replay
+ *
+ * A QueryCapture installed on one or more clients records every request:
+ * when it started, the command as sent, its latency, the reply size, the
+ * result count and the outcome. Requests are appended to an in-memory ring
+ * without locks and written to the log file by a background thread, so the
+ * request path never waits for disk; when the ring is full, records are
+ * dropped and counted rather than blocking.
+ *
+ * Log format (native byte order): a CaptureLogHeader, then one entry per
+ * request: a varint payload length and the payload, which is the varints
+ * start_ns, latency_ns, response_bytes, matched, connection and error_code,
+ * the command type byte, and the varint command length and the command
+ * bytes (without the trailing \r\n). Varints are unsigned LEB128.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "mygramdb/client_metrics.h"
+#include "utils/error.h"
+#include "utils/expected.h"
+
+namespace mygramdb::client {
+
+/**
+ * @brief Capture log file header (24 bytes)
+ */
+struct CaptureLogHeader {
+  static constexpr char kMagic[8] = {'M', 'Y', 'G', 'C', 'A', 'P', 'T', '1'};
+
+  char magic[8];
+  uint32_t version;        // 1
+  uint32_t reserved;
+  uint64_t start_unix_ns;  // Wall-clock capture start; record start_ns values are offsets from it
+};
+static_assert(sizeof(CaptureLogHeader) == 24, "CaptureLogHeader layout is part of the capture log format");
+
+/**
+ * @brief One captured request, as read back by ReadCaptureLog()
+ */
+struct CaptureRecord {
+  uint64_t start_ns = 0;        // Request start, offset from the capture start
+  uint64_t latency_ns = 0;      // Whole client call
+  uint64_t response_bytes = 0;  // Reply bytes received
+  uint64_t matched = 0;         // SEARCH total / COUNT result; 1 for a GET that found its document
+  uint32_t connection = 0;      // Capture-assigned id of the client that sent it
+  uint32_t error_code = 0;      // mygram::utils::ErrorCode, 0 on success
+  CommandType command = CommandType::kOther;
+  std::string text;             // Command as sent, without the trailing \r\n
+};
+
+/**
+ * @brief Lock-free capture of client requests into a log file
+ *
+ * Record() may be called from any number of threads (and clients) at once:
+ * a writer claims ring space with a compare-and-swap, copies its record in
+ * and publishes it with a release store. The background thread drains
+ * published records in order and appends them to the file; a record still
+ * being copied holds back the ones claimed after it until it is published.
+ */
+class QueryCapture {
+ public:
+  static constexpr size_t kDefaultBufferBytes = size_t{1} << 20;
+
+  /**
+   * @brief Create (truncate) a capture log and start its writer thread
+   * @param path Log file path
+   * @param buffer_bytes Ring size, rounded up to a power of two (at least 4 KiB)
+   */
+  static mygram::utils::Expected<std::unique_ptr<QueryCapture>, mygram::utils::Error> Open(
+      const std::string& path, size_t buffer_bytes = kDefaultBufferBytes);
+
+  /**
+   * @brief Write out everything recorded and close the log
+   */
+  ~QueryCapture();
+
+  QueryCapture(const QueryCapture&) = delete;
+  QueryCapture& operator=(const QueryCapture&) = delete;
+  QueryCapture(QueryCapture&&) = delete;
+  QueryCapture& operator=(QueryCapture&&) = delete;
+
+  /**
+   * @brief Id for the next client attached to this capture
+   */
+  uint32_t NextConnectionId() { return next_connection_.fetch_add(1, std::memory_order_relaxed); }
+
+  /**
+   * @brief Append one request; never blocks (dropped if the ring is full)
+   *
+   * @param command Command as sent (a trailing \r\n is ignored)
+   * @param start When the client call began
+   */
+  void Record(uint32_t connection, std::chrono::steady_clock::time_point start, CommandType type,
+              std::string_view command, uint64_t latency_ns, uint64_t response_bytes, uint64_t matched,
+              mygram::utils::ErrorCode error);
+
+  /**
+   * @brief Wait until every record published so far is in the file
+   */
+  void Flush();
+
+  [[nodiscard]] uint64_t recorded() const { return recorded_.load(std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  QueryCapture(std::FILE* file, size_t buffer_bytes);
+
+  /**
+   * @brief Move published records from the ring to the file (drain_mutex_ held)
+   * @return Whether anything was written
+   */
+  bool Drain();
+
+  void Run();
+
+  std::FILE* file_;
+  const std::chrono::steady_clock::time_point start_;
+  const size_t mask_;                              // Ring words - 1
+  std::unique_ptr<std::atomic<uint64_t>[]> ring_;  // Per record: a header word, then the payload words
+  alignas(64) std::atomic<uint64_t> head_{0};      // Words claimed by writers
+  alignas(64) std::atomic<uint64_t> tail_{0};      // Words drained to the file
+  std::atomic<uint64_t> recorded_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint32_t> next_connection_{0};
+  std::mutex drain_mutex_;
+  std::string staging_;  // Encoded entries awaiting fwrite (drain_mutex_ held)
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+  bool stop_ = false;  // Guarded by wake_mutex_
+  std::thread writer_;
+};
+
+/**
+ * @brief Read every record of a capture log
+ * @param start_unix_ns Optional; receives the wall-clock capture start
+ */
+mygram::utils::Expected<std::vector<CaptureRecord>, mygram::utils::Error> ReadCaptureLog(
+    const std::string& path, uint64_t* start_unix_ns = nullptr);
+
+}  // namespace mygramdb::client
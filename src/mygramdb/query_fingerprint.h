@@ -0,0 +1,36 @@
+/**
+ * @file query_fingerprint.h
+ * @brief Query shape fingerprints for MygramDB protocol commands
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace mygramdb::client {
+
+/**
+ * @brief Normalize a SEARCH or COUNT command to its shape
+ *
+ * The query, AND/NOT terms, filter values and LIMIT values are replaced by
+ * '?', while the command, table, clause keywords (so the number of terms),
+ * filter keys and sort clause are kept. Consecutive FILTER clauses are
+ * sorted, so filter order does not matter. Commands that differ only in
+ * literals therefore share a fingerprint:
+ *
+ *   SEARCH articles "hello world" AND perl FILTER status = 1 LIMIT 0,20
+ *   -> SEARCH articles ? AND ? FILTER status = ? LIMIT ?
+ *
+ * Other commands are reduced to their first word.
+ *
+ * @param command Command as sent, with or without the trailing \r\n
+ */
+std::string FingerprintCommand(std::string_view command);
+
+/**
+ * @brief FingerprintCommand() into a reused string (cleared first)
+ */
+void FingerprintCommand(std::string_view command, std::string& fingerprint);
+
+}  // namespace mygramdb::client
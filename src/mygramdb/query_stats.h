@@ -0,0 +1,110 @@
+/**
+ * @file query_stats.h
+ * @brief Per-query-shape statistics for MygramDB clients
+ *
+ * SEARCH and COUNT requests are grouped by FingerprintCommand(), so requests
+ * that differ only in their literals share one entry holding call and error
+ * counts, a latency histogram, the distribution of matched documents and the
+ * averages of any server DebugInfo returned with the replies.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mygramdb/client_metrics.h"
+#include "mygramdb/debug_profiler.h"
+#include "utils/error.h"
+
+namespace mygramdb::client {
+
+/**
+ * @brief Power-of-two histogram of result sizes
+ *
+ * Bucket 0 counts zeros; bucket i counts values in [2^(i-1), 2^i - 1].
+ */
+struct ResultSizeHistogram {
+  static constexpr size_t kBuckets = 65;
+
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t max = 0;
+  std::array<uint64_t, kBuckets> buckets{};
+
+  static size_t IndexOf(uint64_t value) { return value == 0 ? 0 : static_cast<size_t>(64 - __builtin_clzll(value)); }
+
+  /**
+   * @brief Largest value that maps to bucket index
+   */
+  static uint64_t UpperBound(size_t index);
+
+  void Add(uint64_t value);
+
+  /**
+   * @brief Value at or below which percentile% of results fall (bucket upper
+   *        bound clamped to max; 0 when empty)
+   * @param percentile 0-100
+   */
+  [[nodiscard]] uint64_t ValueAtPercentile(double percentile) const;
+};
+
+/**
+ * @brief Statistics of one query shape
+ */
+struct QueryShapeStats {
+  std::string fingerprint;      // FingerprintCommand() of the requests
+  uint64_t calls = 0;           // Completed requests (successful or not)
+  uint64_t errors = 0;          // Requests that returned an error
+  LatencyHistogram latency;     // Call latency, as in ClientMetrics
+  ResultSizeHistogram matched;  // Total matches (SEARCH) or count (COUNT) of successful requests
+  DebugProfile debug;           // DebugInfo means (debug.samples == 0 if no reply carried DEBUG output)
+};
+
+/**
+ * @brief Bounded, thread-safe map of QueryShapeStats keyed by fingerprint
+ *
+ * Each Record() takes a mutex, which is why MygramClient only feeds an
+ * aggregator once query stats are enabled. At most max_fingerprints shapes
+ * are tracked; requests of new shapes beyond that are aggregated under
+ * DebugProfiler::kOverflowFingerprint.
+ */
+class QueryStatsAggregator {
+ public:
+  static constexpr size_t kDefaultMaxFingerprints = 256;
+
+  explicit QueryStatsAggregator(size_t max_fingerprints = kDefaultMaxFingerprints);
+  ~QueryStatsAggregator();
+
+  QueryStatsAggregator(const QueryStatsAggregator&) = delete;
+  QueryStatsAggregator& operator=(const QueryStatsAggregator&) = delete;
+  QueryStatsAggregator(QueryStatsAggregator&&) = delete;
+  QueryStatsAggregator& operator=(QueryStatsAggregator&&) = delete;
+
+  /**
+   * @brief Record one completed request
+   * @param fingerprint FingerprintCommand() of the command sent
+   * @param error kSuccess if the call succeeded (matched and debug are ignored otherwise)
+   * @param debug DebugInfo of the reply, or nullptr
+   */
+  void Record(std::string_view fingerprint, uint64_t latency_ns, mygram::utils::ErrorCode error, uint64_t matched,
+              const DebugInfo* debug);
+
+  /**
+   * @brief Current statistics, most called shape first
+   */
+  [[nodiscard]] std::vector<QueryShapeStats> Snapshot() const;
+
+  void Reset();
+
+ private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+}  // namespace mygramdb::client
@@ -0,0 +1,175 @@
+/**
+ * @file request_observer.h
+ * @brief Request lifecycle hooks for MygramDB clients
+ *
+ * A RequestObserver installed on a MygramClient is called at the start of
+ * every request, when the command has been written, when the first reply
+ * bytes arrive, and when the request completes or fails. With no observer
+ * installed the client only tests a null pointer.
+ *
+ * RingFileObserver is a bundled observer that appends one fixed-size span
+ * record per request to a memory-mapped ring file for offline analysis.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "mygramdb/client_metrics.h"
+#include "utils/error.h"
+#include "utils/expected.h"
+
+namespace mygramdb::client {
+
+/**
+ * @brief Identity of a request, passed to every callback of that request
+ */
+struct RequestInfo {
+  uint64_t id = 0;                                   // Per-client sequence number, starting at 1
+  CommandType command = CommandType::kOther;         // Command category
+  std::string_view table;                            // Target table (empty for server-wide commands)
+  std::chrono::steady_clock::time_point start;       // When the client call began
+  std::chrono::system_clock::time_point wall_start;  // Same instant on the wall clock
+};
+
+/**
+ * @brief Sizes and timings of a finished request
+ *
+ * Offsets are measured from RequestInfo::start; an offset is 0 if the
+ * request never reached that point (e.g. it failed validation).
+ */
+struct RequestSummary {
+  uint64_t bytes_sent = 0;      // Command bytes written to the socket
+  uint64_t bytes_received = 0;  // Reply bytes read from the socket
+  uint64_t recv_calls = 0;      // recv() calls needed to read the reply
+  uint64_t write_ns = 0;        // Offset at which the command was written
+  uint64_t first_byte_ns = 0;   // Offset at which the first reply bytes arrived
+  uint64_t latency_ns = 0;      // Whole call, including validation and parsing
+};
+
+/**
+ * @brief Callbacks for request lifecycle events
+ *
+ * All callbacks have empty defaults; override the ones you need. Callbacks
+ * run synchronously on the thread issuing the request, so they must be
+ * cheap and must not call back into the client. The string_views in
+ * RequestInfo are only valid during the callback. An observer may be shared
+ * by several clients, in which case it must be thread-safe.
+ */
+class RequestObserver {
+ public:
+  virtual ~RequestObserver() = default;
+
+  virtual void OnRequestStart(const RequestInfo& /*request*/) {}
+
+  /**
+   * @param bytes Command size
+   * @param elapsed_ns Offset from the request start
+   */
+  virtual void OnBytesWritten(const RequestInfo& /*request*/, uint64_t /*bytes*/, uint64_t /*elapsed_ns*/) {}
+
+  /**
+   * @param elapsed_ns Offset from the request start
+   */
+  virtual void OnFirstByte(const RequestInfo& /*request*/, uint64_t /*elapsed_ns*/) {}
+
+  virtual void OnComplete(const RequestInfo& /*request*/, const RequestSummary& /*summary*/) {}
+
+  virtual void OnError(const RequestInfo& /*request*/, const mygram::utils::Error& /*error*/,
+                       const RequestSummary& /*summary*/) {}
+};
+
+/**
+ * @brief Span record written by RingFileObserver (64 bytes, native byte order)
+ */
+struct SpanRecord {
+  static constexpr size_t kTableBytes = 10;
+
+  uint64_t request_id;      // RequestInfo::id
+  uint64_t start_unix_ns;   // Wall-clock request start, ns since the Unix epoch
+  uint64_t latency_ns;      // RequestSummary::latency_ns
+  uint64_t write_ns;        // RequestSummary::write_ns
+  uint64_t first_byte_ns;   // RequestSummary::first_byte_ns
+  uint32_t bytes_sent;      // Saturated at UINT32_MAX
+  uint32_t bytes_received;  // Saturated at UINT32_MAX
+  uint16_t recv_calls;      // Saturated at UINT16_MAX
+  uint16_t error_code;      // mygram::utils::ErrorCode, 0 on success
+  uint8_t command;          // CommandType
+  uint8_t table_length;     // Bytes of the table name stored (truncated to kTableBytes)
+  char table[kTableBytes];  // Table name prefix, not NUL-terminated
+};
+static_assert(sizeof(SpanRecord) == 64, "SpanRecord layout is part of the ring file format");
+
+/**
+ * @brief Ring file header (64 bytes, native byte order)
+ *
+ * Records follow the header. The record for sequence number n (starting at
+ * 0) lives in slot n % capacity; next_sequence is the number of records
+ * ever claimed, so the newest min(next_sequence, capacity) slots are valid.
+ * A record still being written when the file is read may be torn.
+ */
+struct SpanRingHeader {
+  static constexpr char kMagic[8] = {'M', 'Y', 'G', 'S', 'P', 'A', 'N', '1'};
+
+  char magic[8];
+  uint32_t version;      // 1
+  uint32_t record_size;  // sizeof(SpanRecord)
+  uint64_t capacity;     // Number of record slots
+  uint64_t next_sequence;
+  char reserved[32];
+};
+static_assert(sizeof(SpanRingHeader) == 64, "SpanRingHeader layout is part of the ring file format");
+
+/**
+ * @brief Observer writing one SpanRecord per finished request to a ring file
+ *
+ * Slots are claimed with an atomic increment in the shared mapping, so one
+ * file can be written by many threads and by several processes (e.g.
+ * prefork workers) at once. Records are written with plain stores; the file
+ * is for offline analysis, not for synchronization. Processes sharing a file
+ * should open it once before forking (or open an already initialized file),
+ * as concurrent initialization is not coordinated.
+ */
+class RingFileObserver : public RequestObserver {
+ public:
+  /**
+   * @brief Map a ring file, creating it if needed
+   *
+   * An existing file with a matching header and capacity is attached to and
+   * keeps its records; anything else is (re)initialized.
+   *
+   * @param path File path
+   * @param capacity Number of record slots (> 0)
+   */
+  static mygram::utils::Expected<std::unique_ptr<RingFileObserver>, mygram::utils::Error> Open(
+      const std::string& path, size_t capacity);
+
+  ~RingFileObserver() override;
+
+  RingFileObserver(const RingFileObserver&) = delete;
+  RingFileObserver& operator=(const RingFileObserver&) = delete;
+  RingFileObserver(RingFileObserver&&) = delete;
+  RingFileObserver& operator=(RingFileObserver&&) = delete;
+
+  void OnComplete(const RequestInfo& request, const RequestSummary& summary) override;
+
+  void OnError(const RequestInfo& request, const mygram::utils::Error& error, const RequestSummary& summary) override;
+
+  [[nodiscard]] size_t capacity() const { return capacity_; }
+
+ private:
+  RingFileObserver(void* mapping, size_t mapping_size, size_t capacity);
+
+  void Write(const RequestInfo& request, const RequestSummary& summary, mygram::utils::ErrorCode error);
+
+  void* mapping_;
+  size_t mapping_size_;
+  size_t capacity_;
+};
+
+}  // namespace mygramdb::client
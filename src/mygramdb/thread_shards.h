@@ -0,0 +1,132 @@
+/**
+ * @file thread_shards.h
+ * @brief Per-thread counter shards shared by MetricsRegistry and HeavyHitters
+ *
+ * Not part of the client API. Each recording thread owns one shard and is
+ * the only thread that writes it, so counters are bumped without locked
+ * instructions and readers merge all shards. A reset cannot zero another
+ * thread's shard (the owner's load-then-store would write the old value
+ * back), so it advances a reset epoch instead: the owner clears its shard
+ * at its next record, and readers skip shards of an older epoch.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mygramdb::client::thread_shards {
+
+/**
+ * @brief Add to a counter that only the owning thread writes
+ *
+ * A relaxed load and store instead of fetch_add: no locked instruction on
+ * the hot path, while readers still see untorn values.
+ */
+inline void Bump(std::atomic<uint64_t>& counter, uint64_t delta) {
+  counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline uint64_t Load(const std::atomic<uint64_t>& counter) { return counter.load(std::memory_order_relaxed); }
+
+/**
+ * @brief Owner and reset epoch of a shard; shard types derive from it
+ */
+struct ShardHeader {
+  ShardHeader(std::thread::id owner_thread, uint64_t reset_epoch) : owner(owner_thread), epoch(reset_epoch) {}
+
+  const std::thread::id owner;
+  std::atomic<uint64_t> epoch;  // Reset epoch the counters belong to; kClearing while the owner clears them
+};
+
+// Shard epoch while its owner clears it
+inline constexpr uint64_t kClearing = std::numeric_limits<uint64_t>::max();
+
+/**
+ * @brief Calling thread's shard of a shard set, created on first use
+ *
+ * A small thread-local cache keyed by set_id (process-unique per shard set)
+ * makes repeat lookups lock-free; only a thread's first call for a set, or
+ * one after eviction from the cache, takes mutex.
+ *
+ * @param make Creates the calling thread's shard (called with mutex held)
+ */
+template <typename Shard, typename Make>
+Shard& Local(uint64_t set_id, std::mutex& mutex, std::vector<std::unique_ptr<Shard>>& shards, Make&& make) {
+  constexpr size_t kCacheEntries = 4;
+  struct CacheEntry {
+    uint64_t set_id = 0;
+    Shard* shard = nullptr;
+  };
+  thread_local std::array<CacheEntry, kCacheEntries> cache{};
+  thread_local size_t next_victim = 0;
+
+  for (const auto& entry : cache) {
+    if (entry.set_id == set_id) {
+      return *entry.shard;
+    }
+  }
+
+  // First use from this thread (or evicted from the cache): find or create its shard
+  Shard* shard = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto self = std::this_thread::get_id();
+    for (const auto& candidate : shards) {
+      if (candidate->owner == self) {
+        shard = candidate.get();
+        break;
+      }
+    }
+    if (shard == nullptr) {
+      shards.push_back(make(self));
+      shard = shards.back().get();
+    }
+  }
+
+  cache[next_victim] = {set_id, shard};
+  next_victim = (next_victim + 1) % kCacheEntries;
+  return *shard;
+}
+
+/**
+ * @brief Owner side of a reset: clear the shard if epoch has moved on since it last recorded
+ *
+ * The shard reads kClearing meanwhile, so a concurrent Read() discards a
+ * half-cleared shard.
+ */
+template <typename Clear>
+void CatchUp(ShardHeader& shard, uint64_t epoch, Clear&& clear) {
+  if (Load(shard.epoch) == epoch) {
+    return;
+  }
+  shard.epoch.store(kClearing, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  clear();
+  shard.epoch.store(epoch, std::memory_order_release);
+}
+
+/**
+ * @brief Reader side: run read over the shard's counters if they belong to epoch
+ *
+ * @return false if the shard holds counts from before a reset, or its owner
+ *         started clearing it during read; the values read must then be dropped
+ */
+template <typename Reader>
+bool Read(const ShardHeader& shard, uint64_t epoch, Reader&& read) {
+  if (shard.epoch.load(std::memory_order_acquire) != epoch) {
+    return false;
+  }
+  read();
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return Load(shard.epoch) == epoch;
+}
+
+}  // namespace mygramdb::client::thread_shards
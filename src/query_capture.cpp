@@ -0,0 +1,277 @@
+/**
+ * @file query_capture.cpp
+ * @brief Lock-free request capture log and its reader
+ */
+
+#include "mygramdb/query_capture.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace mygramdb::client {
+
+using mygram::utils::Error;
+using mygram::utils::ErrorCode;
+using mygram::utils::Expected;
+using mygram::utils::MakeError;
+using mygram::utils::MakeUnexpected;
+
+namespace {
+
+constexpr uint32_t kCaptureLogVersion = 1;
+constexpr size_t kMinBufferBytes = 4096;
+constexpr auto kWriterPollInterval = std::chrono::milliseconds(5);
+
+// Ring header word: (size << 8) | kind, 0 while not yet published
+constexpr uint64_t kRecordWord = 1;   // size: payload bytes, which follow in the next words
+constexpr uint64_t kPaddingWord = 2;  // size: words skipped to wrap to the ring start
+constexpr unsigned kKindBits = 8;
+constexpr uint64_t kKindMask = 0xff;
+
+size_t PayloadWords(size_t bytes) {
+  return (bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+}
+
+void PutVarint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+bool GetVarint(std::string_view& in, uint64_t& value) {
+  value = 0;
+  for (unsigned shift = 0; shift < 64 && !in.empty(); shift += 7) {
+    const auto byte = static_cast<unsigned char>(in.front());
+    in.remove_prefix(1);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DecodeRecord(std::string_view payload, CaptureRecord& record) {
+  uint64_t connection = 0;
+  uint64_t error_code = 0;
+  uint64_t length = 0;
+  if (!GetVarint(payload, record.start_ns) || !GetVarint(payload, record.latency_ns) ||
+      !GetVarint(payload, record.response_bytes) || !GetVarint(payload, record.matched) ||
+      !GetVarint(payload, connection) || !GetVarint(payload, error_code) || payload.empty()) {
+    return false;
+  }
+  record.connection = static_cast<uint32_t>(connection);
+  record.error_code = static_cast<uint32_t>(error_code);
+  record.command = static_cast<CommandType>(static_cast<unsigned char>(payload.front()));
+  payload.remove_prefix(1);
+  if (!GetVarint(payload, length) || length != payload.size()) {
+    return false;
+  }
+  record.text.assign(payload);
+  return true;
+}
+
+}  // namespace
+
+Expected<std::unique_ptr<QueryCapture>, Error> QueryCapture::Open(const std::string& path, size_t buffer_bytes) {
+  std::FILE* file = std::fopen(path.c_str(), "wbe");
+  if (file == nullptr) {
+    return MakeUnexpected(
+        MakeError(ErrorCode::kIOError, "Failed to open capture log " + path + ": " + strerror(errno)));
+  }
+  size_t bytes = kMinBufferBytes;
+  while (bytes < buffer_bytes) {
+    bytes <<= 1;
+  }
+  return std::unique_ptr<QueryCapture>(new QueryCapture(file, bytes));
+}
+
+QueryCapture::QueryCapture(std::FILE* file, size_t buffer_bytes)
+    : file_(file),
+      start_(std::chrono::steady_clock::now()),
+      mask_(buffer_bytes / sizeof(uint64_t) - 1),
+      ring_(new std::atomic<uint64_t>[mask_ + 1]) {
+  for (size_t i = 0; i <= mask_; ++i) {
+    ring_[i].store(0, std::memory_order_relaxed);
+  }
+
+  CaptureLogHeader header{};
+  std::memcpy(header.magic, CaptureLogHeader::kMagic, sizeof(header.magic));
+  header.version = kCaptureLogVersion;
+  header.start_unix_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+          .count());
+  std::fwrite(&header, sizeof(header), 1, file_);
+
+  writer_ = std::thread([this] { Run(); });
+}
+
+QueryCapture::~QueryCapture() {
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_one();
+  writer_.join();
+  Flush();
+  std::fclose(file_);
+}
+
+void QueryCapture::Record(uint32_t connection, std::chrono::steady_clock::time_point start, CommandType type,
+                          std::string_view command, uint64_t latency_ns, uint64_t response_bytes, uint64_t matched,
+                          ErrorCode error) {
+  if (command.size() >= 2 && command.substr(command.size() - 2) == "\r\n") {
+    command.remove_suffix(2);
+  }
+
+  thread_local std::string payload;
+  payload.clear();
+  PutVarint(payload, start > start_ ? static_cast<uint64_t>(
+                                          std::chrono::duration_cast<std::chrono::nanoseconds>(start - start_).count())
+                                    : 0);
+  PutVarint(payload, latency_ns);
+  PutVarint(payload, response_bytes);
+  PutVarint(payload, matched);
+  PutVarint(payload, connection);
+  PutVarint(payload, static_cast<uint64_t>(error));
+  payload.push_back(static_cast<char>(type));
+  PutVarint(payload, command.size());
+  payload.append(command);
+
+  // Claim 1 header word plus the payload, preceded by padding if it would wrap
+  const uint64_t ring_words = mask_ + 1;
+  const uint64_t words = 1 + PayloadWords(payload.size());
+  if (words > ring_words / 2) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  uint64_t padding = 0;
+  do {
+    const uint64_t to_end = ring_words - (head & mask_);
+    padding = words > to_end ? to_end : 0;
+    if (head + padding + words - tail_.load(std::memory_order_acquire) > ring_words) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  } while (!head_.compare_exchange_weak(head, head + padding + words, std::memory_order_acq_rel,
+                                        std::memory_order_relaxed));
+
+  if (padding != 0) {
+    ring_[head & mask_].store((padding << kKindBits) | kPaddingWord, std::memory_order_release);
+    head += padding;
+  }
+  for (size_t i = 0; i < words - 1; ++i) {
+    uint64_t word = 0;
+    std::memcpy(&word, payload.data() + (i * sizeof(word)),
+                std::min(sizeof(word), payload.size() - (i * sizeof(word))));
+    ring_[(head + 1 + i) & mask_].store(word, std::memory_order_relaxed);
+  }
+  ring_[head & mask_].store((static_cast<uint64_t>(payload.size()) << kKindBits) | kRecordWord,
+                            std::memory_order_release);
+  recorded_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool QueryCapture::Drain() {
+  uint64_t tail = tail_.load(std::memory_order_relaxed);
+  const uint64_t first = tail;
+  while (true) {
+    const uint64_t header = ring_[tail & mask_].load(std::memory_order_acquire);
+    if (header == 0) {
+      break;  // Not published yet
+    }
+    uint64_t words = header >> kKindBits;
+    if ((header & kKindMask) == kRecordWord) {
+      const size_t bytes = header >> kKindBits;
+      words = 1 + PayloadWords(bytes);
+      PutVarint(staging_, bytes);
+      for (size_t i = 0; i < words - 1; ++i) {
+        const uint64_t word = ring_[(tail + 1 + i) & mask_].load(std::memory_order_relaxed);
+        staging_.append(reinterpret_cast<const char*>(&word), std::min(sizeof(word), bytes - (i * sizeof(word))));
+      }
+    }
+    // Writers reuse the space once tail_ passes it and expect unpublished (zero) headers
+    for (uint64_t i = 0; i < words; ++i) {
+      ring_[(tail + i) & mask_].store(0, std::memory_order_relaxed);
+    }
+    tail += words;
+  }
+  if (tail == first) {
+    return false;
+  }
+  tail_.store(tail, std::memory_order_release);
+  std::fwrite(staging_.data(), 1, staging_.size(), file_);
+  staging_.clear();
+  return true;
+}
+
+void QueryCapture::Flush() {
+  const uint64_t target = head_.load(std::memory_order_acquire);
+  std::lock_guard<std::mutex> lock(drain_mutex_);
+  while (tail_.load(std::memory_order_relaxed) < target) {
+    if (!Drain()) {
+      std::this_thread::yield();  // A writer is still copying its record in
+    }
+  }
+  std::fflush(file_);
+}
+
+void QueryCapture::Run() {
+  std::unique_lock<std::mutex> wake_lock(wake_mutex_);
+  while (!stop_) {
+    wake_lock.unlock();
+    bool drained = false;
+    {
+      std::lock_guard<std::mutex> lock(drain_mutex_);
+      drained = Drain();
+    }
+    wake_lock.lock();
+    if (!drained) {
+      wake_.wait_for(wake_lock, kWriterPollInterval, [this] { return stop_; });  // Idle: poll
+    }
+  }
+}
+
+Expected<std::vector<CaptureRecord>, Error> ReadCaptureLog(const std::string& path, uint64_t* start_unix_ns) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return MakeUnexpected(MakeError(ErrorCode::kIOError, "Failed to open capture log " + path));
+  }
+  const std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  CaptureLogHeader header{};
+  if (contents.size() < sizeof(header)) {
+    return MakeUnexpected(MakeError(ErrorCode::kInvalidArgument, "Not a capture log: " + path));
+  }
+  std::memcpy(&header, contents.data(), sizeof(header));
+  if (std::memcmp(header.magic, CaptureLogHeader::kMagic, sizeof(header.magic)) != 0 ||
+      header.version != kCaptureLogVersion) {
+    return MakeUnexpected(MakeError(ErrorCode::kInvalidArgument, "Not a capture log: " + path));
+  }
+  if (start_unix_ns != nullptr) {
+    *start_unix_ns = header.start_unix_ns;
+  }
+
+  std::vector<CaptureRecord> records;
+  std::string_view rest(contents);
+  rest.remove_prefix(sizeof(header));
+  while (!rest.empty()) {
+    uint64_t length = 0;
+    CaptureRecord record;
+    if (!GetVarint(rest, length) || length > rest.size() || !DecodeRecord(rest.substr(0, length), record)) {
+      return MakeUnexpected(MakeError(ErrorCode::kInvalidArgument,
+                                      "Corrupt capture log " + path + " after " + std::to_string(records.size()) +
+                                          " records"));
+    }
+    rest.remove_prefix(length);
+    records.push_back(std::move(record));
+  }
+  return records;
+}
+
+}  // namespace mygramdb::client
@@ -0,0 +1,137 @@
+/**
+ * @file query_fingerprint.cpp
+ * @brief Query shape fingerprints for MygramDB protocol commands
+ */
+
+#include "mygramdb/query_fingerprint.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace mygramdb::client {
+
+namespace {
+
+/**
+ * @brief Split off the next token: a double-quoted string (with backslash
+ *        escapes) or a run of non-space characters
+ */
+std::string_view NextCommandToken(std::string_view& rest) {
+  size_t start = rest.find_first_not_of(" \r\n");
+  if (start == std::string_view::npos) {
+    rest = {};
+    return {};
+  }
+  rest.remove_prefix(start);
+
+  size_t end = 0;
+  if (rest.front() == '"') {
+    end = 1;
+    while (end < rest.size() && rest[end] != '"') {
+      end += rest[end] == '\\' ? 2 : 1;
+    }
+    end = end < rest.size() ? end + 1 : rest.size();
+  } else {
+    end = rest.find_first_of(" \r\n");
+    if (end == std::string_view::npos) {
+      end = rest.size();
+    }
+  }
+
+  std::string_view token = rest.substr(0, end);
+  rest.remove_prefix(end);
+  return token;
+}
+
+void AppendToken(std::string& out, std::string_view token) {
+  if (token.empty()) {
+    return;
+  }
+  if (!out.empty()) {
+    out += ' ';
+  }
+  out.append(token.data(), token.size());
+}
+
+/**
+ * @brief Sort the FILTER clauses at [begin, end) of fingerprint by text
+ *
+ * Clients often build filters from unordered maps (Perl hashes), so the
+ * same shape would otherwise yield one fingerprint per filter order.
+ */
+void SortFilterClauses(std::string& fingerprint, const std::vector<std::pair<size_t, size_t>>& clauses) {
+  std::vector<std::string> sorted;
+  sorted.reserve(clauses.size());
+  for (const auto& [begin, end] : clauses) {
+    sorted.emplace_back(fingerprint, begin, end - begin);
+  }
+  std::sort(sorted.begin(), sorted.end());
+
+  std::string joined;
+  for (const auto& clause : sorted) {
+    AppendToken(joined, clause);
+  }
+  const size_t begin = clauses.front().first;
+  fingerprint.replace(begin, clauses.back().second - begin, joined);
+}
+
+}  // namespace
+
+std::string FingerprintCommand(std::string_view command) {
+  std::string fingerprint;
+  FingerprintCommand(command, fingerprint);
+  return fingerprint;
+}
+
+void FingerprintCommand(std::string_view command, std::string& fingerprint) {
+  fingerprint.clear();
+  std::string_view rest = command;
+
+  std::string_view verb = NextCommandToken(rest);
+  AppendToken(fingerprint, verb);
+  if (verb != "SEARCH" && verb != "COUNT") {
+    return;
+  }
+
+  AppendToken(fingerprint, NextCommandToken(rest));  // Table
+  if (!NextCommandToken(rest).empty()) {              // Query
+    AppendToken(fingerprint, "?");
+  }
+
+  std::vector<std::pair<size_t, size_t>> filters;  // [begin, end) of each FILTER clause
+  bool filters_contiguous = true;
+  for (std::string_view token = NextCommandToken(rest); !token.empty(); token = NextCommandToken(rest)) {
+    if (token == "AND" || token == "NOT" || token == "LIMIT") {
+      AppendToken(fingerprint, token);
+      if (!NextCommandToken(rest).empty()) {
+        AppendToken(fingerprint, "?");
+      }
+    } else if (token == "FILTER") {
+      // FILTER <key> <op> <value>
+      const size_t begin = fingerprint.empty() ? 0 : fingerprint.size() + 1;
+      filters_contiguous = filters_contiguous && (filters.empty() || filters.back().second + 1 == begin);
+      AppendToken(fingerprint, token);
+      AppendToken(fingerprint, NextCommandToken(rest));
+      AppendToken(fingerprint, NextCommandToken(rest));
+      if (!NextCommandToken(rest).empty()) {
+        AppendToken(fingerprint, "?");
+      }
+      filters.emplace_back(begin, fingerprint.size());
+    } else if (token == "SORT") {
+      // SORT <column> [ASC|DESC] or SORT ASC|DESC
+      AppendToken(fingerprint, token);
+      AppendToken(fingerprint, NextCommandToken(rest));
+    } else if (token == "ASC" || token == "DESC") {
+      AppendToken(fingerprint, token);
+    } else {
+      AppendToken(fingerprint, "?");
+    }
+  }
+
+  if (filters.size() > 1 && filters_contiguous) {
+    SortFilterClauses(fingerprint, filters);
+  }
+}
+
+}  // namespace mygramdb::client
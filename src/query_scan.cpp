@@ -0,0 +1,225 @@
+/**
+ * @file query_scan.cpp
+ * @brief Vectorized validation and escape classification of query strings
+ */
+
+#include "utils/query_scan.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MYGRAM_QUERY_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(MYGRAM_QUERY_SCAN_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MYGRAM_QUERY_SCAN_AVX2 1
+#endif
+
+namespace mygramdb::utils {
+
+namespace {
+
+constexpr unsigned char kLastControl = 0x1F;
+constexpr unsigned char kDelete = 0x7F;
+
+/**
+ * @brief Scalar classification of term from pos on, accumulating into scan
+ * @return false if a control character was found (scan.first_control set)
+ */
+bool ScanTail(std::string_view term, size_t pos, TermScan& scan) {
+  for (; pos < term.size(); ++pos) {
+    const auto byte = static_cast<unsigned char>(term[pos]);
+    if (byte <= kLastControl || byte == kDelete) {
+      scan.first_control = pos;
+      return false;
+    }
+    if (byte == ' ' || byte == '"' || byte == '\'') {
+      scan.needs_quoting = true;
+    }
+    if (byte == '"' || byte == '\\') {
+      ++scan.escapes;
+    }
+  }
+  return true;
+}
+
+#ifdef MYGRAM_QUERY_SCAN_X86
+
+int CountTrailingZeros(uint32_t mask) { return __builtin_ctz(mask); }
+
+int PopCount(uint32_t mask) { return __builtin_popcount(mask); }
+
+/**
+ * @brief Bytes of mask that precede bit `limit` (limit < 32)
+ */
+uint32_t BitsBelow(uint32_t mask, int limit) { return mask & ((1U << limit) - 1U); }
+
+#endif
+
+}  // namespace
+
+TermScan ScanTermScalar(std::string_view term) {
+  TermScan scan;
+  ScanTail(term, 0, scan);
+  return scan;
+}
+
+#ifdef MYGRAM_QUERY_SCAN_X86
+
+TermScan ScanTermSse2(std::string_view term) {
+  constexpr size_t kWidth = 16;
+  TermScan scan;
+  const __m128i last_control = _mm_set1_epi8(static_cast<char>(kLastControl));
+  const __m128i del = _mm_set1_epi8(static_cast<char>(kDelete));
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i dquote = _mm_set1_epi8('"');
+  const __m128i squote = _mm_set1_epi8('\'');
+  const __m128i backslash = _mm_set1_epi8('\\');
+
+  size_t pos = 0;
+  for (; pos + kWidth <= term.size(); pos += kWidth) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(term.data() + pos));
+    // Unsigned chunk <= 0x1F, expressed as min(chunk, 0x1F) == chunk
+    const __m128i control =
+        _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(chunk, last_control), chunk), _mm_cmpeq_epi8(chunk, del));
+    const __m128i is_dquote = _mm_cmpeq_epi8(chunk, dquote);
+    const __m128i quote = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), is_dquote),
+                                       _mm_cmpeq_epi8(chunk, squote));
+    const __m128i escape = _mm_or_si128(is_dquote, _mm_cmpeq_epi8(chunk, backslash));
+
+    const auto control_mask = static_cast<uint32_t>(_mm_movemask_epi8(control));
+    auto quote_mask = static_cast<uint32_t>(_mm_movemask_epi8(quote));
+    auto escape_mask = static_cast<uint32_t>(_mm_movemask_epi8(escape));
+    if (control_mask != 0) {
+      // Only bytes before the first control character count
+      const int first = CountTrailingZeros(control_mask);
+      quote_mask = BitsBelow(quote_mask, first);
+      escape_mask = BitsBelow(escape_mask, first);
+      scan.needs_quoting = scan.needs_quoting || quote_mask != 0;
+      scan.escapes += static_cast<size_t>(PopCount(escape_mask));
+      scan.first_control = pos + static_cast<size_t>(first);
+      return scan;
+    }
+    scan.needs_quoting = scan.needs_quoting || quote_mask != 0;
+    scan.escapes += static_cast<size_t>(PopCount(escape_mask));
+  }
+
+  ScanTail(term, pos, scan);
+  return scan;
+}
+
+#else
+
+TermScan ScanTermSse2(std::string_view term) { return ScanTermScalar(term); }
+
+#endif
+
+#ifdef MYGRAM_QUERY_SCAN_AVX2
+
+namespace {
+
+__attribute__((target("avx2"))) TermScan ScanTermAvx2Impl(std::string_view term) {
+  constexpr size_t kWidth = 32;
+  TermScan scan;
+  const __m256i last_control = _mm256_set1_epi8(static_cast<char>(kLastControl));
+  const __m256i del = _mm256_set1_epi8(static_cast<char>(kDelete));
+  const __m256i space = _mm256_set1_epi8(' ');
+  const __m256i dquote = _mm256_set1_epi8('"');
+  const __m256i squote = _mm256_set1_epi8('\'');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+
+  size_t pos = 0;
+  for (; pos + kWidth <= term.size(); pos += kWidth) {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(term.data() + pos));
+    const __m256i control = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(chunk, last_control), chunk),
+                                            _mm256_cmpeq_epi8(chunk, del));
+    const __m256i is_dquote = _mm256_cmpeq_epi8(chunk, dquote);
+    const __m256i quote = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), is_dquote),
+                                          _mm256_cmpeq_epi8(chunk, squote));
+    const __m256i escape = _mm256_or_si256(is_dquote, _mm256_cmpeq_epi8(chunk, backslash));
+
+    const auto control_mask = static_cast<uint32_t>(_mm256_movemask_epi8(control));
+    auto quote_mask = static_cast<uint32_t>(_mm256_movemask_epi8(quote));
+    auto escape_mask = static_cast<uint32_t>(_mm256_movemask_epi8(escape));
+    if (control_mask != 0) {
+      const int first = CountTrailingZeros(control_mask);
+      quote_mask = BitsBelow(quote_mask, first);
+      escape_mask = BitsBelow(escape_mask, first);
+      scan.needs_quoting = scan.needs_quoting || quote_mask != 0;
+      scan.escapes += static_cast<size_t>(PopCount(escape_mask));
+      scan.first_control = pos + static_cast<size_t>(first);
+      return scan;
+    }
+    scan.needs_quoting = scan.needs_quoting || quote_mask != 0;
+    scan.escapes += static_cast<size_t>(PopCount(escape_mask));
+  }
+
+  // Finish with the 16-byte kernel's tail handling
+  TermScan tail = ScanTermSse2(term.substr(pos));
+  scan.needs_quoting = scan.needs_quoting || tail.needs_quoting;
+  scan.escapes += tail.escapes;
+  if (tail.HasControl()) {
+    scan.first_control = pos + tail.first_control;
+  }
+  return scan;
+}
+
+bool CpuHasAvx2() {
+  static const bool kHasAvx2 = __builtin_cpu_supports("avx2") != 0;
+  return kHasAvx2;
+}
+
+}  // namespace
+
+TermScan ScanTermAvx2(std::string_view term) {
+  return CpuHasAvx2() ? ScanTermAvx2Impl(term) : ScanTermSse2(term);
+}
+
+#else
+
+TermScan ScanTermAvx2(std::string_view term) { return ScanTermSse2(term); }
+
+#endif
+
+namespace {
+
+using ScanFunction = TermScan (*)(std::string_view);
+
+struct Dispatch {
+  ScanFunction function;
+  const char* name;
+};
+
+Dispatch SelectKernel() {
+#if defined(MYGRAM_QUERY_SCAN_AVX2)
+  if (CpuHasAvx2()) {
+    return {ScanTermAvx2Impl, "avx2"};
+  }
+#endif
+#if defined(MYGRAM_QUERY_SCAN_X86)
+  return {ScanTermSse2, "sse2"};
+#else
+  return {ScanTermScalar, "scalar"};
+#endif
+}
+
+const Dispatch& Kernel() {
+  static const Dispatch kKernel = SelectKernel();
+  return kKernel;
+}
+
+}  // namespace
+
+TermScan ScanTerm(std::string_view term) {
+  // Short terms (most single words) are cheaper to scan than to dispatch
+  constexpr size_t kScalarMaxLen = 16;
+  if (term.size() < kScalarMaxLen) {
+    return ScanTermScalar(term);
+  }
+  return Kernel().function(term);
+}
+
+const char* ScanTermKernel() { return Kernel().name; }
+
+}  // namespace mygramdb::utils
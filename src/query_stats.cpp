@@ -0,0 +1,130 @@
+/**
+ * @file query_stats.cpp
+ * @brief Per-query-shape statistics for MygramDB clients
+ */
+
+#include "mygramdb/query_stats.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+#include "mygramdb/mygramclient.h"
+
+namespace mygramdb::client {
+
+// ResultSizeHistogram
+
+uint64_t ResultSizeHistogram::UpperBound(size_t index) {
+  if (index + 1 >= kBuckets) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return (uint64_t{1} << index) - 1;
+}
+
+void ResultSizeHistogram::Add(uint64_t value) {
+  ++count;
+  sum += value;
+  max = std::max(max, value);
+  ++buckets[IndexOf(value)];
+}
+
+uint64_t ResultSizeHistogram::ValueAtPercentile(double percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+  percentile = std::clamp(percentile, 0.0, 100.0);
+  auto rank = static_cast<uint64_t>((percentile / 100.0) * static_cast<double>(count) + 0.5);
+  rank = std::clamp<uint64_t>(rank, 1, count);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return std::min(UpperBound(i), max);
+    }
+  }
+  return max;
+}
+
+// QueryStatsAggregator
+
+namespace {
+
+struct ShapeSums {
+  uint64_t calls = 0;
+  uint64_t errors = 0;
+  LatencyHistogram latency;
+  ResultSizeHistogram matched;
+  DebugInfoSums debug;
+};
+
+}  // namespace
+
+struct QueryStatsAggregator::State {
+  explicit State(size_t max) : max_fingerprints(max) {}
+
+  const size_t max_fingerprints;
+  mutable std::mutex mutex;
+  std::unordered_map<std::string, ShapeSums> shapes;
+  std::string key;  // Lookup key, reused so that recording a known shape does not allocate
+};
+
+QueryStatsAggregator::QueryStatsAggregator(size_t max_fingerprints)
+    : state_(std::make_unique<State>(max_fingerprints)) {}
+
+QueryStatsAggregator::~QueryStatsAggregator() = default;
+
+void QueryStatsAggregator::Record(std::string_view fingerprint, uint64_t latency_ns, mygram::utils::ErrorCode error,
+                                  uint64_t matched, const DebugInfo* debug) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->key.assign(fingerprint);
+  auto found = state_->shapes.find(state_->key);
+  if (found == state_->shapes.end()) {
+    if (state_->shapes.size() >= state_->max_fingerprints) {
+      state_->key = DebugProfiler::kOverflowFingerprint;
+    }
+    found = state_->shapes.try_emplace(state_->key).first;
+  }
+
+  ShapeSums& sums = found->second;
+  ++sums.calls;
+  sums.latency.Add(latency_ns);
+  if (error != mygram::utils::ErrorCode::kSuccess) {
+    ++sums.errors;
+    return;
+  }
+  sums.matched.Add(matched);
+  if (debug != nullptr) {
+    sums.debug.Add(*debug);
+  }
+}
+
+std::vector<QueryShapeStats> QueryStatsAggregator::Snapshot() const {
+  std::vector<QueryShapeStats> shapes;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    shapes.reserve(state_->shapes.size());
+    for (const auto& [fingerprint, sums] : state_->shapes) {
+      QueryShapeStats& stats = shapes.emplace_back();
+      stats.fingerprint = fingerprint;
+      stats.calls = sums.calls;
+      stats.errors = sums.errors;
+      stats.latency = sums.latency;
+      stats.matched = sums.matched;
+      stats.debug = sums.debug.Mean(fingerprint);
+    }
+  }
+  std::sort(shapes.begin(), shapes.end(), [](const QueryShapeStats& lhs, const QueryShapeStats& rhs) {
+    return lhs.calls != rhs.calls ? lhs.calls > rhs.calls : lhs.fingerprint < rhs.fingerprint;
+  });
+  return shapes;
+}
+
+void QueryStatsAggregator::Reset() {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->shapes.clear();
+}
+
+}  // namespace mygramdb::client
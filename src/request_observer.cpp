@@ -0,0 +1,130 @@
+/**
+ * @file request_observer.cpp
+ * @brief Memory-mapped ring file observer for MygramDB clients
+ */
+
+#include "mygramdb/request_observer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+namespace mygramdb::client {
+
+using mygram::utils::Error;
+using mygram::utils::ErrorCode;
+using mygram::utils::Expected;
+using mygram::utils::MakeError;
+using mygram::utils::MakeUnexpected;
+
+namespace {
+
+constexpr uint32_t kSpanRingVersion = 1;
+constexpr mode_t kSpanRingFileMode = 0644;
+
+template <typename T>
+T Saturate(uint64_t value) {
+  return static_cast<T>(std::min<uint64_t>(value, std::numeric_limits<T>::max()));
+}
+
+Error SystemError(const std::string& what, const std::string& path) {
+  return MakeError(ErrorCode::kIOError, what + " " + path + ": " + strerror(errno));
+}
+
+bool HeaderMatches(const SpanRingHeader& header, size_t capacity) {
+  return std::memcmp(header.magic, SpanRingHeader::kMagic, sizeof(header.magic)) == 0 &&
+         header.version == kSpanRingVersion && header.record_size == sizeof(SpanRecord) &&
+         header.capacity == capacity;
+}
+
+}  // namespace
+
+Expected<std::unique_ptr<RingFileObserver>, Error> RingFileObserver::Open(const std::string& path, size_t capacity) {
+  if (capacity == 0) {
+    return MakeUnexpected(MakeError(ErrorCode::kInvalidArgument, "Span ring capacity must be positive"));
+  }
+  const size_t mapping_size = sizeof(SpanRingHeader) + (capacity * sizeof(SpanRecord));
+
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, kSpanRingFileMode);
+  if (fd < 0) {
+    return MakeUnexpected(SystemError("Failed to open span ring", path));
+  }
+
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    auto error = SystemError("Failed to stat span ring", path);
+    close(fd);
+    return MakeUnexpected(error);
+  }
+
+  const bool sized = static_cast<size_t>(st.st_size) == mapping_size;
+  if (!sized && ftruncate(fd, static_cast<off_t>(mapping_size)) != 0) {
+    auto error = SystemError("Failed to size span ring", path);
+    close(fd);
+    return MakeUnexpected(error);
+  }
+
+  void* mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);  // The mapping keeps the file referenced
+  if (mapping == MAP_FAILED) {
+    return MakeUnexpected(SystemError("Failed to map span ring", path));
+  }
+
+  auto* header = static_cast<SpanRingHeader*>(mapping);
+  if (!sized || !HeaderMatches(*header, capacity)) {
+    std::memset(mapping, 0, mapping_size);
+    header->version = kSpanRingVersion;
+    header->record_size = sizeof(SpanRecord);
+    header->capacity = capacity;
+    std::memcpy(header->magic, SpanRingHeader::kMagic, sizeof(header->magic));  // Last: marks the file valid
+  }
+
+  return std::unique_ptr<RingFileObserver>(new RingFileObserver(mapping, mapping_size, capacity));
+}
+
+RingFileObserver::RingFileObserver(void* mapping, size_t mapping_size, size_t capacity)
+    : mapping_(mapping), mapping_size_(mapping_size), capacity_(capacity) {}
+
+RingFileObserver::~RingFileObserver() {
+  munmap(mapping_, mapping_size_);
+}
+
+void RingFileObserver::OnComplete(const RequestInfo& request, const RequestSummary& summary) {
+  Write(request, summary, ErrorCode::kSuccess);
+}
+
+void RingFileObserver::OnError(const RequestInfo& request, const Error& error, const RequestSummary& summary) {
+  Write(request, summary, error.code());
+}
+
+void RingFileObserver::Write(const RequestInfo& request, const RequestSummary& summary, ErrorCode error) {
+  SpanRecord record{};
+  record.request_id = request.id;
+  record.start_unix_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(request.wall_start.time_since_epoch()).count());
+  record.latency_ns = summary.latency_ns;
+  record.write_ns = summary.write_ns;
+  record.first_byte_ns = summary.first_byte_ns;
+  record.bytes_sent = Saturate<uint32_t>(summary.bytes_sent);
+  record.bytes_received = Saturate<uint32_t>(summary.bytes_received);
+  record.recv_calls = Saturate<uint16_t>(summary.recv_calls);
+  record.error_code = static_cast<uint16_t>(error);
+  record.command = static_cast<uint8_t>(request.command);
+  record.table_length = static_cast<uint8_t>(std::min(request.table.size(), SpanRecord::kTableBytes));
+  std::memcpy(record.table, request.table.data(), record.table_length);
+
+  // The sequence counter lives in the shared mapping, so it is claimed with
+  // an atomic builtin rather than a std::atomic member
+  auto* header = static_cast<SpanRingHeader*>(mapping_);
+  const uint64_t sequence = __atomic_fetch_add(&header->next_sequence, 1, __ATOMIC_RELAXED);
+  auto* records = reinterpret_cast<SpanRecord*>(header + 1);
+  std::memcpy(&records[sequence % capacity_], &record, sizeof(record));
+}
+
+}  // namespace mygramdb::client
@@ -0,0 +1,53 @@
+/**
+ * @file query_scan.h
+ * @brief Vectorized validation and escape classification of query strings
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace mygramdb::utils {
+
+/**
+ * @brief What one pass over a query string found
+ *
+ * Control characters are those std::iscntrl() accepts in the "C" locale
+ * (0x00-0x1F and 0x7F). When one is found the scan stops, and the quoting
+ * fields describe only the bytes before it.
+ */
+struct TermScan {
+  static constexpr size_t kNoControl = static_cast<size_t>(-1);
+
+  size_t first_control = kNoControl;  // Offset of the first control character
+  bool needs_quoting = false;         // Contains space, tab, CR, LF, '"' or '\''
+  size_t escapes = 0;                 // Number of '"' and '\\' (escaped when quoted)
+
+  [[nodiscard]] bool HasControl() const { return first_control != kNoControl; }
+};
+
+/**
+ * @brief Classify a query string in one pass
+ *
+ * Uses the widest kernel the CPU supports (AVX2, SSE2, or scalar), chosen
+ * once at first use.
+ */
+TermScan ScanTerm(std::string_view term);
+
+/**
+ * @brief Individual kernels, exposed for benchmarks and differential checks
+ *
+ * Kernels not compiled for this target (or not supported by this CPU)
+ * fall back to ScanTermScalar.
+ */
+TermScan ScanTermScalar(std::string_view term);
+TermScan ScanTermSse2(std::string_view term);
+TermScan ScanTermAvx2(std::string_view term);
+
+/**
+ * @brief Name of the kernel ScanTerm dispatches to ("avx2", "sse2" or "scalar")
+ */
+const char* ScanTermKernel();
+
+}  // namespace mygramdb::utils
@@ -0,0 +1,68 @@
+/**
+ * @file usdt.h
+ * @brief USDT (static tracepoint) probes for the MygramDB client
+ *
+ * Probes use <sys/sdt.h> (systemtap-sdt-dev / systemtap-sdt-devel) and are
+ * compiled out when it is missing or MYGRAMCLIENT_NO_USDT is defined. Each
+ * probe has an is-enabled semaphore that tracers (bpftrace, bcc, perf)
+ * raise while attached, so arguments that cost something to compute (clock
+ * reads) are only computed then; an unattached probe is a single nop.
+ *
+ * Provider "mygramclient". Command kinds are CommandType values (0 SEARCH,
+ * 1 COUNT, 2 GET, 3 INFO, 4 CONFIG, 5 SAVE, 6 LOAD, 7 REPLICATION, 8 DEBUG,
+ * 9 OTHER); durations are nanoseconds since the client call began.
+ *
+ *   command_build(kind, bytes, elapsed_ns)        Command serialized
+ *   send(kind, bytes, elapsed_ns)                 Command written
+ *   recv_chunk(kind, bytes, total_bytes)          recv() returned data
+ *   response_complete(kind, bytes, elapsed_ns)    Reply terminator received
+ *   parse_complete(kind, error_code, latency_ns)  Call finished (0: success)
+ *   capi_entry(function)                          C API function entered
+ *   capi_return(function, latency_ns)             C API function returning
+ *
+ * Usage:
+ *   MYGRAM_USDT_SEMAPHORE(send);  // Once, at global scope in the .cpp
+ *   if (MYGRAM_USDT_ENABLED(send)) {
+ *     MYGRAM_USDT3(send, kind, bytes, ElapsedNs(start, Clock::now()));
+ *   }
+ */
+
+#pragma once
+
+#if !defined(MYGRAMCLIENT_NO_USDT) && defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define MYGRAMCLIENT_HAS_USDT 1
+#endif
+#endif
+
+#ifdef MYGRAMCLIENT_HAS_USDT
+
+// Make STAP_PROBE* record and honor the per-probe semaphores
+#define _SDT_HAS_SEMAPHORES 1  // NOLINT(bugprone-reserved-identifier)
+#include <sys/sdt.h>
+
+// The probe notes refer to the semaphore by its assembler name, so it must
+// be a C-linkage global named <provider>_<probe>_semaphore
+#define MYGRAM_USDT_SEMAPHORE(name)                                                                         \
+  extern "C" {                                                                                              \
+  __attribute__((used, section(".probes"))) volatile unsigned short mygramclient_##name##_semaphore = 0; \
+  }                                                                                                         \
+  static_assert(true, "")
+
+#define MYGRAM_USDT_ENABLED(name) __builtin_expect(mygramclient_##name##_semaphore != 0, 0)
+
+#define MYGRAM_USDT1(name, a) STAP_PROBE1(mygramclient, name, a)
+#define MYGRAM_USDT2(name, a, b) STAP_PROBE2(mygramclient, name, a, b)
+#define MYGRAM_USDT3(name, a, b, c) STAP_PROBE3(mygramclient, name, a, b, c)
+
+#else
+
+// Arguments are referenced in an unevaluated context only, so they cost
+// nothing and do not trigger unused-variable warnings
+#define MYGRAM_USDT_SEMAPHORE(name) static_assert(true, "")
+#define MYGRAM_USDT_ENABLED(name) false
+#define MYGRAM_USDT1(name, a) ((void)sizeof(a))
+#define MYGRAM_USDT2(name, a, b) ((void)sizeof((a), (b)))
+#define MYGRAM_USDT3(name, a, b, c) ((void)sizeof((a), (b), (c)))
+
+#endif
@@ -10,11 +10,16 @@ eval { require MygramDB::Client::XS; };
 if ($@) {
     plan skip_all => 'MygramDB::Client::XS not available (XS module not built)';
 } else {
-    plan tests => 2;
+    plan tests => 3;
     use_ok('MygramDB::Client::XS');
     diag("Testing MygramDB::Client::XS $MygramDB::Client::XS::VERSION");
 
     # Test constructor
     my $client = MygramDB::Client::XS->new('localhost', 11016, 5000, 65536);
     isa_ok($client, 'MygramDB::Client::XS', 'XS client object');
+
+    # Diagnostics: SVs kept alive are counted
+    my $before = MygramDB::Client::XS::live_sv_count();
+    my @held = map { "sv$_" } 1 .. 100;
+    cmp_ok(MygramDB::Client::XS::live_sv_count() - $before, '>=', 100, 'live_sv_count counts held SVs');
 }
@@ -0,0 +1,41 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use Test::More;
+
+# XS module is optional
+eval { require MygramDB::Client::XS; };
+
+if ($@) {
+    plan skip_all => 'MygramDB::Client::XS not available (XS module not built)';
+} else {
+    plan tests => 7;
+
+    # Preparing does not contact the server
+    my $client = MygramDB::Client::XS->new('localhost', 11016, 5000, 65536);
+
+    my $prepared = $client->prepare_search('articles');
+    isa_ok($prepared, 'MygramDB::Client::XS::PreparedSearch', 'minimal prepared search');
+
+    my $full = $client->prepare_search('articles', ['AI'], ['old'], {status => 1}, 'created_at', 0);
+    isa_ok($full, 'MygramDB::Client::XS::PreparedSearch', 'prepared search with clauses');
+
+    eval { $client->prepare_search("arti\x01cles") };
+    like($@, qr/Prepare search failed: .*table name contains control character 0x01/,
+         'control character in table is rejected at prepare time');
+
+    eval { $client->prepare_search('articles', ["A\nI"]) };
+    like($@, qr/AND term contains control character 0x0A/, 'control character in AND term is rejected');
+
+    eval { $client->search_prepared($prepared, 'hello') };
+    like($@, qr/Search failed/, 'executing without a connection fails');
+
+    # Nor does it lease a connection from a pool
+    my $pooled = MygramDB::Client::XS->new_pooled('127.0.0.1', 1, 2, 200, 65536);
+    isa_ok($pooled->prepare_search('articles', ['AI']), 'MygramDB::Client::XS::PreparedSearch',
+           'pooled handle prepares without a server');
+
+    eval { $client->search_prepared($client, 'hello') };
+    like($@, qr/not of type MygramDB::Client::XS::PreparedSearch/, 'argument type is checked');
+}
@@ -0,0 +1,41 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use Test::More;
+
+# XS module is optional
+eval { require MygramDB::Client::XS; };
+
+if ($@) {
+    plan skip_all => 'MygramDB::Client::XS not available (XS module not built)';
+} else {
+    # Inputs are validated before the connection is used, so no server is needed
+    my $client = MygramDB::Client::XS->new('localhost', 11016, 5000, 65536);
+
+    # Control characters at every offset of inputs spanning several vector widths
+    for my $len (1, 15, 16, 17, 31, 32, 33, 100) {
+        for my $pos (0, int($len / 2), $len - 1) {
+            my $query = 'x' x $len;
+            substr($query, $pos, 1) = "\x01";
+            substr($query, $len - 1, 1) = "\x02" if $pos < $len - 1;
+            eval { $client->search('articles', $query) };
+            like($@, qr/search query contains control character 0x01/,
+                 "first control character reported (len $len, pos $pos)");
+        }
+    }
+
+    eval { $client->search('articles', "\xe6\x97\xa5\xe6\x9c\xac" x 20 . "\x7f") };
+    like($@, qr/control character 0x7F/, 'DEL after multi-byte text is rejected');
+
+    eval { $client->search('articles', "tab\there") };
+    like($@, qr/control character 0x09/, 'tab is rejected');
+
+    eval { $client->search_advanced('articles', 'ok', 10, 0, ['fine'], [], {status => "a\nb"}, '', 1) };
+    like($@, qr/filter value contains control character 0x0A/, 'filter value is validated');
+
+    eval { $client->search('articles', 'quotes "and" \\backslashes and ' . ("\xe6\x97\xa5" x 30)) };
+    like($@, qr/Not connected/, 'valid input reaches the connection check');
+
+    done_testing();
+}
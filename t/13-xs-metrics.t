@@ -0,0 +1,53 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use Test::More;
+
+# XS module is optional
+eval { require MygramDB::Client::XS; };
+
+if ($@) {
+    plan skip_all => 'MygramDB::Client::XS not available (XS module not built)';
+} else {
+    # Failed calls are recorded too, so no server is needed
+    my $client = MygramDB::Client::XS->new('localhost', 11016, 5000, 65536);
+
+    my $metrics = $client->metrics;
+    is($metrics->{commands}{SEARCH}{requests}, 0, 'new client has no SEARCH requests');
+    is_deeply($metrics->{errors}, [], 'new client has no errors');
+    ok(exists $metrics->{commands}{$_}, "$_ is reported") for qw(SEARCH COUNT GET INFO OTHER);
+
+    eval { $client->search('articles', 'hello') } for 1 .. 3;
+    eval { $client->search('articles', "bad\x01query") };
+    eval { $client->count('articles', 'hello') };
+
+    $metrics = $client->metrics;
+    my $search = $metrics->{commands}{SEARCH};
+    is($search->{requests}, 4, 'SEARCH requests counted');
+    is($search->{errors}, 4, 'SEARCH errors counted');
+    is($search->{bytes_sent}, 0, 'nothing was sent');
+    is($search->{recv_calls}, 0, 'nothing was received');
+    is($search->{latency}{count}, 4, 'latency recorded per request');
+    ok($search->{latency}{min_ns} <= $search->{latency}{p50_ns}, 'p50 is not below min');
+    ok($search->{latency}{p999_ns} <= $search->{latency}{max_ns}, 'p99.9 is not above max');
+
+    my $bucketed = 0;
+    $bucketed += $_->[1] for @{ $search->{latency}{buckets} };
+    is($bucketed, 4, 'bucket counts add up to the request count');
+
+    is($metrics->{commands}{COUNT}{requests}, 1, 'COUNT requests counted separately');
+    is($metrics->{commands}{GET}{requests}, 0, 'GET untouched');
+
+    my %errors = map { $_->{code} => $_->{count} } @{ $metrics->{errors} };
+    is($errors{7000}, 4, 'not-connected errors counted by code');
+    is($errors{7009}, 1, 'invalid-argument error counted by code');
+
+    $client->reset_metrics;
+    $metrics = $client->metrics;
+    is($metrics->{commands}{SEARCH}{requests}, 0, 'reset clears requests');
+    is($metrics->{commands}{SEARCH}{latency}{count}, 0, 'reset clears latency');
+    is_deeply($metrics->{errors}, [], 'reset clears errors');
+
+    done_testing();
+}
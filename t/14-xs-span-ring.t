@@ -0,0 +1,88 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use File::Temp qw(tempdir);
+use Test::More;
+
+# XS module is optional
+eval { require MygramDB::Client::XS; };
+
+if ($@) {
+    plan skip_all => 'MygramDB::Client::XS not available (XS module not built)';
+} else {
+    # Failed calls are recorded too, so no server is needed
+    my $dir = tempdir(CLEANUP => 1);
+    my $path = "$dir/spans.ring";
+    my $capacity = 4;
+
+    my $client = MygramDB::Client::XS->new('localhost', 11016, 5000, 65536);
+    ok($client->set_span_ring($path, $capacity) == 0, 'span ring installed');
+    is(-s $path, 64 + $capacity * 64, 'ring file sized for header and slots');
+
+    eval { $client->search('articles_with_a_long_name', 'hello') };
+    eval { $client->count('posts', "bad\x01") };
+    eval { $client->info };
+
+    my @records = read_ring($path);
+    is(scalar @records, 3, 'one record per request');
+    is_deeply([map { $_->{id} } @records], [1, 2, 3], 'request ids are sequential');
+    is_deeply([map { $_->{command} } @records], [0, 1, 3], 'command types recorded (SEARCH, COUNT, INFO)');
+    is_deeply([map { $_->{table} } @records], ['articles_w', 'posts', ''], 'table name prefixes recorded');
+    is_deeply([map { $_->{error} } @records], [7000, 7009, 7000], 'error codes recorded');
+    ok($records[0]{start_ns} > 1_000_000_000 * 1_000_000_000, 'start is a wall-clock timestamp');
+    is($records[0]{sent}, 0, 'nothing was sent');
+
+    # Wraps around, keeping the newest records
+    eval { $client->get('docs', $_) } for 1 .. 3;
+    @records = read_ring($path);
+    is(scalar @records, $capacity, 'ring keeps capacity records');
+    is_deeply([map { $_->{id} } @records], [3, 4, 5, 6], 'oldest records overwritten');
+
+    # Reopening an existing ring keeps its records; clients get their own ids
+    my $other = MygramDB::Client::XS->new('localhost', 11016, 5000, 65536);
+    $other->set_span_ring($path, $capacity);
+    eval { $other->search('articles', 'again') };
+    @records = read_ring($path);
+    is_deeply([map { $_->{id} } @records], [4, 5, 6, 1], 'existing ring reused');
+
+    $client->set_span_ring(undef);
+    eval { $client->search('articles', 'untraced') };
+    is(scalar(() = read_ring($path)), $capacity, 'still full');
+    is((read_ring($path))[-1]{command}, 0, 'no record after the ring is removed');
+    is(header($path)->{next_sequence}, 7, 'nothing appended after removal');
+
+    eval { $client->set_span_ring("$dir/missing/spans.ring", 4) };
+    like($@, qr/Set span ring failed/, 'unwritable path croaks');
+
+    done_testing();
+}
+
+sub header {
+    my ($path) = @_;
+    open(my $fh, '<:raw', $path) or die "open $path: $!";
+    read($fh, my $data, 64);
+    my ($magic, $version, $record_size, $capacity, $next_sequence) = unpack('a8 L L Q Q', $data);
+    return { magic => $magic, capacity => $capacity, next_sequence => $next_sequence };
+}
+
+sub read_ring {
+    my ($path) = @_;
+    my $header = header($path);
+    return () unless $header->{magic} eq 'MYGSPAN1';
+    open(my $fh, '<:raw', $path) or die "open $path: $!";
+    local $/;
+    my $data = <$fh>;
+    my $next = $header->{next_sequence};
+    my $first = $next > $header->{capacity} ? $next - $header->{capacity} : 0;
+    my @records;
+    for my $sequence ($first .. $next - 1) {
+        my $offset = 64 + ($sequence % $header->{capacity}) * 64;
+        my %r;
+        @r{qw(id start_ns latency_ns write_ns first_byte_ns sent received recv_calls error command table_length table)}
+            = unpack('Q5 L2 S2 C2 a10', substr($data, $offset, 64));
+        $r{table} = substr($r{table}, 0, $r{table_length});
+        push @records, \%r;
+    }
+    return @records;
+}
@@ -0,0 +1,85 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/lib";
+use MockMygram;
+use Test::More;
+
+# XS module is optional
+eval { require MygramDB::Client::XS; };
+
+if ($@) {
+    plan skip_all => 'MygramDB::Client::XS not available (XS module not built)';
+} else {
+    # Replies carry DEBUG output only on connections that sent DEBUG ON
+    my $server = MockMygram->start(sub {
+        my ($line, $conn) = @_;
+        if ($line eq 'DEBUG ON') {
+            $conn->{debug} = 1;
+            return 'OK DEBUG_ON';
+        }
+        if ($line =~ /^SEARCH /) {
+            return 'OK RESULTS 1 42' unless $conn->{debug};
+            return 'OK RESULTS 1 42 DEBUG query_time=1.5 candidates=100 final=1 optimization=intersect';
+        }
+        if ($line =~ /^COUNT /) {
+            return 'OK COUNT 7' . ($conn->{debug} ? ' DEBUG query_time=0.5 candidates=7 final=7' : '');
+        }
+        return 'ERROR Unknown command';
+    }) or plan skip_all => "Cannot listen: $!";
+
+    my $client = MygramDB::Client::XS->new('127.0.0.1', $server->port, 5000, 65536);
+    $client->connect;
+
+    # Sampling off: nothing is profiled
+    $client->search('articles', 'hello', 10, 0) for 1 .. 3;
+    is_deeply($client->debug_profiles, [], 'no profiles without sampling');
+
+    # Bytes of one search command, for the check below
+    $client->reset_metrics;
+    $client->search('articles', 'term0', 10, 0);
+    my $command_bytes = $client->metrics->{commands}{SEARCH}{bytes_sent};
+    $client->reset_metrics;
+
+    # Every other request goes to the DEBUG ON connection
+    $client->set_debug_sampling(2);
+    $client->search('articles', "term$_", 10, 0) for 1 .. 4;
+
+    # Opening that connection is not part of the request that triggered it
+    my $searches = $client->metrics->{commands}{SEARCH};
+    is($searches->{bytes_sent}, 4 * $command_bytes, 'DEBUG ON handshake not counted in request bytes');
+    is($searches->{recv_calls}, 4, 'nor its reply in receive calls');
+    $client->count('articles', 'hello') for 1 .. 2;
+
+    my $profiles = $client->debug_profiles;
+    is(scalar @$profiles, 2, 'one profile per fingerprint');
+    my %by_shape = map { $_->{fingerprint} => $_ } @$profiles;
+    ok($by_shape{'SEARCH articles ? LIMIT ?'}, 'search literals replaced in fingerprint');
+    is($by_shape{'SEARCH articles ? LIMIT ?'}{samples}, 2, '1 in 2 searches sampled');
+    is($by_shape{'COUNT articles ?'}{samples}, 1, '1 in 2 counts sampled');
+    is($profiles->[0]{fingerprint}, 'SEARCH articles ? LIMIT ?', 'most sampled first');
+
+    my $search = $by_shape{'SEARCH articles ? LIMIT ?'};
+    is($search->{candidates}, 100, 'candidates averaged');
+    is($search->{final}, 1, 'final averaged');
+    cmp_ok(abs($search->{query_time_ms} - 1.5), '<', 1e-9, 'query time averaged');
+    is_deeply($search->{optimizations}, {intersect => 2}, 'optimizations counted');
+
+    # Unsampled requests stayed on the primary connection without DEBUG
+    my $result = $client->search('articles', 'plain', 10, 0);
+    is($result->{total_count}, 1, 'primary connection still answers');
+
+    $client->reset_debug_profiles;
+    is_deeply($client->debug_profiles, [], 'profiles reset');
+
+    $client->set_debug_sampling(0);
+    $client->search('articles', 'off', 10, 0) for 1 .. 4;
+    is_deeply($client->debug_profiles, [], 'sampling turned off');
+
+    $client->disconnect;
+    $server->stop;
+
+    done_testing();
+}
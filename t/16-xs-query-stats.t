@@ -0,0 +1,98 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/lib";
+use MockMygram;
+use Test::More;
+
+# XS module is optional
+eval { require MygramDB::Client::XS; };
+
+if ($@) {
+    plan skip_all => 'MygramDB::Client::XS not available (XS module not built)';
+} else {
+    # SEARCH matches as many documents as the query has characters; the
+    # query "boom" fails, and DEBUG ON adds debug output
+    my $server = MockMygram->start(sub {
+        my ($line, $conn) = @_;
+        if ($line eq 'DEBUG ON') {
+            $conn->{debug} = 1;
+            return 'OK DEBUG_ON';
+        }
+        if ($line =~ /^SEARCH \S+ (\S+)/) {
+            return 'ERROR Query failed' if $1 eq 'boom';
+            my $reply = 'OK RESULTS ' . length($1) . ' 1';
+            $reply .= ' DEBUG query_time=2.0 candidates=50 optimization=scan' if $conn->{debug};
+            return $reply;
+        }
+        return 'OK COUNT 7' if $line =~ /^COUNT /;
+        return 'ERROR Unknown command';
+    }) or plan skip_all => "Cannot listen: $!";
+
+    my $client = MygramDB::Client::XS->new('127.0.0.1', $server->port, 5000, 65536);
+    $client->connect;
+
+    $client->search('articles', 'off', 10, 0);
+    is_deeply($client->query_stats, [], 'nothing collected until enabled');
+
+    is($client->enable_query_stats, 0, 'query stats enabled');
+    $client->search('articles', $_, 10, 0) for qw(a bb cccc dddddddd);
+    eval { $client->search('articles', 'boom', 10, 0) };
+    $client->count('articles', 'x') for 1 .. 2;
+
+    # Filters come from a hash; their order must not split the shape
+    $client->search_advanced('articles', 'q', 10, 0, [], [], {status => 1, lang => 'en', year => 2024}, '', 0)
+        for 1 .. 3;
+
+    my $stats = $client->query_stats;
+    is(scalar @$stats, 3, 'one entry per shape');
+    my %by_shape = map { $_->{fingerprint} => $_ } @$stats;
+
+    my $search = $by_shape{'SEARCH articles ? LIMIT ?'};
+    ok($search, 'search shape present');
+    is($stats->[0]{fingerprint}, 'SEARCH articles ? LIMIT ?', 'most called first');
+    is($search->{calls}, 5, 'calls counted, failures included');
+    is($search->{errors}, 1, 'errors counted');
+    is($search->{matched}{sum}, 1 + 2 + 4 + 8, 'matches summed over successful calls');
+    is($search->{matched}{max}, 8, 'largest result');
+    is($search->{matched}{p50}, 3, 'median as power-of-two bucket bound');
+    ok($search->{latency}{p99_ns} >= $search->{latency}{p50_ns}, 'latency percentiles ordered');
+    ok($search->{latency}{min_ns} > 0, 'latency recorded');
+    ok(!defined $search->{debug}, 'no debug means without DEBUG output');
+
+    is($by_shape{'COUNT articles ?'}{calls}, 2, 'count shape counted');
+    is($by_shape{'COUNT articles ?'}{matched}{sum}, 14, 'count results summed');
+
+    my $filtered = $by_shape{'SEARCH articles ? FILTER lang = ? FILTER status = ? FILTER year = ? SORT ASC LIMIT ?'};
+    ok($filtered, 'filter clauses sorted in fingerprint');
+    is($filtered && $filtered->{calls}, 3, 'filter order does not split the shape');
+
+    # DebugInfo from debug-sampled requests is averaged per shape
+    $client->reset_query_stats;
+    $client->set_debug_sampling(1);
+    $client->search('articles', 'abc', 10, 0) for 1 .. 2;
+    $client->set_debug_sampling(0);
+    $stats = $client->query_stats;
+    is(scalar @$stats, 1, 'reset drops earlier shapes');
+    is($stats->[0]{debug}{samples}, 2, 'debug samples counted');
+    is($stats->[0]{debug}{candidates}, 50, 'debug candidates averaged');
+    is_deeply($stats->[0]{debug}{optimizations}, {scan => 2}, 'debug optimizations counted');
+
+    # Bounded: shapes beyond the limit are pooled
+    $client->enable_query_stats(1);
+    $client->search('articles', 'a', 10, 0);
+    $client->count('articles', 'a');
+    $client->search('posts', 'a', 10, 0);
+    is_deeply([sort map { "$_->{fingerprint}=$_->{calls}" } @{ $client->query_stats }],
+              ['(other)=2', 'SEARCH articles ? LIMIT ?=1'], 'new shapes beyond the bound pooled');
+
+    $client->disable_query_stats;
+    is_deeply($client->query_stats, [], 'disabled');
+
+    $client->disconnect;
+    $server->stop;
+
+    done_testing();
+}
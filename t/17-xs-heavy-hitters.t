@@ -0,0 +1,70 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/lib";
+use MockMygram;
+use Test::More;
+
+# XS module is optional
+eval { require MygramDB::Client::XS; };
+
+if ($@) {
+    plan skip_all => 'MygramDB::Client::XS not available (XS module not built)';
+} else {
+    my $server = MockMygram->start(sub {
+        my ($line) = @_;
+        return 'OK RESULTS 1 42' if $line =~ /^SEARCH /;
+        return 'OK COUNT 7' if $line =~ /^COUNT /;
+        return 'ERROR Unknown command';
+    }) or plan skip_all => "Cannot listen: $!";
+
+    my $client = MygramDB::Client::XS->new('127.0.0.1', $server->port, 5000, 65536);
+    $client->connect;
+
+    eval { $client->heavy_hitters };
+    like($@, qr/Heavy hitters failed: .*not enabled/, 'croaks until enabled');
+
+    is($client->enable_heavy_hitters(3), 0, 'tracking enabled');
+
+    # A skewed stream: "hot" dominates, a long tail of one-off queries
+    my $requests = 0;
+    for my $i (1 .. 200) {
+        $client->search('articles', 'hot', 10, 0);
+        $client->search('articles', 'warm', 10, 0) if $i % 2 == 0;
+        $client->count('articles', 'tepid') if $i % 4 == 0;
+        $client->search('articles', "tail$i", 10, 0);
+        $requests += 1 + ($i % 2 == 0) + ($i % 4 == 0) + 1;
+    }
+
+    my $hh = $client->heavy_hitters;
+    is($hh->{total_requests}, $requests, 'every request counted');
+    ok($hh->{total_latency_ns} > 0, 'latency summed');
+    is(scalar @{ $hh->{top} }, 3, 'top-K bounded');
+    is_deeply([map { $_->{command} } @{ $hh->{top} }],
+              ['SEARCH articles hot LIMIT 10', 'SEARCH articles warm LIMIT 10', 'COUNT articles tepid'],
+              'hottest literal commands, most frequent first');
+    cmp_ok($hh->{top}[0]{count}, '>=', 200, 'hot count never undercounted');
+    cmp_ok($hh->{top}[0]{count}, '<', 210, 'hot count close to exact');
+    cmp_ok($hh->{top}[1]{count}, '>=', 100, 'warm count never undercounted');
+    my $share = $hh->{top}[0]{latency_share};
+    ok($share > 0 && $share < 1, 'latency share is a fraction');
+
+    $client->reset_heavy_hitters;
+    $hh = $client->heavy_hitters;
+    is($hh->{total_requests}, 0, 'reset clears counts');
+    is_deeply($hh->{top}, [], 'reset clears candidates');
+
+    $client->search('articles', 'again', 10, 0);
+    is($client->heavy_hitters->{top}[0]{command}, 'SEARCH articles again LIMIT 10', 'tracking resumes after reset');
+
+    $client->enable_heavy_hitters(0);
+    eval { $client->heavy_hitters };
+    ok($@, 'disabled');
+
+    $client->disconnect;
+    $server->stop;
+
+    done_testing();
+}
@@ -0,0 +1,255 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use FindBin;
+use IO::Socket::INET;
+use Test::More;
+use Time::HiRes qw(time);
+
+# XS module is optional
+eval { require MygramDB::Client::XS; };
+
+my $tool = "$FindBin::Bin/../tools/mygram_mock_server";
+
+if ($@) {
+    plan skip_all => 'MygramDB::Client::XS not available (XS module not built)';
+} elsif (!-x $tool) {
+    plan skip_all => 'tools/mygram_mock_server not built';
+} else {
+    my @servers;
+
+    # Start the mock server on a free port; returns the port
+    my $start = sub {
+        # Silence the counters the server prints on exit
+        open(my $stderr, '>&', \*STDERR) or die "dup: $!";
+        open(STDERR, '>', '/dev/null') or die "/dev/null: $!";
+        my $pid = open(my $out, '-|', $tool, '--port', '0', @_);
+        open(STDERR, '>&', $stderr) or die "dup: $!";
+        die "Cannot run $tool: $!" unless $pid;
+        my $line = <$out>;
+        die "mock server did not start" unless defined $line && $line =~ /^PORT (\d+)/;
+        push @servers, [$pid, $out];
+        return $1;
+    };
+
+    my $connect = sub {
+        my $client = MygramDB::Client::XS->new('127.0.0.1', $_[0], 5000, 65536);
+        $client->connect;
+        return $client;
+    };
+
+    # Protocol coverage through the XS client
+    my $port = $start->('--table', 'articles:10000:4', '--table', 'users:500');
+    my $client = $connect->($port);
+
+    my $result = $client->search('articles', 'hello', 10, 0);
+    ok($result->{total_count} > 0, 'search matches documents');
+    is(scalar @{$result->{results}}, 10, 'search honors LIMIT');
+    is_deeply($client->search('articles', 'hello', 10, 0), $result, 'replies are deterministic');
+
+    my $page = $client->search('articles', 'hello', 5, 5);
+    is_deeply([map { $_->{primary_key} } @{$page->{results}}],
+              [map { $_->{primary_key} } @{$result->{results}}[5 .. 9]], 'offset pages through the same matches');
+
+    my $narrowed = $client->search_advanced('articles', 'hello', 10, 0, ['world'], ['spam'], {status => 1}, '', 0);
+    ok($narrowed->{total_count} < $result->{total_count}, 'AND/NOT/FILTER narrow the match');
+    is($client->count('articles', 'hello'), $result->{total_count}, 'count agrees with search');
+
+    my $doc = $client->get('articles', $result->{results}[0]{primary_key});
+    is(scalar keys %{$doc->{fields}}, 4, 'get returns the configured fields');
+    like($doc->{fields}{title}, qr/^Document_\d+$/, 'synthetic title');
+    eval { $client->get('articles', '10001') };
+    like($@, qr/Document not found/, 'get beyond the table fails');
+    eval { $client->search('missing', 'x', 10, 0) };
+    like($@, qr/Table not found/, 'unknown table fails');
+
+    # Results are decoded from per-client handles that every call refills
+    my $first_key = $result->{results}[0]{primary_key};
+    is(scalar @{$result->{results}}, 10, 'earlier search result survives later calls');
+    is($doc->{primary_key}, $first_key, 'earlier document survives later calls');
+    is_deeply($client->get('articles', $first_key), $doc, 'get after a failed get');
+    is(scalar @{$client->search('articles', 'hello', 3, 0)->{results}}, 3, 'smaller page after a larger one');
+
+    # Lightweight return modes: the same keys as a flat list or packed IDs
+    my @keys = map { $_->{primary_key} } @{$result->{results}};
+    is_deeply(scalar $client->search_keys('articles', 'hello', 10, 0), \@keys, 'search_keys returns the keys');
+    my ($ids, $total) = $client->search_ids('articles', 'hello', 10, 0);
+    is_deeply([unpack('Q*', $ids)], \@keys, 'search_ids packs the keys as uint64');
+    is($total, $result->{total_count}, 'total_count follows in list context');
+    my $prepared_shape = $client->prepare_search('articles');
+    is_deeply(scalar $client->search_prepared_keys($prepared_shape, 'hello', 5, 5), [@keys[5 .. 9]], 'prepared keys');
+    is(scalar $client->search_prepared_ids($prepared_shape, 'hello', 5, 5), pack('Q*', @keys[5 .. 9]),
+       'prepared packed IDs');
+    my ($empty, $empty_total) = $client->search_ids('articles', 'hello', 10, 100000);
+    is($empty, '', 'an empty page packs to an empty string');
+    is($empty_total, $result->{total_count}, 'an empty page still carries total_count');
+    is(scalar $client->search_prepared_ids($prepared_shape, 'hello', 10, 100000), '', 'empty prepared page');
+    is_deeply(scalar $client->search_keys('articles', 'hello', 10, 100000), [], 'empty page of keys');
+
+    # Pipelined batches: one write, replies in order, per-item errors
+    my $batch = $client->search_batch([['articles', 'hello', 10], ['missing', 'x'], ['articles', 'hello', 5, 5]]);
+    is(scalar @$batch, 3, 'one batch item per request');
+    is_deeply($batch->[0], $result, 'batched search matches a single search');
+    like($batch->[1]{error}, qr/Table not found/, 'failed batch item carries its error');
+    is_deeply($batch->[2], $page, 'items after a failed one are answered');
+    my $counts = $client->count_batch([['articles', 'hello'], ['articles', "bad\nquery"], ['users', 'hello']]);
+    is($counts->[0]{count}, $result->{total_count}, 'batched count');
+    like($counts->[1]{error}, qr/query/, 'invalid batch item rejected before sending');
+    ok(defined $counts->[2]{count}, 'items after a rejected one are answered');
+    is_deeply($client->search_batch([]), [], 'empty batch');
+    is($client->count('articles', 'hello'), $result->{total_count}, 'single commands after a batch');
+
+    # Non-blocking requests: several in flight, replies polled in submission order
+    my $prepared = $client->prepare_search('articles');
+    my @ids = ($client->submit_search('articles', 'hello', 10), $client->submit_count('articles', 'hello'),
+               $client->submit_get('articles', $first_key), $client->submit_search('missing', 'x'),
+               $client->submit_search_prepared($prepared, 'hello', 5, 5));
+    is($client->pending, 5, 'submitted requests pending');
+    eval { $client->count('articles', 'hello') };
+    like($@, qr/in flight/, 'blocking calls refused while requests are in flight');
+    eval { $client->submit_count('articles', "bad\nquery") };
+    like($@, qr/Submit failed/, 'invalid request rejected at submission');
+    ok($client->wants_write, 'submitted commands wait for process_io');
+    $client->process_io;
+    ok(!$client->wants_write, 'process_io writes the submitted commands');
+    my @replies;
+    while (1) {
+        while (my $reply = $client->poll_result) {
+            push @replies, $reply;
+        }
+        last if @replies >= @ids;
+        my $rin = '';
+        vec($rin, $client->fileno, 1) = 1;
+        last unless select(my $rout = $rin, undef, undef, 5);
+        $client->process_io;
+    }
+    is_deeply([map { delete $_->{id} } @replies], \@ids, 'replies polled in submission order');
+    is_deeply($replies[0], $result, 'submitted search matches a single search');
+    is($replies[1]{count}, $result->{total_count}, 'submitted count');
+    is_deeply($replies[2], $doc, 'submitted get');
+    like($replies[3]{error}, qr/Table not found/, 'failed request carries its error');
+    is_deeply($replies[4], $page, 'submitted prepared search');
+    is($client->pending, 0, 'nothing pending once polled');
+    ok(!defined $client->poll_result, 'poll without results');
+    is($client->count('articles', 'hello'), $result->{total_count}, 'blocking calls once the replies are read');
+
+    my $info = $client->info;
+    is($info->{doc_count}, 10500, 'info sums documents');
+    is_deeply($info->{tables}, ['articles', 'users'], 'info lists tables');
+    ok($info->{total_requests} > 0, 'info counts requests');
+
+    is($client->enable_debug, 0, 'debug on');
+    $client->set_debug_sampling(1);
+    $client->search('articles', 'hello', 10, 0);
+    my ($profile) = @{$client->debug_profiles};
+    is($profile->{final}, $result->{total_count}, 'debug output reports the final count');
+    $client->set_debug_sampling(0);
+    is($client->disable_debug, 0, 'debug off');
+    is($client->replication_stop, 0, 'replication stop');
+    is($client->replication_start, 0, 'replication start');
+
+    # Commands the XS client does not wrap
+    my $raw = IO::Socket::INET->new(PeerAddr => '127.0.0.1', PeerPort => $port) or die "connect: $!";
+    my %replies = (
+        'SAVE /tmp/x.dmp'    => qr/^OK SAVED \/tmp\/x\.dmp$/,
+        'LOAD /tmp/x.dmp'    => qr/^OK LOADED \/tmp\/x\.dmp$/,
+        'REPLICATION STATUS' => qr/^OK REPLICATION status=running gtid=\S+$/,
+        'SYNC users'         => qr/^OK SYNC STARTED table=users$/,
+        'SYNC STATUS'        => qr/^OK SYNC STATUS /,
+        'BOGUS'              => qr/^ERROR Unknown command/,
+    );
+    for my $command (sort keys %replies) {
+        print $raw "$command\r\n";
+        my $reply = <$raw>;
+        $reply =~ s/\r\n\z//;
+        like($reply, $replies{$command}, $command);
+    }
+    print $raw "CONFIG\r\n";
+    is(scalar <$raw>, "OK CONFIG\r\n", 'CONFIG');
+    close $raw;
+
+    # Replies trickled out in 3-byte segments read the same
+    my $slow = $connect->($start->('--table', 'articles:10000:4', '--segment', '3', '--segment-delay', '100'));
+    is_deeply($slow->search('articles', 'hello', 10, 0), $result, 'segmented search reply');
+    is_deeply($slow->info->{tables}, ['articles'], 'segmented multi-line reply');
+
+    # Latency injection
+    my $delayed = $connect->($start->('--latency', 'fixed:30000'));
+    my $begin = time;
+    $delayed->count('articles', 'hello');
+    cmp_ok(time - $begin, '>=', 0.025, 'fixed latency delays replies');
+
+    # Error injection: every 3rd request
+    my $failing = $connect->($start->('--error-every', '3'));
+    $failing->count('articles', 'a') for 1 .. 2;
+    eval { $failing->count('articles', 'a') };
+    like($@, qr/Injected failure/, 'injected error');
+    ok(eval { $failing->count('articles', 'a'); 1 }, 'connection survives an injected error');
+
+    # Disconnect injection: every 2nd request
+    my $dropping = $connect->($start->('--disconnect-every', '2'));
+    ok(eval { $dropping->count('articles', 'a'); 1 }, 'first request answered');
+    eval { $dropping->count('articles', 'a') };
+    ok($@, 'injected disconnect fails the request');
+    $dropping->disconnect;
+    $dropping->connect;
+    ok(eval { $dropping->count('articles', 'a'); 1 }, 'reconnect after a disconnect');
+
+    # Threads of closed connections are joined, not kept until shutdown: an
+    # exited thread that was never joined keeps its stack mapped
+    SKIP: {
+        my $reaping_port = $start->();
+        my $status = "/proc/$servers[-1][0]/status";
+        skip 'no /proc status', 1 unless -r $status;
+        my $vm_kb = sub {
+            open(my $fh, '<', $status) or die "$status: $!";
+            my ($kb) = join('', <$fh>) =~ /^VmSize:\s+(\d+)/m;
+            return $kb;
+        };
+        my $before = $vm_kb->();
+        for (1 .. 100) {
+            my $short = $connect->($reaping_port);
+            $short->count('articles', 'a');
+            $short->disconnect;
+            select(undef, undef, undef, 0.01);  # Let its worker finish before the next accept
+        }
+        my $grown_mb = ($vm_kb->() - $before) / 1024;
+        # Unjoined, 100 stacks of 8 MB; joined, the stacks are reused
+        ok($grown_mb < 256, sprintf('finished connection threads are joined (VmSize +%.0f MB)', $grown_mb));
+    }
+
+    # Pooled handles: a connection is leased per call
+    my $pooled = MygramDB::Client::XS->new_pooled('127.0.0.1', $port, 2, 5000, 65536);
+    is($pooled->is_connected, 0, 'pooled handle opens no connection up front');
+    $pooled->connect;
+    is($pooled->is_connected, 1, 'connect opens a pooled connection');
+    is_deeply($pooled->search('articles', 'hello', 10, 0), $result, 'pooled search');
+    is($pooled->count('articles', 'hello'), $result->{total_count}, 'pooled count');
+    is_deeply($pooled->search_batch([['articles', 'hello', 10]]), [$result], 'pooled batch');
+    is_deeply($pooled->search_prepared($pooled->prepare_search('articles'), 'hello', 10, 0), $result,
+              'pooled prepared search');
+    eval { $pooled->search('missing', 'x', 10, 0) };
+    like($@, qr/Table not found/, 'pooled errors are reported');
+    like($pooled->get_last_error, qr/Table not found/, 'last error of this thread');
+    is($pooled->metrics->{commands}{SEARCH}{requests}, 4, 'metrics cover the pooled connections');
+    is($pooled->fileno, -1, 'no single socket to poll');
+    eval { $pooled->query_stats };
+    like($@, qr/Not supported on pooled handles/, 'per-connection calls are refused');
+    $pooled->disconnect;
+    is($pooled->is_connected, 0, 'disconnect closes the idle connections');
+    is($pooled->count('articles', 'hello'), $result->{total_count}, 'calls reconnect on demand');
+
+    # A pooled connection that failed midway is reopened for the next call
+    my $recovering = MygramDB::Client::XS->new_pooled('127.0.0.1', $start->('--disconnect-every', '2'), 1);
+    ok(eval { $recovering->count('articles', 'a'); 1 }, 'pooled request answered');
+    eval { $recovering->count('articles', 'a') };
+    ok($@, 'injected disconnect fails the pooled request');
+    ok(eval { $recovering->count('articles', 'a'); 1 }, 'next pooled request reconnects by itself');
+
+    for my $server (@servers) {
+        kill 'TERM', $server->[0];
+        close $server->[1];
+    }
+    done_testing();
+}
@@ -0,0 +1,30 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use FindBin;
+use File::Temp qw(tempfile);
+use Test::More;
+
+my $tool = "$FindBin::Bin/../tools/mygram_load";
+
+if (!-x $tool) {
+    plan skip_all => 'tools/mygram_load not built';
+} else {
+    my ($fh, $mix) = tempfile(UNLINK => 1);
+    print $fh "# weight command\n3 SEARCH articles hello LIMIT 10\nCOUNT articles \"a b\"\nGET articles 7\nBOGUS\n";
+    close $fh;
+
+    my $output = `$tool --mock --rate 400 --connections 4 --duration 1 --interval 0.5 --mix $mix 2>&1`;
+    is($?, 0, 'load run exits cleanly') or diag($output);
+    like($output, qr/connections=4\s+duration=1s/, 'reports its configuration');
+    is(scalar(() = $output =~ /^\s+\d+\.\d\s+\d+/mg), 2, 'one row per interval');
+
+    my ($requests, $errors) = $output =~ /^corrected\s+(\d+)\s+\d+\s+(\d+)/m;
+    ok($requests > 300 && $requests < 500, 'open loop issues about rate x duration requests') or diag($output);
+    ok($errors > 0 && $errors < $requests, 'unknown commands count as errors');
+    like($output, qr/^\s+service\s+\d+/m, 'uncorrected service time reported');
+
+    isnt(system("$tool --rate 0 >/dev/null 2>&1"), 0, 'invalid rate rejected');
+    done_testing();
+}
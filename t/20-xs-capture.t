@@ -0,0 +1,88 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use FindBin;
+use File::Temp qw(tempfile);
+use Test::More;
+
+# XS module is optional
+eval { require MygramDB::Client::XS; };
+
+my $server_tool = "$FindBin::Bin/../tools/mygram_mock_server";
+my $replay_tool = "$FindBin::Bin/../tools/mygram_replay";
+
+if ($@) {
+    plan skip_all => 'MygramDB::Client::XS not available (XS module not built)';
+} elsif (!-x $server_tool || !-x $replay_tool) {
+    plan skip_all => 'tools/mygram_mock_server or tools/mygram_replay not built';
+} else {
+    my @servers;
+
+    # Start the mock server on a free port; returns the port
+    my $start = sub {
+        open(my $stderr, '>&', \*STDERR) or die "dup: $!";
+        open(STDERR, '>', '/dev/null') or die "/dev/null: $!";
+        my $pid = open(my $out, '-|', $server_tool, '--port', '0', @_);
+        open(STDERR, '>&', $stderr) or die "dup: $!";
+        die "Cannot run $server_tool: $!" unless $pid;
+        my $line = <$out>;
+        die "mock server did not start" unless defined $line && $line =~ /^PORT (\d+)/;
+        push @servers, [$pid, $out];
+        return $1;
+    };
+
+    my $port = $start->('--table', 'articles:10000:4');
+    my $client = MygramDB::Client::XS->new('127.0.0.1', $port, 5000, 65536);
+    $client->connect;
+
+    my (undef, $capture) = tempfile(UNLINK => 1);
+    is($client->set_capture($capture), 0, 'capture started');
+    my $total = $client->search('articles', 'hello', 10, 0)->{total_count};
+    $client->search_advanced('articles', 'hello', 5, 0, ['world'], [], {status => 1}, '', 0);
+    $client->count('articles', 'news');
+    $client->get('articles', '42');
+    eval { $client->get('articles', '20000') };
+    eval { $client->search('missing', 'x', 10, 0) };
+    $client->info;
+    is($client->set_capture(undef), 0, 'capture stopped');
+
+    my @dump = `$replay_tool --dump $capture`;
+    is($?, 0, 'dump exits cleanly');
+    is(scalar @dump, 8, 'one line per request plus a header');
+    like($dump[1], qr/^\s*[\d.]+\s+0\s+SEARCH\s+[\d.]+\s+\d+\s+$total\s+0 SEARCH articles hello LIMIT 10$/,
+         'search captured with its total');
+    like($dump[4], qr/\s1\s+0 GET articles 42$/, 'found document captured');
+    like($dump[5], qr/\s0\s+[1-9]\d* GET articles 20000$/, 'failed get captured with its error code');
+    like($dump[7], qr/\sINFO$/, 'server-wide command captured');
+
+    my $output = `$replay_tool --port $port --speed 0 $capture`;
+    is($?, 0, 'replay against the same data matches') or diag($output);
+    like($output, qr/6 requests over 1 connections \(1 skipped\)/, 'INFO skipped by default');
+    like($output, qr/^\s+original\s+6\s/m, 'original latencies reported');
+    like($output, qr/^\s+replay\s+6\s/m, 'replay latencies reported');
+    like($output, qr/^mismatches=0$/m, 'no mismatches');
+
+    $output = `$replay_tool --port $port --all $capture`;
+    like($output, qr/7 requests over 1 connections \(0 skipped\)/, '--all replays everything');
+
+    # A smaller table changes the counts
+    my $other = $start->('--table', 'articles:500:4');
+    $output = `$replay_tool --port $other --speed 0 --max-diffs 1 $capture`;
+    isnt($?, 0, 'replay against different data fails');
+    is(scalar(() = $output =~ /^DIFF /mg), 1, 'diffs limited by --max-diffs');
+    like($output, qr/^DIFF conn=0 at=[\d.]+ms captured=$total replayed=\d+  SEARCH articles hello LIMIT 10$/m,
+         'first diff shows both counts');
+    like($output, qr/^mismatches=[2-9]$/m, 'all mismatches counted');
+
+    my ($fh, $bogus) = tempfile(UNLINK => 1);
+    print $fh "not a capture log at all\n";
+    close $fh;
+    like(`$replay_tool --dump $bogus 2>&1`, qr/Not a capture log/, 'foreign file rejected');
+
+    for my $server (@servers) {
+        kill 'TERM', $server->[0];
+        close $server->[1];
+    }
+    done_testing();
+}
@@ -0,0 +1,46 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use FindBin;
+use JSON::PP ();
+use Test::More;
+
+my $bench = "$FindBin::Bin/../bench/client_bench.pl";
+
+if (!-x "$FindBin::Bin/../tools/mygram_mock_server") {
+    plan skip_all => 'tools/mygram_mock_server not built';
+} else {
+    my $has_xs = eval { require MygramDB::Client::XS; 1 };
+    my $clients = $has_xs ? 'pp,xs,xs_ids' : 'pp';
+    my $inc = join(' ', map { "-I$_" } grep { !ref } @INC);
+
+    my $sweep = "--clients $clients --mixes search,get --limits 5 --concurrency 1,2 --iterations 50 --warmup 5";
+    my @lines = `$^X $inc $bench --json $sweep`;
+    is($?, 0, 'harness exits cleanly');
+    my @records = map { JSON::PP::decode_json($_) } @lines;
+    is(scalar @records, ($has_xs ? 5 : 2) * 2, 'one record per client, mix and concurrency');
+
+    for my $record (@records) {
+        my $name = "$record->{client}/$record->{mix}/$record->{concurrency}";
+        ok(!exists $record->{error}, "$name ran") or diag($record->{error});
+        is($record->{ops}, 50 * $record->{concurrency}, "$name: every worker's calls");
+        ok($record->{ops_per_sec} > 0, "$name: throughput");
+        ok($record->{p50_us} <= $record->{p99_us} && $record->{p99_us} <= $record->{max_us}, "$name: percentiles");
+        is($record->{results_per_op}, $record->{mix} eq 'search' ? 5 : 1, "$name: results per call");
+        ok(exists $record->{allocs_per_op} && exists $record->{rss_growth_kb}, "$name: memory fields");
+        ok($record->{us_per_1k_results} > 0, "$name: time per 1,000 results");
+    }
+
+    # SVs held by one result: a hash, a key and a reference per result for xs, none for packed IDs
+    if ($has_xs) {
+        my %svs = map { ("$_->{client}/$_->{mix}" => $_->{svs_per_op}) } grep { $_->{concurrency} == 1 } @records;
+        ok($svs{'xs/search'} >= 3 * 5, 'xs: SVs per search result');
+        ok($svs{'xs_ids/search'} < 5, 'xs_ids: no SV per result');
+    }
+
+    my $table = `$^X $inc $bench --clients pp --mixes count --concurrency 1 --iterations 20 --warmup 1 --no-allocs`;
+    like($table, qr/^client\s+mix\s+limit\s+conc\s+ops\/s/m, 'table header');
+    like($table, qr/^pp\s+count\s+-\s+1\s+\d+/m, 'table row');
+    done_testing();
+}
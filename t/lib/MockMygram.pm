@@ -0,0 +1,77 @@
+package MockMygram;
+
+# Forked MygramDB stand-in for the XS tests. The handler is called for each
+# request line with a per-connection state hash and returns the reply line.
+
+use strict;
+use warnings;
+use IO::Select;
+use IO::Socket::INET;
+
+sub start {
+    my ($class, $handler) = @_;
+
+    my $listener = IO::Socket::INET->new(
+        LocalAddr => '127.0.0.1',
+        LocalPort => 0,
+        Listen    => 5,
+        ReuseAddr => 1,
+    ) or return;
+
+    my $pid = fork();
+    die "fork failed: $!" unless defined $pid;
+    if ($pid == 0) {
+        serve($listener, $handler);
+        exit 0;
+    }
+
+    my $port = $listener->sockport;
+    close $listener;
+    return bless { pid => $pid, port => $port }, $class;
+}
+
+sub port { $_[0]{port} }
+
+sub stop {
+    my ($self) = @_;
+    return unless $self->{pid};
+    kill 'TERM', $self->{pid};
+    waitpid($self->{pid}, 0);
+    $self->{pid} = undef;
+}
+
+sub DESTROY { $_[0]->stop }
+
+sub serve {
+    my ($listener, $handler) = @_;
+    my $select = IO::Select->new($listener);
+    my %state;
+    my %buffer;
+
+    while (1) {
+        for my $fh ($select->can_read(10)) {
+            if ($fh == $listener) {
+                my $conn = $listener->accept or next;
+                $select->add($conn);
+                $state{fileno $conn} = {};
+                $buffer{fileno $conn} = '';
+                next;
+            }
+
+            my $fd = fileno $fh;
+            my $chunk;
+            if (!sysread($fh, $chunk, 4096)) {
+                $select->remove($fh);
+                close $fh;
+                next;
+            }
+            $buffer{$fd} .= $chunk;
+
+            while ($buffer{$fd} =~ s/^([^\r\n]*)\r\n//) {
+                syswrite($fh, $handler->($1, $state{$fd}) . "\r\n");
+            }
+        }
+    }
+}
+
+1;
@@ -0,0 +1,539 @@
+/**
+ * @file mygram_load.cpp
+ * @brief Open-loop load generator for MygramDB built on MygramClient
+ *
+ * Requests are issued on a fixed schedule (constant or Poisson arrivals at
+ * --rate requests/s in total) regardless of how fast replies come back, so
+ * queueing delay is not hidden the way a closed request loop hides it.
+ * Latency is measured from each request's intended start time, not from
+ * when it was actually sent: when the server stalls, the requests that
+ * should have gone out meanwhile are charged for the wait (correction for
+ * coordinated omission). The uncorrected service time is reported next to
+ * it. Arrivals still unsent when the run ends are counted as "unsent" and
+ * recorded with the wait they had accumulated so far.
+ *
+ * Each connection gets its own thread and an equal share of the arrival
+ * rate, and has one request in flight at a time, so --connections is the
+ * concurrency. The query mix comes from --mix (one SEARCH, COUNT or
+ * GET command per line, optionally prefixed with an integer weight;
+ * '#' starts a comment) or defaults to a small synthetic mix. With --mock
+ * the run targets an in-process MockServer instead of --host/--port.
+ *
+ * Usage: mygram_load [--host ADDR] [--port N] [--mock] [--rate R]
+ *                    [--arrival poisson|constant] [--connections N]
+ *                    [--duration S] [--warmup S] [--interval S]
+ *                    [--mix FILE] [--order random|sequential]
+ *                    [--timeout MS] [--seed N]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "mygramdb/client_metrics.h"
+#include "mygramdb/mock_server.h"
+#include "mygramdb/mygramclient.h"
+
+using mygram::utils::ErrorCode;
+using mygramdb::client::ClientConfig;
+using mygramdb::client::CountResponse;
+using mygramdb::client::Document;
+using mygramdb::client::LatencyHistogram;
+using mygramdb::client::MygramClient;
+using mygramdb::client::SearchResponse;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr double kPercentiles[] = {50.0, 90.0, 99.0, 99.9};
+
+/**
+ * @brief One entry of the query mix, parsed once
+ */
+struct MixEntry {
+  enum class Kind : uint8_t { kSearch, kCount, kGet, kRaw };
+
+  Kind kind = Kind::kRaw;
+  uint32_t weight = 1;
+  std::string line;  // Command as written, for kRaw
+  std::string table;
+  std::string query;  // Query text, or primary key for kGet
+  std::vector<std::string> and_terms;
+  std::vector<std::string> not_terms;
+  std::vector<std::pair<std::string, std::string>> filters;
+  std::string sort_column;
+  bool sort_desc = true;
+  uint32_t limit = 100;
+  uint32_t offset = 0;
+};
+
+/**
+ * @brief Split off the next token: a double-quoted string (with backslash
+ *        escapes, which are removed) or a run of non-space characters
+ */
+std::string NextToken(std::string_view& rest) {
+  size_t start = rest.find_first_not_of(" \t");
+  if (start == std::string_view::npos) {
+    rest = {};
+    return {};
+  }
+  rest.remove_prefix(start);
+
+  std::string token;
+  if (rest.front() == '"') {
+    size_t pos = 1;
+    while (pos < rest.size() && rest[pos] != '"') {
+      if (rest[pos] == '\\' && pos + 1 < rest.size()) {
+        ++pos;
+      }
+      token += rest[pos++];
+    }
+    rest.remove_prefix(std::min(pos + 1, rest.size()));
+    return token;
+  }
+
+  size_t end = std::min(rest.find_first_of(" \t"), rest.size());
+  token.assign(rest.substr(0, end));
+  rest.remove_prefix(end);
+  return token;
+}
+
+/**
+ * @brief Parse a SEARCH/COUNT/GET command into structured arguments
+ *
+ * Clauses the client API cannot express (filters other than '=') leave the
+ * entry as kRaw, sent verbatim through SendCommand().
+ */
+MixEntry ParseMixLine(std::string_view line) {
+  MixEntry entry;
+  std::string_view rest = line;
+  std::string verb = NextToken(rest);
+  if (!verb.empty() && verb.find_first_not_of("0123456789") == std::string::npos) {
+    entry.weight = static_cast<uint32_t>(std::max(1UL, std::strtoul(verb.c_str(), nullptr, 10)));
+    line = rest.substr(std::min(rest.find_first_not_of(" \t"), rest.size()));
+    verb = NextToken(rest);
+  }
+  entry.line.assign(line);
+
+  if (verb == "GET") {
+    entry.table = NextToken(rest);
+    entry.query = NextToken(rest);
+    entry.kind = MixEntry::Kind::kGet;
+    return entry;
+  }
+  if (verb != "SEARCH" && verb != "COUNT") {
+    return entry;
+  }
+
+  entry.table = NextToken(rest);
+  entry.query = NextToken(rest);
+  for (std::string token = NextToken(rest); !token.empty(); token = NextToken(rest)) {
+    if (token == "AND") {
+      entry.and_terms.push_back(NextToken(rest));
+    } else if (token == "NOT") {
+      entry.not_terms.push_back(NextToken(rest));
+    } else if (token == "FILTER") {
+      std::string key = NextToken(rest);
+      if (NextToken(rest) != "=") {
+        return entry;
+      }
+      entry.filters.emplace_back(key, NextToken(rest));
+    } else if (token == "SORT") {
+      std::string next = NextToken(rest);
+      if (next != "ASC" && next != "DESC") {
+        entry.sort_column = next;
+        std::string_view peek = rest;
+        std::string order = NextToken(peek);
+        if (order == "ASC" || order == "DESC") {
+          next = order;
+          rest = peek;
+        }
+      }
+      entry.sort_desc = next != "ASC";
+    } else if (token == "LIMIT") {
+      std::string value = NextToken(rest);
+      size_t comma = value.find(',');
+      if (comma != std::string::npos) {
+        entry.offset = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        value.erase(0, comma + 1);
+      }
+      entry.limit = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    } else {
+      return entry;
+    }
+  }
+  entry.kind = verb == "SEARCH" ? MixEntry::Kind::kSearch : MixEntry::Kind::kCount;
+  return entry;
+}
+
+std::vector<MixEntry> DefaultMix() {
+  std::vector<MixEntry> mix;
+  for (int i = 0; i < 20; ++i) {
+    const std::string term = "term" + std::to_string(i);
+    mix.push_back(ParseMixLine("6 SEARCH articles " + term + " LIMIT 20"));
+    mix.push_back(ParseMixLine("2 SEARCH articles " + term + " AND extra FILTER status = 1 LIMIT 20,20"));
+    mix.push_back(ParseMixLine("1 COUNT articles " + term));
+    mix.push_back(ParseMixLine("1 GET articles " + std::to_string((i * 4099) % 100000 + 1)));
+  }
+  return mix;
+}
+
+bool ReadMix(const std::string& path, std::vector<MixEntry>& mix) {
+  std::ifstream in(path);
+  if (!in) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string::npos || line[start] == '#') {
+      continue;
+    }
+    mix.push_back(ParseMixLine(std::string_view(line).substr(start)));
+  }
+  return !mix.empty();
+}
+
+/**
+ * @brief Latencies of one reporting interval (or the whole run)
+ */
+struct Window {
+  LatencyHistogram corrected;  // From intended start
+  LatencyHistogram service;    // From actual send
+  uint64_t errors = 0;
+  uint64_t unsent = 0;
+
+  void Absorb(const Window& other) {
+    corrected.Merge(other.corrected);
+    service.Merge(other.service);
+    errors += other.errors;
+    unsent += other.unsent;
+  }
+};
+
+struct Options {
+  std::string host = "127.0.0.1";
+  uint16_t port = 11016;
+  bool mock = false;
+  double rate = 1000.0;
+  bool poisson = true;
+  int connections = 4;
+  double duration_s = 10.0;
+  double warmup_s = 0.0;
+  double interval_s = 1.0;
+  std::string mix_path;
+  bool sequential = false;
+  uint32_t timeout_ms = 5000;
+  uint64_t seed = 1;
+};
+
+/**
+ * @brief One load thread: its connection, arrival schedule and current window
+ */
+class Worker {
+ public:
+  Worker(const Options& options, const std::vector<MixEntry>& mix, int index)
+      : options_(options),
+        mix_(mix),
+        rng_(options.seed * 1000003 + static_cast<uint64_t>(index)),
+        index_(index),
+        client_(ConfigFor(options)) {
+    std::vector<double> weights;
+    weights.reserve(mix.size());
+    for (const auto& entry : mix) {
+      weights.push_back(entry.weight);
+    }
+    pick_ = std::discrete_distribution<size_t>(weights.begin(), weights.end());
+    mean_gap_s_ = static_cast<double>(options.connections) / options.rate;
+  }
+
+  bool Connect() {
+    if (auto status = client_.Connect(); !status) {
+      std::fprintf(stderr, "connect to %s:%u failed: %s\n", options_.host.c_str(), static_cast<unsigned>(options_.port),
+                   status.error().message().c_str());
+      return false;
+    }
+    return true;
+  }
+
+  void Run(Clock::time_point start, Clock::time_point measure_from, Clock::time_point end) {
+    std::exponential_distribution<double> gap(1.0);
+    auto next_gap = [&] { return Seconds(options_.poisson ? mean_gap_s_ * gap(rng_) : mean_gap_s_); };
+    size_t next_entry = static_cast<size_t>(index_);
+
+    // Stagger constant-rate connections so their arrivals interleave
+    auto intended = start + (options_.poisson ? next_gap() : Seconds(mean_gap_s_ * index_ / options_.connections));
+    for (; intended < end; intended += next_gap()) {
+      if (stop_.load(std::memory_order_relaxed)) {
+        break;
+      }
+      std::this_thread::sleep_until(intended);
+
+      const MixEntry& entry = options_.sequential ? mix_[next_entry++ % mix_.size()] : mix_[pick_(rng_)];
+      const auto sent = Clock::now();
+      const bool ok = Issue(entry);
+      const auto done = Clock::now();
+
+      if (intended < measure_from) {
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      window_.corrected.Add(Nanos(done - intended));
+      window_.service.Add(Nanos(done - sent));
+      window_.errors += ok ? 0 : 1;
+    }
+
+    // Arrivals the run fell behind on: charge them the wait so far
+    const auto now = Clock::now();
+    for (; intended < end; intended += next_gap()) {
+      if (intended < measure_from) {
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      window_.corrected.Add(Nanos(now - intended));
+      ++window_.unsent;
+    }
+  }
+
+  /**
+   * @brief Hand over the latencies recorded since the last call
+   */
+  Window TakeWindow() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::exchange(window_, Window{});
+  }
+
+  void Stop() { stop_.store(true, std::memory_order_relaxed); }
+
+ private:
+  static ClientConfig ConfigFor(const Options& options) {
+    ClientConfig config;
+    config.host = options.host;
+    config.port = options.port;
+    config.timeout_ms = options.timeout_ms;
+    return config;
+  }
+
+  static Clock::duration Seconds(double seconds) {
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+  }
+
+  static uint64_t Nanos(Clock::duration duration) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+  }
+
+  bool Issue(const MixEntry& entry) {
+    mygram::utils::Expected<void, mygram::utils::Error> status;
+    switch (entry.kind) {
+      case MixEntry::Kind::kSearch:
+        status = client_.Search(entry.table, entry.query, entry.limit, entry.offset, entry.and_terms, entry.not_terms,
+                                entry.filters, entry.sort_column, entry.sort_desc, search_);
+        break;
+      case MixEntry::Kind::kCount:
+        status = client_.Count(entry.table, entry.query, entry.and_terms, entry.not_terms, entry.filters, count_);
+        break;
+      case MixEntry::Kind::kGet:
+        status = client_.Get(entry.table, entry.query, document_);
+        break;
+      case MixEntry::Kind::kRaw:
+        if (auto reply = client_.SendCommand(entry.line); !reply) {
+          status = mygram::utils::MakeUnexpected(reply.error());
+        } else if (reply->compare(0, 5, "ERROR") == 0) {
+          status = mygram::utils::MakeUnexpected(mygram::utils::MakeError(ErrorCode::kClientServerError, *reply));
+        }
+        break;
+    }
+    if (status) {
+      return true;
+    }
+    // Transport failures leave the connection unusable; server errors do not
+    const ErrorCode code = status.error().code();
+    if (code != ErrorCode::kClientServerError && code != ErrorCode::kClientInvalidArgument) {
+      client_.Disconnect();
+      (void)client_.Connect();
+    }
+    return false;
+  }
+
+  const Options& options_;
+  const std::vector<MixEntry>& mix_;
+  std::mt19937_64 rng_;
+  std::discrete_distribution<size_t> pick_;
+  const int index_;
+  double mean_gap_s_ = 0.0;
+  MygramClient client_;
+  SearchResponse search_;  // Reused replies, so the generator itself stays cheap
+  CountResponse count_;
+  Document document_;
+
+  std::atomic<bool> stop_{false};
+  std::mutex mutex_;
+  Window window_;
+};
+
+void PrintHeader() {
+  std::printf("%9s %9s %8s %7s %10s %10s %10s %10s %10s\n", "time_s", "requests", "rate/s", "errors", "p50_ms",
+              "p90_ms", "p99_ms", "p99.9_ms", "max_ms");
+}
+
+void PrintRow(const char* label, const LatencyHistogram& latency, uint64_t errors, double seconds) {
+  const double ms = 1e-6;
+  std::printf("%9s %9llu %8.0f %7llu", label, static_cast<unsigned long long>(latency.count),
+              seconds > 0 ? static_cast<double>(latency.count) / seconds : 0.0,
+              static_cast<unsigned long long>(errors));
+  for (double percentile : kPercentiles) {
+    std::printf(" %10.3f", static_cast<double>(latency.ValueAtPercentile(percentile)) * ms);
+  }
+  std::printf(" %10.3f\n", static_cast<double>(latency.max_ns) * ms);
+}
+
+int Usage(const char* program) {
+  std::fprintf(stderr,
+               "Usage: %s [--host ADDR] [--port N] [--mock] [--rate R] [--arrival poisson|constant]\n"
+               "          [--connections N] [--duration S] [--warmup S] [--interval S]\n"
+               "          [--mix FILE] [--order random|sequential] [--timeout MS] [--seed N]\n",
+               program);
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--mock") {
+      options.mock = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return Usage(argv[0]);
+    }
+    const std::string value = argv[++i];
+    if (arg == "--host") {
+      options.host = value;
+    } else if (arg == "--port") {
+      options.port = static_cast<uint16_t>(std::strtoul(value.c_str(), nullptr, 10));
+    } else if (arg == "--rate") {
+      options.rate = std::strtod(value.c_str(), nullptr);
+    } else if (arg == "--arrival" && (value == "poisson" || value == "constant")) {
+      options.poisson = value == "poisson";
+    } else if (arg == "--connections") {
+      options.connections = std::atoi(value.c_str());
+    } else if (arg == "--duration") {
+      options.duration_s = std::strtod(value.c_str(), nullptr);
+    } else if (arg == "--warmup") {
+      options.warmup_s = std::strtod(value.c_str(), nullptr);
+    } else if (arg == "--interval") {
+      options.interval_s = std::strtod(value.c_str(), nullptr);
+    } else if (arg == "--mix") {
+      options.mix_path = value;
+    } else if (arg == "--order" && (value == "random" || value == "sequential")) {
+      options.sequential = value == "sequential";
+    } else if (arg == "--timeout") {
+      options.timeout_ms = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    } else if (arg == "--seed") {
+      options.seed = std::strtoull(value.c_str(), nullptr, 10);
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+  if (options.rate <= 0 || options.connections <= 0 || options.duration_s <= 0 || options.interval_s <= 0) {
+    return Usage(argv[0]);
+  }
+
+  std::vector<MixEntry> mix;
+  if (options.mix_path.empty()) {
+    mix = DefaultMix();
+  } else if (!ReadMix(options.mix_path, mix)) {
+    std::fprintf(stderr, "cannot read a query mix from %s\n", options.mix_path.c_str());
+    return 1;
+  }
+
+  std::unique_ptr<mygramdb::mock::MockServer> mock;
+  if (options.mock) {
+    auto started = mygramdb::mock::MockServer::Start(mygramdb::mock::MockServerOptions{});
+    if (!started) {
+      std::fprintf(stderr, "mock server: %s\n", started.error().message().c_str());
+      return 1;
+    }
+    mock = std::move(*started);
+    options.host = "127.0.0.1";
+    options.port = mock->port();
+  }
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  for (int i = 0; i < options.connections; ++i) {
+    workers.push_back(std::make_unique<Worker>(options, mix, i));
+    if (!workers.back()->Connect()) {
+      return 1;
+    }
+  }
+
+  std::printf("# %s:%u  rate=%.0f/s (%s)  connections=%d  duration=%.0fs  mix=%zu entries\n",
+              options.host.c_str(), static_cast<unsigned>(options.port), options.rate,
+              options.poisson ? "poisson" : "constant", options.connections, options.duration_s, mix.size());
+  std::printf("# Latency from intended start (corrected for coordinated omission)\n");
+  PrintHeader();
+
+  const auto start = Clock::now();
+  const auto measure_from = start + std::chrono::duration_cast<Clock::duration>(
+                                        std::chrono::duration<double>(options.warmup_s));
+  const auto end = measure_from + std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(options.duration_s));
+  std::vector<std::thread> threads;
+  threads.reserve(workers.size());
+  for (auto& worker : workers) {
+    threads.emplace_back([&worker, start, measure_from, end] { worker->Run(start, measure_from, end); });
+  }
+
+  // Report each interval while the load runs
+  Window total;
+  const auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.interval_s));
+  for (auto tick = measure_from + interval; tick <= end; tick += interval) {
+    std::this_thread::sleep_until(tick);
+    Window window;
+    for (auto& worker : workers) {
+      window.Absorb(worker->TakeWindow());
+    }
+    char label[32];
+    std::snprintf(label, sizeof(label), "%.1f", std::chrono::duration<double>(tick - measure_from).count());
+    PrintRow(label, window.corrected, window.errors, options.interval_s);
+    std::fflush(stdout);
+    total.Absorb(window);
+  }
+
+  // Replies still outstanding at the end get a grace period of one timeout
+  const auto grace = end + std::chrono::milliseconds(options.timeout_ms);
+  std::this_thread::sleep_until(std::min(grace, Clock::now() + interval));
+  for (auto& worker : workers) {
+    worker->Stop();
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& worker : workers) {
+    total.Absorb(worker->TakeWindow());
+  }
+
+  std::printf("\n# Summary over %.1fs (%llu unsent)\n", options.duration_s,
+              static_cast<unsigned long long>(total.unsent));
+  PrintHeader();
+  PrintRow("corrected", total.corrected, total.errors, options.duration_s);
+  PrintRow("service", total.service, total.errors, options.duration_s);
+  return 0;
+}
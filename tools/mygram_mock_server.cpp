@@ -0,0 +1,176 @@
+/**
+ * @file mygram_mock_server.cpp
+ * @brief Stand-alone MygramDB stand-in serving synthetic tables
+ *
+ * Runs MockServer until SIGINT/SIGTERM so the examples, tests and benchmarks
+ * can be pointed at it instead of a real server. Prints "PORT <n>" once
+ * listening (useful with --port 0) and the server counters on exit.
+ *
+ * Usage: mygram_mock_server [options]
+ *   --host ADDR              Listen address (default 127.0.0.1)
+ *   --port N                 Listen port, 0 for any free port (default 11016)
+ *   --table NAME:DOCS[:FIELDS]
+ *                            Serve a table; repeatable (default articles:100000:4)
+ *   --latency SPEC           fixed:US | uniform:MIN_US:MAX_US | exp:MEAN_US |
+ *                            lognormal:MEDIAN_US:SIGMA
+ *   --segment BYTES          Write replies in chunks of BYTES
+ *   --segment-delay US       Pause between chunks (slow trickle)
+ *   --disconnect-every N     Drop the connection instead of answering every Nth request
+ *   --disconnect-rate P      ... or each request with probability P
+ *   --error-every N          Answer every Nth request with an ERROR
+ *   --error-rate P           ... or each request with probability P
+ *   --seed N                 Seed for data and injected faults (default 1)
+ */
+
+#include <pthread.h>
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "mygramdb/mock_server.h"
+
+using mygramdb::mock::LatencyModel;
+using mygramdb::mock::MockServer;
+using mygramdb::mock::MockServerOptions;
+using mygramdb::mock::MockTable;
+
+namespace {
+
+constexpr uint16_t kDefaultPort = 11016;
+
+std::vector<std::string> Split(const std::string& text, char separator) {
+  std::vector<std::string> parts;
+  size_t start = 0;
+  for (size_t pos = text.find(separator); pos != std::string::npos; pos = text.find(separator, start)) {
+    parts.push_back(text.substr(start, pos - start));
+    start = pos + 1;
+  }
+  parts.push_back(text.substr(start));
+  return parts;
+}
+
+bool ParseTable(const std::string& spec, MockTable& table) {
+  auto parts = Split(spec, ':');
+  if (parts.size() < 2 || parts.size() > 3 || parts[0].empty()) {
+    return false;
+  }
+  table.name = parts[0];
+  table.documents = std::strtoull(parts[1].c_str(), nullptr, 10);
+  if (parts.size() == 3) {
+    table.fields = static_cast<uint32_t>(std::strtoul(parts[2].c_str(), nullptr, 10));
+  }
+  return table.documents > 0;
+}
+
+bool ParseLatency(const std::string& spec, LatencyModel& latency) {
+  auto parts = Split(spec, ':');
+  const size_t expected_args = (parts[0] == "uniform" || parts[0] == "lognormal") ? 3 : 2;
+  if (parts.size() != expected_args) {
+    return false;
+  }
+  latency.a_us = std::strtod(parts[1].c_str(), nullptr);
+  latency.b = expected_args == 3 ? std::strtod(parts[2].c_str(), nullptr) : 0.0;
+  if (parts[0] == "fixed") {
+    latency.distribution = LatencyModel::Distribution::kFixed;
+  } else if (parts[0] == "uniform") {
+    latency.distribution = LatencyModel::Distribution::kUniform;
+  } else if (parts[0] == "exp") {
+    latency.distribution = LatencyModel::Distribution::kExponential;
+  } else if (parts[0] == "lognormal") {
+    latency.distribution = LatencyModel::Distribution::kLogNormal;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+int Usage(const char* program) {
+  std::fprintf(stderr,
+               "Usage: %s [--host ADDR] [--port N] [--table NAME:DOCS[:FIELDS]]... [--latency SPEC]\n"
+               "          [--segment BYTES] [--segment-delay US] [--disconnect-every N] [--disconnect-rate P]\n"
+               "          [--error-every N] [--error-rate P] [--seed N]\n"
+               "  SPEC: fixed:US | uniform:MIN_US:MAX_US | exp:MEAN_US | lognormal:MEDIAN_US:SIGMA\n",
+               program);
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  MockServerOptions options;
+  options.port = kDefaultPort;
+  std::vector<MockTable> tables;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      return Usage(argv[0]);
+    }
+    const std::string value = argv[++i];
+    if (arg == "--host") {
+      options.host = value;
+    } else if (arg == "--port") {
+      options.port = static_cast<uint16_t>(std::strtoul(value.c_str(), nullptr, 10));
+    } else if (arg == "--table") {
+      MockTable table;
+      if (!ParseTable(value, table)) {
+        return Usage(argv[0]);
+      }
+      tables.push_back(table);
+    } else if (arg == "--latency") {
+      if (!ParseLatency(value, options.latency)) {
+        return Usage(argv[0]);
+      }
+    } else if (arg == "--segment") {
+      options.segment_bytes = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (arg == "--segment-delay") {
+      options.segment_delay_us = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    } else if (arg == "--disconnect-every") {
+      options.disconnect_every = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (arg == "--disconnect-rate") {
+      options.disconnect_rate = std::strtod(value.c_str(), nullptr);
+    } else if (arg == "--error-every") {
+      options.error_every = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (arg == "--error-rate") {
+      options.error_rate = std::strtod(value.c_str(), nullptr);
+    } else if (arg == "--seed") {
+      options.seed = std::strtoull(value.c_str(), nullptr, 10);
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+  if (!tables.empty()) {
+    options.tables = tables;
+  }
+
+  // Block the signals before the server threads start so only this thread sees them
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  auto server = MockServer::Start(options);
+  if (!server) {
+    std::fprintf(stderr, "mygram_mock_server: %s\n", server.error().message().c_str());
+    return 1;
+  }
+  std::printf("PORT %u\n", static_cast<unsigned>((*server)->port()));
+  std::fflush(stdout);
+
+  int signum = 0;
+  sigwait(&signals, &signum);
+
+  (*server)->Stop();
+  const auto stats = (*server)->Stats();
+  std::fprintf(stderr,
+               "connections=%llu requests=%llu errors_injected=%llu disconnects=%llu bytes_sent=%llu\n",
+               static_cast<unsigned long long>(stats.connections), static_cast<unsigned long long>(stats.requests),
+               static_cast<unsigned long long>(stats.errors_injected),
+               static_cast<unsigned long long>(stats.disconnects),
+               static_cast<unsigned long long>(stats.bytes_sent));
+  return 0;
+}
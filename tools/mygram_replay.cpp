@@ -0,0 +1,338 @@
+/**
+ * @file mygram_replay.cpp
+ * @brief Re-issue a capture log (see query_capture.h) and diff the results
+ *
+ * Every captured connection is replayed by its own thread over its own
+ * connection, in capture order, with each request sent at its original
+ * offset from the capture start divided by --speed (--speed 0 sends each
+ * request as soon as the previous reply of that connection is in), so the
+ * original concurrency and arrival pattern are reproduced. By default only
+ * SEARCH, COUNT and GET are replayed; --all also re-issues everything else
+ * that was captured (SAVE, LOAD, replication control, ...).
+ *
+ * For SEARCH and COUNT the replayed result count is compared with the
+ * captured one, for GET whether the document was found, and for every
+ * request whether it failed; the first --max-diffs mismatches are listed.
+ * Original and replayed latency percentiles are printed side by side. Exits
+ * with 1 when any replayed request did not match.
+ *
+ * With --dump the log is printed as text instead of replayed.
+ *
+ * Usage: mygram_replay [--host ADDR] [--port N] [--mock] [--speed X] [--all]
+ *                      [--max-diffs N] [--timeout MS] [--dump] CAPTURE
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mygramdb/client_metrics.h"
+#include "mygramdb/mock_server.h"
+#include "mygramdb/mygramclient.h"
+#include "mygramdb/query_capture.h"
+
+using mygramdb::client::CaptureRecord;
+using mygramdb::client::ClientConfig;
+using mygramdb::client::CommandType;
+using mygramdb::client::CommandTypeName;
+using mygramdb::client::LatencyHistogram;
+using mygramdb::client::MygramClient;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr double kPercentiles[] = {50.0, 90.0, 99.0, 99.9};
+
+struct Options {
+  std::string host = "127.0.0.1";
+  uint16_t port = 11016;
+  bool mock = false;
+  double speed = 1.0;
+  bool all = false;
+  size_t max_diffs = 10;
+  uint32_t timeout_ms = 5000;
+  bool dump = false;
+  std::string path;
+};
+
+/**
+ * @brief Result of a request as compared by the replay
+ */
+struct Outcome {
+  bool failed = false;
+  uint64_t matched = 0;  // Result count, or 1 for a GET that found its document
+};
+
+struct Mismatch {
+  const CaptureRecord* record;
+  Outcome replayed;
+};
+
+/**
+ * @brief Replay of one captured connection
+ */
+struct Stream {
+  std::vector<const CaptureRecord*> records;  // In start order
+  LatencyHistogram original;
+  LatencyHistogram replayed;
+  std::vector<Mismatch> mismatches;
+  uint64_t mismatch_count = 0;
+  std::string connect_error;
+};
+
+bool Replayable(const CaptureRecord& record, bool all) {
+  return all || record.command == CommandType::kSearch || record.command == CommandType::kCount ||
+         record.command == CommandType::kGet;
+}
+
+/**
+ * @brief Parse the outcome of a reply as the client would count it
+ */
+Outcome ParseReply(CommandType type, const std::string& reply) {
+  Outcome outcome;
+  if (reply.compare(0, 5, "ERROR") == 0) {
+    outcome.failed = true;
+  } else if (type == CommandType::kGet) {
+    outcome.matched = reply.compare(0, 6, "OK DOC") == 0 ? 1 : 0;
+  } else if (reply.compare(0, 11, "OK RESULTS ") == 0) {
+    outcome.matched = std::strtoull(reply.c_str() + 11, nullptr, 10);
+  } else if (reply.compare(0, 9, "OK COUNT ") == 0) {
+    outcome.matched = std::strtoull(reply.c_str() + 9, nullptr, 10);
+  }
+  return outcome;
+}
+
+bool Matches(const CaptureRecord& record, const Outcome& replayed) {
+  const bool failed = record.error_code != 0;
+  if (failed || replayed.failed) {
+    return failed == replayed.failed;
+  }
+  switch (record.command) {
+    case CommandType::kSearch:
+    case CommandType::kCount:
+    case CommandType::kGet:
+      return record.matched == replayed.matched;
+    default:
+      return true;
+  }
+}
+
+void RunStream(const Options& options, Clock::time_point start, Stream& stream) {
+  ClientConfig config;
+  config.host = options.host;
+  config.port = options.port;
+  config.timeout_ms = options.timeout_ms;
+  MygramClient client(config);
+  if (auto status = client.Connect(); !status) {
+    stream.connect_error = status.error().message();
+    return;
+  }
+
+  for (const CaptureRecord* record : stream.records) {
+    if (options.speed > 0) {
+      std::this_thread::sleep_until(
+          start + std::chrono::duration_cast<Clock::duration>(
+                      std::chrono::duration<double, std::nano>(static_cast<double>(record->start_ns) / options.speed)));
+    }
+
+    const auto sent = Clock::now();
+    auto reply = client.SendCommand(record->text);
+    stream.replayed.Add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sent)
+                                                  .count()));
+    stream.original.Add(record->latency_ns);
+
+    Outcome outcome;
+    if (reply) {
+      outcome = ParseReply(record->command, *reply);
+    } else {
+      outcome.failed = true;
+      if (!client.IsConnected() || reply.error().code() == mygram::utils::ErrorCode::kClientConnectionClosed) {
+        client.Disconnect();
+        (void)client.Connect();  // Keep going; the next request reports whether it worked
+      }
+    }
+    if (!Matches(*record, outcome)) {
+      ++stream.mismatch_count;
+      if (stream.mismatches.size() < options.max_diffs) {
+        stream.mismatches.push_back({record, outcome});
+      }
+    }
+  }
+}
+
+void PrintRow(const char* label, const LatencyHistogram& latency) {
+  const double ms = 1e-6;
+  std::printf("%9s %9llu", label, static_cast<unsigned long long>(latency.count));
+  for (double percentile : kPercentiles) {
+    std::printf(" %10.3f", static_cast<double>(latency.ValueAtPercentile(percentile)) * ms);
+  }
+  std::printf(" %10.3f\n", static_cast<double>(latency.max_ns) * ms);
+}
+
+std::string DescribeOutcome(const Outcome& outcome) {
+  return outcome.failed ? "error" : std::to_string(outcome.matched);
+}
+
+void Dump(const std::vector<CaptureRecord>& records) {
+  std::printf("%12s %5s %-11s %10s %9s %9s %5s %s\n", "start_ms", "conn", "command", "latency_ms", "bytes", "matched",
+              "error", "text");
+  for (const CaptureRecord& record : records) {
+    std::printf("%12.3f %5u %-11s %10.3f %9llu %9llu %5u %s\n", static_cast<double>(record.start_ns) * 1e-6,
+                record.connection, CommandTypeName(record.command), static_cast<double>(record.latency_ns) * 1e-6,
+                static_cast<unsigned long long>(record.response_bytes),
+                static_cast<unsigned long long>(record.matched), record.error_code, record.text.c_str());
+  }
+}
+
+int Usage(const char* program) {
+  std::fprintf(stderr,
+               "Usage: %s [--host ADDR] [--port N] [--mock] [--speed X] [--all] [--max-diffs N]\n"
+               "          [--timeout MS] [--dump] CAPTURE\n",
+               program);
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--mock") {
+      options.mock = true;
+      continue;
+    }
+    if (arg == "--all") {
+      options.all = true;
+      continue;
+    }
+    if (arg == "--dump") {
+      options.dump = true;
+      continue;
+    }
+    if (arg.compare(0, 2, "--") != 0) {
+      if (!options.path.empty()) {
+        return Usage(argv[0]);
+      }
+      options.path = arg;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return Usage(argv[0]);
+    }
+    const std::string value = argv[++i];
+    if (arg == "--host") {
+      options.host = value;
+    } else if (arg == "--port") {
+      options.port = static_cast<uint16_t>(std::strtoul(value.c_str(), nullptr, 10));
+    } else if (arg == "--speed") {
+      options.speed = std::strtod(value.c_str(), nullptr);
+    } else if (arg == "--max-diffs") {
+      options.max_diffs = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (arg == "--timeout") {
+      options.timeout_ms = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+  if (options.path.empty() || options.speed < 0) {
+    return Usage(argv[0]);
+  }
+
+  auto records = mygramdb::client::ReadCaptureLog(options.path);
+  if (!records) {
+    std::fprintf(stderr, "mygram_replay: %s\n", records.error().message().c_str());
+    return 1;
+  }
+  if (options.dump) {
+    Dump(*records);
+    return 0;
+  }
+
+  // One stream per captured connection, each in start order
+  std::map<uint32_t, Stream> streams;
+  size_t skipped = 0;
+  for (const CaptureRecord& record : *records) {
+    if (Replayable(record, options.all)) {
+      streams[record.connection].records.push_back(&record);
+    } else {
+      ++skipped;
+    }
+  }
+  for (auto& [connection, stream] : streams) {
+    std::stable_sort(stream.records.begin(), stream.records.end(),
+                     [](const CaptureRecord* a, const CaptureRecord* b) { return a->start_ns < b->start_ns; });
+  }
+
+  std::unique_ptr<mygramdb::mock::MockServer> mock;
+  if (options.mock) {
+    auto started = mygramdb::mock::MockServer::Start(mygramdb::mock::MockServerOptions{});
+    if (!started) {
+      std::fprintf(stderr, "mock server: %s\n", started.error().message().c_str());
+      return 1;
+    }
+    mock = std::move(*started);
+    options.host = "127.0.0.1";
+    options.port = mock->port();
+  }
+
+  std::printf("# %s:%u  %zu requests over %zu connections (%zu skipped)  speed=%g%s\n", options.host.c_str(),
+              static_cast<unsigned>(options.port), records->size() - skipped, streams.size(), skipped, options.speed,
+              options.speed == 0 ? " (as fast as possible)" : "");
+
+  const auto start = Clock::now();
+  std::vector<std::thread> threads;
+  threads.reserve(streams.size());
+  for (auto& [connection, stream] : streams) {
+    threads.emplace_back([&options, start, &stream = stream] { RunStream(options, start, stream); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const double elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+  LatencyHistogram original;
+  LatencyHistogram replayed;
+  uint64_t mismatch_count = 0;
+  std::vector<std::pair<uint32_t, Mismatch>> mismatches;
+  for (auto& [connection, stream] : streams) {
+    if (!stream.connect_error.empty()) {
+      std::fprintf(stderr, "mygram_replay: connection %u: %s\n", connection, stream.connect_error.c_str());
+      return 1;
+    }
+    original.Merge(stream.original);
+    replayed.Merge(stream.replayed);
+    mismatch_count += stream.mismatch_count;
+    for (const Mismatch& mismatch : stream.mismatches) {
+      mismatches.emplace_back(connection, mismatch);
+    }
+  }
+
+  std::printf("%9s %9s %10s %10s %10s %10s %10s\n", "latency", "requests", "p50_ms", "p90_ms", "p99_ms", "p99.9_ms",
+              "max_ms");
+  PrintRow("original", original);
+  PrintRow("replay", replayed);
+  std::printf("# replayed in %.3fs\n", elapsed_s);
+
+  std::sort(mismatches.begin(), mismatches.end(), [](const auto& a, const auto& b) {
+    return a.second.record->start_ns < b.second.record->start_ns;
+  });
+  if (mismatches.size() > options.max_diffs) {
+    mismatches.resize(options.max_diffs);
+  }
+  for (const auto& [connection, mismatch] : mismatches) {
+    const CaptureRecord& record = *mismatch.record;
+    Outcome captured{record.error_code != 0, record.matched};
+    std::printf("DIFF conn=%u at=%.3fms captured=%s replayed=%s  %s\n", connection,
+                static_cast<double>(record.start_ns) * 1e-6, DescribeOutcome(captured).c_str(),
+                DescribeOutcome(mismatch.replayed).c_str(), record.text.c_str());
+  }
+  std::printf("mismatches=%llu\n", static_cast<unsigned long long>(mismatch_count));
+  return mismatch_count == 0 ? 0 : 1;
+}